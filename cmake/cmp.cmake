@@ -1,4 +1,9 @@
 
+# Single-threaded shell sessions
+option(BASHSPARK_SINGLE_THREADED "Share session state without atomic reference counts" OFF)
+# Diagnostic log
+option(BASHSPARK_NO_LOG "Remove the diagnostic log at compile time" OFF)
+
 # Add compile options to target
 message(STATUS "aaaaaaaaaa")
 
@@ -16,6 +21,16 @@ function(add_cmp_flags target)
     )
     # Link json
     target_link_libraries("${target}" PUBLIC nlohmann_json::nlohmann_json)
+    # Link threads
+    target_link_libraries("${target}" PUBLIC Threads::Threads)
+    # Shell policy (changes the layout of the sessions, so it is public)
+    if (BASHSPARK_SINGLE_THREADED)
+        target_compile_definitions("${target}" PUBLIC BS_SINGLE_THREADED)
+    endif ()
+    # Diagnostic log (used by the headers, so it is public)
+    if (BASHSPARK_NO_LOG)
+        target_compile_definitions("${target}" PUBLIC BS_NO_LOG)
+    endif ()
     # Compiler flags
     if (CMAKE_BUILD_TYPE STREQUAL "Debug")
         message(STATUS "debug")
@@ -55,7 +70,3 @@ function(add_cmp_flags target)
         endif ()
     endif ()
 endfunction()
-
-if (CMAKE_BUILD_TYPE STREQUAL "Debug")
-    add_definitions(-DBS_DEBUG)
-endif()
@@ -34,7 +34,15 @@
 
 #include "BashSpark/command.h"
 #include "BashSpark/shell.h"
+#include "BashSpark/shell/shell_script.h"
+#include "BashSpark/shell/shell_alloc.h"
+#include "BashSpark/shell/shell_log.h"
+#include "BashSpark/shell/shell_profiler.h"
+#include "BashSpark/shell/shell_tracer.h"
+#include "BashSpark/shell/shell_scheduler.h"
+#include "BashSpark/static_shell.h"
 #include "BashSpark/shell/shell_status.h"
 #include "BashSpark/shell/shell_session.h"
+#include "BashSpark/shell/shell_source.h"
 
 
@@ -33,8 +33,11 @@
 #pragma once
 
 #include <span>
+#include <string_view>
 
+#include "BashSpark/command/command_metrics.h"
 #include "BashSpark/shell/shell_session.h"
+#include "BashSpark/shell/shell_task.h"
 
 namespace bs {
     class shell;
@@ -78,6 +81,25 @@ namespace bs {
             shell_session &oSession
         ) const = 0;
 
+        /**
+         * @brief Execute the command as a coroutine.
+         *
+         * Used instead of \ref run when the script runs as a task, see
+         * \ref bs::shell_script::run_async "shell_script::run_async". Commands
+         * waiting on I/O may override it to start the I/O, `co_await` a
+         * \ref bs::shell_event "shell_event" set once the I/O completes, and
+         * `co_return` the status. While awaiting, the task gives up its thread.
+         * By default it runs \ref run.
+         *
+         * @param vArgs Arguments for the command, valid until the task finishes.
+         * @param oSession The shell session context.
+         * @return Task returning the status of command execution.
+         */
+        [[nodiscard]] virtual shell_task run_async(
+            std::span<const std::string> vArgs,
+            shell_session &oSession
+        ) const;
+
     public:
         /**
          * @brief Get the command name (copy).
@@ -95,9 +117,24 @@ namespace bs {
             return this->m_sName;
         }
 
+        /**
+         * @brief Get the metrics of the command.
+         *
+         * Recorded while the shell collects metrics, see
+         * \ref bs::shell::set_collect_metrics "shell::set_collect_metrics".
+         * The command may be shared by several shells, its metrics are too.
+         *
+         * @return Reference to the metrics.
+         */
+        [[nodiscard]] command_metrics &get_metrics() const noexcept {
+            return this->m_oMetrics;
+        }
+
     private:
         /// Command name
         std::string m_sName;
+        /// Command metrics, updated by const runs
+        mutable command_metrics m_oMetrics;
     };
 
     /**
@@ -109,12 +146,16 @@ namespace bs {
       *
       */
     class command_echo : public command {
+    public:
+        /// Name of the command
+        constexpr static std::string_view NAME{"echo"};
+
     public:
         /**
          * @brief Constructs the command
          */
         command_echo()
-            : command("echo") {
+            : command(std::string(NAME)) {
         }
 
     public:
@@ -144,12 +185,16 @@ namespace bs {
      * allows dynamic command execution at runtime.
      */
     class command_eval : public command {
+    public:
+        /// Name of the command
+        constexpr static std::string_view NAME{"eval"};
+
     public:
         /**
          * @brief Constructs the command
          */
         explicit command_eval()
-            : command("eval") {
+            : command(std::string(NAME)) {
         }
 
     public:
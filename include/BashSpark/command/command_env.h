@@ -36,12 +36,16 @@ namespace bs {
      * Syntax: getenv variable
      */
     class command_getenv : public command {
+    public:
+        /// Name of the command
+        constexpr static std::string_view NAME{"getenv"};
+
     public:
         /**
          * @brief Constructs command
          */
         command_getenv()
-            : command("getenv") {
+            : command(std::string(NAME)) {
         }
 
         /**
@@ -83,12 +87,16 @@ namespace bs {
      * Syntax: setenv variable value
      */
     class command_setenv : public command {
+    public:
+        /// Name of the command
+        constexpr static std::string_view NAME{"setenv"};
+
     public:
         /**
          * @brief Constructs command
          */
         command_setenv()
-            : command("setenv") {
+            : command(std::string(NAME)) {
         }
 
         /**
@@ -42,12 +42,16 @@ namespace bs {
      *
      */
     class command_fcall : public command {
+    public:
+        /// Name of the command
+        constexpr static std::string_view NAME{"fcall"};
+
     public:
         /**
          * @brief Constructs command
          */
         command_fcall()
-            : command("fcall") {
+            : command(std::string(NAME)) {
         }
 
     public:
@@ -60,6 +64,14 @@ namespace bs {
          */
         shell_status run(const std::span<const std::string> &vArgs, shell_session &oSession) const override;
 
+        /**
+         * @brief Calls a function as a task, so the function body may suspend.
+         * @param vArgs Arguments for the command.
+         * @param oSession The shell session context.
+         * @return Task returning the status of command execution.
+         */
+        shell_task run_async(std::span<const std::string> vArgs, shell_session &oSession) const override;
+
     public:
         /**
          * @brief Print an error if the wrong number of arguments is provided.
@@ -77,5 +89,24 @@ namespace bs {
          * @param sFunction Status code
          */
         virtual void msg_error_function_not_found(std::ostream &oStdErr, const std::string &sFunction) const;
+
+    private:
+        /**
+         * @brief Function call, ready to be evaluated.
+         */
+        struct function_call {
+            const shell_session::func_type *m_pFunc = nullptr; ///< Function to call.
+            std::unique_ptr<shell_session> m_pSession; ///< Session of the function.
+        };
+
+        /**
+         * @brief Checks a call and makes the session of the function, shared by the evaluators.
+         * @param vArgs Arguments for the command.
+         * @param oSession The shell session context.
+         * @param oCall Call to fill.
+         * @return SHELL_SUCCESS, or the error status once displayed.
+         */
+        shell_status make_call(std::span<const std::string> vArgs, shell_session &oSession,
+                               function_call &oCall) const;
     };
 }
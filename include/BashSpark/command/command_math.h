@@ -64,12 +64,16 @@ namespace bs {
      *
      */
     class command_math : public command {
+    public:
+        /// Name of the command
+        constexpr static std::string_view NAME{"math"};
+
     public:
         /**
          * @brief Constructs command
          */
         command_math()
-            : command("math") {
+            : command(std::string(NAME)) {
         }
 
     public:
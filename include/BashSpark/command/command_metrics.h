@@ -0,0 +1,136 @@
+/**
+ * @file command_metrics.h
+ * @brief Defines class `bs::command_metrics`.
+ *
+ * This file contains the lock-free counters kept by each command while the
+ * shell collects metrics, and the snapshot they are read through.
+ *
+ * @date Created on 22/11/25
+ * @author Dante Doménech Martínez
+ *
+ * @copyright GNU General Public License v3.0
+ *
+ * This file is part of BashSpark.
+ * Copyright (C) 2025 Dante Doménech Martínez
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <string>
+
+#include "BashSpark/shell/shell_status.h"
+
+namespace bs {
+    /**
+     * @struct command_metrics_snapshot
+     * @brief Values of the metrics of a command at some point.
+     *
+     * See \ref bs::shell::get_command_metrics "shell::get_command_metrics".
+     */
+    struct command_metrics_snapshot {
+        /// Number of latency buckets, bucket `i` counts the runs faster than `2^i` microseconds, the last one the rest.
+        constexpr static std::size_t LATENCY_BUCKETS = 24;
+
+        /// Command name.
+        std::string m_sName;
+        /// Number of runs.
+        std::uint64_t m_nCalls = 0;
+        /// Number of runs not returning `bs::shell_status::SHELL_SUCCESS`.
+        std::uint64_t m_nErrors = 0;
+        /// Number of failed runs by status, for the statuses below \ref bs::command_metrics::STATUS_SLOTS.
+        std::map<shell_status, std::uint64_t> m_mErrors;
+        /// Number of failed runs with any other status.
+        std::uint64_t m_nOtherErrors = 0;
+        /// Time spent running the command.
+        std::chrono::nanoseconds m_nLatency{0};
+        /// Histogram of the run times.
+        std::array<std::uint64_t, LATENCY_BUCKETS> m_vLatency{};
+        /// Characters written to the standard output.
+        std::uint64_t m_nBytesOut = 0;
+        /// Characters written to the error output.
+        std::uint64_t m_nBytesErr = 0;
+
+        /**
+         * @brief Gets the upper bound of a latency quantile.
+         * @param dQuantile Quantile, between 0 and 1.
+         * @return Upper bound of the bucket holding the quantile, `max()` if it is the last one.
+         */
+        [[nodiscard]] std::chrono::microseconds get_latency_quantile(double dQuantile) const noexcept;
+    };
+
+    /**
+     * @class command_metrics
+     * @brief Lock-free counters of the runs of a command.
+     *
+     * Runs are recorded concurrently with relaxed atomic operations, so a
+     * snapshot taken while the command runs may mix values of different runs.
+     * Statuses from \ref STATUS_SLOTS on are counted together, as other statuses.
+     */
+    class command_metrics {
+    public:
+        /// Number of statuses counted apart
+        constexpr static std::size_t STATUS_SLOTS = 128;
+        static_assert(static_cast<std::size_t>(shell_status::SHELL_CMD_ERROR) < STATUS_SLOTS);
+
+        /// Number of latency buckets
+        constexpr static std::size_t LATENCY_BUCKETS = command_metrics_snapshot::LATENCY_BUCKETS;
+
+    public:
+        /**
+         * @brief Records a run.
+         * @param nStatus Status returned by the command.
+         * @param nLatency Time spent running.
+         * @param nBytesOut Characters written to the standard output.
+         * @param nBytesErr Characters written to the error output.
+         */
+        void record(
+            shell_status nStatus,
+            std::chrono::nanoseconds nLatency,
+            std::size_t nBytesOut,
+            std::size_t nBytesErr
+        ) noexcept;
+
+        /**
+         * @brief Reads the counters.
+         * @return The current values, without the command name.
+         */
+        [[nodiscard]] command_metrics_snapshot snapshot() const;
+
+        /**
+         * @brief Sets all the counters to zero.
+         */
+        void reset() noexcept;
+
+    private:
+        /// Counter type
+        using counter = std::atomic<std::uint64_t>;
+
+        counter m_nCalls{0}; ///< Number of runs.
+        counter m_nErrors{0}; ///< Number of failed runs.
+        counter m_nLatency{0}; ///< Time spent running, in nanoseconds.
+        counter m_nBytesOut{0}; ///< Characters written to the standard output.
+        counter m_nBytesErr{0}; ///< Characters written to the error output.
+        counter m_nOtherErrors{0}; ///< Failed runs with a status from \ref STATUS_SLOTS on.
+        std::array<counter, STATUS_SLOTS> m_vErrors{}; ///< Failed runs by status.
+        std::array<counter, LATENCY_BUCKETS> m_vLatency{}; ///< Histogram of the run times.
+    };
+}
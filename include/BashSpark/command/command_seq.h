@@ -39,12 +39,16 @@ namespace bs {
      *
      */
     class command_seq : public command {
+    public:
+        /// Name of the command
+        constexpr static std::string_view NAME{"seq"};
+
     public:
         /**
          * @brief Constructs command
          */
         command_seq()
-            : command("seq") {
+            : command(std::string(NAME)) {
         }
 
         /**
@@ -54,12 +54,16 @@ namespace bs {
      *
      */
     class command_test : public command {
+    public:
+        /// Name of the command
+        constexpr static std::string_view NAME{"test"};
+
     public:
         /**
          * @brief Constructs command
          */
         command_test()
-            : command("test") {
+            : command(std::string(NAME)) {
         }
 
     public:
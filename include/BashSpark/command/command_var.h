@@ -36,12 +36,16 @@ namespace bs {
      * Syntax: getvar variable
      */
     class command_getvar : public command {
+    public:
+        /// Name of the command
+        constexpr static std::string_view NAME{"getvar"};
+
     public:
         /**
           * @brief Constructs command
           */
         command_getvar()
-            : command("getvar") {
+            : command(std::string(NAME)) {
         }
 
         /**
@@ -84,12 +88,16 @@ namespace bs {
      * Syntax: setvar variable value
      */
     class command_setvar : public command {
+    public:
+        /// Name of the command
+        constexpr static std::string_view NAME{"setvar"};
+
     public:
         /**
          * @brief Constructs command
          */
         command_setvar()
-            : command("setvar") {
+            : command(std::string(NAME)) {
         }
 
         /**
@@ -123,4 +131,272 @@ namespace bs {
          */
         virtual void msg_error_variable_name(std::ostream &oStdErr, const std::string &sVariableName) const;
     };
+
+    /**
+     * @class command_appendvar
+     * @brief Appends to the value of a local variable in place.
+     *
+     * Syntax: appendvar variable value
+     */
+    class command_appendvar : public command {
+    public:
+        /// Name of the command
+        constexpr static std::string_view NAME{"appendvar"};
+
+    public:
+        /**
+         * @brief Constructs command
+         */
+        command_appendvar()
+            : command(std::string(NAME)) {
+        }
+
+        /**
+          * @brief Appends to the local variable value without copying it.
+          * If the local variable does not exist, creates it.
+          *
+          * If the parameter number does not match 2 then method `msg_error_param_number` is called.
+          * If the variable names is invalid then method `msg_error_variable_name` is called.
+          *
+          * @param vArgs Arguments for the command.
+          * @param oSession The shell session context.
+          * @return Status of command execution.
+          */
+        [[nodiscard]] shell_status run(
+            const std::span<const std::string> &vArgs,
+            shell_session &oSession
+        ) const override;
+
+    public:
+        /**
+         * @brief Print an error if the wrong number of arguments is provided.
+         * @param oStdErr Stream to print error message.
+         * @param nArgs Number of provided arguments.
+         */
+        virtual void msg_error_param_number(std::ostream &oStdErr, std::size_t nArgs) const;
+
+        /**
+         * @brief Print an error if variable name is invalid.
+         * @param oStdErr Stream to print error message.
+         * @param sVariableName Variable name provided.
+         */
+        virtual void msg_error_variable_name(std::ostream &oStdErr, const std::string &sVariableName) const;
+    };
+
+    /**
+     * @class command_setarray
+     * @brief Sets an indexed array variable.
+     *
+     * Syntax: setarray array [value...]
+     */
+    class command_setarray : public command {
+    public:
+        /// Name of the command
+        constexpr static std::string_view NAME{"setarray"};
+
+    public:
+        /**
+         * @brief Constructs command
+         */
+        command_setarray()
+            : command(std::string(NAME)) {
+        }
+
+        /**
+          * @brief Replaces the indexed array with the given values (elements 0, 1, ...).
+          *
+          * If no parameter is provided then method `msg_error_param_number` is called.
+          * If the array name is invalid then method `msg_error_variable_name` is called.
+          *
+          * @param vArgs Arguments for the command.
+          * @param oSession The shell session context.
+          * @return Status of command execution.
+          */
+        [[nodiscard]] shell_status run(
+            const std::span<const std::string> &vArgs,
+            shell_session &oSession
+        ) const override;
+
+    public:
+        /**
+         * @brief Print an error if the wrong number of arguments is provided.
+         * @param oStdErr Stream to print error message.
+         * @param nArgs Number of provided arguments.
+         */
+        virtual void msg_error_param_number(std::ostream &oStdErr, std::size_t nArgs) const;
+
+        /**
+         * @brief Print an error if array name is invalid.
+         * @param oStdErr Stream to print error message.
+         * @param sVariableName Array name provided.
+         */
+        virtual void msg_error_variable_name(std::ostream &oStdErr, const std::string &sVariableName) const;
+    };
+
+    /**
+     * @class command_setmap
+     * @brief Sets an associative array variable.
+     *
+     * Syntax: setmap array [key value...]
+     */
+    class command_setmap : public command {
+    public:
+        /// Name of the command
+        constexpr static std::string_view NAME{"setmap"};
+
+    public:
+        /**
+         * @brief Constructs command
+         */
+        command_setmap()
+            : command(std::string(NAME)) {
+        }
+
+        /**
+          * @brief Replaces the associative array with the given key-value pairs.
+          *
+          * If the parameter number is not odd then method `msg_error_param_number` is called.
+          * If the array name is invalid then method `msg_error_variable_name` is called.
+          *
+          * @param vArgs Arguments for the command.
+          * @param oSession The shell session context.
+          * @return Status of command execution.
+          */
+        [[nodiscard]] shell_status run(
+            const std::span<const std::string> &vArgs,
+            shell_session &oSession
+        ) const override;
+
+    public:
+        /**
+         * @brief Print an error if the wrong number of arguments is provided.
+         * @param oStdErr Stream to print error message.
+         * @param nArgs Number of provided arguments.
+         */
+        virtual void msg_error_param_number(std::ostream &oStdErr, std::size_t nArgs) const;
+
+        /**
+         * @brief Print an error if array name is invalid.
+         * @param oStdErr Stream to print error message.
+         * @param sVariableName Array name provided.
+         */
+        virtual void msg_error_variable_name(std::ostream &oStdErr, const std::string &sVariableName) const;
+    };
+
+    /**
+     * @class command_setitem
+     * @brief Sets an element of an array variable.
+     *
+     * Syntax: setitem array key value
+     */
+    class command_setitem : public command {
+    public:
+        /// Name of the command
+        constexpr static std::string_view NAME{"setitem"};
+
+    public:
+        /**
+         * @brief Constructs command
+         */
+        command_setitem()
+            : command(std::string(NAME)) {
+        }
+
+        /**
+          * @brief Sets the element of the array in place.
+          * If the array does not exist, creates an indexed array.
+          *
+          * If the parameter number does not match 3 then method `msg_error_param_number` is called.
+          * If the array name is invalid then method `msg_error_variable_name` is called.
+          * If the index is not valid for an indexed array then method `msg_error_index` is called.
+          *
+          * @param vArgs Arguments for the command.
+          * @param oSession The shell session context.
+          * @return Status of command execution.
+          */
+        [[nodiscard]] shell_status run(
+            const std::span<const std::string> &vArgs,
+            shell_session &oSession
+        ) const override;
+
+    public:
+        /**
+         * @brief Print an error if the wrong number of arguments is provided.
+         * @param oStdErr Stream to print error message.
+         * @param nArgs Number of provided arguments.
+         */
+        virtual void msg_error_param_number(std::ostream &oStdErr, std::size_t nArgs) const;
+
+        /**
+         * @brief Print an error if array name is invalid.
+         * @param oStdErr Stream to print error message.
+         * @param sVariableName Array name provided.
+         */
+        virtual void msg_error_variable_name(std::ostream &oStdErr, const std::string &sVariableName) const;
+
+        /**
+         * @brief Print an error if the index is not valid for an indexed array.
+         * @param oStdErr Stream to print error message.
+         * @param sVariableName Array name provided.
+         * @param sIndex Index provided.
+         */
+        virtual void msg_error_index(
+            std::ostream &oStdErr,
+            const std::string &sVariableName,
+            const std::string &sIndex
+        ) const;
+    };
+
+    /**
+     * @class command_readarray
+     * @brief Reads the input words into an indexed array variable.
+     *
+     * Syntax: readarray array
+     */
+    class command_readarray : public command {
+    public:
+        /// Name of the command
+        constexpr static std::string_view NAME{"readarray"};
+
+    public:
+        /**
+         * @brief Constructs command
+         */
+        command_readarray()
+            : command(std::string(NAME)) {
+        }
+
+        /**
+          * @brief Replaces the indexed array with the words of the input.
+          *
+          * Words are delimited by spaces, tabs and new lines. When piped from a
+          * builtin producing records, the records are taken without parsing text.
+          *
+          * If the number of parameters is not 1 then method `msg_error_param_number` is called.
+          * If the array name is invalid then method `msg_error_variable_name` is called.
+          *
+          * @param vArgs Arguments for the command.
+          * @param oSession The shell session context.
+          * @return Status of command execution.
+          */
+        [[nodiscard]] shell_status run(
+            const std::span<const std::string> &vArgs,
+            shell_session &oSession
+        ) const override;
+
+    public:
+        /**
+         * @brief Print an error if the wrong number of arguments is provided.
+         * @param oStdErr Stream to print error message.
+         * @param nArgs Number of provided arguments.
+         */
+        virtual void msg_error_param_number(std::ostream &oStdErr, std::size_t nArgs) const;
+
+        /**
+         * @brief Print an error if array name is invalid.
+         * @param oStdErr Stream to print error message.
+         * @param sVariableName Array name provided.
+         */
+        virtual void msg_error_variable_name(std::ostream &oStdErr, const std::string &sVariableName) const;
+    };
 }
@@ -34,15 +34,36 @@
 
 #pragma once
 
+#include <filesystem>
 #include <memory>
+#include <span>
+#include <stdexcept>
 #include <string_view>
+#include <vector>
 
 #include "BashSpark/command.h"
+#include "BashSpark/shell/shell_batch.h"
 #include "BashSpark/shell/shell_session.h"
 #include "BashSpark/shell/shell_parser_exception.h"
+#include "BashSpark/shell/shell_script.h"
 #include "BashSpark/tools/shell_hash.h"
 
 namespace bs {
+    /**
+     * @struct shell_capture
+     * @brief Result of a run whose output is captured.
+     *
+     * See \ref bs::shell::run_capture "shell::run_capture".
+     */
+    struct shell_capture {
+        /// Status code of last executed command.
+        shell_status m_nStatus;
+        /// Captured standard output.
+        std::string m_sOut;
+        /// Captured error output.
+        std::string m_sErr;
+    };
+
     /**
      * @class shell
      * @brief A simplified shell environment inspired by Bash.
@@ -74,6 +95,9 @@ namespace bs {
         /// Default size for the command hash table
         constexpr static std::size_t DEFAULT_COMMAND_HASH_TABLE_SIZE = 1024;
 
+        /// Maximum number of pending items of a streaming command substitution
+        constexpr static std::size_t STREAM_SUBSTITUTION_QUEUE_SIZE = 256;
+
     public:
         /**
          * @brief Construct bash object
@@ -85,11 +109,28 @@ namespace bs {
          * \ref bs::command_getvar "Command getvar"
          * \ref bs::command_setenv "Command setenv"
          * \ref bs::command_setvar "Command setvar"
+         * \ref bs::command_appendvar "Command appendvar"
+         * \ref bs::command_setarray "Command setarray"
+         * \ref bs::command_setmap "Command setmap"
+         * \ref bs::command_setitem "Command setitem"
+         * \ref bs::command_readarray "Command readarray"
          * \ref bs::command_seq "Command seq"
          * \ref bs::command_test "Command test"
          */
         static std::unique_ptr<shell> make_default_shell();
 
+        /**
+         * @brief Get the shared default shell
+         *
+         * The shell is built once, on first use, with the commands of
+         * \ref bs::shell::make_default_shell "make_default_shell" and is never modified.
+         * It is meant as the base of cheap per-request shells,
+         * see \ref bs::shell::shell(std::shared_ptr<const shell>) "shell(pBase)".
+         *
+         * @return The shared default shell.
+         */
+        static std::shared_ptr<const shell> get_shared_default_shell();
+
     public:
         /**
          * @brief Construct bash object
@@ -103,6 +144,56 @@ namespace bs {
          */
         virtual ~shell() = default;
 
+        /**
+         * @brief Construct bash object on top of a shared base shell
+         *
+         * Commands not set on this shell are searched on the base shell, so the
+         * base commands are shared instead of copied and only the additions
+         * of this shell are allocated. Erasing or removing a base command only
+         * hides it from this shell. The options are copied from the base shell.
+         *
+         * @param pBase Base shell, must not be modified while shared.
+         * @throw std::invalid_argument If pBase is null.
+         */
+        explicit shell(std::shared_ptr<const shell> pBase)
+            : m_pBase(pBase != nullptr ? std::move(pBase) : throw std::invalid_argument("Base shell is null")),
+              m_bStopOnCommandNotFound(m_pBase->m_bStopOnCommandNotFound),
+              m_bStreamSubstitution(m_pBase->m_bStreamSubstitution),
+              m_bCollectMetrics(m_pBase->m_bCollectMetrics) {
+        }
+
+    protected:
+        /// Finds a builtin of a derived shell by its name, nullptr if not a builtin
+        using builtin_finder = const command *(*)(const shell &, std::string_view) noexcept;
+
+        /// Runs a builtin of a derived shell by its name, false if not a builtin
+        using builtin_runner = bool (*)(
+            const shell &,
+            std::string_view,
+            std::span<const std::string>,
+            shell_session &,
+            shell_status &
+        );
+
+        /**
+         * @brief Construct bash object with a custom command hash table size
+         *
+         * The builtin finder and runner are plain functions rather than virtual
+         * methods, so shells without builtins only pay a null check on each lookup.
+         *
+         * @param nCommandHashTableSize Initial number of buckets of the command hash table
+         * @param fFindBuiltin Searched before the hash table, nullptr if none
+         * @param fRunBuiltin Runs the builtins found by fFindBuiltin, nullptr if none
+         */
+        explicit shell(
+            const std::size_t nCommandHashTableSize,
+            const builtin_finder fFindBuiltin = nullptr,
+            const builtin_runner fRunBuiltin = nullptr
+        ) : m_mCommands(nCommandHashTableSize),
+            m_fFindBuiltin(fFindBuiltin),
+            m_fRunBuiltin(fRunBuiltin) {
+        }
+
     public:
         /**
          * @brief Runs a command or script
@@ -137,19 +228,137 @@ namespace bs {
             shell_session &oSession
         );
 
+        /**
+         * @brief Runs a command or script capturing its output
+         *
+         * The command runs with the input, env, args, vars and functions of
+         * the session, but its output is written directly into the returned
+         * strings instead of the session streams.
+         *
+         * @param sCommand Command or script to run
+         * @param oSession Shell session
+         * @return Status code of last executed command and captured output
+         */
+        static shell_capture run_capture(
+            const std::string_view &sCommand,
+            shell_session &oSession
+        );
+
+        /**
+         * @brief Runs a parsed script capturing its output
+         *
+         * See \ref bs::shell::run_capture(const std::string_view &, shell_session &) "run_capture".
+         *
+         * @param oScript Script to run
+         * @param oSession Shell session
+         * @return Status code of last executed command and captured output
+         */
+        static shell_capture run_capture(
+            const shell_script &oScript,
+            shell_session &oSession
+        );
+
+        /**
+         * @brief Runs a script file
+         *
+         * The file is memory-mapped and parsed in place, without copies.
+         * If the file can not be read, the error is displayed with
+         * \ref bs::shell::msg_error_file_not_readable "msg_error_file_not_readable".
+         *
+         * @param oPath Path of the script
+         * @param oSession Shell session
+         * @return Status code of last executed command
+         */
+        static shell_status run_file(
+            const std::filesystem::path &oPath,
+            shell_session &oSession
+        );
+
+        /**
+         * @brief Parses a command or script
+         * @param sCommand Command or script to parse
+         * @return The parsed script
+         * @throw shell_parser_exception If a syntax error is found.
+         */
+        static shell_script compile(const std::string_view &sCommand);
+
+        /**
+         * @brief Parses a script file
+         *
+         * The file is memory-mapped and parsed in place, without copies.
+         * The mapping is released once parsed, the script owns its text.
+         *
+         * @param oPath Path of the script
+         * @return The parsed script
+         * @throw shell_parser_exception If a syntax error is found.
+         * @throw std::filesystem::filesystem_error If the file can not be read.
+         */
+        static shell_script compile_file(const std::filesystem::path &oPath);
+
+        /**
+         * @brief Runs independent jobs on a pool of threads
+         *
+         * Each job runs on its own session of this shell, with its own input,
+         * environment and arguments, and its output is captured. The calling
+         * thread takes part in the pool. Jobs sharing a compiled script are
+         * not parsed again. With the single-threaded policy, see
+         * \ref bs::shell_traits "shell_traits", jobs run on the calling thread.
+         *
+         * If a job throws, its status is `SHELL_ERROR` and the message of the
+         * exception is appended to its error output; the other jobs still run.
+         *
+         * The threads are started by each call and joined before it returns, and
+         * each job gets a fresh session: neither threads nor sessions are pooled
+         * across calls, so small batches pay the start of the threads. If a thread
+         * can not be started, the jobs run on the threads already started.
+         *
+         * @param vJobs Jobs to run
+         * @param nThreads Maximum number of threads, 0 to use the hardware concurrency
+         * @return Results of the jobs, in order, and aggregate statistics
+         */
+        shell_batch_result run_batch(std::span<const shell_job> vJobs, std::size_t nThreads = 0) const;
+
     public:
         /**
           * @brief Retrieves a command pointer by its string.
+          *
+          * The builtins of a \ref bs::static_shell "static_shell" are searched
+          * first, without the hash table.
+          *
           * @param sCommand The command string.
           * @return Pointer to the command, or nullptr if not found.
           */
         [[nodiscard]] const command *get_command(const std::string &sCommand) const noexcept;
 
+        /**
+          * @brief Runs a builtin command without looking it up in the hash table.
+          *
+          * The builtins of a \ref bs::static_shell "static_shell" are called
+          * through their type, without virtual dispatch. Other shells have no
+          * builtins. The metrics of the command are not recorded, see
+          * \ref set_collect_metrics.
+          *
+          * @param sCommand The command string.
+          * @param vArgs Arguments for the command.
+          * @param oSession The shell session context.
+          * @param nStatus Set to the status of the command if it is a builtin.
+          * @return true if the command is a builtin; false otherwise.
+          */
+        bool run_builtin(
+            std::string_view sCommand,
+            std::span<const std::string> vArgs,
+            shell_session &oSession,
+            shell_status &nStatus
+        ) const;
+
         /**
           * @brief Sets a command using a unique pointer. Overwrites previous command.
+          *
+          * Can be overwritten to reject some names, see \ref bs::static_shell "static_shell".
+          *
           * @param pCommand Unique pointer to the command.
           */
-        void set_command(std::unique_ptr<command> &&pCommand);
+        virtual void set_command(std::unique_ptr<command> &&pCommand);
 
         /**
           * @brief Creates and sets a command of type CommandT.
@@ -171,6 +380,9 @@ namespace bs {
 
         /**
           * @brief Removes a command and returns it.
+          *
+          * Commands of the base shell are hidden, but can not be returned.
+          *
           * @param sCommand The command string.
           * @return Unique pointer to the removed command, or nullptr if not found.
           */
@@ -182,6 +394,25 @@ namespace bs {
           */
         void erase_command(const std::string &sCommand);
 
+        /**
+          * @brief Retrieves the commands of the shell.
+          *
+          * Includes the commands of the base shell not hidden by this shell.
+          * Can be overwritten along with \ref get_command.
+          *
+          * @return Pointers to the commands, in no particular order.
+          */
+        [[nodiscard]] virtual std::vector<const command *> get_commands() const;
+
+        /**
+          * @brief Reads the metrics of the commands of the shell.
+          *
+          * See \ref set_collect_metrics.
+          *
+          * @return Snapshot of the metrics of each command, sorted by name.
+          */
+        [[nodiscard]] std::vector<command_metrics_snapshot> get_command_metrics() const;
+
     public:
         /**
          * @brief Checks if execution stops on command not found.
@@ -195,6 +426,45 @@ namespace bs {
          */
         void set_stop_on_command_not_found(bool bStopOnCommandNotFound) noexcept;
 
+        /**
+         * @brief Checks if for-loops stream their command substitutions.
+         * @return true if they stream; false otherwise.
+         */
+        [[nodiscard]] bool get_stream_substitution() const noexcept;
+
+        /**
+         * @brief Sets whether for-loops stream their command substitutions.
+         *
+         * When enabled, `for x in $(producer)` runs the producer on a worker thread
+         * and the loop consumes its items from a bounded queue as they appear.
+         * The producer reads no input and its error output is written once it
+         * finishes. Ignored by the single-threaded \ref bs::shell_traits "shell_traits"
+         * and by coroutine evaluation, which would block its scheduler.
+         *
+         * @param bStreamSubstitution If true, substitutions are streamed; if false, they are fully captured first.
+         */
+        void set_stream_substitution(bool bStreamSubstitution) noexcept;
+
+        /**
+         * @brief Checks if the runs of the commands are recorded in their metrics.
+         * @return true if they are recorded; false otherwise.
+         */
+        [[nodiscard]] bool get_collect_metrics() const noexcept;
+
+        /**
+         * @brief Sets whether the runs of the commands are recorded in their metrics.
+         *
+         * When enabled, each run records its status, its time and the characters
+         * it writes in the metrics of the command, see
+         * \ref bs::command::get_metrics "command::get_metrics". The characters are
+         * counted by redirecting the session to counting streams during the run,
+         * the streams of the session are not changed, so they may be shared by
+         * sessions on other threads.
+         *
+         * @param bCollectMetrics If true, runs are recorded; if false, they are not.
+         */
+        void set_collect_metrics(bool bCollectMetrics) noexcept;
+
     public:
         /**
          * @brief Displays the error message for “command not found”.
@@ -216,6 +486,46 @@ namespace bs {
          */
         virtual void msg_error_invalid_function_name(shell_session &oSession, const std::string &sFunction) const;
 
+        /**
+         * @brief Displays the error message for “loop bound is not an integer”.
+         *
+         * Can be overwritten with custom behaviour.
+         *
+         * @param oSession Shell session
+         * @param sValue Invalid bound or step
+         */
+        virtual void msg_error_invalid_loop_bound(shell_session &oSession, const std::string &sValue) const;
+
+        /**
+         * @brief Displays the error message for “loop step can not reach the end value”.
+         *
+         * Can be overwritten with custom behaviour.
+         *
+         * @param oSession Shell session
+         * @param nFrom First value
+         * @param nStep Step
+         * @param nTo Last value
+         */
+        virtual void msg_error_invalid_loop_step(
+            shell_session &oSession,
+            std::int64_t nFrom,
+            std::int64_t nStep,
+            std::int64_t nTo
+        ) const;
+
+        /**
+         * @brief Displays the error message for “file can not be read”.
+         *
+         * Can be overwritten with custom behaviour.
+         *
+         * @param oSession Shell session
+         * @param oError Error reading the file
+         */
+        virtual void msg_error_file_not_readable(
+            shell_session &oSession,
+            const std::filesystem::filesystem_error &oError
+        ) const;
+
         /**
          * @brief Displays the error message for “syntax errors”.
          *
@@ -230,11 +540,21 @@ namespace bs {
         ) const;
 
     private:
-        /// Data structure to hold commands. Optimized for read time.
+        /// Shared base shell, nullptr if none.
+        std::shared_ptr<const shell> m_pBase;
+        /// Data structure to hold commands. Optimized for read time. Null commands hide base commands.
         std::unordered_map<std::string, std::unique_ptr<command>, shell_hash> m_mCommands;
+        /// Finds the builtins of a derived shell, nullptr if none
+        builtin_finder m_fFindBuiltin = nullptr;
+        /// Runs the builtins of a derived shell, nullptr if none
+        builtin_runner m_fRunBuiltin = nullptr;
         /// Mutex to allow only one command execution at once
         mutable std::mutex m_oExecutionMutex;
         /// Stop execution on command not found
         bool m_bStopOnCommandNotFound = true;
+        /// Stream command substitutions of for-loops
+        bool m_bStreamSubstitution = false;
+        /// Record the runs of the commands in their metrics
+        bool m_bCollectMetrics = false;
     };
 }
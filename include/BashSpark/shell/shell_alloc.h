@@ -0,0 +1,211 @@
+/**
+ * @file shell_alloc.h
+ * @brief Defines the allocation accounting of the interpreter.
+ *
+ * This file contains the definition of the `bs::shell_alloc_stats` class,
+ * which counts the allocations of a session by interpreter phase, and of the
+ * `bs::shell_alloc_scope` class, which selects the stats and the phase the
+ * allocations of the calling thread are attributed to.
+ *
+ * @date Created on 22/11/25
+ * @author Dante Doménech Martínez
+ *
+ * @copyright GNU General Public License v3.0
+ *
+ * This file is part of BashSpark.
+ * Copyright (C) 2025 Dante Doménech Martínez
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+#include "BashSpark/shell/shell_session.h"
+
+namespace bs {
+    /**
+     * @brief Phase of the interpreter an allocation is attributed to.
+     */
+    enum class shell_alloc_phase : std::uint8_t {
+        /// Control flow: blocks, loops, conditions, pipes and sessions.
+        SAP_CONTROL = 0,
+        /// Splitting the source into tokens.
+        SAP_TOKENIZE,
+        /// Building the syntax tree.
+        SAP_PARSE,
+        /// Expanding the words of a command.
+        SAP_EXPAND,
+        /// Resolving the command and its arguments.
+        SAP_DISPATCH,
+        /// Running the command.
+        SAP_COMMAND,
+    };
+
+    /// Number of phases of \ref bs::shell_alloc_phase "shell_alloc_phase"
+    constexpr std::size_t SHELL_ALLOC_PHASES = 6;
+
+    /**
+     * @brief Gets the name of a phase.
+     * @param nPhase The phase.
+     * @return The name, such as `parse`.
+     */
+    [[nodiscard]] std::string_view get_alloc_phase_name(shell_alloc_phase nPhase) noexcept;
+
+    /**
+     * @struct shell_alloc_count
+     * @brief Number of allocations and of bytes allocated.
+     */
+    struct shell_alloc_count {
+        /// Number of allocations.
+        std::uint64_t m_nAllocations = 0;
+        /// Number of bytes allocated.
+        std::uint64_t m_nBytes = 0;
+    };
+
+    /**
+     * @class shell_alloc_stats
+     * @brief Counts the allocations of the interpreter by phase.
+     *
+     * The library can not see the allocations by itself: the application
+     * replaces the global `operator new` and calls \ref record_allocation from
+     * it. The allocation is then attributed to the stats and the phase of the
+     * innermost \ref bs::shell_alloc_scope "shell_alloc_scope" of the thread,
+     * and ignored if there is none.
+     *
+     * Attach the stats to a session with
+     * \ref bs::shell_session::set_alloc_stats "shell_session::set_alloc_stats".
+     * The sessions derived from it share the stats, which may be updated from
+     * several threads. Without stats, the cost is a null pointer check per
+     * command. Scripts run as coroutines are only attributed inside their
+     * synchronous parts, such as command substitutions.
+     */
+    class shell_alloc_stats {
+    public:
+        /**
+         * @brief Records an allocation of the calling thread.
+         *
+         * Meant to be called from a replaced global `operator new`. It does not
+         * allocate.
+         *
+         * @param nBytes Bytes allocated.
+         */
+        static void record_allocation(std::size_t nBytes) noexcept;
+
+    public:
+        /**
+         * @brief Gets the allocations of a phase.
+         * @param nPhase The phase.
+         * @return The allocations.
+         */
+        [[nodiscard]] shell_alloc_count get(shell_alloc_phase nPhase) const noexcept;
+
+        /**
+         * @brief Gets the allocations of all the phases.
+         * @return The allocations.
+         */
+        [[nodiscard]] shell_alloc_count get_total() const noexcept;
+
+        /**
+         * @brief Adds an allocation to a phase.
+         * @param nPhase The phase.
+         * @param nBytes Bytes allocated.
+         */
+        void add(shell_alloc_phase nPhase, std::size_t nBytes) noexcept;
+
+        /**
+         * @brief Sets all the counters to zero.
+         */
+        void clear() noexcept;
+
+    private:
+        /// Allocations by phase
+        std::array<std::atomic<std::uint64_t>, SHELL_ALLOC_PHASES> m_vAllocations{};
+        /// Bytes allocated by phase
+        std::array<std::atomic<std::uint64_t>, SHELL_ALLOC_PHASES> m_vBytes{};
+    };
+
+    /**
+     * @class shell_alloc_scope
+     * @brief Attributes the allocations of the calling thread while alive.
+     *
+     * Scopes nest, the previous attribution is restored on destruction.
+     * A scope without stats does nothing.
+     */
+    class shell_alloc_scope {
+    public:
+        /**
+         * @brief Attributes the allocations to some stats.
+         * @param pStats The stats, nullptr to keep the current attribution.
+         * @param nPhase The phase.
+         */
+        shell_alloc_scope(shell_alloc_stats *pStats, const shell_alloc_phase nPhase) noexcept
+            : m_bActive(pStats != nullptr) {
+            if (this->m_bActive) this->enter(pStats, nPhase);
+        }
+
+        /**
+         * @brief Attributes the allocations to the stats of a session.
+         * @param oSession The session.
+         * @param nPhase The phase.
+         */
+        shell_alloc_scope(const shell_session &oSession, const shell_alloc_phase nPhase) noexcept
+            : shell_alloc_scope(oSession.get_alloc_stats(), nPhase) {
+        }
+
+        /**
+         * @brief Changes the phase of the current attribution, if any.
+         * @param nPhase The phase.
+         */
+        explicit shell_alloc_scope(shell_alloc_phase nPhase) noexcept;
+
+        /**
+         * @brief Restores the previous attribution.
+         */
+        ~shell_alloc_scope() {
+            if (this->m_bActive) this->leave();
+        }
+
+        shell_alloc_scope(const shell_alloc_scope &) = delete;
+
+        shell_alloc_scope &operator=(const shell_alloc_scope &) = delete;
+
+    private:
+        /**
+         * @brief Sets the attribution of the thread, saving the previous one.
+         * @param pStats The stats.
+         * @param nPhase The phase.
+         */
+        void enter(shell_alloc_stats *pStats, shell_alloc_phase nPhase) noexcept;
+
+        /**
+         * @brief Restores the previous attribution of the thread.
+         */
+        void leave() const noexcept;
+
+    private:
+        /// Whether this scope changed the attribution
+        bool m_bActive;
+        /// Previous stats
+        shell_alloc_stats *m_pPrevStats = nullptr;
+        /// Previous phase
+        shell_alloc_phase m_nPrevPhase = shell_alloc_phase::SAP_CONTROL;
+    };
+}
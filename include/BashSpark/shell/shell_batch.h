@@ -0,0 +1,117 @@
+/**
+ * @file shell_batch.h
+ * @brief Defines the jobs and results of a batch run.
+ *
+ * This file contains the structures used by \ref bs::shell::run_batch "shell::run_batch"
+ * to describe independent jobs, their captured results and the aggregate
+ * statistics of the batch.
+ *
+ * @date Created on 22/11/25
+ * @author Dante Doménech Martínez
+ *
+ * @copyright GNU General Public License v3.0
+ *
+ * This file is part of BashSpark.
+ * Copyright (C) 2025 Dante Doménech Martínez
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <chrono>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "BashSpark/shell/shell_arg.h"
+#include "BashSpark/shell/shell_env.h"
+#include "BashSpark/shell/shell_script.h"
+#include "BashSpark/shell/shell_status.h"
+
+namespace bs {
+    class shell_tracer;
+
+    /**
+     * @struct shell_job
+     * @brief An independent job of a batch run.
+     *
+     * Each job runs on a fresh session with its own environment and arguments.
+     * If the script is set the command is ignored, so a script compiled once
+     * can be shared by any number of jobs.
+     */
+    struct shell_job {
+        /// Compiled script to run, nullptr to run the command.
+        const shell_script *m_pScript = nullptr;
+        /// Command or script to run if no compiled script is given.
+        std::string_view m_sCommand;
+        /// Text read by the job from its standard input.
+        std::string_view m_sIn;
+        /// Initial environment of the job.
+        shell_env m_oEnv;
+        /// Arguments of the job.
+        shell_arg m_oArg;
+        /// Tracer of the job, nullptr if not traced, see \ref bs::shell_tracer "shell_tracer".
+        shell_tracer *m_pTracer = nullptr;
+    };
+
+    /**
+     * @struct shell_job_result
+     * @brief Result of a job of a batch run.
+     */
+    struct shell_job_result {
+        /// Status code of last executed command.
+        shell_status m_nStatus = shell_status::SHELL_SUCCESS;
+        /// Captured standard output.
+        std::string m_sOut;
+        /// Captured error output.
+        std::string m_sErr;
+        /// Time spent running the job.
+        std::chrono::nanoseconds m_nLatency{0};
+    };
+
+    /**
+     * @struct shell_batch_stats
+     * @brief Aggregate statistics of a batch run.
+     *
+     * Latency percentiles use the nearest rank among the job latencies.
+     */
+    struct shell_batch_stats {
+        /// Number of jobs run.
+        std::size_t m_nJobs = 0;
+        /// Number of threads used.
+        std::size_t m_nThreads = 0;
+        /// Wall time of the whole batch.
+        std::chrono::nanoseconds m_nWallTime{0};
+        /// Jobs completed per second.
+        double m_dThroughput = 0;
+        /// Median job latency.
+        std::chrono::nanoseconds m_nLatencyP50{0};
+        /// 99th percentile job latency.
+        std::chrono::nanoseconds m_nLatencyP99{0};
+        /// Maximum job latency.
+        std::chrono::nanoseconds m_nLatencyMax{0};
+    };
+
+    /**
+     * @struct shell_batch_result
+     * @brief Result of a batch run.
+     */
+    struct shell_batch_result {
+        /// Results of the jobs, in the same order as the jobs.
+        std::vector<shell_job_result> m_vResults;
+        /// Aggregate statistics.
+        shell_batch_stats m_oStats;
+    };
+}
@@ -28,8 +28,10 @@
 
 #pragma once
 
+#include <memory>
 #include <string>
 
+#include "BashSpark/shell/shell_traits.h"
 #include "BashSpark/tools/shell_hash.h"
 
 namespace bs {
@@ -37,13 +39,33 @@ namespace bs {
      * @class shell_env
      * @brief Represents an environment for shell commands.
      *
-     * This class manages environment variables.
+     * This class manages environment variables. An environment may be built on
+     * an immutable base environment shared among many environments: variables
+     * are set on the environment itself (the overlay) and searched on the
+     * overlay first, then on the base. Copying an environment copies only the
+     * overlay, so its cost does not depend on the size of the base.
+     *
+     * The base is held by the pointer of the shell policy, see
+     * \ref bs::shell_traits "shell_traits", so the single-threaded policy
+     * shares it without atomic reference counts.
      */
     class shell_env {
+    public:
+        /// Pointer sharing the base environment, see \ref bs::shell_traits "shell_traits"
+        using base_pointer = shell_traits::pointer<const shell_env>;
+
     public:
         /// Default constructor (empty environment).
         shell_env() = default;
 
+        /**
+         * @brief Constructs an empty overlay on a base environment.
+         * @param pBase Shared base environment, must not be modified while shared.
+         */
+        explicit shell_env(base_pointer pBase)
+            : m_pBase(std::move(pBase)) {
+        }
+
     public:
         /**
          * @brief Retrieves the value of an environment variable.
@@ -51,8 +73,8 @@ namespace bs {
          * @return The value of the environment variable, or an empty string if not found.
          */
         [[nodiscard]] std::string get_env(const std::string &sVar) const {
-            const auto pIter = this->m_mEnvVariables.find(sVar);
-            return pIter != this->m_mEnvVariables.end() ? pIter->second : "";
+            const auto pValue = this->find_env(sVar);
+            return pValue != nullptr ? *pValue : "";
         }
 
         /**
@@ -62,14 +84,17 @@ namespace bs {
          * @return The value of the resolved environment variable, or an empty string if not found.
          */
         [[nodiscard]] std::string get_env_hop2(const std::string &sVar) const {
-            const auto pIter1 = this->m_mEnvVariables.find(sVar);
-            if (pIter1 == this->m_mEnvVariables.end()) return "";
-            const auto pIter2 = this->m_mEnvVariables.find(pIter1->second);
-            return pIter2 != this->m_mEnvVariables.end() ? pIter2->second : "";
+            const auto pValue1 = this->find_env(sVar);
+            if (pValue1 == nullptr) return "";
+            const auto pValue2 = this->find_env(*pValue1);
+            return pValue2 != nullptr ? *pValue2 : "";
         }
 
         /**
          * @brief Sets the value of an environment variable.
+         *
+         * The variable is set on the overlay, the base is never modified.
+         *
          * @param sVar The name of the environment variable.
          * @param sValue The value to be set.
          */
@@ -83,27 +108,61 @@ namespace bs {
          * @return True if the variable exists, false otherwise.
          */
         [[nodiscard]] bool has_env(const std::string &sVar) const noexcept {
-            return this->m_mEnvVariables.contains(sVar);
+            return this->find_env(sVar) != nullptr;
         }
 
         /**
          * @brief Gets the number of environment variables.
-         * @return The size of the environment variables map.
+         *
+         * Counts the variables of the overlay and the base once.
+         *
+         * @return The number of environment variables.
          */
         [[nodiscard]] std::size_t get_env_size() const noexcept {
-            return this->m_mEnvVariables.size();
+            if (!this->m_pBase) return this->m_mEnvVariables.size();
+            std::size_t nSize = this->m_pBase->get_env_size();
+            for (const auto &[sVar, sValue]: this->m_mEnvVariables)
+                if (!this->m_pBase->has_env(sVar)) ++nSize;
+            return nSize;
         }
 
         /**
-         * @brief Retrieves all environment variables.
-         * @return A const reference to the map of environment variables.
+         * @brief Retrieves the environment variables set on the overlay.
+         *
+         * The variables of the base are available through \ref get_base.
+         *
+         * @return A const reference to the map of environment variables of the overlay.
          */
         [[nodiscard]] const std::unordered_map<std::string, std::string, shell_hash> &get_env() const noexcept {
             return this->m_mEnvVariables;
         }
 
+        /**
+         * @brief Retrieves the base environment.
+         * @return The shared base environment, nullptr if none.
+         */
+        [[nodiscard]] const base_pointer &get_base() const noexcept {
+            return this->m_pBase;
+        }
+
+    private:
+        /**
+         * @brief Searches a variable on the overlay, then on the base.
+         * @param sVar The name of the environment variable.
+         * @return Pointer to the value, or nullptr if not found.
+         */
+        [[nodiscard]] const std::string *find_env(const std::string &sVar) const noexcept {
+            for (auto pEnv = this; pEnv != nullptr; pEnv = pEnv->m_pBase.get()) {
+                const auto pIter = pEnv->m_mEnvVariables.find(sVar);
+                if (pIter != pEnv->m_mEnvVariables.end()) return &pIter->second;
+            }
+            return nullptr;
+        }
+
     private:
         /// Map to store environment variables.
         std::unordered_map<std::string, std::string, shell_hash> m_mEnvVariables;
+        /// Shared base environment.
+        base_pointer m_pBase;
     };
 } // namespace bs
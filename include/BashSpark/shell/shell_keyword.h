@@ -67,6 +67,7 @@ namespace bs {
         PM_BACKQUOTE = 1 << 0, ///< Backquote parsing mode.
         PM_LOOP = 1 << 1, ///< Loop parsing mode.
         PM_FUNCTION_NAME = 1 << 2, // Function name parsing mode
+        PM_SINGLE_WORD = 1 << 3, ///< Stops at the first space, parses a single word.
         PM_BACKQUOTE_LOOP = PM_BACKQUOTE & PM_LOOP ///< Combined mode for handling both backquote and looping.
     };
 
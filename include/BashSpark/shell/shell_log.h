@@ -0,0 +1,280 @@
+/**
+ * @file shell_log.h
+ * @brief Defines the diagnostic log of the interpreter.
+ *
+ * This file contains the definition of the `bs::shell_log` class, which
+ * writes the diagnostics of the interpreter by level and category, and of
+ * the `BS_LOG` macro used to emit them. Defining `BS_NO_LOG` removes the
+ * diagnostics at compile time.
+ *
+ * @date Created on 22/11/25
+ * @author Dante Doménech Martínez
+ *
+ * @copyright GNU General Public License v3.0
+ *
+ * This file is part of BashSpark.
+ * Copyright (C) 2025 Dante Doménech Martínez
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+#include <sstream>
+#include <span>
+#include <string>
+#include <string_view>
+
+namespace bs {
+    /**
+     * @brief Level of a diagnostic, from the most to the least important.
+     */
+    enum class shell_log_level : std::uint8_t {
+        /// Failures of the interpreter.
+        SLL_ERROR = 0,
+        /// Suspicious situations.
+        SLL_WARNING,
+        /// Notable events.
+        SLL_INFO,
+        /// Details useful while debugging.
+        SLL_DEBUG,
+        /// Every step, such as each token or each command.
+        SLL_TRACE,
+    };
+
+    /// Number of levels of \ref bs::shell_log_level "shell_log_level"
+    constexpr std::size_t SHELL_LOG_LEVELS = 5;
+
+    /**
+     * @brief Part of the interpreter a diagnostic comes from.
+     */
+    enum class shell_log_category : std::uint8_t {
+        /// Splitting the source into tokens.
+        SLC_TOKENIZE = 0,
+        /// Building the syntax tree.
+        SLC_PARSE,
+        /// Expanding words and substitutions.
+        SLC_EXPAND,
+        /// Dispatching the commands.
+        SLC_COMMAND,
+        /// Calling the functions.
+        SLC_FUNCTION,
+        /// Creating the sessions.
+        SLC_SESSION,
+    };
+
+    /// Number of categories of \ref bs::shell_log_category "shell_log_category"
+    constexpr std::size_t SHELL_LOG_CATEGORIES = 6;
+
+    /**
+     * @class shell_log
+     * @brief Writes the diagnostics of the interpreter.
+     *
+     * The log is global and disabled by default. Enable it with
+     * \ref configure, giving a sink, the least important level to write and
+     * the categories to write. Diagnostics are emitted with the `BS_LOG`
+     * macro:
+     *
+     * @code
+     * BS_LOG(SLL_DEBUG, SLC_FUNCTION, "fcall " << sName);
+     * @endcode
+     *
+     * When the diagnostic is not enabled, the cost is an atomic load and a
+     * branch; the message is neither built nor formatted. Defining
+     * `BS_NO_LOG` turns the macro into nothing.
+     *
+     * Each diagnostic is written as a single line, `[level] category: text`,
+     * under a mutex, so it may be emitted from several threads. The sink must
+     * outlive the configuration.
+     */
+    class shell_log {
+    public:
+        /// Mask of all the categories
+        constexpr static std::uint32_t ALL_CATEGORIES = (std::uint32_t{1} << SHELL_LOG_CATEGORIES) - 1;
+
+        /**
+         * @class message
+         * @brief Builds a diagnostic and writes it when destroyed.
+         */
+        class message {
+        public:
+            /**
+             * @brief Starts a diagnostic.
+             * @param nLevel Level of the diagnostic.
+             * @param nCategory Category of the diagnostic.
+             */
+            message(const shell_log_level nLevel, const shell_log_category nCategory)
+                : m_nLevel(nLevel), m_nCategory(nCategory) {
+            }
+
+            /**
+             * @brief Writes the diagnostic.
+             */
+            ~message() {
+                shell_log::write(this->m_nLevel, this->m_nCategory, this->m_oText.view());
+            }
+
+            message(const message &) = delete;
+
+            message &operator=(const message &) = delete;
+
+            /**
+             * @brief Gets the stream the text is written to.
+             * @return The stream.
+             */
+            [[nodiscard]] std::ostream &stream() noexcept {
+                return this->m_oText;
+            }
+
+        private:
+            /// Level of the diagnostic
+            shell_log_level m_nLevel;
+            /// Category of the diagnostic
+            shell_log_category m_nCategory;
+            /// Text of the diagnostic
+            std::ostringstream m_oText;
+        };
+
+        /**
+         * @class join
+         * @brief Writes words separated by spaces to a stream.
+         */
+        class join {
+        public:
+            /**
+             * @brief Constructs the writer.
+             * @param vWords The words, which must outlive the writer.
+             */
+            explicit join(const std::span<const std::string> vWords) noexcept
+                : m_vWords(vWords) {
+            }
+
+            /**
+             * @brief Writes the words.
+             * @param oOut Output stream.
+             * @param oJoin The words.
+             * @return The output stream.
+             */
+            friend std::ostream &operator<<(std::ostream &oOut, const join &oJoin) {
+                for (std::size_t i = 0; i < oJoin.m_vWords.size(); ++i) {
+                    if (i != 0) oOut.put(' ');
+                    oOut << oJoin.m_vWords[i];
+                }
+                return oOut;
+            }
+
+        private:
+            /// The words
+            std::span<const std::string> m_vWords;
+        };
+
+    public:
+        /**
+         * @brief Checks whether a diagnostic is written.
+         * @param nLevel Level of the diagnostic.
+         * @param nCategory Category of the diagnostic.
+         * @return true if the log has a sink, the level is enabled and the category is enabled.
+         */
+        [[nodiscard]] static bool is_enabled(
+            const shell_log_level nLevel,
+            const shell_log_category nCategory
+        ) noexcept {
+            const auto nBit = static_cast<std::size_t>(nLevel) * SHELL_LOG_CATEGORIES
+                              + static_cast<std::size_t>(nCategory);
+            return (get_mask().load(std::memory_order_relaxed) >> nBit & 1) != 0;
+        }
+
+        /**
+         * @brief Enables the log.
+         * @param oSink Where the diagnostics are written.
+         * @param nLevel Least important level written.
+         * @param nCategories Mask of the categories written, see \ref get_category_mask.
+         */
+        static void configure(
+            std::ostream &oSink,
+            shell_log_level nLevel,
+            std::uint32_t nCategories = ALL_CATEGORIES
+        );
+
+        /**
+         * @brief Disables the log.
+         */
+        static void disable() noexcept;
+
+        /**
+         * @brief Writes a diagnostic if it is enabled.
+         * @param nLevel Level of the diagnostic.
+         * @param nCategory Category of the diagnostic.
+         * @param sText Text of the diagnostic.
+         */
+        static void write(shell_log_level nLevel, shell_log_category nCategory, std::string_view sText);
+
+        /**
+         * @brief Gets the mask of a category.
+         * @param nCategory The category.
+         * @return The mask, to be combined with `|`.
+         */
+        [[nodiscard]] constexpr static std::uint32_t get_category_mask(const shell_log_category nCategory) noexcept {
+            return std::uint32_t{1} << static_cast<std::uint32_t>(nCategory);
+        }
+
+        /**
+         * @brief Gets the name of a level.
+         * @param nLevel The level.
+         * @return The name, such as `debug`.
+         */
+        [[nodiscard]] static std::string_view get_level_name(shell_log_level nLevel) noexcept;
+
+        /**
+         * @brief Gets the name of a category.
+         * @param nCategory The category.
+         * @return The name, such as `parse`.
+         */
+        [[nodiscard]] static std::string_view get_category_name(shell_log_category nCategory) noexcept;
+
+    private:
+        /**
+         * @brief Gets the enabled diagnostics.
+         *
+         * Bit `level * SHELL_LOG_CATEGORIES + category` is set when the
+         * diagnostic is enabled.
+         *
+         * @return The mask.
+         */
+        [[nodiscard]] static std::atomic<std::uint64_t> &get_mask() noexcept {
+            constinit static std::atomic<std::uint64_t> g_nMask{0};
+            return g_nMask;
+        }
+    };
+}
+
+#ifdef BS_NO_LOG
+/// Emits a diagnostic, removed by `BS_NO_LOG`
+#define BS_LOG(nLevel, nCategory, ...) static_cast<void>(0)
+#else
+/// Emits a diagnostic, see \ref bs::shell_log "shell_log"
+#define BS_LOG(nLevel, nCategory, ...)                                                                     \
+    do {                                                                                                   \
+        if (::bs::shell_log::is_enabled(::bs::shell_log_level::nLevel, ::bs::shell_log_category::nCategory)) \
+            [[unlikely]] {                                                                                 \
+            ::bs::shell_log::message oLogMessage(                                                          \
+                ::bs::shell_log_level::nLevel, ::bs::shell_log_category::nCategory);                       \
+            oLogMessage.stream() << __VA_ARGS__;                                                           \
+        }                                                                                                  \
+    } while (false)
+#endif
@@ -39,6 +39,7 @@
 #include <vector>
 
 #include "BashSpark/shell/shell_status.h"
+#include "BashSpark/shell/shell_task.h"
 
 namespace bs {
     class shell_session;
@@ -67,6 +68,7 @@ namespace bs {
         SNT_DOLLAR_VARIABLE_DHOP,
         SNT_DOLLAR_ARG,
         SNT_DOLLAR_ARG_DHOP,
+        SNT_DOLLAR_ARRAY,
         SNT_DOLLAR_COMMAND,
         SNT_BACKGROUND,
         SNT_AND,
@@ -86,6 +88,8 @@ namespace bs {
         SNT_COMMAND,
         SNT_COMMAND_BLOCK,
         SNT_COMMAND_BLOCK_SUBSHELL,
+        // Appended after the existing values, so that they keep their number
+        SNT_FOR_COUNT,
     };
 
     /**
@@ -182,6 +186,19 @@ namespace bs {
          * @return shell_status Result status of the execution.
          */
         virtual shell_status evaluate(shell_session &oSession) const =0;
+
+        /**
+         * @brief Evaluate (execute) the node as a coroutine.
+         *
+         * Nodes holding other evaluable nodes suspend at command boundaries
+         * and loop back-edges once the time slice of the task has expired, see
+         * \ref bs::shell_yield "shell_yield". By default the node is evaluated
+         * synchronously with \ref evaluate.
+         *
+         * @param oSession Session context used during evaluation.
+         * @return shell_task Task returning the result status of the execution.
+         */
+        virtual shell_task evaluate_async(shell_session &oSession) const;
     };
 
     /**
@@ -767,6 +784,85 @@ namespace bs {
         std::string m_sVariable; ///< Variable name.
     };
 
+    /**
+     * @enum shell_array_access
+     * @brief Ways an array variable can be expanded.
+     */
+    enum class shell_array_access {
+        SAA_ELEMENT, ///< A single element (`${a[i]}`).
+        SAA_VALUES, ///< All the elements (`${a[@]}`).
+        SAA_KEYS, ///< All the keys or indices (`${!a[@]}`).
+        SAA_SIZE, ///< The number of elements (`${#a[@]}`).
+    };
+
+    /**
+     * @class shell_node_dollar_array
+     * @brief Array variable reference (`${a[i]}`, `${a[@]}`, `${!a[@]}` or `${#a[@]}`).
+     *
+     * Elements are read directly from the array, no string is split to access them.
+     */
+    class shell_node_dollar_array final : public shell_node_expandable {
+    public:
+        /**
+         * @brief Construct an array reference node.
+         * @throw shell_node_invalid_argument If pSubscript is null when accessing a single element.
+         * @param nPos Position in stream.
+         * @param sVariable Array name.
+         * @param nAccess How the array is expanded.
+         * @param pSubscript Subscript of the element (only for single element access).
+         */
+        shell_node_dollar_array(
+            std::size_t nPos,
+            std::string sVariable,
+            shell_array_access nAccess,
+            std::unique_ptr<shell_node_expandable> &&pSubscript
+        );
+
+    public:
+        /**
+         * @brief Expand the referenced element(s).
+         *
+         * A single element is expanded as a variable. `${a[@]}` and `${!a[@]}` expand to one
+         * token per element, each split as a single element when splitting.
+         *
+         * @inheritdoc
+         */
+        void expand(
+            std::vector<std::string> &vTokens,
+            shell_session &oSession,
+            bool bSplit
+        ) const override;
+
+        /**
+         * @brief Return the referenced array name.
+         * @return std::string Array name.
+         */
+        [[nodiscard]] std::string get_variable() const noexcept {
+            return this->m_sVariable;
+        }
+
+        /**
+         * @brief Return how the array is expanded.
+         * @return shell_array_access Kind of access.
+         */
+        [[nodiscard]] shell_array_access get_access() const noexcept {
+            return this->m_nAccess;
+        }
+
+        /**
+         * @brief Get non-owning pointer to the subscript.
+         * @return const shell_node_expandable* Pointer to the subscript (null unless accessing a single element).
+         */
+        [[nodiscard]] const shell_node_expandable *get_subscript() const noexcept {
+            return this->m_pSubscript.get();
+        }
+
+    private:
+        std::string m_sVariable; ///< Array name.
+        shell_array_access m_nAccess; ///< Kind of access.
+        std::unique_ptr<shell_node_expandable> m_pSubscript; ///< Subscript of the element.
+    };
+
     /**
      * @class shell_node_dollar_command
      * @brief Command-substitution node used in $() or backticks when appearing inside other contexts.
@@ -901,6 +997,13 @@ namespace bs {
          */
         shell_status evaluate(shell_session &oSession) const override;
 
+        /**
+         * @brief Evaluate the command as a task, awaiting \ref bs::command::run_async "command::run_async".
+         * @param oSession Session context.
+         * @return shell_task Task returning the same status as \ref evaluate.
+         */
+        shell_task evaluate_async(shell_session &oSession) const override;
+
         /**
          * @brief Get pointer to the underlying command expression.
          * @return  Non-owning pointer.
@@ -941,6 +1044,13 @@ namespace bs {
          */
         shell_status evaluate(shell_session &oSession) const override;
 
+        /**
+         * @brief Evaluate each subcommand in order, yielding before each one.
+         * @param oSession Session context.
+         * @return shell_task Task returning the same status as \ref evaluate.
+         */
+        shell_task evaluate_async(shell_session &oSession) const override;
+
         /**
          * @brief Access subcommands.
          * @return const reference to vector of subcommands.
@@ -981,6 +1091,13 @@ namespace bs {
          */
         shell_status evaluate(shell_session &oSession) const override;
 
+        /**
+         * @brief Evaluate the block in a subshell context, yielding before each subcommand.
+         * @param oSession Session context.
+         * @return shell_task Task returning the same status as \ref evaluate.
+         */
+        shell_task evaluate_async(shell_session &oSession) const override;
+
         /**
          * @brief Access the subshell's subcommands.
          * @return const reference to vector of subcommands.
@@ -1187,6 +1304,13 @@ namespace bs {
          */
         shell_status evaluate(shell_session &oSession) const override;
 
+        /**
+         * @brief Evaluate logical AND semantics as a task.
+         * @param oSession Session context.
+         * @return shell_task Task returning the same status as \ref evaluate.
+         */
+        shell_task evaluate_async(shell_session &oSession) const override;
+
     private:
         explicit shell_node_and(
             const std::size_t nPos
@@ -1231,6 +1355,13 @@ namespace bs {
          */
         shell_status evaluate(shell_session &oSession) const override;
 
+        /**
+         * @brief Evaluate the pipe as a task, both sides are awaited in order.
+         * @param oSession Session context.
+         * @return shell_task Task returning the same status as \ref evaluate.
+         */
+        shell_task evaluate_async(shell_session &oSession) const override;
+
     private:
         explicit shell_node_pipe(
             const std::size_t nPos
@@ -1275,6 +1406,13 @@ namespace bs {
          */
         shell_status evaluate(shell_session &oSession) const override;
 
+        /**
+         * @brief Evaluate logical OR semantics as a task.
+         * @param oSession Session context.
+         * @return shell_task Task returning the same status as \ref evaluate.
+         */
+        shell_task evaluate_async(shell_session &oSession) const override;
+
     private:
         explicit shell_node_or(
             const std::size_t nPos
@@ -1373,6 +1511,13 @@ namespace bs {
          */
         shell_status evaluate(shell_session &oSession) const override;
 
+        /**
+         * @brief Evaluate the if statement as a task.
+         * @param oSession Session context.
+         * @return shell_task Task returning the same status as \ref evaluate.
+         */
+        shell_task evaluate_async(shell_session &oSession) const override;
+
     public:
         /**
          * @brief Get the condition node.
@@ -1498,8 +1643,8 @@ namespace bs {
          * @param nPos Position in the input stream.
          */
         explicit shell_node_break(const std::size_t nPos)
-            : shell_node(shell_node_type::SNT_CONTINUE, nPos),
-              shell_node_evaluable(shell_node_type::SNT_CONTINUE, nPos) {
+            : shell_node(shell_node_type::SNT_BREAK, nPos),
+              shell_node_evaluable(shell_node_type::SNT_BREAK, nPos) {
         }
     };
 
@@ -1541,6 +1686,13 @@ namespace bs {
          */
         shell_status evaluate(shell_session &oSession) const override;
 
+        /**
+         * @brief Evaluate the for-loop as a task, yielding on each iteration.
+         * @param oSession Session context.
+         * @return shell_task Task returning the same status as \ref evaluate.
+         */
+        shell_task evaluate_async(shell_session &oSession) const override;
+
     public:
         /**
          * @brief Get the loop variable name.
@@ -1572,6 +1724,105 @@ namespace bs {
         std::unique_ptr<shell_node_evaluable> m_pIterative; ///< Owned body executed per item.
     };
 
+    /**
+     * @class shell_node_for_count
+     * @brief Counted 'for' loop node iterating an integer from a start to an end value.
+     *
+     * Implements `for i from A to B step S`. The bounds and the step are expanded once,
+     * then the counter is kept as an integer; the loop variable is only assigned its
+     * textual value for the body. The range includes both bounds. When the step is
+     * omitted it defaults to 1 or -1 depending on the direction of the range.
+     */
+    class shell_node_for_count final : public shell_node_evaluable {
+    public:
+        /**
+         * @brief Construct a counted for-loop node.
+         * @throw shell_node_invalid_argument If \p pFrom, \p pTo or \p pIterative is null.
+         * @param nPos Position in the input stream where the for loop starts.
+         * @param sVariable Name of the loop variable that receives each counter value (moved in).
+         * @param pFrom Owned expandable that yields the first value.
+         * @param pTo Owned expandable that yields the last value.
+         * @param pStep Owned expandable that yields the step, may be null.
+         * @param pIterative Owned evaluable block executed for each counter value.
+         */
+        shell_node_for_count(
+            std::size_t nPos,
+            std::string sVariable,
+            std::unique_ptr<shell_node_expandable> &&pFrom,
+            std::unique_ptr<shell_node_expandable> &&pTo,
+            std::unique_ptr<shell_node_expandable> &&pStep,
+            std::unique_ptr<shell_node_evaluable> &&pIterative
+        );
+
+    public:
+        /**
+         * @brief Evaluate the counted for-loop.
+         *
+         * If a bound or the step is not an integer, `shell::msg_error_invalid_loop_bound`
+         * is called. If the step can not reach the end value, `shell::msg_error_invalid_loop_step`
+         * is called.
+         *
+         * @param oSession Session context used for variable assignment and execution.
+         * @return shell_status Status from the loop's execution (last iteration or error status).
+         */
+        shell_status evaluate(shell_session &oSession) const override;
+
+        /**
+         * @brief Evaluate the counted for-loop as a task, yielding on each iteration.
+         * @param oSession Session context.
+         * @return shell_task Task returning the same status as \ref evaluate.
+         */
+        shell_task evaluate_async(shell_session &oSession) const override;
+
+    public:
+        /**
+         * @brief Get the loop variable name.
+         * @return Reference to the variable name.
+         */
+        [[nodiscard]] const std::string &get_variable() const noexcept {
+            return this->m_sVariable;
+        }
+
+        /**
+         * @brief Get the first value expandable.
+         * @return Non-owning pointer to the first value node.
+         */
+        [[nodiscard]] const shell_node_expandable *get_from() const noexcept {
+            return this->m_pFrom.get();
+        }
+
+        /**
+         * @brief Get the last value expandable.
+         * @return Non-owning pointer to the last value node.
+         */
+        [[nodiscard]] const shell_node_expandable *get_to() const noexcept {
+            return this->m_pTo.get();
+        }
+
+        /**
+         * @brief Get the step expandable.
+         * @return Non-owning pointer to the step node, nullptr if omitted.
+         */
+        [[nodiscard]] const shell_node_expandable *get_step() const noexcept {
+            return this->m_pStep.get();
+        }
+
+        /**
+         * @brief Get the iterative block executed on each counter value.
+         * @return Non-owning pointer to the iterative block.
+         */
+        [[nodiscard]] const shell_node_evaluable *get_iterative() const noexcept {
+            return this->m_pIterative.get();
+        }
+
+    private:
+        std::string m_sVariable; ///< Loop variable name.
+        std::unique_ptr<shell_node_expandable> m_pFrom; ///< Owned first value.
+        std::unique_ptr<shell_node_expandable> m_pTo; ///< Owned last value.
+        std::unique_ptr<shell_node_expandable> m_pStep; ///< Owned step, may be null.
+        std::unique_ptr<shell_node_evaluable> m_pIterative; ///< Owned body executed per value.
+    };
+
 
     /**
      * @class shell_node_while
@@ -1611,6 +1862,13 @@ namespace bs {
          */
         shell_status evaluate(shell_session &oSession) const override;
 
+        /**
+         * @brief Evaluate the while-loop as a task, yielding on each iteration.
+         * @param oSession Session context.
+         * @return shell_task Task returning the same status as \ref evaluate.
+         */
+        shell_task evaluate_async(shell_session &oSession) const override;
+
     public:
         /**
          * @brief Get the condition node.
@@ -1671,6 +1929,13 @@ namespace bs {
          */
         shell_status evaluate(shell_session &oSession) const override;
 
+        /**
+         * @brief Evaluate the until-loop as a task, yielding on each iteration.
+         * @param oSession Session context.
+         * @return shell_task Task returning the same status as \ref evaluate.
+         */
+        shell_task evaluate_async(shell_session &oSession) const override;
+
     public:
         /**
          * @brief Get the stopping condition node.
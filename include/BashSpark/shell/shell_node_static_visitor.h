@@ -0,0 +1,246 @@
+/**
+ * @file shell_node_static_visitor.h
+ * @brief Defines template `bs::shell_node_static_visitor`
+ *
+ * Provides a template to visit shell node structures without virtual calls.
+ * It is meant for analysis passes that traverse large trees.
+ *
+ * @date Created on 22/11/25
+ * @author Dante Doménech Martínez
+ *
+ * @copyright GNU General Public License v3.0
+ *
+ * This file is part of BashSpark.
+ * Copyright (C) 2025 Dante Doménech Martínez
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <type_traits>
+
+#include "BashSpark/shell/shell_node.h"
+
+namespace bs {
+    /**
+     * @brief Static visitor for shell AST nodes.
+     *
+     * Alternative to \ref bs::shell_node_visitor "shell_node_visitor" resolved
+     * at compile time: the derived class is given as template argument and
+     * its `visit()` overloads are called directly, so they may be inlined.
+     * They need not be virtual, and a single template overload may handle
+     * several node types:
+     *
+     * @code
+     * class node_counter final : public shell_node_static_visitor<node_counter, std::size_t> {
+     *     friend shell_node_static_visitor;
+     *
+     *     template<typename node_t>
+     *     std::size_t visit(shell_session &oSession, const node_t *pNode) {
+     *         std::size_t nCount = 1;
+     *         for_each_child(pNode, [&](const auto *pChild) { nCount += this->visit_node(oSession, pChild); });
+     *         return nCount;
+     *     }
+     * };
+     * @endcode
+     *
+     * Every concrete node derives from \ref bs::shell_node_evaluable "shell_node_evaluable"
+     * or \ref bs::shell_node_expandable "shell_node_expandable" without
+     * virtual inheritance, so the dispatch from those is a switch on the
+     * node type and a `static_cast`. The children getters of the nodes
+     * return such pointers, so traversing a tree needs no `dynamic_cast`.
+     * Only a node given as a plain \ref bs::shell_node "shell_node" costs
+     * one `dynamic_cast` to its kind, because `shell_node` is a virtual base.
+     *
+     * @tparam derived_t The derived visitor.
+     * @tparam visit_t The return type of all visit functions.
+     * Must be void or default-constructible.
+     */
+    template<typename derived_t, typename visit_t>
+    class shell_node_static_visitor {
+        static_assert(std::is_void_v<visit_t> || std::is_default_constructible_v<visit_t>,
+                      "visit_t must be void or default-constructible");
+
+    public:
+        /// Type of data resulting of visit
+        using visit_type = visit_t;
+
+        /**
+         * @brief Dispatch an evaluable node to the correct visit function.
+         * @param oSession Execution session.
+         * @param pRawNode Pointer to the node being visited.
+         * @return The result of the dispatched visit, or a default-constructed
+         *         `visit_t` if the node type is unhandled.
+         */
+        visit_t visit_node(shell_session &oSession, const shell_node_evaluable *pRawNode) {
+            switch (pRawNode->get_type()) {
+                case shell_node_type::SNT_NULL_COMMAND:
+                    return this->dispatch(oSession, static_cast<const shell_node_null_command *>(pRawNode));
+                case shell_node_type::SNT_COMMAND:
+                    return this->dispatch(oSession, static_cast<const shell_node_command *>(pRawNode));
+                case shell_node_type::SNT_COMMAND_BLOCK:
+                    return this->dispatch(oSession, static_cast<const shell_node_command_block *>(pRawNode));
+                case shell_node_type::SNT_COMMAND_BLOCK_SUBSHELL:
+                    return this->dispatch(oSession, static_cast<const shell_node_command_block_subshell *>(pRawNode));
+                case shell_node_type::SNT_BACKGROUND:
+                    return this->dispatch(oSession, static_cast<const shell_node_background *>(pRawNode));
+                case shell_node_type::SNT_AND:
+                    return this->dispatch(oSession, static_cast<const shell_node_and *>(pRawNode));
+                case shell_node_type::SNT_PIPE:
+                    return this->dispatch(oSession, static_cast<const shell_node_pipe *>(pRawNode));
+                case shell_node_type::SNT_OR:
+                    return this->dispatch(oSession, static_cast<const shell_node_or *>(pRawNode));
+                case shell_node_type::SNT_IF:
+                    return this->dispatch(oSession, static_cast<const shell_node_if *>(pRawNode));
+                case shell_node_type::SNT_TEST:
+                    return this->dispatch(oSession, static_cast<const shell_node_test *>(pRawNode));
+                case shell_node_type::SNT_FOR:
+                    return this->dispatch(oSession, static_cast<const shell_node_for *>(pRawNode));
+                case shell_node_type::SNT_FOR_COUNT:
+                    return this->dispatch(oSession, static_cast<const shell_node_for_count *>(pRawNode));
+                case shell_node_type::SNT_WHILE:
+                    return this->dispatch(oSession, static_cast<const shell_node_while *>(pRawNode));
+                case shell_node_type::SNT_UNTIL:
+                    return this->dispatch(oSession, static_cast<const shell_node_until *>(pRawNode));
+                case shell_node_type::SNT_BREAK:
+                    return this->dispatch(oSession, static_cast<const shell_node_break *>(pRawNode));
+                case shell_node_type::SNT_CONTINUE:
+                    return this->dispatch(oSession, static_cast<const shell_node_continue *>(pRawNode));
+                case shell_node_type::SNT_FUNCTION:
+                    return this->dispatch(oSession, static_cast<const shell_node_function *>(pRawNode));
+                default:
+                    return visit_t();
+            }
+        }
+
+        /**
+         * @brief Dispatch an expandable node to the correct visit function.
+         * @param oSession Execution session.
+         * @param pRawNode Pointer to the node being visited.
+         * @return The result of the dispatched visit, or a default-constructed
+         *         `visit_t` if the node type is unhandled.
+         */
+        visit_t visit_node(shell_session &oSession, const shell_node_expandable *pRawNode) {
+            switch (pRawNode->get_type()) {
+                case shell_node_type::SNT_COMMAND_EXPRESSION:
+                    return this->dispatch(oSession, static_cast<const shell_node_command_expression *>(pRawNode));
+                case shell_node_type::SNT_STR_SIMPLE:
+                    return this->dispatch(oSession, static_cast<const shell_node_str_simple *>(pRawNode));
+                case shell_node_type::SNT_STR_DOUBLE:
+                    return this->dispatch(oSession, static_cast<const shell_node_str_double *>(pRawNode));
+                case shell_node_type::SNT_STR_BACK:
+                    return this->dispatch(oSession, static_cast<const shell_node_str_back *>(pRawNode));
+                case shell_node_type::SNT_WORD:
+                    return this->dispatch(oSession, static_cast<const shell_node_word *>(pRawNode));
+                case shell_node_type::SNT_UNICODE:
+                    return this->dispatch(oSession, static_cast<const shell_node_unicode *>(pRawNode));
+                case shell_node_type::SNT_ARG:
+                    return this->dispatch(oSession, static_cast<const shell_node_arg *>(pRawNode));
+                case shell_node_type::SNT_VARIABLE:
+                    return this->dispatch(oSession, static_cast<const shell_node_variable *>(pRawNode));
+                case shell_node_type::SNT_DOLLAR_SPECIAL:
+                    return this->dispatch(oSession, static_cast<const shell_node_dollar_special *>(pRawNode));
+                case shell_node_type::SNT_DOLLAR_VARIABLE:
+                    return this->dispatch(oSession, static_cast<const shell_node_dollar_variable *>(pRawNode));
+                case shell_node_type::SNT_DOLLAR_VARIABLE_DHOP:
+                    return this->dispatch(oSession, static_cast<const shell_node_dollar_variable_dhop *>(pRawNode));
+                case shell_node_type::SNT_DOLLAR_ARG:
+                    return this->dispatch(oSession, static_cast<const shell_node_dollar_arg *>(pRawNode));
+                case shell_node_type::SNT_DOLLAR_ARG_DHOP:
+                    return this->dispatch(oSession, static_cast<const shell_node_dollar_arg_dhop *>(pRawNode));
+                case shell_node_type::SNT_DOLLAR_ARRAY:
+                    return this->dispatch(oSession, static_cast<const shell_node_dollar_array *>(pRawNode));
+                case shell_node_type::SNT_DOLLAR_COMMAND:
+                    return this->dispatch(oSession, static_cast<const shell_node_dollar_command *>(pRawNode));
+                default:
+                    return visit_t();
+            }
+        }
+
+        /**
+         * @brief Dispatch a node of unknown kind to the correct visit function.
+         *
+         * Costs a `dynamic_cast` to the kind of the node, prefer the overloads
+         * for evaluable and expandable nodes.
+         *
+         * @param oSession Execution session.
+         * @param pRawNode Pointer to the node being visited.
+         * @return The result of the dispatched visit, or a default-constructed
+         *         `visit_t` if the node type is unhandled.
+         */
+        visit_t visit_node(shell_session &oSession, const shell_node *pRawNode) {
+            if (const auto pNode = dynamic_cast<const shell_node_evaluable *>(pRawNode); pNode != nullptr)
+                return this->visit_node(oSession, pNode);
+            if (const auto pNode = dynamic_cast<const shell_node_expandable *>(pRawNode); pNode != nullptr)
+                return this->visit_node(oSession, pNode);
+            return visit_t();
+        }
+
+    public:
+        /**
+         * @brief Calls a function on each child of a node, in source order.
+         *
+         * Omitted children, such as a missing `else`, are skipped. The function
+         * receives a pointer to \ref bs::shell_node_evaluable "shell_node_evaluable",
+         * \ref bs::shell_node_expandable "shell_node_expandable" or a concrete
+         * node, all of which \ref visit_node accepts.
+         *
+         * @tparam node_t Type of the node.
+         * @tparam function_t Type of the function.
+         * @param pNode The node.
+         * @param fChild The function.
+         */
+        template<typename node_t, typename function_t>
+        static void for_each_child(const node_t *pNode, function_t &&fChild) {
+            const auto fCall = [&fChild](const auto *pChild) {
+                if (pChild != nullptr) fChild(pChild);
+            };
+            if constexpr (requires { pNode->get_name(); }) fCall(pNode->get_name());
+            if constexpr (requires { pNode->get_test(); }) fCall(pNode->get_test());
+            if constexpr (requires { pNode->get_condition(); }) fCall(pNode->get_condition());
+            if constexpr (requires { pNode->get_case_if(); }) fCall(pNode->get_case_if());
+            if constexpr (requires { pNode->get_case_else(); }) fCall(pNode->get_case_else());
+            if constexpr (requires { pNode->get_sequence(); }) fCall(pNode->get_sequence());
+            if constexpr (requires { pNode->get_from(); }) fCall(pNode->get_from());
+            if constexpr (requires { pNode->get_to(); }) fCall(pNode->get_to());
+            if constexpr (requires { pNode->get_step(); }) fCall(pNode->get_step());
+            if constexpr (requires { pNode->get_subscript(); }) fCall(pNode->get_subscript());
+            if constexpr (requires { pNode->get_command(); }) fCall(pNode->get_command());
+            if constexpr (requires { pNode->get_left(); }) fCall(pNode->get_left());
+            if constexpr (requires { pNode->get_right(); }) fCall(pNode->get_right());
+            if constexpr (requires { pNode->get_children(); })
+                for (const auto &pChild: pNode->get_children()) fCall(pChild.get());
+            if constexpr (requires { pNode->get_iterative(); }) fCall(pNode->get_iterative());
+            if constexpr (requires { pNode->get_body(); }) fCall(pNode->get_body());
+        }
+
+    private:
+        /**
+         * @brief Calls the visit function of the derived visitor.
+         * @tparam node_t Type of the node.
+         * @param oSession Execution session.
+         * @param pNode The node.
+         * @return The result of the visit.
+         */
+        template<typename node_t>
+        visit_t dispatch(shell_session &oSession, const node_t *pNode) {
+            if constexpr (std::is_void_v<visit_t>) {
+                static_cast<derived_t *>(this)->visit(oSession, pNode);
+            } else {
+                return static_cast<derived_t *>(this)->visit(oSession, pNode);
+            }
+        }
+    };
+}
@@ -40,12 +40,12 @@ namespace bs {
      * to the node types they wish to handle.
      *
      * @tparam visit_t The return type of all visit functions.
-     * Must be default-constructible.
+     * Must be void or default-constructible.
      */
     template<typename visit_t>
     class shell_node_visitor {
-        static_assert(std::is_default_constructible_v<visit_t>,
-                      "visit_t must be default-constructible");
+        static_assert(std::is_void_v<visit_t> || std::is_default_constructible_v<visit_t>,
+                      "visit_t must be void or default-constructible");
 
     public:
         /// Type of data resulting of visit
@@ -201,6 +201,14 @@ namespace bs {
          */
         virtual visit_t visit(shell_session &oSession, const shell_node_dollar_variable_dhop *pNode) = 0;
 
+        /**
+         * @brief Visit an array variable reference node (`${a[i]}`, `${a[@]}`, etc.).
+         * @param oSession The current shell session.
+         * @param pNode The node to visit.
+         * @return The visitor result.
+         */
+        virtual visit_t visit(shell_session &oSession, const shell_node_dollar_array *pNode) = 0;
+
         /**
          * @brief Visit a command substitution node (`$(...)`).
          * @param oSession The current shell session.
@@ -289,6 +297,14 @@ namespace bs {
          */
         virtual visit_t visit(shell_session &oSession, const shell_node_for *pNode) = 0;
 
+        /**
+         * @brief Visit a counted for-loop node.
+         * @param oSession The current shell session.
+         * @param pNode The node to visit.
+         * @return The visitor result.
+         */
+        virtual visit_t visit(shell_session &oSession, const shell_node_for_count *pNode) = 0;
+
         /**
          * @brief Visit a while-loop node.
          * @param oSession The current shell session.
@@ -475,6 +491,20 @@ namespace bs {
                 }
                 break;
             }
+            case shell_node_type::SNT_DOLLAR_ARRAY: {
+                if (
+                    const auto pNode = dynamic_cast<const shell_node_dollar_array *>(pRawNode);
+                    pNode != nullptr
+                ) {
+                    if constexpr (std::is_same_v<visit_t, void>) {
+                        this->visit(oSession, pNode);
+                        return;
+                    } else {
+                        return this->visit(oSession, pNode);
+                    }
+                }
+                break;
+            }
             case shell_node_type::SNT_DOLLAR_ARG: {
                 if (
                     const auto pNode = dynamic_cast<const shell_node_dollar_arg *>(pRawNode);
@@ -615,6 +645,20 @@ namespace bs {
                 }
                 break;
             }
+            case shell_node_type::SNT_FOR_COUNT: {
+                if (
+                    const auto pNode = dynamic_cast<const shell_node_for_count *>(pRawNode);
+                    pNode != nullptr
+                ) {
+                    if constexpr (std::is_same_v<visit_t, void>) {
+                        this->visit(oSession, pNode);
+                        return;
+                    } else {
+                        return this->visit(oSession, pNode);
+                    }
+                }
+                break;
+            }
             case shell_node_type::SNT_WHILE: {
                 if (
                     const auto pNode = dynamic_cast<const shell_node_while *>(pRawNode);
@@ -61,6 +61,28 @@ namespace bs {
         nlohmann::basic_json<nlohmann::ordered_map>
         visit_node(shell_session &oSession, const shell_node *pRawNode) override;
 
+        /**
+         * @brief Gets the expansion of a node, as written in the JSON.
+         *
+         * The node is expanded on a subsession with null streams.
+         *
+         * @param oSession The active shell session, not modified.
+         * @param pNode The node to expand.
+         * @return The words of the expansion, each one between brackets.
+         */
+        [[nodiscard]] static std::string get_expansion(shell_session &oSession, const shell_node_expandable *pNode);
+
+        /**
+         * @brief Gets the evaluation of a node, as written in the JSON.
+         *
+         * The node is evaluated on a subsession with null streams.
+         *
+         * @param oSession The active shell session, not modified.
+         * @param pNode The node to evaluate.
+         * @return The status of the evaluation.
+         */
+        [[nodiscard]] static shell_status get_evaluation(shell_session &oSession, const shell_node_evaluable *pNode);
+
     private:
         /// @name Visit functions for each concrete shell node type.
         /// Implement these in derived classes.
@@ -194,6 +216,14 @@ namespace bs {
          */
         visit_type visit(shell_session &oSession, const shell_node_dollar_variable_dhop *pNode) override;
 
+        /**
+         * @brief Visit an array variable reference node (`${a[i]}`, `${a[@]}`, etc.).
+         * @param oSession The current shell session.
+         * @param pNode The node to visit.
+         * @return The node as json.
+         */
+        visit_type visit(shell_session &oSession, const shell_node_dollar_array *pNode) override;
+
         /**
          * @brief Visit a command substitution node (`$(...)`).
          * @param oSession The current shell session.
@@ -282,6 +312,14 @@ namespace bs {
          */
         visit_type visit(shell_session &oSession, const shell_node_for *pNode) override;
 
+        /**
+         * @brief Visit a counted for-loop node.
+         * @param oSession The current shell session.
+         * @param pNode The node to visit.
+         * @return The node as json.
+         */
+        visit_type visit(shell_session &oSession, const shell_node_for_count *pNode) override;
+
         /**
          * @brief Visit a while-loop node.
          * @param oSession The current shell session.
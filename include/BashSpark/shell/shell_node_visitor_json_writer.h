@@ -0,0 +1,412 @@
+/**
+ * @file shell_node_visitor_json_writer.h
+ * @brief Defines class `bs::shell_node_visitor_json_writer`
+ *
+ * Defines class `bs::shell_node_visitor_json_writer` to visit shell node structures.
+ * This particular visitor writes the shell node structure as json to a stream while
+ * it traverses it, without building the json document in memory.
+ *
+ * @date Created on 22/11/25
+ * @author Dante Doménech Martínez
+ *
+ * @copyright GNU General Public License v3.0
+ *
+ * This file is part of BashSpark.
+ * Copyright (C) 2025 Dante Doménech Martínez
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <optional>
+#include <ostream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <nlohmann/json.hpp>
+
+#include "BashSpark/shell/shell_node_visitor.h"
+
+namespace bs {
+    /**
+     * @class shell_node_visitor_json_writer
+     * @brief Visitor that writes shell nodes as JSON to a stream.
+     *
+     * The output is byte-identical to dumping the document of
+     * \ref bs::shell_node_visitor_json "shell_node_visitor_json" with the same
+     * indentation, but each node is written as soon as it is visited. The
+     * memory used is bounded by the depth of the tree instead of its size,
+     * which allows to dump the tree of very large scripts.
+     *
+     * The evaluation and the expansion of a node are computed before its
+     * children are visited, on subsessions that do not modify the session.
+     */
+    class shell_node_visitor_json_writer final : public shell_node_visitor<void> {
+    public:
+        /**
+         * @brief Constructs the writer.
+         * @param oOut Output stream.
+         * @param nIndent Indentation of each level, as in `nlohmann::json::dump`; negative for a compact output.
+         * @param cIndent Indentation character.
+         */
+        explicit shell_node_visitor_json_writer(std::ostream &oOut, int nIndent = -1, char cIndent = ' ');
+
+    public:
+        /**
+         * @brief Visit a generic shell node and write its JSON representation.
+         *
+         * Computes the evaluation and the expansion of the node and dispatches
+         * it to the appropriate specialized `visit()` overload, which writes
+         * the node and its children.
+         *
+         * @param oSession The active shell session used during evaluation.
+         * @param pRawNode Pointer to the node being visited.
+         */
+        void visit_node(shell_session &oSession, const shell_node *pRawNode) override;
+
+    private:
+        /// @name Visit functions for each concrete shell node type.
+        /// Implement these in derived classes.
+        /// @{
+
+        /**
+         * @brief Visit a word node.
+         * @param oSession The current shell session.
+         * @param pNode The node to visit.
+         */
+        void visit(shell_session &oSession, const shell_node_word *pNode) override;
+
+        /**
+         * @brief Visit a unicode node.
+         * @param oSession The current shell session.
+         * @param pNode The node to visit.
+         */
+        void visit(shell_session &oSession, const shell_node_unicode *pNode) override;
+
+        /**
+         * @brief Visit a simple quoted string node.
+         * @param oSession The current shell session.
+         * @param pNode The node to visit.
+         */
+        void visit(shell_session &oSession, const shell_node_str_simple *pNode) override;
+
+        /**
+         * @brief Visit a double-quoted string node.
+         * @param oSession The current shell session.
+         * @param pNode The node to visit.
+         */
+        void visit(shell_session &oSession, const shell_node_str_double *pNode) override;
+
+        /**
+         * @brief Visit a backtick command string node.
+         * @param oSession The current shell session.
+         * @param pNode The node to visit.
+         */
+        void visit(shell_session &oSession, const shell_node_str_back *pNode) override;
+
+        /**
+         * @brief Visit a null command node.
+         * @param oSession The current shell session.
+         * @param pNode The node to visit.
+         */
+        void visit(shell_session &oSession, const shell_node_null_command *pNode) override;
+
+        /**
+         * @brief Visit a command node.
+         * @param oSession The current shell session.
+         * @param pNode The node to visit.
+         */
+        void visit(shell_session &oSession, const shell_node_command *pNode) override;
+
+        /**
+         * @brief Visit a command expression node.
+         * @param oSession The current shell session.
+         * @param pNode The node to visit.
+         */
+        void visit(shell_session &oSession, const shell_node_command_expression *pNode) override;
+
+        /**
+         * @brief Visit a command block node.
+         * @param oSession The current shell session.
+         * @param pNode The node to visit.
+         */
+        void visit(shell_session &oSession, const shell_node_command_block *pNode) override;
+
+        /**
+         * @brief Visit a subshell command block node.
+         * @param oSession The current shell session.
+         * @param pNode The node to visit.
+         */
+        void visit(shell_session &oSession, const shell_node_command_block_subshell *pNode) override;
+
+        /**
+         * @brief Visit an argument node.
+         * @param oSession The current shell session.
+         * @param pNode The node to visit.
+         */
+        void visit(shell_session &oSession, const shell_node_arg *pNode) override;
+
+        /**
+         * @brief Visit a variable node.
+         * @param oSession The current shell session.
+         * @param pNode The node to visit.
+         */
+        void visit(shell_session &oSession, const shell_node_variable *pNode) override;
+
+        /**
+         * @brief Visit a `$N` argument reference node.
+         * @param oSession The current shell session.
+         * @param pNode The node to visit.
+         */
+        void visit(shell_session &oSession, const shell_node_dollar_arg *pNode) override;
+
+        /**
+         * @brief Visit a `$var` variable reference node.
+         * @param oSession The current shell session.
+         * @param pNode The node to visit.
+         */
+        void visit(shell_session &oSession, const shell_node_dollar_variable *pNode) override;
+
+        /**
+         * @brief Visit a `${N}` argument reference node.
+         * @param oSession The current shell session.
+         * @param pNode The node to visit.
+         */
+        void visit(shell_session &oSession, const shell_node_dollar_arg_dhop *pNode) override;
+
+        /**
+         * @brief Visit a `${var}` variable reference node.
+         * @param oSession The current shell session.
+         * @param pNode The node to visit.
+         */
+        void visit(shell_session &oSession, const shell_node_dollar_variable_dhop *pNode) override;
+
+        /**
+         * @brief Visit an array variable reference node (`${a[i]}`, `${a[@]}`, etc.).
+         * @param oSession The current shell session.
+         * @param pNode The node to visit.
+         */
+        void visit(shell_session &oSession, const shell_node_dollar_array *pNode) override;
+
+        /**
+         * @brief Visit a command substitution node (`$(...)`).
+         * @param oSession The current shell session.
+         * @param pNode The node to visit.
+         */
+        void visit(shell_session &oSession, const shell_node_dollar_command *pNode) override;
+
+        /**
+         * @brief Visit a special variable node (`$?`, `$#`, etc.).
+         * @param oSession The current shell session.
+         * @param pNode The node to visit.
+         */
+        void visit(shell_session &oSession, const shell_node_dollar_special *pNode) override;
+
+        /**
+         * @brief Visit a background operator node.
+         * @param oSession The current shell session.
+         * @param pNode The node to visit.
+         */
+        void visit(shell_session &oSession, const shell_node_background *pNode) override;
+
+        /**
+         * @brief Visit a pipe operator node.
+         * @param oSession The current shell session.
+         * @param pNode The node to visit.
+         */
+        void visit(shell_session &oSession, const shell_node_pipe *pNode) override;
+
+        /**
+         * @brief Visit a logical OR operator node.
+         * @param oSession The current shell session.
+         * @param pNode The node to visit.
+         */
+        void visit(shell_session &oSession, const shell_node_or *pNode) override;
+
+        /**
+         * @brief Visit a logical AND operator node.
+         * @param oSession The current shell session.
+         * @param pNode The node to visit.
+         */
+        void visit(shell_session &oSession, const shell_node_and *pNode) override;
+
+        /**
+         * @brief Visit a test command node.
+         * @param oSession The current shell session.
+         * @param pNode The node to visit.
+         */
+        void visit(shell_session &oSession, const shell_node_test *pNode) override;
+
+        /**
+         * @brief Visit an if-statement node.
+         * @param oSession The current shell session.
+         * @param pNode The node to visit.
+         */
+        void visit(shell_session &oSession, const shell_node_if *pNode) override;
+
+        /**
+         * @brief Visit a break statement node.
+         * @param oSession The current shell session.
+         * @param pNode The node to visit.
+         */
+        void visit(shell_session &oSession, const shell_node_break *pNode) override;
+
+        /**
+         * @brief Visit a continue statement node.
+         * @param oSession The current shell session.
+         * @param pNode The node to visit.
+         */
+        void visit(shell_session &oSession, const shell_node_continue *pNode) override;
+
+        /**
+         * @brief Visit a for-loop node.
+         * @param oSession The current shell session.
+         * @param pNode The node to visit.
+         */
+        void visit(shell_session &oSession, const shell_node_for *pNode) override;
+
+        /**
+         * @brief Visit a counted for-loop node.
+         * @param oSession The current shell session.
+         * @param pNode The node to visit.
+         */
+        void visit(shell_session &oSession, const shell_node_for_count *pNode) override;
+
+        /**
+         * @brief Visit a while-loop node.
+         * @param oSession The current shell session.
+         * @param pNode The node to visit.
+         */
+        void visit(shell_session &oSession, const shell_node_while *pNode) override;
+
+        /**
+         * @brief Visit an until-loop node.
+         * @param oSession The current shell session.
+         * @param pNode The node to visit.
+         */
+        void visit(shell_session &oSession, const shell_node_until *pNode) override;
+
+        /**
+         * @brief Visit a function node.
+         * @param oSession The current shell session.
+         * @param pNode The node to visit.
+         */
+        void visit(shell_session &oSession, const shell_node_function *pNode) override;
+
+        /// @}
+
+    private:
+        /**
+         * @brief Writes the line break and the indentation of the current level.
+         */
+        void write_indent();
+
+        /**
+         * @brief Starts an item of the current object or array.
+         */
+        void write_separator();
+
+        /**
+         * @brief Writes the key of a member of the current object.
+         * @param sKey The key.
+         */
+        void write_key(std::string_view sKey);
+
+        /**
+         * @brief Writes a scalar value.
+         * @param oValue The value, converted as by `nlohmann::ordered_json`.
+         */
+        template<typename T>
+        void write_value(const T &oValue) {
+            this->m_oOut << nlohmann::ordered_json(oValue);
+        }
+
+        /**
+         * @brief Writes a member holding a scalar value.
+         * @param sKey The key.
+         * @param oValue The value.
+         */
+        template<typename T>
+        void write_member(const std::string_view sKey, const T &oValue) {
+            this->write_key(sKey);
+            this->write_value(oValue);
+        }
+
+        /**
+         * @brief Writes a member holding a node.
+         * @param oSession The current shell session.
+         * @param sKey The key.
+         * @param pNode The node, written as null if nullptr.
+         */
+        void write_member(shell_session &oSession, std::string_view sKey, const shell_node *pNode);
+
+        /**
+         * @brief Writes a member holding nodes.
+         * @param oSession The current shell session.
+         * @param sKey The key.
+         * @param vChildren The nodes, written as null if nullptr.
+         */
+        template<typename C>
+        void write_children(shell_session &oSession, const std::string_view sKey, const C &vChildren) {
+            this->write_key(sKey);
+            this->begin('[');
+            for (const auto &pChild: vChildren) {
+                this->write_separator();
+                this->write_node(oSession, pChild.get());
+            }
+            this->end(']');
+        }
+
+        /**
+         * @brief Writes a node.
+         * @param oSession The current shell session.
+         * @param pNode The node, written as null if nullptr.
+         */
+        void write_node(shell_session &oSession, const shell_node *pNode);
+
+        /**
+         * @brief Opens a node and writes its type, evaluation and expansion.
+         * @param sType The type of the node.
+         */
+        void begin_node(std::string_view sType);
+
+        /**
+         * @brief Opens an object or an array.
+         * @param cOpen `{` or `[`.
+         */
+        void begin(char cOpen);
+
+        /**
+         * @brief Closes the last object or array.
+         * @param cClose `}` or `]`.
+         */
+        void end(char cClose);
+
+    private:
+        /// Output stream
+        std::ostream &m_oOut;
+        /// Indentation of each level, negative for a compact output
+        int m_nIndent;
+        /// Indentation character
+        char m_cIndent;
+        /// Whether each open object or array is still empty
+        std::vector<bool> m_vEmpty;
+        /// Evaluation of the node being opened
+        std::optional<shell_status> m_oEvaluation;
+        /// Expansion of the node being opened
+        std::optional<std::string> m_oExpansion;
+    };
+}
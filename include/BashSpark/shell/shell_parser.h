@@ -33,6 +33,7 @@
 #include "BashSpark/shell.h"
 #include "BashSpark/shell/shell_node.h"
 #include "BashSpark/shell/shell_keyword.h"
+#include "BashSpark/shell/shell_source.h"
 #include "BashSpark/tools/fakestream.h"
 
 namespace bs {
@@ -64,20 +65,22 @@ namespace bs {
         /**
          * @brief Parse input into an evaluable AST.
          *
-         * Reads tokens from the given input stream and produces the root node
-         * of the parsed command or expression.
+         * Tokenizes the text of the source and produces the root node of the
+         * parsed command or expression. Every syntax error shares the source.
          *
-         * @param oIstream The input token stream.
+         * @param pSource The source to parse.
          * @return The root evaluable AST node.
+         * @throw shell_parser_exception If a syntax error is found.
          */
         static evaluable_ptr parse(
-            ifakestream &oIstream
+            const std::shared_ptr<const shell_source> &pSource
         );
 
     private:
         shell_parser(
             ifakestream &oIstream,
-            token_holder &oTokens
+            token_holder &oTokens,
+            const std::shared_ptr<const shell_source> &pSource
         );
 
     private:
@@ -129,7 +132,17 @@ namespace bs {
          *
          * @return An expandable AST node.
          */
-        [[nodiscard]] expandable_ptr parse_dollar_variable() const;
+        [[nodiscard]] expandable_ptr parse_dollar_variable();
+
+        /**
+         * @brief Parse an array variable expansion (`${a[i]}`, `${a[@]}`, `${!a[@]}` or `${#a[@]}`).
+         *
+         * @param pNameToken Token holding the array name.
+         * @param bKeys Whether the expansion is prefixed by `!`.
+         * @param bSize Whether the expansion is prefixed by `#`.
+         * @return An expandable AST node.
+         */
+        [[nodiscard]] expandable_ptr parse_dollar_array(const shell_token *pNameToken, bool bKeys, bool bSize);
 
         /**
          * @brief Parse a `$(...)` command substitution.
@@ -247,6 +260,37 @@ namespace bs {
          */
         [[nodiscard]] evaluable_ptr parse_for();
 
+        /**
+         * @brief Parse the rest of a counted `for ... from ... to ... step ...` loop.
+         *
+         * The current token must be the `from` word.
+         *
+         * @param nPos Position of the `for` keyword.
+         * @param sVariable Loop variable name.
+         * @return An evaluable AST node.
+         */
+        [[nodiscard]] evaluable_ptr parse_for_count(std::size_t nPos, std::string sVariable);
+
+        /**
+         * @brief Parse a single word operand of a counted `for` loop.
+         *
+         * Skips the current token and the surrounding spaces.
+         *
+         * @param nPos Position of the `for` keyword.
+         * @return An expandable AST node.
+         */
+        [[nodiscard]] expandable_ptr parse_for_count_operand(std::size_t nPos);
+
+        /**
+         * @brief Checks if the current token is a given standalone word.
+         *
+         * Used for contextual keywords, which are not reserved elsewhere.
+         *
+         * @param sWord The word to compare against.
+         * @return True if the current token is the word followed by a space or the end.
+         */
+        [[nodiscard]] bool is_word(const std::string_view &sWord) const noexcept;
+
         /**
          * @brief Parse a `while` loop.
          *
@@ -286,6 +330,8 @@ namespace bs {
         std::size_t m_nDepth = 0;
         /// Istream to parse
         ifakestream &m_oIstream;
+        /// Source read by the stream, shared by the syntax errors
+        const std::shared_ptr<const shell_source> &m_pSource;
         // Token holder
         token_holder &m_oTokens;
     };
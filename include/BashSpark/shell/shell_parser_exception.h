@@ -29,10 +29,14 @@
 
 #pragma once
 
-#include <vector>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <string_view>
 
+#include "BashSpark/shell/shell_source.h"
 #include "BashSpark/shell/shell_status.h"
-#include "BashSpark/tools/fakestream.h"
 
 namespace bs {
     /**
@@ -41,22 +45,37 @@ namespace bs {
      *
      * This exception class is used to capture and report errors encountered
      * during the parsing and execution of shell commands.
+     *
+     * The source is shared, see \ref bs::shell_source "shell_source", and the
+     * message is only formatted the first time \ref what is called. Copies of
+     * the exception share both.
      */
     class shell_parser_exception final : public std::runtime_error {
     public:
         /**
          * @brief Constructs a shell_exception instance.
          * @param nStatus The status indicating the type of error.
-         * @param sCommand The command that caused the error.
-         * @param nPos The position in the command where the error occurred.
+         * @param pSource The source that caused the error.
+         * @param nPos The position in the source where the error occurred.
          */
         shell_parser_exception(
             shell_status nStatus,
-            std::string sCommand,
+            std::shared_ptr<const shell_source> pSource,
             std::size_t nPos
         );
 
     public:
+        /**
+         * @brief Returns the formatted message.
+         *
+         * The message holds the error, the line of the error with a marker
+         * under it, and the position of the error. It is formatted on the
+         * first call.
+         *
+         * @return The message.
+         */
+        [[nodiscard]] const char *what() const noexcept override;
+
         /**
          * @brief Returns the error status associated with the exception.
          * @return The shell_status indicating the type of error.
@@ -69,8 +88,16 @@ namespace bs {
          * @brief Returns the command that caused the exception.
          * @return A string containing the command.
          */
-        [[nodiscard]] const std::string &get_command() const noexcept {
-            return m_sCommand;
+        [[nodiscard]] std::string_view get_command() const noexcept {
+            return m_pState->m_pSource->get_text();
+        }
+
+        /**
+         * @brief Returns the source that caused the exception.
+         * @return The shared source.
+         */
+        [[nodiscard]] const std::shared_ptr<const shell_source> &get_source() const noexcept {
+            return m_pState->m_pSource;
         }
 
         /**
@@ -81,11 +108,29 @@ namespace bs {
             return m_nPos;
         }
 
+        /**
+         * @brief Returns the line where the error occurred.
+         * @return The line, from 1.
+         */
+        [[nodiscard]] std::size_t get_line() const {
+            return m_pState->m_pSource->get_line(m_nPos) + 1;
+        }
+
+    private:
+        /**
+         * @brief State shared by the copies of the exception.
+         */
+        struct state {
+            std::shared_ptr<const shell_source> m_pSource; ///< The source that caused the exception.
+            std::once_flag m_oMessageFlag; ///< Formats the message once.
+            std::string m_sMessage; ///< The formatted message, empty until formatted.
+        };
+
     private:
         /// The error status.
         shell_status m_nStatus;
-        /// The command that caused the exception.
-        std::string m_sCommand;
+        /// The shared state.
+        std::shared_ptr<state> m_pState;
         /// The position of the error in the command.
         std::size_t m_nPos;
     };
@@ -0,0 +1,318 @@
+/**
+ * @file shell_profiler.h
+ * @brief Defines class `bs::shell_profiler`.
+ *
+ * This file contains the definition of the `bs::shell_profiler` class,
+ * which records the time spent on each node of a script and on each
+ * function called with `fcall`. The results are exported as a top-N text
+ * report or as folded stacks for flamegraph tools.
+ *
+ * @date Created on 22/11/25
+ * @author Dante Doménech Martínez
+ *
+ * @copyright GNU General Public License v3.0
+ *
+ * This file is part of BashSpark.
+ * Copyright (C) 2025 Dante Doménech Martínez
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <ostream>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+#include "BashSpark/shell/shell_node.h"
+#include "BashSpark/shell/shell_session.h"
+
+namespace bs {
+    /**
+     * @class shell_profiler
+     * @brief Records the time spent on each node and function of a script.
+     *
+     * Attach the profiler to a session with
+     * \ref bs::shell_session::set_profiler "shell_session::set_profiler". The
+     * sessions derived from it (pipes, subshells, function calls) share the
+     * profiler. Without a profiler, the cost is a null pointer check per node.
+     *
+     * Nodes are keyed by their type and their position, see
+     * \ref bs::shell_node::get_pos "shell_node::get_pos", which is mapped to a
+     * line and a column of the source given to the constructor. The profiled
+     * source is the outermost tree evaluated, see \ref source. The trees it
+     * runs, such as the strings given to `eval`, number their positions from
+     * 0 again: their nodes are keyed by type and position in a bucket of their
+     * own and labelled as nested, so they are neither merged with nor reported
+     * at the lines of the profiled source. Repeated runs of a nested source
+     * add up in the same entries, and so do the nodes of different nested
+     * sources at the same position. Functions are keyed by name.
+     *
+     * The inclusive time of an entry includes the time of the nodes it runs,
+     * counted once on recursion. The exclusive time excludes it.
+     *
+     * Only the synchronous evaluation is profiled. The coroutine evaluation,
+     * \ref bs::shell_script::run_async "shell_script::run_async" and
+     * \ref bs::shell_scheduler "shell_scheduler", records no time for the
+     * commands, blocks, loops and function calls it awaits: the active
+     * evaluations are kept on a single stack, which tasks suspended and
+     * resumed in any order would corrupt. Only the nodes those tasks evaluate
+     * synchronously, such as the tests and the command substitutions, are
+     * recorded. A profiler must only be used by one thread at a time;
+     * streamed command substitutions run on a worker thread and are not
+     * profiled.
+     */
+    class shell_profiler {
+    public:
+        /// Clock of the measures
+        using clock_type = std::chrono::steady_clock;
+
+        /**
+         * @struct entry
+         * @brief Measures of a node or a function.
+         */
+        struct entry {
+            /// Node type, meaningless for functions.
+            shell_node_type m_nType = shell_node_type::SNT_COMMAND;
+            /// Position of the node in the source, meaningless for functions.
+            std::size_t m_nPos = 0;
+            /// Line of the node, from 1, 0 if unknown.
+            std::size_t m_nLine = 0;
+            /// Column of the node, from 1, 0 if unknown.
+            std::size_t m_nColumn = 0;
+            /// Whether the node belongs to a nested source, such as an `eval` string.
+            bool m_bNested = false;
+            /// Function name, empty for nodes.
+            std::string m_sFunction;
+            /// Number of evaluations.
+            std::uint64_t m_nHits = 0;
+            /// Time spent in the entry and the nodes it runs.
+            std::chrono::nanoseconds m_nInclusive{0};
+            /// Time spent in the entry itself.
+            std::chrono::nanoseconds m_nExclusive{0};
+            /// Active evaluations, for recursion.
+            std::size_t m_nActive = 0;
+
+            /**
+             * @brief Gets the name of the entry in the reports.
+             * @return `function name` for functions, `type@line:column` for nodes,
+             * `type@nested:position` for the nodes of nested sources.
+             */
+            [[nodiscard]] std::string get_label() const;
+        };
+
+        /**
+         * @class scope
+         * @brief Profiles a node or a function while alive.
+         *
+         * Does nothing if the session has no profiler.
+         */
+        class scope {
+        public:
+            /**
+             * @brief Enters a node.
+             * @param oSession Session evaluating the node.
+             * @param pNode The node.
+             */
+            scope(const shell_session &oSession, const shell_node *pNode)
+                : m_pProfiler(oSession.get_profiler()) {
+                if (this->m_pProfiler != nullptr) this->m_pProfiler->enter(pNode);
+            }
+
+            /**
+             * @brief Enters a function.
+             * @param oSession Session calling the function.
+             * @param sFunction Function name.
+             */
+            scope(const shell_session &oSession, const std::string &sFunction)
+                : m_pProfiler(oSession.get_profiler()) {
+                if (this->m_pProfiler != nullptr) this->m_pProfiler->enter(sFunction);
+            }
+
+            /**
+             * @brief Leaves the node or the function.
+             */
+            ~scope() {
+                if (this->m_pProfiler != nullptr) this->m_pProfiler->leave();
+            }
+
+            scope(const scope &) = delete;
+
+            scope &operator=(const scope &) = delete;
+
+        private:
+            /// The profiler, nullptr if disabled
+            shell_profiler *m_pProfiler;
+        };
+
+        /**
+         * @class source
+         * @brief Marks the evaluation of a parsed tree while alive.
+         *
+         * The outermost tree is the profiled source, the trees evaluated
+         * inside it are nested sources. Does nothing if the session has no
+         * profiler.
+         */
+        class source {
+        public:
+            /**
+             * @brief Enters a tree.
+             * @param oSession Session evaluating the tree.
+             * @param pRoot Root node of the tree.
+             */
+            source(shell_session &oSession, const shell_node_evaluable *pRoot)
+                : m_pProfiler(oSession.get_profiler()) {
+                if (this->m_pProfiler != nullptr) this->m_pProfiler->enter_source(oSession, pRoot);
+            }
+
+            /**
+             * @brief Leaves the tree.
+             */
+            ~source() {
+                if (this->m_pProfiler != nullptr) this->m_pProfiler->leave_source();
+            }
+
+            source(const source &) = delete;
+
+            source &operator=(const source &) = delete;
+
+        private:
+            /// The profiler, nullptr if disabled
+            shell_profiler *m_pProfiler;
+        };
+
+    public:
+        /**
+         * @brief Constructs the profiler.
+         * @param sSource Source of the profiled script, used to map the positions to lines and columns.
+         */
+        explicit shell_profiler(std::string sSource = {});
+
+    public:
+        /**
+         * @brief Enters a node.
+         * @param pNode The node.
+         */
+        void enter(const shell_node *pNode);
+
+        /**
+         * @brief Enters a function.
+         * @param sFunction Function name.
+         */
+        void enter(const std::string &sFunction);
+
+        /**
+         * @brief Leaves the last entered node or function.
+         */
+        void leave();
+
+        /**
+         * @brief Enters a parsed tree.
+         *
+         * The nodes of the outermost tree are collected, so that the nodes of
+         * nested trees are told apart.
+         *
+         * @param oSession Session evaluating the tree.
+         * @param pRoot Root node of the tree.
+         */
+        void enter_source(shell_session &oSession, const shell_node_evaluable *pRoot);
+
+        /**
+         * @brief Leaves the last entered tree.
+         */
+        void leave_source();
+
+        /**
+         * @brief Clears the measures.
+         */
+        void clear();
+
+        /**
+         * @brief Gets the measures.
+         * @return The entries sorted by decreasing exclusive time.
+         */
+        [[nodiscard]] std::vector<entry> get_entries() const;
+
+        /**
+         * @brief Writes the entries with the most exclusive time.
+         * @param oOut Output stream.
+         * @param nTop Maximum number of entries, 0 for all.
+         */
+        void write_report(std::ostream &oOut, std::size_t nTop = 20) const;
+
+        /**
+         * @brief Writes the folded stacks.
+         *
+         * Each line holds the labels of a stack separated by `;` and its
+         * exclusive time in microseconds, the input of `flamegraph.pl` and
+         * compatible tools.
+         *
+         * @param oOut Output stream.
+         */
+        void write_folded(std::ostream &oOut) const;
+
+    private:
+        /**
+         * @brief Enters an entry.
+         * @param nKey Key of the entry.
+         * @param oEntry The entry.
+         */
+        void enter(std::uint64_t nKey, entry &oEntry);
+
+        /**
+         * @brief A call stack, stored as a tree.
+         */
+        struct stack_node {
+            std::size_t m_nParent; ///< Caller stack.
+            std::uint64_t m_nKey; ///< Entry on top of the stack.
+            std::chrono::nanoseconds m_nExclusive{0}; ///< Exclusive time of the stack.
+        };
+
+        /**
+         * @brief An active evaluation.
+         */
+        struct frame {
+            entry *m_pEntry; ///< Entry evaluated.
+            std::size_t m_nStack; ///< Stack of the evaluation.
+            clock_type::time_point m_nStart; ///< Start of the evaluation.
+            std::chrono::nanoseconds m_nChildren{0}; ///< Time of the nodes it runs.
+        };
+
+    private:
+        /// Offset of the start of each line of the source
+        std::vector<std::size_t> m_vLines;
+        /// Entries by key
+        std::unordered_map<std::uint64_t, entry> m_mEntries;
+        /// Keys of the functions by name
+        std::unordered_map<std::string, std::uint64_t> m_mFunctions;
+        /// Stacks, the first one is the root
+        std::vector<stack_node> m_vStacks;
+        /// Stacks by caller stack and key
+        std::map<std::pair<std::size_t, std::uint64_t>, std::size_t> m_mStacks;
+        /// Active evaluations
+        std::vector<frame> m_vFrames;
+        /// Nodes of the profiled source, empty outside of it
+        std::unordered_set<const shell_node *> m_sSourceNodes;
+        /// Number of trees being evaluated
+        std::size_t m_nSources = 0;
+    };
+}
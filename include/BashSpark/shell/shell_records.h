@@ -0,0 +1,143 @@
+/**
+ * @file shell_records.h
+ * @brief Defines class `bs::shell_records`.
+ *
+ * This file contains the definition of the `bs::shell_records` class,
+ * a typed channel carrying words between the sides of a pipe. Builtins
+ * on both sides exchange the words directly, skipping the formatting
+ * and the re-splitting of the text.
+ *
+ * @date Created on 22/11/25
+ * @author Dante Doménech Martínez
+ *
+ * @copyright GNU General Public License v3.0
+ *
+ * This file is part of BashSpark.
+ * Copyright (C) 2025 Dante Doménech Martínez
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace bs {
+    /**
+     * @class shell_records
+     * @brief Typed channel of a pipe.
+     *
+     * The text form of the records is the records joined by single spaces,
+     * so a producer may only write records instead of text if its text
+     * output would have been exactly that. The channel accepts records
+     * once, and only while no text has been written to the pipe, so the
+     * text form of the whole output is always the records followed by the
+     * text written afterwards.
+     */
+    class shell_records {
+    public:
+        /**
+         * @brief Constructs the channel.
+         * @param oText Text output of the pipe.
+         */
+        explicit shell_records(const std::ostringstream &oText)
+            : m_oText(oText) {
+        }
+
+    public:
+        /**
+         * @brief Checks whether the channel accepts records.
+         * @return true if nothing has been written to the pipe yet.
+         */
+        [[nodiscard]] bool is_open() const noexcept {
+            return !this->m_bWritten && this->m_oText.view().empty();
+        }
+
+        /**
+         * @brief Writes the records, closing the channel.
+         * @param vRecords Records to write.
+         */
+        void write(std::vector<std::string> vRecords) noexcept {
+            this->m_vRecords = std::move(vRecords);
+            this->m_bWritten = true;
+        }
+
+        /**
+         * @brief Checks whether records have been written.
+         * @return true if records have been written.
+         */
+        [[nodiscard]] bool has_records() const noexcept {
+            return this->m_bWritten;
+        }
+
+        /**
+         * @brief Checks whether the whole output are records.
+         * @return true if records and no text have been written.
+         */
+        [[nodiscard]] bool is_typed() const noexcept {
+            return this->m_bWritten && this->m_oText.view().empty();
+        }
+
+        /**
+         * @brief Moves the records out of the channel.
+         * @return The records.
+         */
+        [[nodiscard]] std::vector<std::string> take() noexcept {
+            return std::move(this->m_vRecords);
+        }
+
+        /**
+         * @brief Renders the whole output as text.
+         * @return The records joined by spaces, followed by the text output.
+         */
+        [[nodiscard]] std::string text() const {
+            std::string sText;
+            for (const auto &sRecord: this->m_vRecords) {
+                if (!sText.empty()) sText.push_back(' ');
+                sText.append(sRecord);
+            }
+            sText.append(this->m_oText.view());
+            return sText;
+        }
+
+        /**
+         * @brief Splits text into records.
+         *
+         * Words are delimited by spaces, tabs and new lines.
+         *
+         * @param vRecords Where to append the records.
+         * @param sText Text to split.
+         */
+        static void split(std::vector<std::string> &vRecords, const std::string_view sText) {
+            std::size_t nStart = 0;
+            for (std::size_t i = 0; i <= sText.size(); ++i) {
+                if (i == sText.size() || sText[i] == ' ' || sText[i] == '\n' || sText[i] == '\t') {
+                    if (i > nStart) vRecords.emplace_back(sText.substr(nStart, i - nStart));
+                    nStart = i + 1;
+                }
+            }
+        }
+
+    private:
+        /// Text output of the pipe.
+        const std::ostringstream &m_oText;
+        /// Records written.
+        std::vector<std::string> m_vRecords;
+        /// Whether records have been written.
+        bool m_bWritten = false;
+    };
+}
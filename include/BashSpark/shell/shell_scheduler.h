@@ -0,0 +1,144 @@
+/**
+ * @file shell_scheduler.h
+ * @brief Defines the `bs::shell_scheduler` class.
+ *
+ * This file contains the round-robin scheduler running many
+ * \ref bs::shell_task "shell_task" on a few threads. Each task runs for a
+ * time slice and then goes back to the end of the queue at its next
+ * suspension point. Tasks awaiting a \ref bs::shell_event "shell_event" are
+ * put aside until the event is set.
+ *
+ * @date Created on 22/11/25
+ * @author Dante Doménech Martínez
+ *
+ * @copyright GNU General Public License v3.0
+ *
+ * This file is part of BashSpark.
+ * Copyright (C) 2025 Dante Doménech Martínez
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <future>
+#include <list>
+#include <mutex>
+
+#include "BashSpark/shell/shell_script.h"
+#include "BashSpark/shell/shell_task.h"
+
+namespace bs {
+    /**
+     * @class shell_scheduler
+     * @brief Runs many tasks on a few threads with fair time slicing.
+     *
+     * Tasks are submitted with \ref submit and run by the threads calling
+     * \ref run. A task only gives up its thread at a suspension point, so a
+     * single synchronous command runs to completion, while an asynchronous
+     * command gives up its thread while awaiting an event, see
+     * \ref bs::command::run_async "command::run_async". Each session must only
+     * be used by one task at a time.
+     *
+     * With the single-threaded policy, see \ref bs::shell_traits "shell_traits",
+     * all tasks run on the thread calling \ref run, so events must be set
+     * by the tasks themselves.
+     */
+    class shell_scheduler {
+    public:
+        /// Default time slice of a task
+        constexpr static std::chrono::microseconds DEFAULT_TIME_SLICE{1000};
+
+    public:
+        /**
+         * @brief Constructs the scheduler.
+         * @param nTimeSlice Time a task runs before yielding to the next one
+         */
+        explicit shell_scheduler(const std::chrono::nanoseconds nTimeSlice = DEFAULT_TIME_SLICE)
+            : m_nTimeSlice(nTimeSlice) {
+        }
+
+    public:
+        /**
+         * @brief Submits a task.
+         * @param oTask Root task to run, see \ref bs::shell_script::run_async "shell_script::run_async"
+         * @return Future receiving the status or the exception of the task
+         */
+        std::future<shell_status> submit(shell_task oTask);
+
+        /**
+         * @brief Submits a script.
+         * @param oScript Script to run, must outlive the task
+         * @param oSession Session of the script, must outlive the task
+         * @return Future receiving the status or the exception of the script
+         */
+        std::future<shell_status> submit(const shell_script &oScript, shell_session &oSession) {
+            return this->submit(oScript.run_async(oSession));
+        }
+
+        /**
+         * @brief Runs the submitted tasks until none is left.
+         *
+         * The calling thread takes part in the run. Tasks submitted while
+         * running are also run. Threads without tasks to run sleep until
+         * a task is submitted or an awaited event is set.
+         *
+         * @param nThreads Number of threads, 0 to use the hardware concurrency
+         */
+        void run(std::size_t nThreads = 1);
+
+        /**
+         * @brief Gets the number of tasks not yet finished.
+         * @return Number of pending tasks.
+         */
+        [[nodiscard]] std::size_t size() const;
+
+    private:
+        /**
+         * @brief A task waiting for its turn.
+         */
+        struct entry {
+            shell_task m_oTask; ///< The task.
+            std::promise<shell_status> m_oResult; ///< Result of the task.
+        };
+
+        /**
+         * @brief Runs tasks until none is left.
+         */
+        void work();
+
+        /**
+         * @brief Requeues a task put aside once its event is set.
+         * @param pParked The task.
+         */
+        void wake(std::list<entry>::iterator pParked);
+
+    private:
+        /// Time slice of a task
+        std::chrono::nanoseconds m_nTimeSlice;
+        /// Tasks waiting for their turn
+        std::deque<entry> m_dReady;
+        /// Tasks awaiting an event
+        std::list<entry> m_lParked;
+        /// Number of tasks being run
+        std::size_t m_nRunning = 0;
+        /// Guards the queue
+        mutable std::mutex m_oMutex;
+        /// Signals new tasks or the end of the run
+        std::condition_variable m_oSignal;
+    };
+}
@@ -0,0 +1,98 @@
+/**
+ * @file shell_script.h
+ * @brief Defines class `bs::shell_script`.
+ *
+ * This file contains the definition of the `bs::shell_script` class,
+ * which holds a parsed script ready to be run any number of times.
+ *
+ * @date Created on 22/11/25
+ * @author Dante Doménech Martínez
+ *
+ * @copyright GNU General Public License v3.0
+ *
+ * This file is part of BashSpark.
+ * Copyright (C) 2025 Dante Doménech Martínez
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <memory>
+
+#include "BashSpark/shell/shell_alloc.h"
+#include "BashSpark/shell/shell_node.h"
+#include "BashSpark/shell/shell_profiler.h"
+
+namespace bs {
+    /**
+     * @class shell_script
+     * @brief A parsed script.
+     *
+     * Obtained from \ref bs::shell::compile "shell::compile" or
+     * \ref bs::shell::compile_file "shell::compile_file". The script owns
+     * all of its text, so it does not depend on the source it was parsed from.
+     * Running a script does not modify it, so it may be run concurrently
+     * on different sessions.
+     */
+    class shell_script {
+    public:
+        /**
+         * @brief Constructs the script.
+         * @param pRoot Root node of the script.
+         */
+        explicit shell_script(std::unique_ptr<shell_node_evaluable> pRoot)
+            : m_pRoot(std::move(pRoot)) {
+        }
+
+    public:
+        /**
+         * @brief Runs the script.
+         * @param oSession Shell session
+         * @return Status code of last executed command
+         */
+        shell_status run(shell_session &oSession) const {
+            const shell_alloc_scope oAlloc(oSession, shell_alloc_phase::SAP_CONTROL);
+            const shell_profiler::source oSource(oSession, this->m_pRoot.get());
+            return this->m_pRoot->evaluate(oSession);
+        }
+
+        /**
+         * @brief Runs the script as a coroutine.
+         *
+         * The task may be driven with \ref bs::shell_task::resume "shell_task::resume"
+         * or handed to a \ref bs::shell_scheduler "shell_scheduler". The script
+         * and the session must outlive the task. The awaited commands are not
+         * profiled, see \ref bs::shell_profiler "shell_profiler".
+         *
+         * @param oSession Shell session
+         * @return Task returning the status code of last executed command
+         */
+        [[nodiscard]] shell_task run_async(shell_session &oSession) const {
+            return this->m_pRoot->evaluate_async(oSession);
+        }
+
+        /**
+         * @brief Gets the root node of the script.
+         * @return Root node.
+         */
+        [[nodiscard]] const shell_node_evaluable *get_root() const noexcept {
+            return this->m_pRoot.get();
+        }
+
+    private:
+        /// Root node of the script
+        std::unique_ptr<shell_node_evaluable> m_pRoot;
+    };
+}
@@ -37,11 +37,17 @@
 #include "shell_vtable.h"
 #include "BashSpark/shell/shell_arg.h"
 #include "BashSpark/shell/shell_env.h"
+#include "BashSpark/shell/shell_log.h"
 #include "BashSpark/shell/shell_var.h"
+#include "BashSpark/shell/shell_records.h"
 #include "BashSpark/shell/shell_status.h"
+#include "BashSpark/shell/shell_traits.h"
 
 namespace bs {
     class shell;
+    class shell_alloc_stats;
+    class shell_profiler;
+    class shell_tracer;
 
     /**
      * @class shell_session
@@ -55,10 +61,16 @@ namespace bs {
      * and pipe-left/right sessions.
      */
     class shell_session {
+        friend class shell_tracer;
+
     public:
         /// Sell function type
         using func_type = shell_vtable::func_type;
 
+        /// Pointer sharing state among sessions, see \ref bs::shell_traits "shell_traits"
+        template<typename T>
+        using pointer_type = shell_traits::pointer<T>;
+
     public:
         /**
          * @brief Construct a new shell session with fresh env/var/arg.
@@ -74,10 +86,10 @@ namespace bs {
             std::ostream &oStdOut,
             std::ostream &oStdErr
         )
-            : m_pEnv(std::make_shared<shell_env>()),
-              m_pArg(std::make_shared<shell_arg>()),
-              m_pVar(std::make_shared<shell_var>()),
-              m_pVtable(std::make_shared<shell_vtable>()),
+            : m_pEnv(shell_traits::make<shell_env>()),
+              m_pArg(shell_traits::make<shell_arg>()),
+              m_pVar(shell_traits::make<shell_var>()),
+              m_pVtable(shell_traits::make<shell_vtable>()),
               m_nLastCommandResult(shell_status::SHELL_SUCCESS),
               m_pShell(pShell),
               m_oStdIn(oStdIn),
@@ -103,9 +115,10 @@ namespace bs {
             shell_env oEnv,
             shell_arg oArg
         )
-            : m_pEnv(std::make_shared<shell_env>(std::move(oEnv))),
-              m_pArg(std::make_shared<shell_arg>(std::move(oArg))),
-              m_pVar(std::make_shared<shell_var>()),
+            : m_pEnv(shell_traits::make<shell_env>(std::move(oEnv))),
+              m_pArg(shell_traits::make<shell_arg>(std::move(oArg))),
+              m_pVar(shell_traits::make<shell_var>()),
+              m_pVtable(shell_traits::make<shell_vtable>()),
               m_nLastCommandResult(shell_status::SHELL_SUCCESS),
               m_pShell(pBash),
               m_oStdIn(oStdIn),
@@ -197,6 +210,16 @@ namespace bs {
             return m_pVar->get_var(sVariable);
         }
 
+        /**
+         * @brief Retrieve the integer value of a local variable.
+         * @param sVariable Variable name.
+         * @param nValue Where to store the value (only set if the variable is an integer).
+         * @return Whether the variable exists and is an integer.
+         */
+        bool get_var_int(const std::string &sVariable, std::int64_t &nValue) const {
+            return m_pVar->get_var_int(sVariable, nValue);
+        }
+
         /**
          * @brief Retrieve a local variable using hop-2 resolution.
          * @param sVariable Variable name.
@@ -214,6 +237,53 @@ namespace bs {
             m_pVar->set_var(sVariable, std::move(sValue));
         }
 
+        /**
+         * @brief Set the integer value of a local variable.
+         * @param sVariable Variable name.
+         * @param nValue Assigned value.
+         */
+        void set_var_int(const std::string &sVariable, const std::int64_t nValue) {
+            m_pVar->set_var_int(sVariable, nValue);
+        }
+
+        /**
+         * @brief Append to a local variable in place.
+         * @param sVariable Variable name.
+         * @param sValue Appended value.
+         */
+        void append_var(const std::string &sVariable, const std::string_view &sValue) {
+            m_pVar->append_var(sVariable, sValue);
+        }
+
+        /**
+         * @brief Retrieve an array variable.
+         * @param sVariable Array name.
+         * @return Pointer to the array, or nullptr if not found.
+         */
+        [[nodiscard]] const shell_var_array *get_array(const std::string &sVariable) const {
+            return m_pVar->get_array(sVariable);
+        }
+
+        /**
+         * @brief Set an array variable.
+         * @param sVariable Array name.
+         * @param oArray Assigned array.
+         */
+        void set_array(const std::string &sVariable, shell_var_array oArray) {
+            m_pVar->set_array(sVariable, std::move(oArray));
+        }
+
+        /**
+         * @brief Set an element of an array variable.
+         * @param sVariable Array name.
+         * @param sKey Key or index of the element.
+         * @param sValue Assigned value.
+         * @return Whether the key is valid for the array.
+         */
+        bool set_array_item(const std::string &sVariable, const std::string &sKey, std::string sValue) {
+            return m_pVar->set_array_item(sVariable, sKey, std::move(sValue));
+        }
+
         // @section shell_arg Arguments
 
         /** @brief Get const argument list. */
@@ -248,8 +318,18 @@ namespace bs {
 
         // @section streams Streams
 
-        /** @brief Get stdin stream. */
-        [[nodiscard]] std::istream &in() const noexcept { return m_oStdIn; }
+        /**
+         * @brief Get stdin stream.
+         *
+         * Records piped into the session and not yet read are rendered as text first.
+         */
+        [[nodiscard]] std::istream &in() const {
+            if (m_pRecordsIn != nullptr) {
+                m_pRecordsText->str(m_pRecordsIn->text());
+                m_pRecordsIn = nullptr;
+            }
+            return m_oStdIn;
+        }
 
         /** @brief Get stdout stream. */
         [[nodiscard]] std::ostream &out() const noexcept { return m_oStdOut; }
@@ -257,6 +337,21 @@ namespace bs {
         /** @brief Get stderr stream. */
         [[nodiscard]] std::ostream &err() const noexcept { return m_oStdErr; }
 
+        /**
+         * @brief Replace the output streams of the session.
+         *
+         * Only the session is changed, the streams themselves are left untouched,
+         * unlike \ref make_redirection it keeps the pipes, the depth and the status.
+         * Sessions derived meanwhile write to the new streams.
+         *
+         * @param oStdOut New output stream, must outlive its use.
+         * @param oStdErr New error stream, must outlive its use.
+         */
+        void set_output(std::ostream &oStdOut, std::ostream &oStdErr) noexcept {
+            m_oStdOut = std::ref(oStdOut);
+            m_oStdErr = std::ref(oStdErr);
+        }
+
         // @section shell_status Status
 
         /**
@@ -292,16 +387,18 @@ namespace bs {
             std::ostream &oStdOut,
             std::ostream &oStdErr
         ) {
-            return std::unique_ptr<shell_session>(new shell_session(
+            auto pSession = std::unique_ptr<shell_session>(new shell_session(
                 m_pShell,
                 oStdIn,
                 oStdOut,
                 oStdErr,
-                std::make_shared<shell_env>(*m_pEnv),
+                shell_traits::make<shell_env>(*m_pEnv),
                 m_pArg,
-                std::make_shared<shell_var>(*m_pVar),
-                std::make_shared<shell_vtable>(*m_pVtable)
+                shell_traits::make<shell_var>(*m_pVar),
+                shell_traits::make<shell_vtable>(*m_pVtable)
             ));
+            this->share_instruments(*pSession);
+            return pSession;
         }
 
         /**
@@ -312,14 +409,36 @@ namespace bs {
          * @param oArg Argument list to use for the function call.
          */
         virtual std::unique_ptr<shell_session> make_function_call(shell_arg oArg) {
-            std::cout << "fcall " << m_pArg->get_arg(1) << std::endl;
-            return std::unique_ptr<shell_session>(new shell_session(
-                m_pShell, m_oStdIn, m_oStdOut, m_oStdErr,
+            BS_LOG(SLL_TRACE, SLC_SESSION, "function session with " << oArg.get_arg_size() - 1 << " args");
+            auto pSession = std::unique_ptr<shell_session>(new shell_session(
+                m_pShell, this->in(), m_oStdOut, m_oStdErr,
                 m_pEnv,
-                std::make_shared<shell_arg>(std::move(oArg)),
-                std::make_shared<shell_var>(),
+                shell_traits::make<shell_arg>(std::move(oArg)),
+                shell_traits::make<shell_var>(),
                 m_pVtable
             ));
+            this->share_instruments(*pSession);
+            return pSession;
+        }
+
+        /**
+         * @brief Create a session with redirected output.
+         *
+         * Keeps input, env, args, vars and functions but writes to the given streams.
+         *
+         * @param oStdOut New output stream.
+         * @param oStdErr New error stream.
+         */
+        virtual std::unique_ptr<shell_session> make_redirection(
+            std::ostream &oStdOut,
+            std::ostream &oStdErr
+        ) {
+            auto pSession = std::unique_ptr<shell_session>(new shell_session(
+                m_pShell, this->in(), oStdOut, oStdErr,
+                m_pEnv, m_pArg, m_pVar, m_pVtable
+            ));
+            this->share_instruments(*pSession);
+            return pSession;
         }
 
         /**
@@ -332,10 +451,12 @@ namespace bs {
         virtual std::unique_ptr<shell_session> make_pipe_left(
             std::ostringstream &oStdOut
         ) {
-            return std::unique_ptr<shell_session>(new shell_session(
-                m_pShell, m_oStdIn, oStdOut, m_oStdErr,
+            auto pSession = std::unique_ptr<shell_session>(new shell_session(
+                m_pShell, this->in(), oStdOut, m_oStdErr,
                 m_pEnv, m_pArg, m_pVar, m_pVtable
             ));
+            this->share_instruments(*pSession);
+            return pSession;
         }
 
         /**
@@ -348,7 +469,7 @@ namespace bs {
         virtual std::unique_ptr<shell_session> make_pipe_right(
             std::istringstream &oStdIn
         ) {
-            return std::unique_ptr<shell_session>(new shell_session(
+            auto pSession = std::unique_ptr<shell_session>(new shell_session(
                 m_pShell,
                 oStdIn,
                 m_oStdOut,
@@ -358,6 +479,67 @@ namespace bs {
                 m_pVar,
                 m_pVtable
             ));
+            this->share_instruments(*pSession);
+            return pSession;
+        }
+
+        // @section records Typed records
+
+        /**
+         * @brief Get the typed channel of the pipe the session writes to.
+         *
+         * Builtins whose text output are words joined by spaces may write the
+         * words to the channel instead, see \ref bs::shell_records "shell_records".
+         *
+         * @return The channel, or nullptr if records can not be written.
+         */
+        [[nodiscard]] shell_records *get_record_output() const noexcept {
+            if (m_pRecordsOut != nullptr && m_pRecordsOut->is_open())
+                return m_pRecordsOut;
+            return nullptr;
+        }
+
+        /**
+         * @brief Set the typed channel of the pipe the session writes to.
+         * @param pRecords The channel, or nullptr.
+         */
+        void set_record_output(shell_records *pRecords) noexcept {
+            m_pRecordsOut = pRecords;
+        }
+
+        /**
+         * @brief Set the records piped into the session.
+         * @param pRecords Channel holding the records, or nullptr.
+         * @param oText Input stream of the session, receives the records as text if read as text.
+         */
+        void set_record_input(shell_records *pRecords, std::istringstream &oText) noexcept {
+            m_pRecordsIn = pRecords;
+            m_pRecordsText = &oText;
+        }
+
+        /**
+         * @brief Read the whole input as words.
+         *
+         * Takes the records piped into the session if any, otherwise reads
+         * stdin and splits it on spaces, tabs and new lines.
+         *
+         * @param vRecords Where to append the words.
+         */
+        void read_records(std::vector<std::string> &vRecords) {
+            if (m_pRecordsIn != nullptr) {
+                auto vPiped = m_pRecordsIn->take();
+                m_pRecordsIn = nullptr;
+                if (vRecords.empty()) {
+                    vRecords = std::move(vPiped);
+                } else {
+                    vRecords.insert(vRecords.end(),
+                                    std::make_move_iterator(vPiped.begin()),
+                                    std::make_move_iterator(vPiped.end()));
+                }
+                return;
+            }
+            const std::string sText(std::istreambuf_iterator<char>(m_oStdIn.get()), {});
+            shell_records::split(vRecords, sText);
         }
 
         // @section vtable Function vtable
@@ -397,6 +579,72 @@ namespace bs {
             return this->m_pVtable->get_vtable_size();
         }
 
+        // @section profiler Profiler
+
+        /**
+         * @brief Gets the profiler of the session.
+         * @return The profiler, or nullptr if not profiled.
+         */
+        [[nodiscard]] shell_profiler *get_profiler() const noexcept {
+            return m_pProfiler;
+        }
+
+        /**
+         * @brief Sets the profiler of the session.
+         *
+         * Sessions made from this one share the profiler, see
+         * \ref bs::shell_profiler "shell_profiler".
+         *
+         * @param pProfiler The profiler, or nullptr to stop profiling. Must outlive its use.
+         */
+        void set_profiler(shell_profiler *pProfiler) noexcept {
+            m_pProfiler = pProfiler;
+        }
+
+        // @section alloc Allocation accounting
+
+        /**
+         * @brief Gets the allocation stats of the session.
+         * @return The stats, or nullptr if not accounted.
+         */
+        [[nodiscard]] shell_alloc_stats *get_alloc_stats() const noexcept {
+            return m_pAllocStats;
+        }
+
+        /**
+         * @brief Sets the allocation stats of the session.
+         *
+         * Sessions made from this one share the stats, see
+         * \ref bs::shell_alloc_stats "shell_alloc_stats".
+         *
+         * @param pAllocStats The stats, or nullptr to stop accounting. Must outlive its use.
+         */
+        void set_alloc_stats(shell_alloc_stats *pAllocStats) noexcept {
+            m_pAllocStats = pAllocStats;
+        }
+
+        // @section tracer Tracer
+
+        /**
+         * @brief Gets the tracer of the session.
+         * @return The tracer, or nullptr if not traced.
+         */
+        [[nodiscard]] shell_tracer *get_tracer() const noexcept {
+            return m_pTracer;
+        }
+
+        /**
+         * @brief Sets the tracer of the session.
+         *
+         * Sessions made from this one share the tracer, see
+         * \ref bs::shell_tracer "shell_tracer".
+         *
+         * @param pTracer The tracer, or nullptr to stop tracing. Must outlive its use.
+         */
+        void set_tracer(shell_tracer *pTracer) noexcept {
+            m_pTracer = pTracer;
+        }
+
        // @section depth Shell Depth
 
     public:
@@ -436,10 +684,10 @@ namespace bs {
             std::istream &oStdIn,
             std::ostream &oStdOut,
             std::ostream &oStdErr,
-            std::shared_ptr<shell_env> pEnv,
-            std::shared_ptr<shell_arg> pArg,
-            std::shared_ptr<shell_var> pVar,
-            std::shared_ptr<shell_vtable> pVtable
+            pointer_type<shell_env> pEnv,
+            pointer_type<shell_arg> pArg,
+            pointer_type<shell_var> pVar,
+            pointer_type<shell_vtable> pVtable
         )
             : m_pEnv(std::move(pEnv)),
               m_pArg(std::move(pArg)),
@@ -452,15 +700,39 @@ namespace bs {
               m_oStdErr(std::ref(oStdErr)) {
         }
 
+        /**
+         * @brief Shares the profiler, the allocation stats and the tracer with a derived session.
+         * @param oSession The derived session.
+         */
+        void share_instruments(shell_session &oSession) const noexcept {
+            oSession.m_pProfiler = m_pProfiler;
+            oSession.m_pAllocStats = m_pAllocStats;
+            oSession.m_pTracer = m_pTracer;
+        }
+
     protected:
         /// Shared environment.
-        std::shared_ptr<shell_env> m_pEnv;
+        pointer_type<shell_env> m_pEnv;
         /// Argument list.
-        std::shared_ptr<shell_arg> m_pArg;
+        pointer_type<shell_arg> m_pArg;
         /// Local variables.
-        std::shared_ptr<shell_var> m_pVar;
+        pointer_type<shell_var> m_pVar;
         /// Function vTable.
-        std::shared_ptr<shell_vtable> m_pVtable;
+        pointer_type<shell_vtable> m_pVtable;
+        /// Typed channel of the output pipe.
+        shell_records *m_pRecordsOut = nullptr;
+        /// Records piped into the session and not yet read.
+        mutable shell_records *m_pRecordsIn = nullptr;
+        /// Input stream receiving the piped records as text.
+        mutable std::istringstream *m_pRecordsText = nullptr;
+        /// Profiler, shared with the derived sessions.
+        shell_profiler *m_pProfiler = nullptr;
+        /// Allocation stats, shared with the derived sessions.
+        shell_alloc_stats *m_pAllocStats = nullptr;
+        /// Tracer, shared with the derived sessions.
+        shell_tracer *m_pTracer = nullptr;
+        /// Id of the session in the traces, 0 until traced.
+        mutable std::uint64_t m_nTraceId = 0;
         /// Last return status.
         shell_status m_nLastCommandResult;
 
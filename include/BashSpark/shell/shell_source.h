@@ -0,0 +1,152 @@
+/**
+ * @file shell_source.h
+ * @brief Defines class `bs::shell_source`.
+ *
+ * This file contains the definition of the `bs::shell_source` class, which
+ * holds the source of a script shared by the diagnostics that refer to it,
+ * and maps byte positions to lines on demand.
+ *
+ * @date Created on 22/11/25
+ * @author Dante Doménech Martínez
+ *
+ * @copyright GNU General Public License v3.0
+ *
+ * This file is part of BashSpark.
+ * Copyright (C) 2025 Dante Doménech Martínez
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace bs {
+    /**
+     * @class shell_source
+     * @brief Source of a script, shared by the diagnostics that refer to it.
+     *
+     * The source is immutable and meant to be held through a
+     * `std::shared_ptr<const shell_source>`, so that copying a diagnostic does
+     * not copy the script. The offsets of the lines are only computed the
+     * first time a position is mapped to a line, and may be computed from
+     * several threads. The text is either owned by the source or viewed in a
+     * storage the source keeps alive, such as a memory-mapped file.
+     */
+    class shell_source {
+    public:
+        /**
+         * @brief Constructs the source.
+         * @param sText Text of the script.
+         */
+        explicit shell_source(std::string sText) noexcept
+            : m_sStorage(std::move(sText)),
+              m_sText(m_sStorage) {
+        }
+
+        /**
+         * @brief Constructs the source over a text it does not own.
+         * @param sText Text of the script.
+         * @param pOwner Storage of the text, kept alive by the source.
+         */
+        shell_source(const std::string_view sText, std::shared_ptr<const void> pOwner) noexcept
+            : m_pOwner(std::move(pOwner)),
+              m_sText(sText) {
+        }
+
+        shell_source(const shell_source &) = delete;
+
+        shell_source &operator=(const shell_source &) = delete;
+
+        /**
+         * @brief Creates a shared source owning a copy of the text.
+         * @param sText Text of the script.
+         * @return The source.
+         */
+        [[nodiscard]] static std::shared_ptr<const shell_source> make(const std::string_view sText) {
+            return std::make_shared<const shell_source>(std::string(sText));
+        }
+
+        /**
+         * @brief Creates a shared source viewing a text it does not own.
+         * @param sText Text of the script, which must outlive the source.
+         * @return The source.
+         */
+        [[nodiscard]] static std::shared_ptr<const shell_source> view(const std::string_view sText) {
+            return std::make_shared<const shell_source>(sText, nullptr);
+        }
+
+    public:
+        /**
+         * @brief Gets the text of the script.
+         * @return The text.
+         */
+        [[nodiscard]] std::string_view get_text() const noexcept {
+            return this->m_sText;
+        }
+
+        /**
+         * @brief Gets the number of lines.
+         * @return The number of lines, at least 1.
+         */
+        [[nodiscard]] std::size_t get_line_count() const {
+            return this->get_lines().size();
+        }
+
+        /**
+         * @brief Gets the line of a position.
+         * @param nPos Byte position in the text.
+         * @return The line, from 0; the last line if the position is past the end.
+         */
+        [[nodiscard]] std::size_t get_line(std::size_t nPos) const;
+
+        /**
+         * @brief Gets the byte position where a line starts.
+         * @param nLine The line, from 0.
+         * @return The position.
+         */
+        [[nodiscard]] std::size_t get_line_start(std::size_t nLine) const;
+
+        /**
+         * @brief Gets the text of a line, without its line break.
+         * @param nLine The line, from 0.
+         * @return The text, which lives as long as the source.
+         */
+        [[nodiscard]] std::string_view get_line_text(std::size_t nLine) const;
+
+    private:
+        /**
+         * @brief Gets the offsets of the lines, computing them once.
+         * @return The offsets.
+         */
+        [[nodiscard]] const std::vector<std::size_t> &get_lines() const;
+
+    private:
+        /// Text of the script, if owned
+        std::string m_sStorage;
+        /// Storage of the text, if not owned
+        std::shared_ptr<const void> m_pOwner;
+        /// Text of the script
+        std::string_view m_sText;
+        /// Computes the line offsets once
+        mutable std::once_flag m_oLinesFlag;
+        /// Offset of the start of each line
+        mutable std::vector<std::size_t> m_vLines;
+    };
+}
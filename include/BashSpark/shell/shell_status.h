@@ -43,6 +43,7 @@ namespace bs {
     /**
      * @brief Shell status codes
      * @warning Defining command error codes below `bs::shell_status::SHELL_CMD_ERROR` results in undefined behaviour.
+     * @note The values are public: new codes are appended after the last one, so that existing codes keep their value.
      */
     enum class shell_status : std::uint32_t {
         // @section shell Execution Status Codes
@@ -230,6 +231,59 @@ namespace bs {
         /// Command fcall: Indicates the function was not found.
         SHELL_CMD_ERROR_FCALL_FUNCTION_NOT_FOUND,
 
+        // @section appendvar Command appendvar errors
+
+        /// Indicates an error with the number of parameters for command appendvar
+        SHELL_CMD_ERROR_APPENDVAR_PARAM_NUMBER,
+
+        /// Indicates that the variable name passed to appendvar is not valid
+        SHELL_CMD_ERROR_APPENDVAR_VARIABLE_NAME_INVALID,
+
+        // @section countloop Counted loop errors
+
+        /// Indicates a syntax error in the command, the keyword "to" is missing
+        SHELL_ERROR_SYNTAX_ERROR_MISSING_KEYWORD_TO,
+
+        /// Indicates a counted loop bound or step is not an integer.
+        SHELL_ERROR_INVALID_LOOP_BOUND,
+
+        /// Indicates a counted loop step can not reach its end value.
+        SHELL_ERROR_INVALID_LOOP_STEP,
+
+        // @section array Command setarray, setmap, setitem, readarray errors
+
+        /// Indicates an error with the number of parameters for command setarray
+        SHELL_CMD_ERROR_SETARRAY_PARAM_NUMBER,
+
+        /// Indicates that the array name passed to setarray is not valid
+        SHELL_CMD_ERROR_SETARRAY_VARIABLE_NAME_INVALID,
+
+        /// Indicates an error with the number of parameters for command setmap
+        SHELL_CMD_ERROR_SETMAP_PARAM_NUMBER,
+
+        /// Indicates that the array name passed to setmap is not valid
+        SHELL_CMD_ERROR_SETMAP_VARIABLE_NAME_INVALID,
+
+        /// Indicates an error with the number of parameters for command setitem
+        SHELL_CMD_ERROR_SETITEM_PARAM_NUMBER,
+
+        /// Indicates that the array name passed to setitem is not valid
+        SHELL_CMD_ERROR_SETITEM_VARIABLE_NAME_INVALID,
+
+        /// Indicates that the index passed to setitem is not valid for an indexed array
+        SHELL_CMD_ERROR_SETITEM_INDEX_INVALID,
+
+        /// Indicates an error with the number of parameters for command readarray
+        SHELL_CMD_ERROR_READARRAY_PARAM_NUMBER,
+
+        /// Indicates that the array name passed to readarray is not valid
+        SHELL_CMD_ERROR_READARRAY_VARIABLE_NAME_INVALID,
+
+        // @section file Script file errors
+
+        /// Indicates a script file can not be read.
+        SHELL_ERROR_FILE_NOT_READABLE,
+
         // @section userdef User defined
 
         /**
@@ -241,6 +295,11 @@ namespace bs {
 
     };
 
+    static_assert(static_cast<std::uint32_t>(shell_status::SHELL_CMD_ERROR_FCALL_FUNCTION_NOT_FOUND) == 56,
+                  "Existing status codes must keep their value");
+    static_assert(shell_status::SHELL_ERROR_FILE_NOT_READABLE < shell_status::SHELL_CMD_ERROR,
+                  "Status codes must be below the user codes");
+
     /**
      * @brief Generates status codes for user use from user codes
      * @param nCode User code
@@ -256,7 +315,8 @@ namespace bs {
      * @return If the status code represents to a syntax error true, false otherwhise
      */
     constexpr bool is_syntax_error(const shell_status nStatus) {
-        return nStatus >= shell_status::SHELL_ERROR_SYNTAX_ERROR
-               && nStatus <= shell_status::SHELL_ERROR_MAX_DEPTH_REACHED;
+        return (nStatus >= shell_status::SHELL_ERROR_SYNTAX_ERROR
+                && nStatus <= shell_status::SHELL_ERROR_MAX_DEPTH_REACHED)
+               || nStatus == shell_status::SHELL_ERROR_SYNTAX_ERROR_MISSING_KEYWORD_TO;
     }
 }
@@ -0,0 +1,430 @@
+/**
+ * @file shell_task.h
+ * @brief Defines the coroutine type of the cooperative evaluator.
+ *
+ * This file contains `bs::shell_task`, the C++20 coroutine returned by
+ * \ref bs::shell_node_evaluable::evaluate_async "shell_node_evaluable::evaluate_async",
+ * `bs::shell_yield`, the suspension point placed at command boundaries
+ * and loop back-edges, and `bs::shell_event`, awaited by asynchronous
+ * commands while their I/O completes elsewhere.
+ *
+ * Tasks start suspended. Awaiting a task runs it on the awaiting thread;
+ * nested tasks are chained with symmetric transfer, so the depth of the
+ * script does not grow the stack of the resuming thread. A suspended task
+ * resumes exactly where its innermost node yielded.
+ *
+ * @date Created on 22/11/25
+ * @author Dante Doménech Martínez
+ *
+ * @copyright GNU General Public License v3.0
+ *
+ * This file is part of BashSpark.
+ * Copyright (C) 2025 Dante Doménech Martínez
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <coroutine>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+#include "BashSpark/shell/shell_status.h"
+
+namespace bs {
+    class shell_event;
+
+    /**
+     * @class shell_task
+     * @brief A lazily started coroutine evaluating a node.
+     *
+     * The outermost task (the root) is driven with \ref shell_task::resume "resume"
+     * or \ref shell_task::get "get". Inner tasks are only awaited.
+     */
+    class shell_task {
+    public:
+        /// Clock of the time slices
+        using clock_type = std::chrono::steady_clock;
+
+        struct promise_type;
+
+        /// Coroutine handle of the task
+        using handle_type = std::coroutine_handle<promise_type>;
+
+        /**
+         * @brief Resumes the awaiting task once the task finishes.
+         */
+        struct final_awaiter {
+            /// @brief Always suspends.
+            [[nodiscard]] bool await_ready() const noexcept {
+                return false;
+            }
+
+            /**
+             * @brief Transfers to the awaiting task, if any.
+             * @param hTask The finished task.
+             * @return Handle to resume next.
+             */
+            std::coroutine_handle<> await_suspend(const handle_type hTask) const noexcept {
+                if (const auto hContinuation = hTask.promise().m_hContinuation)
+                    return hContinuation;
+                return std::noop_coroutine();
+            }
+
+            /// @brief Never resumed.
+            void await_resume() const noexcept {
+            }
+        };
+
+        /**
+         * @brief Promise of the task.
+         */
+        struct promise_type {
+            /**
+             * @brief Creates the task.
+             * @return The task.
+             */
+            shell_task get_return_object() noexcept {
+                return shell_task(handle_type::from_promise(*this));
+            }
+
+            /// @brief Tasks start suspended.
+            std::suspend_always initial_suspend() const noexcept {
+                return {};
+            }
+
+            /// @brief Resumes the awaiting task.
+            final_awaiter final_suspend() const noexcept {
+                return {};
+            }
+
+            /**
+             * @brief Stores the result.
+             * @param nStatus Status of the evaluation.
+             */
+            void return_value(const shell_status nStatus) noexcept {
+                this->m_nStatus = nStatus;
+            }
+
+            /// @brief Stores the exception, rethrown to the awaiting task.
+            void unhandled_exception() noexcept {
+                this->m_pException = std::current_exception();
+            }
+
+            /// Result of the task.
+            shell_status m_nStatus = shell_status::SHELL_SUCCESS;
+            /// Exception thrown by the task.
+            std::exception_ptr m_pException;
+            /// Task awaiting this one.
+            std::coroutine_handle<> m_hContinuation;
+            /// Promise of the outermost task.
+            promise_type *m_pRoot = this;
+            /// Innermost suspended task, only used on the root.
+            std::coroutine_handle<> m_hResume;
+            /// End of the current time slice, only used on the root.
+            clock_type::time_point m_nDeadline = clock_type::time_point::max();
+            /// Event the task is suspended on, only used on the root.
+            shell_event *m_pEvent = nullptr;
+        };
+
+        /**
+         * @brief Runs an inner task on the awaiting task.
+         */
+        struct awaiter {
+            /// @brief Always transfers to the inner task.
+            [[nodiscard]] bool await_ready() const noexcept {
+                return false;
+            }
+
+            /**
+             * @brief Links the inner task to the awaiting one and starts it.
+             * @param hParent The awaiting task.
+             * @return The inner task.
+             */
+            handle_type await_suspend(const handle_type hParent) const noexcept {
+                auto &oPromise = this->m_hTask.promise();
+                oPromise.m_hContinuation = hParent;
+                oPromise.m_pRoot = hParent.promise().m_pRoot;
+                return this->m_hTask;
+            }
+
+            /**
+             * @brief Gets the result of the inner task.
+             * @return Status of the evaluation.
+             * @throw Any exception thrown by the inner task.
+             */
+            shell_status await_resume() const {
+                auto &oPromise = this->m_hTask.promise();
+                if (oPromise.m_pException) std::rethrow_exception(oPromise.m_pException);
+                return oPromise.m_nStatus;
+            }
+
+            /// The inner task.
+            handle_type m_hTask;
+        };
+
+    public:
+        /**
+         * @brief Constructs an empty task.
+         */
+        shell_task() noexcept = default;
+
+        /**
+         * @brief Takes the ownership of another task.
+         * @param oOther Task to take, left empty.
+         */
+        shell_task(shell_task &&oOther) noexcept
+            : m_hTask(std::exchange(oOther.m_hTask, nullptr)) {
+        }
+
+        /**
+         * @brief Takes the ownership of another task.
+         * @param oOther Task to take, left empty.
+         * @return This task.
+         */
+        shell_task &operator=(shell_task &&oOther) noexcept {
+            if (this != &oOther) {
+                if (this->m_hTask) this->m_hTask.destroy();
+                this->m_hTask = std::exchange(oOther.m_hTask, nullptr);
+            }
+            return *this;
+        }
+
+        shell_task(const shell_task &) = delete;
+
+        shell_task &operator=(const shell_task &) = delete;
+
+        /**
+         * @brief Destroys the coroutine and every task it awaits.
+         */
+        ~shell_task() {
+            if (this->m_hTask) this->m_hTask.destroy();
+        }
+
+    public:
+        /**
+         * @brief Awaits the task from another task.
+         * @return Awaiter running the task.
+         */
+        awaiter operator co_await() const & noexcept {
+            return {this->m_hTask};
+        }
+
+        /**
+         * @brief Checks whether the task has finished.
+         * @return true if finished or empty.
+         */
+        [[nodiscard]] bool done() const noexcept {
+            return !this->m_hTask || this->m_hTask.done();
+        }
+
+        /**
+         * @brief Resumes the root task until it yields or finishes.
+         *
+         * Without a time slice the task only yields when finished.
+         *
+         * @param nDeadline End of the time slice.
+         * @return true if the task has finished.
+         */
+        bool resume(const clock_type::time_point nDeadline = clock_type::time_point::max()) {
+            if (this->done()) return true;
+            auto &oPromise = this->m_hTask.promise();
+            oPromise.m_nDeadline = nDeadline;
+            oPromise.m_pEvent = nullptr;
+            const auto hResume = oPromise.m_hResume ? oPromise.m_hResume : std::coroutine_handle<>(this->m_hTask);
+            oPromise.m_hResume = nullptr;
+            hResume.resume();
+            return this->done();
+        }
+
+        /**
+         * @brief Gets the event the root task is suspended on.
+         * @return The event, or nullptr if the task yielded its time slice or has finished.
+         */
+        [[nodiscard]] shell_event *get_event() const noexcept {
+            return this->done() ? nullptr : this->m_hTask.promise().m_pEvent;
+        }
+
+        /**
+         * @brief Runs the root task to completion.
+         *
+         * Blocks the calling thread while the task is suspended on an event.
+         *
+         * @return Status of the evaluation.
+         * @throw std::logic_error If the task is empty or was moved from.
+         * @throw Any exception thrown by the task.
+         */
+        shell_status get();
+
+    private:
+        /**
+         * @brief Constructs the task from its coroutine.
+         * @param hTask Coroutine handle.
+         */
+        explicit shell_task(const handle_type hTask) noexcept
+            : m_hTask(hTask) {
+        }
+
+    private:
+        /// Coroutine handle, null if empty
+        handle_type m_hTask;
+    };
+
+    /**
+     * @brief Suspension point of a task.
+     *
+     * Suspends the task only if its time slice has expired. Without a time
+     * slice it does not even read the clock.
+     */
+    struct shell_yield {
+        /// @brief Checked on suspension.
+        [[nodiscard]] bool await_ready() const noexcept {
+            return false;
+        }
+
+        /**
+         * @brief Suspends the task if its time slice has expired.
+         * @param hTask The yielding task.
+         * @return true to suspend.
+         */
+        bool await_suspend(const shell_task::handle_type hTask) const noexcept {
+            const auto pRoot = hTask.promise().m_pRoot;
+            if (pRoot->m_nDeadline == shell_task::clock_type::time_point::max()
+                || shell_task::clock_type::now() < pRoot->m_nDeadline)
+                return false;
+            pRoot->m_hResume = hTask;
+            return true;
+        }
+
+        /// @brief Nothing to return.
+        void await_resume() const noexcept {
+        }
+    };
+
+    /**
+     * @class shell_event
+     * @brief One-shot event awaited by tasks.
+     *
+     * The event is set once, usually from the thread completing the I/O.
+     * Awaiting an event already set does not suspend. Several tasks may await
+     * the same event, all of them are woken when it is set. The event must outlive
+     * the call to \ref set, it is safe to destroy it once the awaiting task
+     * has resumed.
+     */
+    class shell_event {
+    public:
+        /**
+         * @brief Constructs an unset event.
+         */
+        shell_event() = default;
+
+        shell_event(const shell_event &) = delete;
+
+        shell_event &operator=(const shell_event &) = delete;
+
+    public:
+        /**
+         * @brief Sets the event and wakes the awaiting tasks.
+         */
+        void set() {
+            std::vector<std::function<void()>> vWakers;
+            {
+                std::lock_guard oLock(this->m_oMutex);
+                this->m_bSet = true;
+                vWakers = std::move(this->m_vWakers);
+                this->m_oSignal.notify_all();
+            }
+            for (const auto &fWake: vWakers) fWake();
+        }
+
+        /**
+         * @brief Checks whether the event is set.
+         * @return true if set.
+         */
+        [[nodiscard]] bool is_set() const {
+            std::lock_guard oLock(this->m_oMutex);
+            return this->m_bSet;
+        }
+
+        /**
+         * @brief Blocks the calling thread until the event is set.
+         */
+        void wait() const {
+            std::unique_lock oLock(this->m_oMutex);
+            this->m_oSignal.wait(oLock, [this] { return this->m_bSet; });
+        }
+
+        /**
+         * @brief Registers a function resuming an awaiting task.
+         *
+         * Used by \ref bs::shell_scheduler "shell_scheduler".
+         *
+         * @param fWake Function called once the event is set.
+         * @return false if the event is already set, in which case the function is not kept.
+         */
+        bool set_waker(std::function<void()> fWake) {
+            std::lock_guard oLock(this->m_oMutex);
+            if (this->m_bSet) return false;
+            this->m_vWakers.push_back(std::move(fWake));
+            return true;
+        }
+
+    public:
+        /// @brief Does not suspend if already set.
+        [[nodiscard]] bool await_ready() const {
+            return this->is_set();
+        }
+
+        /**
+         * @brief Suspends the task until the event is set.
+         * @param hTask The awaiting task.
+         */
+        void await_suspend(const shell_task::handle_type hTask) noexcept {
+            const auto pRoot = hTask.promise().m_pRoot;
+            pRoot->m_hResume = hTask;
+            pRoot->m_pEvent = this;
+        }
+
+        /// @brief Nothing to return.
+        void await_resume() const noexcept {
+        }
+
+    private:
+        /// Guards the state
+        mutable std::mutex m_oMutex;
+        /// Signals the blocked threads
+        mutable std::condition_variable m_oSignal;
+        /// Whether the event is set
+        bool m_bSet = false;
+        /// Resume the awaiting tasks, one per task
+        std::vector<std::function<void()>> m_vWakers;
+    };
+
+    inline shell_status shell_task::get() {
+        if (!this->m_hTask) throw std::logic_error("Getting the status of an empty task");
+        while (!this->resume()) {
+            if (const auto pEvent = this->get_event()) pEvent->wait();
+        }
+        auto &oPromise = this->m_hTask.promise();
+        if (oPromise.m_pException) std::rethrow_exception(oPromise.m_pException);
+        return oPromise.m_nStatus;
+    }
+}
@@ -29,8 +29,10 @@
 
 #pragma once
 
+#include <memory>
 #include <vector>
 
+#include "BashSpark/shell/shell_source.h"
 #include "BashSpark/tools/fakestream.h"
 
 namespace bs {
@@ -96,25 +98,31 @@ namespace bs {
         /**
          * @brief Tokenizes input from the standard input stream.
          * @param oStdIn The input fake stream to read commands from.
+         * @param pSource The source read by the stream, shared by the syntax errors.
          * @return A vector of shell_token instances representing the parsed tokens.
          * @throw shell_exception If a syntax error is detected
          *
          * This method reads from the provided input stream and generates
          * tokens until the end of the input is reached.
          */
-        static std::vector<shell_token> tokens(ifakestream &oStdIn);
+        static std::vector<shell_token> tokens(
+            ifakestream &oStdIn,
+            const std::shared_ptr<const shell_source> &pSource
+        );
 
     private:
         /**
            * @brief Helper method for tokenizing based on a specified delimiter.
            * @param vTokens The vector to store the parsed tokens.
            * @param oStdIn The input stream to read commands from.
+           * @param pSource The source read by the stream.
            * @param cDelimiter The delimiter to use for token separation or '\0' for no delimiter
            * @throw shell_exception If a syntax error is detected
            */
         static void tokens(
             std::vector<shell_token> &vTokens,
             ifakestream &oStdIn,
+            const std::shared_ptr<const shell_source> &pSource,
             char cDelimiter
         );
 
@@ -122,43 +130,81 @@ namespace bs {
          * @brief Handles tokenization for dollar sign usage.
          * @param vTokens The vector to store the parsed tokens.
          * @param oStdIn The input stream to read commands from.
+         * @param pSource The source read by the stream.
          * @throw shell_exception If a syntax error is detected
          *
          * This method specifically processes tokens that contain
          * dollar sign syntax, such as variable references.
          */
-        static void tokens_dollar(std::vector<shell_token> &vTokens, ifakestream &oStdIn);
+        static void tokens_dollar(
+            std::vector<shell_token> &vTokens,
+            ifakestream &oStdIn,
+            const std::shared_ptr<const shell_source> &pSource
+        );
 
         /**
          * @brief Tokenizes variables prefixed by a dollar sign.
          * @param vTokens The vector to store the parsed tokens.
          * @param oStdIn The input stream to read commands from.
+         * @param pSource The source read by the stream.
+         * @throw shell_exception If a syntax error is detected
+         */
+        static void tokens_dollar_variable(
+            std::vector<shell_token> &vTokens,
+            ifakestream &oStdIn,
+            const std::shared_ptr<const shell_source> &pSource
+        );
+
+        /**
+         * @brief Tokenizes the subscript of an array variable (e.g. `[i]` in `${a[i]}`).
+         * @param vTokens The vector to store the parsed tokens.
+         * @param oStdIn The input stream to read commands from.
+         * @param pSource The source read by the stream.
          * @throw shell_exception If a syntax error is detected
          */
-        static void tokens_dollar_variable(std::vector<shell_token> &vTokens, ifakestream &oStdIn);
+        static void tokens_dollar_subscript(
+            std::vector<shell_token> &vTokens,
+            ifakestream &oStdIn,
+            const std::shared_ptr<const shell_source> &pSource
+        );
 
         /**
          * @brief Tokenizes single-quoted strings in input.
          * @param vTokens The vector to store the parsed tokens.
          * @param oStdIn The input stream to read commands from.
+         * @param pSource The source read by the stream.
          * @throw shell_exception If a syntax error is detected
          */
-        static void tokens_quote_simple(std::vector<shell_token> &vTokens, ifakestream &oStdIn);
+        static void tokens_quote_simple(
+            std::vector<shell_token> &vTokens,
+            ifakestream &oStdIn,
+            const std::shared_ptr<const shell_source> &pSource
+        );
 
         /**
          * @brief Tokenizes double-quoted strings in input.
          * @param vTokens The vector to store the parsed tokens.
          * @param oStdIn The input stream to read commands from.
+         * @param pSource The source read by the stream.
          * @throw shell_exception If a syntax error is detected
          */
-        static void tokens_quote_double(std::vector<shell_token> &vTokens, ifakestream &oStdIn);
+        static void tokens_quote_double(
+            std::vector<shell_token> &vTokens,
+            ifakestream &oStdIn,
+            const std::shared_ptr<const shell_source> &pSource
+        );
 
         /**
          * @brief Handles tokenization for backslash-escaped characters.
          * @param vTokens The vector to store the parsed tokens.
          * @param oStdIn The input stream to read commands from.
+         * @param pSource The source read by the stream.
          * @throw shell_exception If a syntax error is detected
          */
-        static void tokens_backslash(std::vector<shell_token> &vTokens, ifakestream &oStdIn);
+        static void tokens_backslash(
+            std::vector<shell_token> &vTokens,
+            ifakestream &oStdIn,
+            const std::shared_ptr<const shell_source> &pSource
+        );
     };
 }
@@ -0,0 +1,289 @@
+/**
+ * @file shell_tracer.h
+ * @brief Defines class `bs::shell_tracer`.
+ *
+ * This file contains the definition of the `bs::shell_tracer` class, which
+ * records begin and end events of the execution of scripts into per-thread
+ * ring buffers and writes them as Chrome trace-event JSON, readable by
+ * `chrome://tracing` and Perfetto.
+ *
+ * @date Created on 22/11/25
+ * @author Dante Doménech Martínez
+ *
+ * @copyright GNU General Public License v3.0
+ *
+ * This file is part of BashSpark.
+ * Copyright (C) 2025 Dante Doménech Martínez
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#include "BashSpark/shell/shell_session.h"
+
+namespace bs {
+    /**
+     * @brief Kind of a traced event.
+     */
+    enum class shell_trace_category : std::uint8_t {
+        /// Parsing a script.
+        STC_PARSE = 0,
+        /// Resolving and running a command.
+        STC_COMMAND,
+        /// Running a command substitution.
+        STC_SUBSTITUTION,
+        /// Running a side of a pipe.
+        STC_PIPE,
+        /// Running a function called with `fcall`.
+        STC_FUNCTION,
+        /// Running a job of a batch.
+        STC_JOB,
+    };
+
+    /**
+     * @class shell_tracer
+     * @brief Records a timeline of the execution of scripts.
+     *
+     * Attach the tracer to a session with
+     * \ref bs::shell_session::set_tracer "shell_session::set_tracer", or to
+     * the jobs of a batch with \ref bs::shell_job::m_pTracer "shell_job::m_pTracer".
+     * The sessions derived from it (pipes, subshells, function calls,
+     * substitutions) share the tracer. Without a tracer, the cost is a null
+     * pointer check per event.
+     *
+     * Each thread writes its events to its own ring buffer without locking;
+     * once full, the oldest events are overwritten. Each session gets an id on
+     * its first event. The coroutine evaluation writes asynchronous events,
+     * see \ref begin_async, since its tasks interleave on their threads.
+     *
+     * The events must be written, see \ref write_json, or cleared while no
+     * traced script runs.
+     */
+    class shell_tracer {
+    public:
+        /// Clock of the events
+        using clock_type = std::chrono::steady_clock;
+
+        /// Default number of events kept per thread
+        constexpr static std::size_t DEFAULT_CAPACITY = 16384;
+
+        /// Maximum length of an event name, longer names are truncated
+        constexpr static std::size_t NAME_SIZE = 46;
+
+        /**
+         * @struct event
+         * @brief A begin or end event.
+         */
+        struct event {
+            /// Time of the event.
+            clock_type::time_point m_nTime;
+            /// Id of the session.
+            std::uint64_t m_nSession;
+            /// Name of the event, truncated.
+            std::array<char, NAME_SIZE> m_sName;
+            /// Length of the name.
+            std::uint8_t m_nNameSize;
+            /// Kind of the event.
+            shell_trace_category m_nCategory;
+            /// `B` for begin, `E` for end, `b` and `e` for asynchronous begin and end.
+            char m_cPhase;
+
+            /**
+             * @brief Gets the name of the event.
+             * @return The name.
+             */
+            [[nodiscard]] std::string_view get_name() const noexcept {
+                return {this->m_sName.data(), this->m_nNameSize};
+            }
+        };
+
+        /**
+         * @class scope
+         * @brief Traces a begin event and its end event while alive.
+         *
+         * Does nothing if the session has no tracer.
+         */
+        class scope {
+        public:
+            /**
+             * @brief Writes the begin event.
+             * @param oSession Session of the event.
+             * @param nCategory Kind of the event.
+             * @param sName Name of the event, must outlive the scope.
+             */
+            scope(const shell_session &oSession, const shell_trace_category nCategory, const std::string_view sName)
+                : m_pTracer(oSession.get_tracer()),
+                  m_oSession(oSession),
+                  m_nCategory(nCategory),
+                  m_sName(sName) {
+                if (this->m_pTracer != nullptr) this->m_pTracer->record(oSession, nCategory, sName, 'B');
+            }
+
+            /**
+             * @brief Writes the end event.
+             */
+            ~scope() {
+                if (this->m_pTracer != nullptr)
+                    this->m_pTracer->record(this->m_oSession, this->m_nCategory, this->m_sName, 'E');
+            }
+
+            scope(const scope &) = delete;
+
+            scope &operator=(const scope &) = delete;
+
+        private:
+            shell_tracer *m_pTracer; ///< The tracer, nullptr if disabled.
+            const shell_session &m_oSession; ///< Session of the event.
+            shell_trace_category m_nCategory; ///< Kind of the event.
+            std::string_view m_sName; ///< Name of the event.
+        };
+
+    public:
+        /**
+         * @brief Constructs the tracer.
+         * @param nCapacity Number of events kept per thread.
+         */
+        explicit shell_tracer(std::size_t nCapacity = DEFAULT_CAPACITY);
+
+        shell_tracer(const shell_tracer &) = delete;
+
+        shell_tracer &operator=(const shell_tracer &) = delete;
+
+    public:
+        /**
+         * @brief Records an event of the calling thread.
+         * @param oSession Session of the event.
+         * @param nCategory Kind of the event.
+         * @param sName Name of the event.
+         * @param cPhase `B` for begin, `E` for end.
+         */
+        void record(const shell_session &oSession, shell_trace_category nCategory, std::string_view sName, char cPhase);
+
+        /**
+         * @brief Writes an asynchronous begin event.
+         *
+         * A \ref scope can not be held across a suspension of a coroutine,
+         * since the tasks suspended on a thread resume in any order. The
+         * asynchronous events are matched by session instead of nesting on
+         * their thread. Does nothing if the session has no tracer.
+         *
+         * @param oSession Session of the event.
+         * @param nCategory Kind of the event.
+         * @param sName Name of the event.
+         */
+        static void begin_async(
+            const shell_session &oSession,
+            const shell_trace_category nCategory,
+            const std::string_view sName
+        ) {
+            if (const auto pTracer = oSession.get_tracer(); pTracer != nullptr)
+                pTracer->record(oSession, nCategory, sName, 'b');
+        }
+
+        /**
+         * @brief Writes an asynchronous end event, see \ref begin_async.
+         * @param oSession Session of the event.
+         * @param nCategory Kind of the event.
+         * @param sName Name of the event.
+         */
+        static void end_async(
+            const shell_session &oSession,
+            const shell_trace_category nCategory,
+            const std::string_view sName
+        ) {
+            if (const auto pTracer = oSession.get_tracer(); pTracer != nullptr)
+                pTracer->record(oSession, nCategory, sName, 'e');
+        }
+
+        /**
+         * @brief Gets the events kept, by thread.
+         * @return The events of each thread that recorded any, oldest first.
+         */
+        [[nodiscard]] std::vector<std::vector<event> > get_events() const;
+
+        /**
+         * @brief Gets the number of events overwritten because a buffer was full.
+         * @return The number of events lost.
+         */
+        [[nodiscard]] std::uint64_t get_dropped() const;
+
+        /**
+         * @brief Removes the events kept.
+         */
+        void clear();
+
+        /**
+         * @brief Writes the events as Chrome trace-event JSON.
+         *
+         * Times are in microseconds since the construction of the tracer.
+         * Threads are numbered in order of their first event and each event
+         * carries the id of its session in its arguments.
+         *
+         * @param oOut Output stream.
+         */
+        void write_json(std::ostream &oOut) const;
+
+    private:
+        /**
+         * @brief Events of a thread.
+         */
+        struct thread_buffer {
+            std::thread::id m_oThread; ///< Writing thread.
+            std::size_t m_nIndex; ///< Number of the thread in the trace.
+            std::unique_ptr<event[]> m_vEvents; ///< Ring of events.
+            std::atomic<std::uint64_t> m_nWritten{0}; ///< Events written since the last clear.
+        };
+
+        /**
+         * @brief Gets the buffer of the calling thread, creating it if needed.
+         * @return The buffer.
+         */
+        thread_buffer &get_buffer();
+
+        /**
+         * @brief Gets the id of a session, assigning it if needed.
+         * @param oSession The session.
+         * @return The id.
+         */
+        std::uint64_t get_session_id(const shell_session &oSession);
+
+    private:
+        /// Unique id of the tracer, buffers of the calling thread are cached by it
+        std::uint64_t m_nId;
+        /// Number of events kept per thread
+        std::size_t m_nCapacity;
+        /// Time of the construction
+        clock_type::time_point m_nStart;
+        /// Last session id given
+        std::atomic<std::uint64_t> m_nSessions{0};
+        /// Guards the list of buffers
+        mutable std::mutex m_oMutex;
+        /// Buffers of the threads
+        std::vector<std::unique_ptr<thread_buffer> > m_vBuffers;
+    };
+}
@@ -0,0 +1,96 @@
+/**
+ * @file shell_traits.h
+ * @brief Defines the compile-time policies of the shell.
+ *
+ * This file contains the policies selecting how the shell sessions share
+ * their state. The multithreaded policy (default) uses `std::shared_ptr`,
+ * while the single-threaded policy uses `bs::local_ptr`, whose reference
+ * count is not atomic, and disables the features that spawn threads.
+ *
+ * The single-threaded policy is selected by defining `BS_SINGLE_THREADED`
+ * (CMake option `BASHSPARK_SINGLE_THREADED`). The whole project and the code
+ * using it must be built with the same policy.
+ *
+ * @date Created on 22/11/25
+ * @author Dante Doménech Martínez
+ *
+ * @copyright GNU General Public License v3.0
+ *
+ * This file is part of BashSpark.
+ * Copyright (C) 2025 Dante Doménech Martínez
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <memory>
+
+#include "BashSpark/tools/local_ptr.h"
+
+namespace bs {
+    /**
+     * @brief Shell policy allowing sessions to be used from several threads.
+     */
+    struct shell_traits_mt {
+        /// Whether sessions may be shared among threads
+        constexpr static bool THREAD_SAFE = true;
+
+        /// Pointer sharing session state
+        template<typename T>
+        using pointer = std::shared_ptr<T>;
+
+        /**
+         * @brief Constructs shared session state.
+         * @tparam T The type of the state.
+         * @param args Arguments forwarded to the state constructor.
+         * @return Pointer owning the new state.
+         */
+        template<typename T, typename... Args>
+        static pointer<T> make(Args &&... args) {
+            return std::make_shared<T>(std::forward<Args>(args)...);
+        }
+    };
+
+    /**
+     * @brief Shell policy for sessions used from a single thread.
+     */
+    struct shell_traits_st {
+        /// Whether sessions may be shared among threads
+        constexpr static bool THREAD_SAFE = false;
+
+        /// Pointer sharing session state
+        template<typename T>
+        using pointer = local_ptr<T>;
+
+        /**
+         * @brief Constructs shared session state.
+         * @tparam T The type of the state.
+         * @param args Arguments forwarded to the state constructor.
+         * @return Pointer owning the new state.
+         */
+        template<typename T, typename... Args>
+        static pointer<T> make(Args &&... args) {
+            return make_local<T>(std::forward<Args>(args)...);
+        }
+    };
+
+#ifdef BS_SINGLE_THREADED
+    /// Policy the shell is built with
+    using shell_traits = shell_traits_st;
+#else
+    /// Policy the shell is built with
+    using shell_traits = shell_traits_mt;
+#endif
+}
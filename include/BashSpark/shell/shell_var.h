@@ -28,11 +28,212 @@
 
 #pragma once
 
+#include <cstdint>
+#include <map>
 #include <string>
+#include <string_view>
+#include <vector>
 
+#include "BashSpark/tools/shell_def.h"
 #include "BashSpark/tools/shell_hash.h"
 
 namespace bs {
+    /**
+     * @class shell_var_value
+     * @brief Value of a local variable with a cached integer form.
+     *
+     * The value is stored as text, as any shell value. Numeric reads parse it once
+     * and cache the integer; integer assignments only produce the text when it is read.
+     * Both forms are kept coherent on every assignment.
+     */
+    class shell_var_value {
+    public:
+        /// Default constructor, empty text.
+        shell_var_value() = default;
+
+        /**
+         * @brief Constructs a text value.
+         * @param sValue Text of the value.
+         */
+        explicit shell_var_value(std::string sValue)
+            : m_sValue(std::move(sValue)),
+              m_nKind(value_kind::VK_UNKNOWN) {
+        }
+
+        /**
+         * @brief Constructs an integer value.
+         * @param nValue Integer of the value.
+         */
+        explicit shell_var_value(const std::int64_t nValue)
+            : m_nValue(nValue),
+              m_nKind(value_kind::VK_INTEGER),
+              m_bText(false) {
+        }
+
+    public:
+        /**
+         * @brief Gets the text of the value.
+         * @return Reference to the text of the value.
+         */
+        [[nodiscard]] const std::string &str() const {
+            if (!this->m_bText) {
+                this->m_sValue = std::to_string(this->m_nValue);
+                this->m_bText = true;
+            }
+            return this->m_sValue;
+        }
+
+        /**
+         * @brief Gets the integer form of the value.
+         * @param nValue Where to store the integer (only set if the value is an integer).
+         * @return Whether the value is an integer.
+         */
+        bool get_int(std::int64_t &nValue) const {
+            if (this->m_nKind == value_kind::VK_UNKNOWN) {
+                this->m_nKind = parse_number(this->m_sValue, this->m_nValue)
+                                    ? value_kind::VK_INTEGER
+                                    : value_kind::VK_TEXT;
+            }
+            if (this->m_nKind != value_kind::VK_INTEGER) return false;
+            nValue = this->m_nValue;
+            return true;
+        }
+
+        /**
+         * @brief Appends text to the value in place.
+         * @param sValue Text to append.
+         */
+        void append(const std::string_view &sValue) {
+            static_cast<void>(this->str());
+            this->m_sValue.append(sValue);
+            this->m_nKind = value_kind::VK_UNKNOWN;
+        }
+
+    private:
+        /// Integer state of the value
+        enum class value_kind : std::uint8_t {
+            VK_TEXT, ///< Known not to be an integer.
+            VK_INTEGER, ///< Integer cached.
+            VK_UNKNOWN, ///< Not parsed yet.
+        };
+
+        mutable std::string m_sValue; ///< Text form, valid if m_bText.
+        mutable std::int64_t m_nValue = 0; ///< Integer form, valid if m_nKind is VK_INTEGER.
+        mutable value_kind m_nKind = value_kind::VK_TEXT; ///< Integer state.
+        mutable bool m_bText = true; ///< Whether the text form is up to date.
+    };
+
+    /**
+     * @class shell_var_array
+     * @brief Value of an array variable, either indexed or associative.
+     *
+     * Indexed arrays are dense and hold their elements in a vector, associative arrays
+     * hold them in a map sorted by key, so that `${!a[@]}` lists the keys in a stable
+     * order. Element access does not split any string.
+     */
+    class shell_var_array {
+    public:
+        /**
+         * @brief Constructs an empty array.
+         * @param bAssociative Whether the array is associative.
+         */
+        explicit shell_var_array(const bool bAssociative = false)
+            : m_bAssociative(bAssociative) {
+        }
+
+    public:
+        /**
+         * @brief Checks whether the array is associative.
+         * @return True if the array is associative, false if it is indexed.
+         */
+        [[nodiscard]] bool is_associative() const noexcept {
+            return this->m_bAssociative;
+        }
+
+        /**
+         * @brief Gets the number of elements.
+         * @return The number of elements.
+         */
+        [[nodiscard]] std::size_t size() const noexcept {
+            return this->m_bAssociative ? this->m_mValues.size() : this->m_vValues.size();
+        }
+
+        /**
+         * @brief Retrieves an element.
+         *
+         * Indexed arrays accept integer keys, negative keys count from the end.
+         *
+         * @param sKey Key or index of the element.
+         * @return Pointer to the element, or nullptr if not found.
+         */
+        [[nodiscard]] const std::string *get(const std::string &sKey) const {
+            if (this->m_bAssociative) {
+                const auto pIter = this->m_mValues.find(sKey);
+                return pIter != this->m_mValues.end() ? &pIter->second : nullptr;
+            }
+            std::int64_t nIndex;
+            if (!parse_number(sKey, nIndex)) return nullptr;
+            const auto nSize = static_cast<std::int64_t>(this->m_vValues.size());
+            if (nIndex < 0) nIndex += nSize;
+            if (nIndex < 0 || nIndex >= nSize) return nullptr;
+            return &this->m_vValues[nIndex];
+        }
+
+        /**
+         * @brief Sets an element.
+         *
+         * Indexed arrays are dense: the index must refer to an existing element,
+         * or be equal to the size to append a new one.
+         *
+         * @param sKey Key or index of the element.
+         * @param sValue Value to set.
+         * @return Whether the key is valid.
+         */
+        bool set(const std::string &sKey, std::string sValue) {
+            if (this->m_bAssociative) {
+                this->m_mValues.insert_or_assign(sKey, std::move(sValue));
+                return true;
+            }
+            std::int64_t nIndex;
+            if (!parse_number(sKey, nIndex)) return false;
+            const auto nSize = static_cast<std::int64_t>(this->m_vValues.size());
+            if (nIndex < 0) nIndex += nSize;
+            if (nIndex < 0 || nIndex > nSize) return false;
+            if (nIndex == nSize) this->m_vValues.push_back(std::move(sValue));
+            else this->m_vValues[nIndex] = std::move(sValue);
+            return true;
+        }
+
+        /**
+         * @brief Appends an element to an indexed array.
+         * @param sValue Value to append.
+         */
+        void push(std::string sValue) {
+            this->m_vValues.push_back(std::move(sValue));
+        }
+
+        /**
+         * @brief Gets the elements of an indexed array.
+         * @return A const reference to the elements.
+         */
+        [[nodiscard]] const std::vector<std::string> &get_values() const noexcept {
+            return this->m_vValues;
+        }
+
+        /**
+         * @brief Gets the elements of an associative array.
+         * @return A const reference to the map of elements.
+         */
+        [[nodiscard]] const std::map<std::string, std::string> &get_map() const noexcept {
+            return this->m_mValues;
+        }
+
+    private:
+        std::vector<std::string> m_vValues; ///< Elements of an indexed array.
+        std::map<std::string, std::string> m_mValues; ///< Elements of an associative array.
+        bool m_bAssociative; ///< Whether the array is associative.
+    };
+
     /**
      * @class shell_var
      * @brief Represents a variable map for shell commands.
@@ -52,7 +253,21 @@ namespace bs {
          */
         [[nodiscard]] std::string get_var(const std::string &sVar) const {
             const auto pIter = this->m_mVariables.find(sVar);
-            return pIter != this->m_mVariables.end() ? pIter->second : "";
+            return pIter != this->m_mVariables.end() ? pIter->second.str() : "";
+        }
+
+        /**
+         * @brief Retrieves the integer value of a variable.
+         *
+         * The text is parsed only once, later reads use the cached integer.
+         *
+         * @param sVar The name of the variable.
+         * @param nValue Where to store the value (only set if the variable is an integer).
+         * @return Whether the variable exists and is an integer.
+         */
+        bool get_var_int(const std::string &sVar, std::int64_t &nValue) const {
+            const auto pIter = this->m_mVariables.find(sVar);
+            return pIter != this->m_mVariables.end() && pIter->second.get_int(nValue);
         }
 
         /**
@@ -64,8 +279,8 @@ namespace bs {
         [[nodiscard]] std::string get_var_hop2(const std::string &sVar) const {
             const auto pIter1 = this->m_mVariables.find(sVar);
             if (pIter1 == this->m_mVariables.end()) return "";
-            const auto pIter2 = this->m_mVariables.find(pIter1->second);
-            return pIter2 != this->m_mVariables.end() ? pIter2->second : "";
+            const auto pIter2 = this->m_mVariables.find(pIter1->second.str());
+            return pIter2 != this->m_mVariables.end() ? pIter2->second.str() : "";
         }
 
         /**
@@ -74,7 +289,37 @@ namespace bs {
          * @param sValue The value to be set.
          */
         void set_var(std::string sVar, std::string sValue) {
-            this->m_mVariables.insert_or_assign(std::move(sVar), std::move(sValue));
+            this->m_mVariables.insert_or_assign(std::move(sVar), shell_var_value(std::move(sValue)));
+        }
+
+        /**
+         * @brief Sets the integer value of a variable.
+         *
+         * The text form is only produced if the variable is read as text.
+         *
+         * @param sVar The name of the variable.
+         * @param nValue The value to be set.
+         */
+        void set_var_int(std::string sVar, const std::int64_t nValue) {
+            this->m_mVariables.insert_or_assign(std::move(sVar), shell_var_value(nValue));
+        }
+
+        /**
+         * @brief Appends to the value of a variable in place.
+         *
+         * If the variable does not exist, creates it. The value grows geometrically,
+         * so accumulating a value with repeated appends takes linear time.
+         *
+         * @param sVar The name of the variable.
+         * @param sValue The value to be appended.
+         */
+        void append_var(const std::string &sVar, const std::string_view &sValue) {
+            const auto pIter = this->m_mVariables.find(sVar);
+            if (pIter == this->m_mVariables.end()) {
+                this->m_mVariables.emplace(sVar, shell_var_value(std::string(sValue)));
+            } else {
+                pIter->second.append(sValue);
+            }
         }
 
         /**
@@ -95,16 +340,75 @@ namespace bs {
         }
 
         /**
-         * @brief Retrieves all variables.
+         * @brief Retrieves all variables as text.
+         *
+         * Builds the map from the stored values, prefer \ref get_var_values to avoid the copy.
+         *
+         * @return The map of variables.
+         */
+        [[nodiscard]] std::unordered_map<std::string, std::string, shell_hash> get_var() const {
+            std::unordered_map<std::string, std::string, shell_hash> mVariables(this->m_mVariables.bucket_count());
+            for (const auto &[sVar, oValue]: this->m_mVariables) mVariables.emplace(sVar, oValue.str());
+            return mVariables;
+        }
+
+        /**
+         * @brief Retrieves all variables with their cached integer form.
          * @return A const reference to the map of variables.
          */
-        [[nodiscard]] const std::unordered_map<std::string, std::string, shell_hash> &get_var() const noexcept {
+        [[nodiscard]] const std::unordered_map<std::string, shell_var_value, shell_hash> &get_var_values() const noexcept {
             return this->m_mVariables;
         }
 
+        /**
+         * @brief Retrieves an array variable.
+         * @param sVar The name of the array.
+         * @return Pointer to the array, or nullptr if not found.
+         */
+        [[nodiscard]] const shell_var_array *get_array(const std::string &sVar) const {
+            const auto pIter = this->m_mArrays.find(sVar);
+            return pIter != this->m_mArrays.end() ? &pIter->second : nullptr;
+        }
+
+        /**
+         * @brief Sets an array variable, replacing any previous array.
+         * @param sVar The name of the array.
+         * @param oArray The array to be set.
+         */
+        void set_array(std::string sVar, shell_var_array oArray) {
+            this->m_mArrays.insert_or_assign(std::move(sVar), std::move(oArray));
+        }
+
+        /**
+         * @brief Sets an element of an array variable.
+         *
+         * If the array does not exist, creates an indexed array.
+         *
+         * @param sVar The name of the array.
+         * @param sKey Key or index of the element.
+         * @param sValue The value to be set.
+         * @return Whether the key is valid for the array.
+         */
+        bool set_array_item(const std::string &sVar, const std::string &sKey, std::string sValue) {
+            const auto [pIter, bInserted] = this->m_mArrays.try_emplace(sVar);
+            if (pIter->second.set(sKey, std::move(sValue))) return true;
+            if (bInserted) this->m_mArrays.erase(pIter);
+            return false;
+        }
+
+        /**
+         * @brief Retrieves all array variables.
+         * @return A const reference to the map of arrays.
+         */
+        [[nodiscard]] const std::unordered_map<std::string, shell_var_array, shell_hash> &get_arrays() const noexcept {
+            return this->m_mArrays;
+        }
+
     private:
         /// Map to store variables.
-        std::unordered_map<std::string, std::string, shell_hash> m_mVariables;
+        std::unordered_map<std::string, shell_var_value, shell_hash> m_mVariables;
+        /// Map to store array variables.
+        std::unordered_map<std::string, shell_var_array, shell_hash> m_mArrays;
 
     };
 } // namespace bs
@@ -0,0 +1,295 @@
+/**
+ * @file static_shell.h
+ * @brief Defines the `bs::static_shell` template with a compile-time builtin table.
+ *
+ * This header file provides the declaration of the `bs::static_shell` class
+ * template. The builtin commands are given as template parameters and are
+ * stored by value inside the shell. Their names are hashed at compile time
+ * with \ref bs::hash(std::string_view) "bs::hash", so resolving a builtin
+ * needs neither heap allocations at construction nor a hash table lookup.
+ * User registered commands are still resolved through the dynamic table.
+ *
+ * @date Created on 22/11/25
+ * @author Dante Doménech Martínez
+ *
+ * @copyright GNU General Public License v3.0
+ *
+ * This file is part of BashSpark.
+ * Copyright (C) 2025 Dante Doménech Martínez
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <memory>
+#include <span>
+#include <stdexcept>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#include "BashSpark/shell.h"
+#include "BashSpark/command/command_env.h"
+#include "BashSpark/command/command_fcall.h"
+#include "BashSpark/command/command_math.h"
+#include "BashSpark/command/command_seq.h"
+#include "BashSpark/command/command_test.h"
+#include "BashSpark/command/command_var.h"
+#include "BashSpark/shell/shell_alloc.h"
+#include "BashSpark/tools/hash.h"
+
+namespace bs {
+    /**
+     * @class static_shell
+     * @brief A shell whose builtin commands are fixed at compile time.
+     *
+     * Every command type must derive from \ref bs::command "command", be default
+     * constructible and expose its name as `constexpr static std::string_view NAME`.
+     * The builtins are resolved by comparing the runtime hash of the command name
+     * against the compile-time hashes of the builtin names; the name is compared
+     * only on a hash match. Commands not found among the builtins are searched
+     * in the dynamic table, so \ref bs::shell::set_command "set_command" keeps working.
+     * The evaluation runs the builtins through \ref bs::shell::run_builtin "run_builtin",
+     * which calls the \ref bs::command::run "run" of their type on a hash match,
+     * without virtual dispatch. The coroutine evaluation and the runs recorded
+     * in the metrics still look the builtins up and call them virtually.
+     *
+     * Builtins can not be replaced: setting a command with the name of a builtin
+     * throws, so \ref bs::shell::remove_command "remove_command" never finds one
+     * and returns nullptr, and \ref bs::shell::erase_command "erase_command" leaves it.
+     *
+     * @tparam CommandT Builtin command types.
+     */
+    template<typename... CommandT>
+    class static_shell : public shell {
+        static_assert((std::is_base_of_v<command, CommandT> && ...),
+                      "Template static_shell only takes command derived classes.");
+
+    public:
+        /// Number of builtin commands
+        constexpr static std::size_t BUILTIN_COUNT = sizeof...(CommandT);
+
+        /// Compile-time hashes of the builtin command names
+        constexpr static std::array<std::uint64_t, BUILTIN_COUNT> BUILTIN_HASHES{hash(CommandT::NAME)...};
+
+        /// Default size for the user command hash table
+        constexpr static std::size_t DEFAULT_USER_COMMAND_HASH_TABLE_SIZE = 16;
+
+    private:
+        /**
+         * @brief Checks that no two builtin names share a hash.
+         * @return true if all hashes are distinct; false otherwise.
+         */
+        constexpr static bool has_distinct_hashes() {
+            for (std::size_t i = 0; i < BUILTIN_COUNT; ++i) {
+                for (std::size_t j = i + 1; j < BUILTIN_COUNT; ++j) {
+                    if (BUILTIN_HASHES[i] == BUILTIN_HASHES[j]) return false;
+                }
+            }
+            return true;
+        }
+
+        static_assert(has_distinct_hashes(), "Builtin command names must be unique.");
+
+    public:
+        /**
+         * @brief Construct bash object
+         */
+        static_shell()
+            : shell(DEFAULT_USER_COMMAND_HASH_TABLE_SIZE, &static_shell::find_builtin_of, &static_shell::run_builtin_of) {
+        }
+
+    public:
+        using shell::set_command;
+
+        /**
+          * @brief Sets a user command. Overwrites previous user command.
+          * @param pCommand Unique pointer to the command.
+          * @throw std::invalid_argument If the name of the command is the name of a builtin.
+          */
+        void set_command(std::unique_ptr<command> &&pCommand) override {
+            if (this->get_builtin(pCommand->get_name_ref()) != nullptr)
+                throw std::invalid_argument("Builtin command can not be replaced: " + pCommand->get_name_ref());
+            shell::set_command(std::move(pCommand));
+        }
+
+        /**
+          * @brief Retrieves the commands of the shell.
+          *
+          * Builtins come first, user registered commands hidden by them are skipped.
+          *
+          * @return Pointers to the commands.
+          */
+        [[nodiscard]] std::vector<const command *> get_commands() const override {
+            std::vector<const command *> vCommands;
+            std::apply([&vCommands](const CommandT &... oBuiltin) {
+                (vCommands.push_back(&oBuiltin), ...);
+            }, this->m_tBuiltins);
+            for (const auto pCommand: shell::get_commands()) {
+                if (this->get_builtin(pCommand->get_name_ref()) == nullptr)
+                    vCommands.push_back(pCommand);
+            }
+            return vCommands;
+        }
+
+        /**
+          * @brief Retrieves a builtin command pointer by its string.
+          * @param sCommand The command string.
+          * @return Pointer to the builtin command, or nullptr if not a builtin.
+          */
+        [[nodiscard]] const command *get_builtin(const std::string_view sCommand) const noexcept {
+            return this->find_builtin(hash(sCommand), sCommand, std::index_sequence_for<CommandT...>{});
+        }
+
+        /**
+          * @brief Retrieves a builtin command by its type.
+          * @tparam CommandU The builtin command type.
+          * @return Reference to the builtin command.
+          */
+        template<typename CommandU>
+        [[nodiscard]] const CommandU &get_builtin() const noexcept {
+            return std::get<CommandU>(this->m_tBuiltins);
+        }
+
+    private:
+        /**
+         * @brief Retrieves a builtin of a static shell, used by \ref bs::shell::get_command "get_command".
+         * @param oShell The static shell.
+         * @param sCommand The command string.
+         * @return Pointer to the builtin command, or nullptr if not a builtin.
+         */
+        [[nodiscard]] static const command *find_builtin_of(
+            const shell &oShell,
+            const std::string_view sCommand
+        ) noexcept {
+            return static_cast<const static_shell &>(oShell).get_builtin(sCommand);
+        }
+
+        /**
+         * @brief Searches the builtin whose name matches.
+         * @tparam I Builtin indices.
+         * @param nHash Hash of the command string.
+         * @param sCommand The command string.
+         * @return Pointer to the builtin command, or nullptr if not a builtin.
+         */
+        template<std::size_t... I>
+        [[nodiscard]] const command *find_builtin(
+            const std::uint64_t nHash,
+            const std::string_view sCommand,
+            std::index_sequence<I...>
+        ) const noexcept {
+            const command *pCommand = nullptr;
+            static_cast<void>((
+                (nHash == BUILTIN_HASHES[I] && sCommand == CommandT::NAME
+                 && (pCommand = &std::get<I>(this->m_tBuiltins), true))
+                || ...
+            ));
+            return pCommand;
+        }
+
+        /**
+         * @brief Runs a builtin of a static shell, used by \ref bs::shell::run_builtin "run_builtin".
+         * @param oShell The static shell.
+         * @param sCommand The command string.
+         * @param vArgs Arguments for the command.
+         * @param oSession The shell session context.
+         * @param nStatus Set to the status of the command if it is a builtin.
+         * @return true if the command is a builtin; false otherwise.
+         */
+        static bool run_builtin_of(
+            const shell &oShell,
+            const std::string_view sCommand,
+            const std::span<const std::string> vArgs,
+            shell_session &oSession,
+            shell_status &nStatus
+        ) {
+            return static_cast<const static_shell &>(oShell).call_builtin(
+                hash(sCommand), sCommand, vArgs, oSession, nStatus, std::index_sequence_for<CommandT...>{}
+            );
+        }
+
+        /**
+         * @brief Runs the builtin whose name matches.
+         * @tparam I Builtin indices.
+         * @param nHash Hash of the command string.
+         * @param sCommand The command string.
+         * @param vArgs Arguments for the command.
+         * @param oSession The shell session context.
+         * @param nStatus Set to the status of the command if it is a builtin.
+         * @return true if the command is a builtin; false otherwise.
+         */
+        template<std::size_t... I>
+        bool call_builtin(
+            const std::uint64_t nHash,
+            const std::string_view sCommand,
+            const std::span<const std::string> vArgs,
+            shell_session &oSession,
+            shell_status &nStatus,
+            std::index_sequence<I...>
+        ) const {
+            return (
+                (nHash == BUILTIN_HASHES[I] && sCommand == CommandT::NAME
+                 && (nStatus = run_typed(std::get<I>(this->m_tBuiltins), vArgs, oSession), true))
+                || ...
+            );
+        }
+
+        /**
+         * @brief Runs a builtin through its type.
+         * @tparam CommandU The builtin command type.
+         * @param oCommand The builtin command.
+         * @param vArgs Arguments for the command.
+         * @param oSession The shell session context.
+         * @return Status of command execution.
+         */
+        template<typename CommandU>
+        static shell_status run_typed(
+            const CommandU &oCommand,
+            const std::span<const std::string> vArgs,
+            shell_session &oSession
+        ) {
+            const shell_alloc_scope oAlloc(oSession, shell_alloc_phase::SAP_COMMAND);
+            // The builtin is stored by value, so its type is its dynamic type
+            return oCommand.CommandU::run(vArgs, oSession);
+        }
+
+    private:
+        /// Builtin commands, stored by value
+        std::tuple<CommandT...> m_tBuiltins;
+    };
+
+    /**
+     * @brief Static shell with the same commands as \ref bs::shell::make_default_shell "make_default_shell".
+     */
+    using default_static_shell = static_shell<
+        command_echo,
+        command_eval,
+        command_getenv,
+        command_getvar,
+        command_setenv,
+        command_setvar,
+        command_appendvar,
+        command_setarray,
+        command_setmap,
+        command_setitem,
+        command_readarray,
+        command_seq,
+        command_test,
+        command_math,
+        command_fcall
+    >;
+}
@@ -0,0 +1,203 @@
+/**
+ * @file capturestream.h
+ * @brief Provides an output stream capturing its contents into a string.
+ *
+ * This header file defines an output stream that writes directly into the
+ * spare capacity of a growable string. Once the writer has finished, the
+ * string can be moved out of the stream without copying it, unlike
+ * `std::ostringstream::str()`.
+ *
+ * @author Dante Doménech Martínez
+ * @date 22/11/25
+ *
+ * @copyright MIT License
+ *
+ * This file is part of BashSpark.
+ * Copyright (c) 2025 Dante Doménech Martínez
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <climits>
+#include <ostream>
+#include <streambuf>
+#include <string>
+#include <string_view>
+
+namespace bs {
+    /**
+     * @brief A stream buffer writing into a growable string.
+     *
+     * The put area is the whole string, which is grown geometrically when full.
+     *
+     * @tparam char_t The character type.
+     * @tparam traits_t The traits type for the character type.
+     */
+    template<typename char_t, typename traits_t>
+    class basic_capturebuffer : public std::basic_streambuf<char_t, traits_t> {
+    public:
+        /// Character type of the buffer.
+        using char_type = std::basic_streambuf<char_t, traits_t>::char_type;
+        /// Character traits of the buffer.
+        using traits_type = std::basic_streambuf<char_t, traits_t>::traits_type;
+        /// Integer type representing characters.
+        using int_type = std::basic_streambuf<char_t, traits_t>::int_type;
+        /// String receiving the output.
+        using string_type = std::basic_string<char_t, traits_t>;
+
+        /// Initial size of the string.
+        static constexpr std::size_t DEFAULT_BUFFER_SIZE = 256;
+
+    public:
+        /**
+         * @brief Gets a view of the output written so far.
+         * @return View of the output.
+         */
+        [[nodiscard]] std::basic_string_view<char_t, traits_t> view() const noexcept {
+            return {this->pbase(), this->used()};
+        }
+
+        /**
+         * @brief Moves the output out of the buffer and empties it.
+         * @return The output.
+         */
+        [[nodiscard]] string_type take() {
+            this->m_sData.resize(this->used());
+            this->setp(nullptr, nullptr);
+            return std::move(this->m_sData);
+        }
+
+    protected:
+        /**
+         * @brief Grows the string and writes a character.
+         * @param nChar Character to write.
+         * @return The character.
+         */
+        int_type overflow(const int_type nChar) override {
+            if (traits_type::eq_int_type(nChar, traits_type::eof()))
+                return traits_type::not_eof(nChar);
+            this->grow(1);
+            *this->pptr() = traits_type::to_char_type(nChar);
+            this->advance(1);
+            return nChar;
+        }
+
+        /**
+         * @brief Writes a number of characters.
+         * @param s Pointer to the characters.
+         * @param n The number of characters.
+         * @return The number of characters written.
+         */
+        std::streamsize xsputn(const char_t *s, const std::streamsize n) override {
+            const auto nLength = static_cast<std::size_t>(n);
+            if (static_cast<std::size_t>(this->epptr() - this->pptr()) < nLength)
+                this->grow(nLength);
+            traits_type::copy(this->pptr(), s, nLength);
+            this->advance(nLength);
+            return n;
+        }
+
+    private:
+        /**
+         * @brief Gets the number of characters written.
+         * @return Number of characters written.
+         */
+        [[nodiscard]] std::size_t used() const noexcept {
+            return static_cast<std::size_t>(this->pptr() - this->pbase());
+        }
+
+        /**
+         * @brief Grows the string to fit more characters.
+         * @param nExtra Number of characters to fit.
+         */
+        void grow(const std::size_t nExtra) {
+            const std::size_t nUsed = this->used();
+            this->m_sData.resize(std::max({DEFAULT_BUFFER_SIZE, 2 * this->m_sData.size(), nUsed + nExtra}));
+            this->setp(this->m_sData.data(), this->m_sData.data() + this->m_sData.size());
+            this->advance(nUsed);
+        }
+
+        /**
+         * @brief Advances the put pointer, pbump only takes int.
+         * @param nCount Number of characters.
+         */
+        void advance(std::size_t nCount) {
+            while (nCount > 0) {
+                const auto nStep = std::min<std::size_t>(nCount, INT_MAX);
+                this->pbump(static_cast<int>(nStep));
+                nCount -= nStep;
+            }
+        }
+
+    private:
+        string_type m_sData; ///< String holding the output and its spare capacity.
+    };
+
+    /**
+     * @brief An output stream capturing its output into a string.
+     *
+     * @tparam char_t The character type.
+     * @tparam traits_t The traits type for the character type.
+     */
+    template<typename char_t, typename traits_t>
+    class basic_ocapturestream : public std::basic_ostream<char_t, traits_t> {
+    public:
+        /// String receiving the output.
+        using string_type = std::basic_string<char_t, traits_t>;
+
+    public:
+        /**
+         * @brief Constructs the stream.
+         */
+        basic_ocapturestream()
+            : std::basic_ostream<char_t, traits_t>(nullptr) {
+            this->rdbuf(&this->m_oBuffer);
+        }
+
+    public:
+        /**
+         * @brief Gets a view of the output written so far.
+         * @return View of the output.
+         */
+        [[nodiscard]] std::basic_string_view<char_t, traits_t> view() const noexcept {
+            return this->m_oBuffer.view();
+        }
+
+        /**
+         * @brief Moves the output out of the stream and empties it.
+         * @return The output.
+         */
+        [[nodiscard]] string_type take() {
+            return this->m_oBuffer.take();
+        }
+
+    private:
+        basic_capturebuffer<char_t, traits_t> m_oBuffer; ///< The buffer holding the output.
+    };
+
+    /**
+     * @section usings Type definitions for simple streams
+     */
+
+    /// Type alias for a capture output stream using char type.
+    using ocapturestream = basic_ocapturestream<char, std::char_traits<char> >;
+}
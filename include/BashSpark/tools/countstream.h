@@ -0,0 +1,137 @@
+/**
+ * @file countstream.h
+ * @brief Provides a stream buffer counting the characters written through it.
+ *
+ * This header file defines a stream buffer that forwards its output to
+ * another stream buffer and counts the characters written. It is meant to be
+ * installed temporarily on an existing stream with `rdbuf`.
+ *
+ * @author Dante Doménech Martínez
+ * @date 22/11/25
+ *
+ * @copyright MIT License
+ *
+ * This file is part of BashSpark.
+ * Copyright (c) 2025 Dante Doménech Martínez
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <ios>
+#include <streambuf>
+#include <string>
+
+namespace bs {
+    /**
+     * @brief A stream buffer forwarding to another one and counting the characters written.
+     *
+     * It holds no buffer, each write is forwarded at once, so the order of the
+     * output and the flushes of the target are kept.
+     *
+     * @tparam char_t The character type.
+     * @tparam traits_t The traits type for the character type.
+     */
+    template<typename char_t, typename traits_t>
+    class basic_countbuffer : public std::basic_streambuf<char_t, traits_t> {
+    public:
+        /// Character type of the buffer.
+        using char_type = std::basic_streambuf<char_t, traits_t>::char_type;
+        /// Character traits of the buffer.
+        using traits_type = std::basic_streambuf<char_t, traits_t>::traits_type;
+        /// Integer type representing characters.
+        using int_type = std::basic_streambuf<char_t, traits_t>::int_type;
+
+    public:
+        /**
+         * @brief Constructs the buffer.
+         * @param pTarget Stream buffer receiving the output, nullptr to discard it.
+         */
+        explicit basic_countbuffer(std::basic_streambuf<char_t, traits_t> *pTarget) noexcept
+            : m_pTarget(pTarget) {
+        }
+
+    public:
+        /**
+         * @brief Gets the number of characters written.
+         * @return Number of characters accepted by the target.
+         */
+        [[nodiscard]] std::size_t count() const noexcept {
+            return this->m_nCount;
+        }
+
+        /**
+         * @brief Gets the target buffer.
+         * @return Stream buffer receiving the output.
+         */
+        [[nodiscard]] std::basic_streambuf<char_t, traits_t> *target() const noexcept {
+            return this->m_pTarget;
+        }
+
+    protected:
+        /**
+         * @brief Writes a character.
+         * @param nChar Character to write.
+         * @return The character, or eof on failure.
+         */
+        int_type overflow(const int_type nChar) override {
+            if (traits_type::eq_int_type(nChar, traits_type::eof()))
+                return traits_type::not_eof(nChar);
+            if (this->m_pTarget == nullptr) return traits_type::eof();
+            const auto nResult = this->m_pTarget->sputc(traits_type::to_char_type(nChar));
+            if (!traits_type::eq_int_type(nResult, traits_type::eof())) ++this->m_nCount;
+            return nResult;
+        }
+
+        /**
+         * @brief Writes a number of characters.
+         * @param s Pointer to the characters.
+         * @param n The number of characters.
+         * @return The number of characters written.
+         */
+        std::streamsize xsputn(const char_t *s, const std::streamsize n) override {
+            if (this->m_pTarget == nullptr) return 0;
+            const auto nWritten = this->m_pTarget->sputn(s, n);
+            this->m_nCount += static_cast<std::size_t>(nWritten);
+            return nWritten;
+        }
+
+        /**
+         * @brief Flushes the target.
+         * @return 0 on success, -1 on failure.
+         */
+        int sync() override {
+            if (this->m_pTarget == nullptr) return -1;
+            return this->m_pTarget->pubsync();
+        }
+
+    private:
+        std::basic_streambuf<char_t, traits_t> *m_pTarget; ///< Buffer receiving the output.
+        std::size_t m_nCount = 0; ///< Characters written.
+    };
+
+    /**
+     * @section usings Type definitions for simple streams
+     */
+
+    /// Type alias for a counting stream buffer using char type.
+    using countbuffer = basic_countbuffer<char, std::char_traits<char> >;
+}
@@ -0,0 +1,251 @@
+/**
+ * @file local_ptr.h
+ * @brief Provides a shared pointer with a non-atomic reference count.
+ *
+ * This header file defines `local_ptr`, a reference counted owning pointer
+ * meant for objects that never leave the thread that created them. The
+ * count and the object share a single allocation and the count is updated
+ * with plain increments, avoiding the atomic operations of `std::shared_ptr`.
+ *
+ * @author Dante Doménech Martínez
+ * @date 22/11/25
+ *
+ * @copyright MIT License
+ *
+ * This file is part of BashSpark.
+ * Copyright (c) 2025 Dante Doménech Martínez
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <type_traits>
+#include <utility>
+
+namespace bs {
+    template<typename T>
+    class local_ptr;
+
+    template<typename T, typename... Args>
+    local_ptr<T> make_local(Args &&... args);
+
+    /**
+     * @brief A shared pointer with a non-atomic reference count.
+     *
+     * Copies share ownership of the object; the object is destroyed when the
+     * last copy is destroyed. Copies must not be used from different threads.
+     * A pointer to `const T` may share the object of a pointer to `T`.
+     *
+     * @tparam T The type of the owned object.
+     */
+    template<typename T>
+    class local_ptr {
+        template<typename U>
+        friend class local_ptr;
+
+        template<typename U, typename... Args>
+        friend local_ptr<U> make_local(Args &&... args);
+
+    private:
+        /**
+         * @brief Allocation holding the count and the object.
+         */
+        struct control_block {
+            /**
+             * @brief Constructs the object with a count of one.
+             * @param args Arguments forwarded to the object constructor.
+             */
+            template<typename... Args>
+            explicit control_block(Args &&... args)
+                : m_oValue(std::forward<Args>(args)...) {
+            }
+
+            std::size_t m_nCount = 1; ///< Number of owners.
+            T m_oValue; ///< The owned object.
+        };
+
+        /// Allocation of the object, the same for the pointers to `T` and to `const T`.
+        using block_type = typename local_ptr<std::remove_const_t<T> >::control_block;
+
+    public:
+        /// Type of the owned object.
+        using element_type = T;
+
+    public:
+        /**
+         * @brief Constructs an empty pointer.
+         */
+        local_ptr() noexcept = default;
+
+        /**
+         * @brief Constructs an empty pointer.
+         */
+        local_ptr(std::nullptr_t) noexcept {
+        }
+
+        /**
+         * @brief Shares the ownership of another pointer.
+         * @param pOther Pointer to share.
+         */
+        local_ptr(const local_ptr &pOther) noexcept
+            : m_pControl(pOther.m_pControl) {
+            if (this->m_pControl) ++this->m_pControl->m_nCount;
+        }
+
+        /**
+         * @brief Takes the ownership of another pointer.
+         * @param pOther Pointer to take, left empty.
+         */
+        local_ptr(local_ptr &&pOther) noexcept
+            : m_pControl(std::exchange(pOther.m_pControl, nullptr)) {
+        }
+
+        /**
+         * @brief Shares the ownership of a pointer to the non-const object.
+         * @param pOther Pointer to share.
+         */
+        template<typename U>
+            requires std::is_same_v<T, const U>
+        local_ptr(const local_ptr<U> &pOther) noexcept
+            : m_pControl(pOther.m_pControl) {
+            if (this->m_pControl) ++this->m_pControl->m_nCount;
+        }
+
+        /**
+         * @brief Takes the ownership of a pointer to the non-const object.
+         * @param pOther Pointer to take, left empty.
+         */
+        template<typename U>
+            requires std::is_same_v<T, const U>
+        local_ptr(local_ptr<U> &&pOther) noexcept
+            : m_pControl(std::exchange(pOther.m_pControl, nullptr)) {
+        }
+
+        /**
+         * @brief Releases the ownership.
+         */
+        ~local_ptr() {
+            this->release();
+        }
+
+    public:
+        /**
+         * @brief Shares the ownership of another pointer.
+         * @param pOther Pointer to share.
+         * @return This pointer.
+         */
+        local_ptr &operator=(const local_ptr &pOther) noexcept {
+            // Read before releasing, pOther may be this pointer
+            const auto pControl = pOther.m_pControl;
+            if (pControl) ++pControl->m_nCount;
+            this->release();
+            this->m_pControl = pControl;
+            return *this;
+        }
+
+        /**
+         * @brief Takes the ownership of another pointer.
+         * @param pOther Pointer to take, left empty.
+         * @return This pointer.
+         */
+        local_ptr &operator=(local_ptr &&pOther) noexcept {
+            if (this != &pOther) {
+                this->release();
+                this->m_pControl = std::exchange(pOther.m_pControl, nullptr);
+            }
+            return *this;
+        }
+
+    public:
+        /**
+         * @brief Releases the ownership, leaving the pointer empty.
+         */
+        void reset() noexcept {
+            this->release();
+        }
+
+        /**
+         * @brief Gets the owned object.
+         * @return Pointer to the object, or nullptr if empty.
+         */
+        [[nodiscard]] T *get() const noexcept {
+            return this->m_pControl ? &this->m_pControl->m_oValue : nullptr;
+        }
+
+        /**
+         * @brief Gets the number of owners.
+         * @return Number of owners, 0 if empty.
+         */
+        [[nodiscard]] std::size_t use_count() const noexcept {
+            return this->m_pControl ? this->m_pControl->m_nCount : 0;
+        }
+
+        /**
+         * @brief Dereferences the pointer.
+         * @return Reference to the object.
+         */
+        T &operator*() const noexcept {
+            return this->m_pControl->m_oValue;
+        }
+
+        /**
+         * @brief Accesses the object members.
+         * @return Pointer to the object.
+         */
+        T *operator->() const noexcept {
+            return &this->m_pControl->m_oValue;
+        }
+
+        /**
+         * @brief Checks whether the pointer owns an object.
+         * @return true if not empty.
+         */
+        explicit operator bool() const noexcept {
+            return this->m_pControl != nullptr;
+        }
+
+    private:
+        /**
+         * @brief Drops the ownership, destroying the object if last owner.
+         */
+        void release() noexcept {
+            if (this->m_pControl && --this->m_pControl->m_nCount == 0)
+                delete this->m_pControl;
+            this->m_pControl = nullptr;
+        }
+
+    private:
+        block_type *m_pControl = nullptr; ///< Shared allocation, nullptr if empty.
+    };
+
+    /**
+     * @brief Constructs an object owned by a local_ptr.
+     * @tparam T The type of the object.
+     * @param args Arguments forwarded to the object constructor.
+     * @return Pointer owning the new object.
+     */
+    template<typename T, typename... Args>
+    local_ptr<T> make_local(Args &&... args) {
+        local_ptr<T> pResult;
+        pResult.m_pControl = new typename local_ptr<T>::block_type(std::forward<Args>(args)...);
+        return pResult;
+    }
+}
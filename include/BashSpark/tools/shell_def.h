@@ -28,6 +28,7 @@
 
 #pragma once
 
+#include <cstdint>
 #include <string>
 
 namespace bs {
@@ -163,4 +164,34 @@ namespace bs {
         }
         return true;
     }
+
+    /**
+     * @brief Validates and parses a number in a single pass.
+     *
+     * Accepts the same representations as `bs::is_number`, except a lone sign.
+     *
+     * @param sArg A string view representing the input string to be parsed.
+     * @param nValue Where to store the parsed value (only set on success).
+     * @return True if the string is a valid number representation, false otherwise.
+     */
+    constexpr bool parse_number(const std::string_view &sArg, std::int64_t &nValue) {
+        if (sArg.empty())return false;
+        std::size_t i = 0;
+        bool bNegative = false;
+        if (sArg[0] == '+' || sArg[0] == '-') {
+            if (sArg.length() == 1 || sArg.length() > 19)return false;
+            bNegative = sArg[0] == '-';
+            ++i;
+        } else {
+            if (sArg.length() > 18)return false;
+        }
+        std::int64_t nResult = 0;
+        while (i < sArg.length()) {
+            if (sArg[i] < '0' || sArg[i] > '9') return false;
+            nResult = nResult * 10 + (sArg[i] - '0');
+            ++i;
+        }
+        nValue = bNegative ? -nResult : nResult;
+        return true;
+    }
 }
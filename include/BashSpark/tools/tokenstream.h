@@ -0,0 +1,267 @@
+/**
+ * @file tokenstream.h
+ * @brief Provides an output stream that splits its contents into a bounded token queue.
+ *
+ * This header file defines a bounded blocking queue of tokens and an output
+ * stream that splits everything written to it on whitespace, pushing every
+ * complete token into the queue as soon as it is delimited.
+ *
+ * The classes are designed to connect a producer running on a worker thread
+ * with a consumer that processes the tokens as they appear — for example,
+ * a `for` loop consuming the output of a command substitution. The queue
+ * capacity bounds the memory used regardless of the producer output size.
+ *
+ * @author Dante Doménech Martínez
+ * @date 21/11/25
+ *
+ * @copyright MIT License
+ *
+ * This file is part of BashSpark.
+ * Copyright (c) 2025 Dante Doménech Martínez
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <ostream>
+#include <streambuf>
+#include <string>
+
+namespace bs {
+    /**
+     * @brief A bounded blocking queue of tokens.
+     *
+     * Producers block on push while the queue is full and consumers block on
+     * pop while it is empty. Closing the queue wakes everybody: pending pushes
+     * fail and pops drain the remaining tokens before failing.
+     *
+     * @tparam char_t The character type.
+     * @tparam traits_t The traits type for the character type.
+     */
+    template<typename char_t, typename traits_t>
+    class basic_token_queue {
+    public:
+        /// Token type stored in the queue.
+        using string_type = std::basic_string<char_t, traits_t>;
+
+    public:
+        /**
+         * @brief Constructs an empty queue.
+         * @param nCapacity Maximum number of tokens held at once (at least 1).
+         */
+        explicit basic_token_queue(const std::size_t nCapacity)
+            : m_nCapacity(nCapacity == 0 ? 1 : nCapacity) {
+        }
+
+    public:
+        /**
+         * @brief Pushes a token, blocking while the queue is full.
+         * @param sToken Token to push (moved in).
+         * @return false if the queue has been closed, true otherwise.
+         */
+        bool push(string_type &&sToken) {
+            std::unique_lock oLock(this->m_oMutex);
+            this->m_oNotFull.wait(oLock, [this] {
+                return this->m_bClosed || this->m_vTokens.size() < this->m_nCapacity;
+            });
+            if (this->m_bClosed) return false;
+            this->m_vTokens.push_back(std::move(sToken));
+            oLock.unlock();
+            this->m_oNotEmpty.notify_one();
+            return true;
+        }
+
+        /**
+         * @brief Pops a token, blocking while the queue is empty and open.
+         * @param sToken Where to store the popped token.
+         * @return false if the queue is closed and drained, true otherwise.
+         */
+        bool pop(string_type &sToken) {
+            std::unique_lock oLock(this->m_oMutex);
+            this->m_oNotEmpty.wait(oLock, [this] {
+                return this->m_bClosed || !this->m_vTokens.empty();
+            });
+            if (this->m_vTokens.empty()) return false;
+            sToken = std::move(this->m_vTokens.front());
+            this->m_vTokens.pop_front();
+            oLock.unlock();
+            this->m_oNotFull.notify_one();
+            return true;
+        }
+
+        /**
+         * @brief Closes the queue and wakes up every waiting thread.
+         */
+        void close() {
+            {
+                std::lock_guard oLock(this->m_oMutex);
+                this->m_bClosed = true;
+            }
+            this->m_oNotFull.notify_all();
+            this->m_oNotEmpty.notify_all();
+        }
+
+    private:
+        std::mutex m_oMutex; ///< Protects the queue state.
+        std::condition_variable m_oNotFull; ///< Signaled when room is available.
+        std::condition_variable m_oNotEmpty; ///< Signaled when a token is available.
+        std::deque<string_type> m_vTokens; ///< Pending tokens.
+        std::size_t m_nCapacity; ///< Maximum number of pending tokens.
+        bool m_bClosed = false; ///< Whether the queue has been closed.
+    };
+
+    /**
+     * @brief A stream buffer that splits its output into tokens.
+     *
+     * Tokens are delimited by spaces, tabs and new lines, matching the word
+     * splitting of command substitution. Every complete token is pushed to the
+     * queue; if the queue has been closed writing fails.
+     *
+     * @tparam char_t The character type.
+     * @tparam traits_t The traits type for the character type.
+     */
+    template<typename char_t, typename traits_t>
+    class basic_tokenbuffer : public std::basic_streambuf<char_t, traits_t> {
+    public:
+        /// Character type of the buffer.
+        using char_type = std::basic_streambuf<char_t, traits_t>::char_type;
+        /// Character traits of the buffer.
+        using traits_type = std::basic_streambuf<char_t, traits_t>::traits_type;
+        /// Integer type representing characters.
+        using int_type = std::basic_streambuf<char_t, traits_t>::int_type;
+        /// Queue receiving the tokens.
+        using queue_type = basic_token_queue<char_t, traits_t>;
+
+    public:
+        /**
+         * @brief Constructs the buffer.
+         * @param oQueue Queue receiving the tokens.
+         */
+        explicit basic_tokenbuffer(queue_type &oQueue)
+            : m_oQueue(oQueue) {
+        }
+
+    public:
+        /**
+         * @brief Pushes the pending token, if any.
+         * @return false if the queue has been closed, true otherwise.
+         */
+        bool finish() {
+            if (this->m_sToken.empty()) return true;
+            return this->m_oQueue.push(std::move(this->m_sToken));
+        }
+
+    protected:
+        /**
+         * @brief Processes a single character.
+         * @param nChar Character to process.
+         * @return The character, or eof if the queue has been closed.
+         */
+        int_type overflow(const int_type nChar) override {
+            if (traits_type::eq_int_type(nChar, traits_type::eof()))
+                return traits_type::not_eof(nChar);
+            return this->put(traits_type::to_char_type(nChar))
+                       ? nChar
+                       : traits_type::eof();
+        }
+
+        /**
+         * @brief Processes a number of characters.
+         * @param s Pointer to the characters.
+         * @param n The number of characters.
+         * @return The number of characters processed.
+         */
+        std::streamsize xsputn(const char_t *s, const std::streamsize n) override {
+            for (std::streamsize i = 0; i < n; ++i) {
+                if (!this->put(s[i])) return i;
+            }
+            return n;
+        }
+
+    private:
+        /**
+         * @brief Appends a character to the token or delimits it.
+         * @param cChar Character to process.
+         * @return false if the queue has been closed, true otherwise.
+         */
+        bool put(const char_t cChar) {
+            if (cChar == ' ' || cChar == '\n' || cChar == '\t') {
+                return this->finish();
+            }
+            this->m_sToken.push_back(cChar);
+            return true;
+        }
+
+    private:
+        queue_type &m_oQueue; ///< Queue receiving the tokens.
+        queue_type::string_type m_sToken; ///< Token being built.
+    };
+
+    /**
+     * @brief An output stream that splits its output into a token queue.
+     *
+     * @tparam char_t The character type.
+     * @tparam traits_t The traits type for the character type.
+     */
+    template<typename char_t, typename traits_t>
+    class basic_otokenstream : public std::basic_ostream<char_t, traits_t> {
+    public:
+        /// Queue receiving the tokens.
+        using queue_type = basic_token_queue<char_t, traits_t>;
+
+    public:
+        /**
+         * @brief Constructs the stream.
+         * @param oQueue Queue receiving the tokens.
+         */
+        explicit basic_otokenstream(queue_type &oQueue)
+            : std::basic_ostream<char_t, traits_t>(nullptr),
+              m_oBuffer(oQueue) {
+            this->rdbuf(&this->m_oBuffer);
+        }
+
+    public:
+        /**
+         * @brief Pushes the pending token, if any.
+         *
+         * Must be called once the producer has finished writing.
+         *
+         * @return false if the queue has been closed, true otherwise.
+         */
+        bool finish() {
+            return this->m_oBuffer.finish();
+        }
+
+    private:
+        basic_tokenbuffer<char_t, traits_t> m_oBuffer; ///< The buffer splitting the output.
+    };
+
+    /**
+     * @section usings Type definitions for simple streams
+     */
+
+    /// Type alias for a token queue using char type.
+    using token_queue = basic_token_queue<char, std::char_traits<char> >;
+    /// Type alias for a token output stream using char type.
+    using otokenstream = basic_otokenstream<char, std::char_traits<char> >;
+}
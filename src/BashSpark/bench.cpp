@@ -0,0 +1,170 @@
+/**
+ * @file bench.cpp
+ * @brief Main file for launching the shell benchmark collection.
+ *
+ * @date Created on 22/11/25
+ * @author Dante Doménech Martínez
+ *
+ * @copyright GNU General Public License v3.0
+ *
+ * This file is part of BashSpark.
+ * Copyright (C) 2025 Dante Doménech Martínez
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <cmath>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "BashSpark/bench/bench_corpus.h"
+#include "BashSpark/bench/bench_shell.h"
+
+using namespace bs;
+
+namespace {
+    /**
+     * @brief Prints the usage.
+     * @param sProgram Program name
+     * @return Error status code
+     */
+    int usage(const std::string_view sProgram) {
+        std::cerr << "Usage: " << sProgram << " [--json] [filter]" << '\n'
+                << "       " << sProgram << " --corpus [--out file] [filter]" << '\n'
+                << "       " << sProgram << " --compare base current [threshold]" << std::endl;
+        return 1;
+    }
+
+    /**
+     * @brief Parses the regression threshold.
+     * @param sThreshold Threshold, in percent
+     * @param dThreshold Where to store the threshold
+     * @return false if not a finite number
+     */
+    bool parse_threshold(const std::string &sThreshold, double &dThreshold) {
+        std::size_t nEnd = 0;
+        try {
+            dThreshold = std::stod(sThreshold, &nEnd);
+        } catch (const std::logic_error &) {
+            return false;
+        }
+        return nEnd == sThreshold.size() && std::isfinite(dThreshold);
+    }
+
+    /**
+     * @brief Runs the corpus and optionally saves the results.
+     * @param sOut Result file, empty to not save them
+     * @param sFilter Workload filter
+     * @return Status code
+     */
+    int run_corpus(const std::string &sOut, const std::string &sFilter) {
+        const auto vResults = debug::bench_corpus().run(sFilter);
+        debug::bench_corpus::print(vResults, std::cout);
+        if (sOut.empty()) return 0;
+
+        std::ofstream oFile(sOut);
+        oFile << debug::bench_corpus::to_json(vResults).dump(4) << std::endl;
+        if (!oFile) {
+            std::cerr << "Can not write " << sOut << std::endl;
+            return 1;
+        }
+        return 0;
+    }
+
+    /**
+     * @brief Compares two result files.
+     * @param sBase Result file of the reference build
+     * @param sCurrent Result file of the build to check
+     * @param dThreshold Change, in percent, reported as a regression
+     * @return 0 if no workload regresses, 2 otherwise
+     */
+    int run_compare(const std::string &sBase, const std::string &sCurrent, const double dThreshold) {
+        std::ifstream oBase(sBase);
+        std::ifstream oCurrent(sCurrent);
+        if (!oBase || !oCurrent) {
+            std::cerr << "Can not read " << (oBase ? sCurrent : sBase) << std::endl;
+            return 1;
+        }
+        std::vector<debug::bench_workload_result> vBase;
+        std::vector<debug::bench_workload_result> vCurrent;
+        try {
+            vBase = debug::bench_corpus::from_json(nlohmann::json::parse(oBase));
+        } catch (const nlohmann::json::exception &oError) {
+            std::cerr << "Invalid results in " << sBase << ": " << oError.what() << std::endl;
+            return 1;
+        }
+        try {
+            vCurrent = debug::bench_corpus::from_json(nlohmann::json::parse(oCurrent));
+        } catch (const nlohmann::json::exception &oError) {
+            std::cerr << "Invalid results in " << sCurrent << ": " << oError.what() << std::endl;
+            return 1;
+        }
+        const bool bPassed = debug::bench_corpus::compare(vBase, vCurrent, dThreshold, std::cout);
+        return bPassed ? 0 : 2;
+    }
+}
+
+/**
+ * @brief Main function to launch the benchmark series of BashSpark
+ *
+ * Usage:
+ * - `bbashspark [--json] [filter]`: runs the micro-benchmarks.
+ * - `bbashspark --corpus [--out file] [filter]`: runs the whole-script corpus.
+ * - `bbashspark --compare base current [threshold]`: compares two corpus results.
+ *
+ * @param argc Number of arguments
+ * @param argv Arguments
+ * @return Status code
+ */
+int main(const int argc, const char *const argv[]) {
+    const std::vector<std::string> vArgs(argv + 1, argv + argc);
+
+    if (!vArgs.empty() && vArgs[0] == "--compare") {
+        if (vArgs.size() != 3 && vArgs.size() != 4) return usage(argv[0]);
+        double dThreshold = debug::bench_corpus::DEFAULT_THRESHOLD;
+        if (vArgs.size() == 4 && !parse_threshold(vArgs[3], dThreshold)) {
+            std::cerr << "Invalid threshold " << vArgs[3] << std::endl;
+            return usage(argv[0]);
+        }
+        return run_compare(vArgs[1], vArgs[2], dThreshold);
+    }
+
+    if (!vArgs.empty() && vArgs[0] == "--corpus") {
+        std::string sOut;
+        std::string sFilter;
+        for (std::size_t i = 1; i < vArgs.size(); ++i) {
+            if (vArgs[i] == "--out" && i + 1 < vArgs.size()) sOut = vArgs[++i];
+            else if (sFilter.empty()) sFilter = vArgs[i];
+            else return usage(argv[0]);
+        }
+        return run_corpus(sOut, sFilter);
+    }
+
+    bool bJson = false;
+    std::string sFilter;
+    for (const auto &sArg: vArgs) {
+        if (sArg == "--json") bJson = true;
+        else if (sFilter.empty()) sFilter = sArg;
+        else return usage(argv[0]);
+    }
+
+    const auto pBench = std::make_unique<debug::bench_shell>(bJson, std::move(sFilter));
+    pBench->bench();
+    return 0;
+}
@@ -47,6 +47,10 @@
 #include "BashSpark/tools/hash.h"
 
 namespace bs {
+    shell_task command::run_async(const std::span<const std::string> vArgs, shell_session &oSession) const {
+        co_return this->run(vArgs, oSession);
+    }
+
     shell_status command_echo::run(
         const std::span<const std::string> &vArgs,
         shell_session &oSession
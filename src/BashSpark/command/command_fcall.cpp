@@ -26,11 +26,48 @@
 
 #include "BashSpark/command/command_fcall.h"
 
+#include "BashSpark/shell/shell_alloc.h"
+#include "BashSpark/shell/shell_log.h"
 #include "BashSpark/shell/shell_node.h"
+#include "BashSpark/shell/shell_profiler.h"
+#include "BashSpark/shell/shell_tracer.h"
 
 namespace bs {
     shell_status command_fcall::run(const std::span<const std::string> &vArgs, shell_session &oSession) const {
-        std::cout << "FCALL" << std::endl;
+        function_call oCall;
+        if (const auto nStatus = this->make_call(vArgs, oSession, oCall); nStatus != shell_status::SHELL_SUCCESS)
+            return nStatus;
+
+        // Run
+        const shell_profiler::scope oProfile(oSession, vArgs[0]);
+        const shell_alloc_scope oAlloc(*oCall.m_pSession, shell_alloc_phase::SAP_CONTROL);
+        const shell_tracer::scope oTrace(*oCall.m_pSession, shell_trace_category::STC_FUNCTION, vArgs[0]);
+        return oCall.m_pFunc->evaluate(*oCall.m_pSession);
+    }
+
+    shell_task command_fcall::run_async(const std::span<const std::string> vArgs, shell_session &oSession) const {
+        function_call oCall;
+        if (const auto nStatus = this->make_call(vArgs, oSession, oCall); nStatus != shell_status::SHELL_SUCCESS)
+            co_return nStatus;
+
+        // Run
+        shell_tracer::begin_async(*oCall.m_pSession, shell_trace_category::STC_FUNCTION, vArgs[0]);
+        shell_status nStatus;
+        try {
+            nStatus = co_await oCall.m_pFunc->evaluate_async(*oCall.m_pSession);
+        } catch (...) {
+            shell_tracer::end_async(*oCall.m_pSession, shell_trace_category::STC_FUNCTION, vArgs[0]);
+            throw;
+        }
+        shell_tracer::end_async(*oCall.m_pSession, shell_trace_category::STC_FUNCTION, vArgs[0]);
+        co_return nStatus;
+    }
+
+    shell_status command_fcall::make_call(
+        const std::span<const std::string> vArgs,
+        shell_session &oSession,
+        function_call &oCall
+    ) const {
         // Check args
         if (vArgs.empty()) {
             this->msg_error_param_number(oSession.err(), vArgs.size());
@@ -38,18 +75,18 @@ namespace bs {
         }
 
         // Check function name
-        const auto pFunc = oSession.get_func(vArgs[0]);
-        if (pFunc == nullptr) {
+        oCall.m_pFunc = oSession.get_func(vArgs[0]);
+        if (oCall.m_pFunc == nullptr) {
             this->msg_error_function_not_found(oSession.err(), vArgs[0]);
             return shell_status::SHELL_CMD_ERROR_FCALL_FUNCTION_NOT_FOUND;
         }
 
-        // Run
+        // Make the session of the function
+        BS_LOG(SLL_DEBUG, SLC_FUNCTION, "fcall " << shell_log::join(vArgs));
         std::vector vFuncArgs(vArgs.begin(), vArgs.end());
         shell_arg oArgs(std::move(vFuncArgs));
-        const auto pSession = oSession.make_function_call(std::move(oArgs));
-        std::cout << "arg 1: " << pSession->get_arg(1) << std::endl;
-        return pFunc->evaluate(*pSession);
+        oCall.m_pSession = oSession.make_function_call(std::move(oArgs));
+        return shell_status::SHELL_SUCCESS;
     }
 
     void command_fcall::msg_error_param_number(std::ostream &oStdErr, const std::size_t nArgs) const {
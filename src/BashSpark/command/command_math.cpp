@@ -294,11 +294,14 @@ namespace bs {
         /**
          * Contstructs a math_parser
          * @param vTokens Tokens to parse
+         * @param oSession Session whose integer variables can be used as values
          */
-        explicit math_parser(
-            const std::span<const std::string> &vTokens
+        math_parser(
+            const std::span<const std::string> &vTokens,
+            const shell_session &oSession
         ) noexcept
-            : m_vTokens(vTokens) {
+            : m_vTokens(vTokens),
+              m_oSession(oSession) {
         }
 
 
@@ -404,6 +407,7 @@ namespace bs {
 
     private:
         const std::span<const std::string> &m_vTokens;
+        const shell_session &m_oSession;
         std::size_t m_nDepth = 0;
     };
 
@@ -414,7 +418,7 @@ namespace bs {
         auto nStatus = shell_status::SHELL_SUCCESS;
         try {
             std::size_t nPos = 0;
-            const auto pParser = std::make_unique<math_parser>(vArgs);
+            const auto pParser = std::make_unique<math_parser>(vArgs, oSession);
             const math_parser::expvar nX;
             const auto nResult = pParser->do_toplevel(nPos, nX);
             oSession.out() << nResult;
@@ -640,10 +644,11 @@ namespace bs {
             return bSign ? -nValue : nValue;
         }
 
-        if (!is_number(m_vTokens[nPos]))
+        // Literal or session variable, whose integer value is cached
+        if (!parse_number(m_vTokens[nPos], nValue)
+            && !(is_var(m_vTokens[nPos]) && m_oSession.get_var_int(m_vTokens[nPos], nValue)))
             throw math_error(shell_status::SHELL_CMD_ERROR_MATH_NOT_AN_INTEGER);
 
-        nValue = std::stoll(m_vTokens[nPos]);
         nPos += 1;
 
         return bSign ? -nValue : nValue;
@@ -0,0 +1,99 @@
+/**
+ * @file command_metrics.cpp
+ * @brief Implements class `bs::command_metrics`.
+ *
+ * @date Created on 22/11/25
+ * @author Dante Doménech Martínez
+ *
+ * @copyright GNU General Public License v3.0
+ *
+ * This file is part of BashSpark.
+ * Copyright (C) 2025 Dante Doménech Martínez
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "BashSpark/command/command_metrics.h"
+
+#include <algorithm>
+#include <bit>
+
+namespace bs {
+    std::chrono::microseconds command_metrics_snapshot::get_latency_quantile(const double dQuantile) const noexcept {
+        const auto nTarget = static_cast<std::uint64_t>(dQuantile * static_cast<double>(this->m_nCalls));
+        std::uint64_t nSeen = 0;
+        for (std::size_t i = 0; i + 1 < LATENCY_BUCKETS; ++i) {
+            nSeen += this->m_vLatency[i];
+            if (nSeen > nTarget || (nSeen == this->m_nCalls && nSeen > 0))
+                return std::chrono::microseconds{std::int64_t{1} << i};
+        }
+        return std::chrono::microseconds::max();
+    }
+
+    void command_metrics::record(
+        const shell_status nStatus,
+        const std::chrono::nanoseconds nLatency,
+        const std::size_t nBytesOut,
+        const std::size_t nBytesErr
+    ) noexcept {
+        constexpr auto RELAXED = std::memory_order_relaxed;
+        this->m_nCalls.fetch_add(1, RELAXED);
+        if (nStatus != shell_status::SHELL_SUCCESS) {
+            this->m_nErrors.fetch_add(1, RELAXED);
+            if (const auto nSlot = static_cast<std::size_t>(nStatus); nSlot < STATUS_SLOTS)
+                this->m_vErrors[nSlot].fetch_add(1, RELAXED);
+            else
+                this->m_nOtherErrors.fetch_add(1, RELAXED);
+        }
+
+        // Bucket of the latency, the bit width of the microseconds
+        const auto nNanoseconds = static_cast<std::uint64_t>(std::max<std::int64_t>(nLatency.count(), 0));
+        const auto nBucket = std::min<std::size_t>(std::bit_width(nNanoseconds / 1000), LATENCY_BUCKETS - 1);
+        this->m_nLatency.fetch_add(nNanoseconds, RELAXED);
+        this->m_vLatency[nBucket].fetch_add(1, RELAXED);
+
+        if (nBytesOut != 0) this->m_nBytesOut.fetch_add(nBytesOut, RELAXED);
+        if (nBytesErr != 0) this->m_nBytesErr.fetch_add(nBytesErr, RELAXED);
+    }
+
+    command_metrics_snapshot command_metrics::snapshot() const {
+        constexpr auto RELAXED = std::memory_order_relaxed;
+        command_metrics_snapshot oSnapshot;
+        oSnapshot.m_nCalls = this->m_nCalls.load(RELAXED);
+        oSnapshot.m_nErrors = this->m_nErrors.load(RELAXED);
+        oSnapshot.m_nLatency = std::chrono::nanoseconds{this->m_nLatency.load(RELAXED)};
+        oSnapshot.m_nBytesOut = this->m_nBytesOut.load(RELAXED);
+        oSnapshot.m_nBytesErr = this->m_nBytesErr.load(RELAXED);
+        oSnapshot.m_nOtherErrors = this->m_nOtherErrors.load(RELAXED);
+        for (std::size_t i = 0; i < STATUS_SLOTS; ++i) {
+            if (const auto nCount = this->m_vErrors[i].load(RELAXED); nCount != 0)
+                oSnapshot.m_mErrors.emplace(static_cast<shell_status>(i), nCount);
+        }
+        for (std::size_t i = 0; i < LATENCY_BUCKETS; ++i)
+            oSnapshot.m_vLatency[i] = this->m_vLatency[i].load(RELAXED);
+        return oSnapshot;
+    }
+
+    void command_metrics::reset() noexcept {
+        constexpr auto RELAXED = std::memory_order_relaxed;
+        this->m_nCalls.store(0, RELAXED);
+        this->m_nErrors.store(0, RELAXED);
+        this->m_nLatency.store(0, RELAXED);
+        this->m_nBytesOut.store(0, RELAXED);
+        this->m_nBytesErr.store(0, RELAXED);
+        this->m_nOtherErrors.store(0, RELAXED);
+        for (auto &nCount: this->m_vErrors) nCount.store(0, RELAXED);
+        for (auto &nCount: this->m_vLatency) nCount.store(0, RELAXED);
+    }
+}
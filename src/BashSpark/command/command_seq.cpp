@@ -32,6 +32,34 @@
 #include "BashSpark/tools/shell_def.h"
 
 namespace bs {
+    namespace {
+        /**
+         * @brief Generates a sequence whose step has already been checked.
+         *
+         * The remaining distance is computed unsigned, so the values never overflow,
+         * even when the end is close to the limits of 64 bit integers.
+         *
+         * @param nFrom First value
+         * @param nStep Step, going towards the last value
+         * @param nTo Last value
+         * @param fEmit Function called on each value
+         */
+        template<typename F>
+        void generate(const std::int64_t nFrom, const std::int64_t nStep, const std::int64_t nTo, F &&fEmit) {
+            const std::uint64_t nDistance = nFrom <= nTo
+                                                ? static_cast<std::uint64_t>(nTo) - static_cast<std::uint64_t>(nFrom)
+                                                : static_cast<std::uint64_t>(nFrom) - static_cast<std::uint64_t>(nTo);
+            const std::uint64_t nStride = nStep >= 0
+                                              ? static_cast<std::uint64_t>(nStep)
+                                              : std::uint64_t{0} - static_cast<std::uint64_t>(nStep);
+            auto nValue = nFrom;
+            fEmit(nValue);
+            for (std::uint64_t nDone = 0; nStride != 0 && nDistance - nDone >= nStride; nDone += nStride) {
+                nValue += nStep;
+                fEmit(nValue);
+            }
+        }
+    }
 
     shell_status command_seq::run(const std::span<const std::string> &vArgs, shell_session &oSession) const {
         if (vArgs.size() != 2 && vArgs.size() != 3) {
@@ -39,14 +67,14 @@ namespace bs {
             return shell_status::SHELL_CMD_ERROR_SEQ_PARAM_NUMBER;
         }
 
-        // Parse ints
+        // Parse ints (literals or variables, whose integer value is cached)
         std::int64_t nArgs[3];
         for (std::size_t i = 0; i < vArgs.size(); ++i) {
-            if (!is_number(vArgs[i])) {
+            if (!parse_number(vArgs[i], nArgs[i])
+                && !(is_var(vArgs[i]) && oSession.get_var_int(vArgs[i], nArgs[i]))) {
                 this->msg_error_int_format(oSession.err(), vArgs[i]);
                 return shell_status::SHELL_CMD_ERROR_SEQ_INVALID_INT_FORMAT;
             }
-            nArgs[i] = std::stoll(vArgs[i]);
         }
 
         // Iterate
@@ -64,17 +92,23 @@ namespace bs {
             }
         }
 
-        oSession.out() << nArgs[0];
-        if (nArgs[0] < nArgs[2]) {
-            for (auto nIter = nArgs[0] + nArgs[1]; nIter <= nArgs[2]; nIter += nArgs[1]) {
-                oSession.out().put(' ') << nIter;
-            }
-        } else if (nArgs[0] > nArgs[2]) {
-            for (auto nIter = nArgs[0] + nArgs[1]; nIter >= nArgs[2]; nIter += nArgs[1]) {
-                oSession.out().put(' ') << nIter;
-            }
+        // Typed output, the text output are the numbers joined by spaces
+        if (const auto pRecords = oSession.get_record_output()) {
+            std::vector<std::string> vRecords;
+            generate(nArgs[0], nArgs[1], nArgs[2], [&vRecords](const std::int64_t nValue) {
+                vRecords.push_back(std::to_string(nValue));
+            });
+            pRecords->write(std::move(vRecords));
+            return shell_status::SHELL_SUCCESS;
         }
 
+        bool bFirst = true;
+        generate(nArgs[0], nArgs[1], nArgs[2], [&oSession, &bFirst](const std::int64_t nValue) {
+            if (!bFirst) oSession.out().put(' ');
+            oSession.out() << nValue;
+            bFirst = false;
+        });
+
         return shell_status::SHELL_SUCCESS;
     }
 
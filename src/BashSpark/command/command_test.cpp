@@ -353,9 +353,8 @@ namespace bs {
             case test_operator::TO_EQUALS: {
                 if (nPos + 2 >= this->m_vTokens.size())
                     throw test_error(shell_status::SHELL_CMD_ERROR_TEST_MALFORMED_EXPRESSION);
-                if (is_number(m_vTokens[nPos]) && is_number(m_vTokens[nPos + 2])) {
-                    const auto n1 = std::stoull(m_vTokens[nPos + 0]);
-                    const auto n2 = std::stoull(m_vTokens[nPos + 2]);
+                std::int64_t n1, n2;
+                if (parse_number(m_vTokens[nPos + 0], n1) && parse_number(m_vTokens[nPos + 2], n2)) {
                     nPos += 3;
                     return n1 == n2;
                 }
@@ -378,9 +377,8 @@ namespace bs {
             case test_operator::TO_GREATER_THAN: {
                 if (nPos + 2 >= this->m_vTokens.size())
                     throw test_error(shell_status::SHELL_CMD_ERROR_TEST_MALFORMED_EXPRESSION);
-                if (is_number(m_vTokens[nPos]) && is_number(m_vTokens[nPos + 2])) {
-                    const auto n1 = std::stoull(m_vTokens[nPos + 0]);
-                    const auto n2 = std::stoull(m_vTokens[nPos + 2]);
+                std::int64_t n1, n2;
+                if (parse_number(m_vTokens[nPos + 0], n1) && parse_number(m_vTokens[nPos + 2], n2)) {
                     nPos += 3;
                     return n1 > n2;
                 }
@@ -391,9 +389,8 @@ namespace bs {
             case test_operator::TO_LESS_THAN: {
                 if (nPos + 2 >= this->m_vTokens.size())
                     throw test_error(shell_status::SHELL_CMD_ERROR_TEST_MALFORMED_EXPRESSION);
-                if (is_number(m_vTokens[nPos]) && is_number(m_vTokens[nPos + 2])) {
-                    const auto n1 = std::stoull(m_vTokens[nPos + 0]);
-                    const auto n2 = std::stoull(m_vTokens[nPos + 2]);
+                std::int64_t n1, n2;
+                if (parse_number(m_vTokens[nPos + 0], n1) && parse_number(m_vTokens[nPos + 2], n2)) {
                     nPos += 3;
                     return n1 < n2;
                 }
@@ -404,19 +401,20 @@ namespace bs {
             case test_operator::TO_GREATER_THAN_OR_EQUALS: {
                 if (nPos + 2 >= this->m_vTokens.size())
                     throw test_error(shell_status::SHELL_CMD_ERROR_TEST_MALFORMED_EXPRESSION);
-                if (is_number(m_vTokens[nPos]) && is_number(m_vTokens[nPos + 2])) {
-                    const auto n1 = std::stoull(m_vTokens[nPos + 0]);
-                    const auto n2 = std::stoull(m_vTokens[nPos + 2]);
+                std::int64_t n1, n2;
+                if (parse_number(m_vTokens[nPos + 0], n1) && parse_number(m_vTokens[nPos + 2], n2)) {
+                    nPos += 3;
                     return n1 >= n2;
                 }
-                return m_vTokens[nPos + 0] >= m_vTokens[nPos + 2];
+                const auto bResult = m_vTokens[nPos + 0] >= m_vTokens[nPos + 2];
+                nPos += 3;
+                return bResult;
             }
             case test_operator::TO_LESS_THAN_OR_EQUALS: {
                 if (nPos + 2 >= this->m_vTokens.size())
                     throw test_error(shell_status::SHELL_CMD_ERROR_TEST_MALFORMED_EXPRESSION);
-                if (is_number(m_vTokens[nPos]) && is_number(m_vTokens[nPos + 2])) {
-                    const auto n1 = std::stoull(m_vTokens[nPos + 0]);
-                    const auto n2 = std::stoull(m_vTokens[nPos + 2]);
+                std::int64_t n1, n2;
+                if (parse_number(m_vTokens[nPos + 0], n1) && parse_number(m_vTokens[nPos + 2], n2)) {
                     nPos += 3;
                     return n1 <= n2;
                 }
@@ -427,9 +425,8 @@ namespace bs {
             case test_operator::TO_NOT_EQUALS: {
                 if (nPos + 2 >= this->m_vTokens.size())
                     throw test_error(shell_status::SHELL_CMD_ERROR_TEST_MALFORMED_EXPRESSION);
-                if (is_number(m_vTokens[nPos]) && is_number(m_vTokens[nPos + 2])) {
-                    const auto n1 = std::stoull(m_vTokens[nPos + 0]);
-                    const auto n2 = std::stoull(m_vTokens[nPos + 2]);
+                std::int64_t n1, n2;
+                if (parse_number(m_vTokens[nPos + 0], n1) && parse_number(m_vTokens[nPos + 2], n2)) {
                     nPos += 3;
                     return n1 != n2;
                 }
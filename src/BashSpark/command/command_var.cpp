@@ -85,4 +85,166 @@ namespace bs {
     void command_setvar::msg_error_variable_name(std::ostream &oStdErr, const std::string &sVariableName) const {
         oStdErr << "setvar: \u201C" << sVariableName << "\u201D: not a variable name." << std::endl;
     }
+
+    shell_status command_appendvar::run(
+        const std::span<const std::string> &vArgs,
+        shell_session &oSession
+    ) const {
+        if (vArgs.size() != 2) {
+            this->msg_error_param_number(oSession.err(), vArgs.size());
+            return shell_status::SHELL_CMD_ERROR_APPENDVAR_PARAM_NUMBER;
+        }
+
+        // Check variable name
+        const std::string &sVariable = vArgs[0];
+        if (!is_var(sVariable)) {
+            msg_error_variable_name(oSession.err(), sVariable);
+            return shell_status::SHELL_CMD_ERROR_APPENDVAR_VARIABLE_NAME_INVALID;
+        }
+
+        oSession.append_var(sVariable, vArgs[1]);
+        return shell_status::SHELL_SUCCESS;
+    }
+
+    void command_appendvar::msg_error_param_number(std::ostream &oStdErr, const std::size_t nArgs) const {
+        oStdErr << "appendvar: takes 2 parameters, but received " << nArgs << "." << std::endl;
+    }
+
+    void command_appendvar::msg_error_variable_name(std::ostream &oStdErr, const std::string &sVariableName) const {
+        oStdErr << "appendvar: \u201C" << sVariableName << "\u201D: not a variable name." << std::endl;
+    }
+
+    shell_status command_setarray::run(
+        const std::span<const std::string> &vArgs,
+        shell_session &oSession
+    ) const {
+        if (vArgs.empty()) {
+            this->msg_error_param_number(oSession.err(), vArgs.size());
+            return shell_status::SHELL_CMD_ERROR_SETARRAY_PARAM_NUMBER;
+        }
+
+        // Check variable name
+        const std::string &sVariable = vArgs[0];
+        if (!is_var(sVariable)) {
+            msg_error_variable_name(oSession.err(), sVariable);
+            return shell_status::SHELL_CMD_ERROR_SETARRAY_VARIABLE_NAME_INVALID;
+        }
+
+        shell_var_array oArray;
+        for (std::size_t i = 1; i < vArgs.size(); ++i)
+            oArray.push(vArgs[i]);
+        oSession.set_array(sVariable, std::move(oArray));
+        return shell_status::SHELL_SUCCESS;
+    }
+
+    void command_setarray::msg_error_param_number(std::ostream &oStdErr, const std::size_t nArgs) const {
+        oStdErr << "setarray: takes at least 1 parameter, but received " << nArgs << "." << std::endl;
+    }
+
+    void command_setarray::msg_error_variable_name(std::ostream &oStdErr, const std::string &sVariableName) const {
+        oStdErr << "setarray: \u201C" << sVariableName << "\u201D: not a variable name." << std::endl;
+    }
+
+    shell_status command_setmap::run(
+        const std::span<const std::string> &vArgs,
+        shell_session &oSession
+    ) const {
+        if (vArgs.size() % 2 != 1) {
+            this->msg_error_param_number(oSession.err(), vArgs.size());
+            return shell_status::SHELL_CMD_ERROR_SETMAP_PARAM_NUMBER;
+        }
+
+        // Check variable name
+        const std::string &sVariable = vArgs[0];
+        if (!is_var(sVariable)) {
+            msg_error_variable_name(oSession.err(), sVariable);
+            return shell_status::SHELL_CMD_ERROR_SETMAP_VARIABLE_NAME_INVALID;
+        }
+
+        shell_var_array oArray(true);
+        for (std::size_t i = 1; i < vArgs.size(); i += 2)
+            oArray.set(vArgs[i], vArgs[i + 1]);
+        oSession.set_array(sVariable, std::move(oArray));
+        return shell_status::SHELL_SUCCESS;
+    }
+
+    void command_setmap::msg_error_param_number(std::ostream &oStdErr, const std::size_t nArgs) const {
+        oStdErr << "setmap: takes an odd number of parameters, but received " << nArgs << "." << std::endl;
+    }
+
+    void command_setmap::msg_error_variable_name(std::ostream &oStdErr, const std::string &sVariableName) const {
+        oStdErr << "setmap: \u201C" << sVariableName << "\u201D: not a variable name." << std::endl;
+    }
+
+    shell_status command_setitem::run(
+        const std::span<const std::string> &vArgs,
+        shell_session &oSession
+    ) const {
+        if (vArgs.size() != 3) {
+            this->msg_error_param_number(oSession.err(), vArgs.size());
+            return shell_status::SHELL_CMD_ERROR_SETITEM_PARAM_NUMBER;
+        }
+
+        // Check variable name
+        const std::string &sVariable = vArgs[0];
+        if (!is_var(sVariable)) {
+            msg_error_variable_name(oSession.err(), sVariable);
+            return shell_status::SHELL_CMD_ERROR_SETITEM_VARIABLE_NAME_INVALID;
+        }
+
+        if (!oSession.set_array_item(sVariable, vArgs[1], vArgs[2])) {
+            msg_error_index(oSession.err(), sVariable, vArgs[1]);
+            return shell_status::SHELL_CMD_ERROR_SETITEM_INDEX_INVALID;
+        }
+        return shell_status::SHELL_SUCCESS;
+    }
+
+    void command_setitem::msg_error_param_number(std::ostream &oStdErr, const std::size_t nArgs) const {
+        oStdErr << "setitem: takes 3 parameters, but received " << nArgs << "." << std::endl;
+    }
+
+    void command_setitem::msg_error_variable_name(std::ostream &oStdErr, const std::string &sVariableName) const {
+        oStdErr << "setitem: \u201C" << sVariableName << "\u201D: not a variable name." << std::endl;
+    }
+
+    void command_setitem::msg_error_index(
+        std::ostream &oStdErr,
+        const std::string &sVariableName,
+        const std::string &sIndex
+    ) const {
+        oStdErr << "setitem: \u201C" << sIndex << "\u201D: not a valid index of \u201C" << sVariableName << "\u201D." << std::endl;
+    }
+
+    shell_status command_readarray::run(
+        const std::span<const std::string> &vArgs,
+        shell_session &oSession
+    ) const {
+        if (vArgs.size() != 1) {
+            this->msg_error_param_number(oSession.err(), vArgs.size());
+            return shell_status::SHELL_CMD_ERROR_READARRAY_PARAM_NUMBER;
+        }
+
+        // Check variable name
+        const std::string &sVariable = vArgs[0];
+        if (!is_var(sVariable)) {
+            msg_error_variable_name(oSession.err(), sVariable);
+            return shell_status::SHELL_CMD_ERROR_READARRAY_VARIABLE_NAME_INVALID;
+        }
+
+        std::vector<std::string> vRecords;
+        oSession.read_records(vRecords);
+        shell_var_array oArray;
+        for (auto &sRecord: vRecords)
+            oArray.push(std::move(sRecord));
+        oSession.set_array(sVariable, std::move(oArray));
+        return shell_status::SHELL_SUCCESS;
+    }
+
+    void command_readarray::msg_error_param_number(std::ostream &oStdErr, const std::size_t nArgs) const {
+        oStdErr << "readarray: takes 1 parameter, but received " << nArgs << "." << std::endl;
+    }
+
+    void command_readarray::msg_error_variable_name(std::ostream &oStdErr, const std::string &sVariableName) const {
+        oStdErr << "readarray: \u201C" << sVariableName << "\u201D: not a variable name." << std::endl;
+    }
 }
@@ -34,14 +34,27 @@
 
 #include "BashSpark/shell.h"
 
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <memory>
+#include <ranges>
+#include <system_error>
+#include <thread>
+
 #include "BashSpark/command/command_env.h"
 #include "BashSpark/command/command_fcall.h"
 #include "BashSpark/command/command_math.h"
 #include "BashSpark/command/command_seq.h"
 #include "BashSpark/command/command_test.h"
 #include "BashSpark/command/command_var.h"
+#include "shell/mapped_file.h"
+#include "BashSpark/shell/shell_alloc.h"
 #include "BashSpark/shell/shell_node_visitor_json.h"
 #include "BashSpark/shell/shell_parser.h"
+#include "BashSpark/shell/shell_source.h"
+#include "BashSpark/shell/shell_tracer.h"
+#include "BashSpark/tools/capturestream.h"
 #include "BashSpark/tools/fakestream.h"
 #include "BashSpark/tools/hash.h"
 #include "BashSpark/tools/nullstream.h"
@@ -55,6 +68,11 @@ namespace bs {
         pShell->set_command<command_getvar>();
         pShell->set_command<command_setenv>();
         pShell->set_command<command_setvar>();
+        pShell->set_command<command_appendvar>();
+        pShell->set_command<command_setarray>();
+        pShell->set_command<command_setmap>();
+        pShell->set_command<command_setitem>();
+        pShell->set_command<command_readarray>();
         pShell->set_command<command_seq>();
         pShell->set_command<command_test>();
         pShell->set_command<command_math>();
@@ -62,11 +80,31 @@ namespace bs {
         return pShell;
     }
 
+    std::shared_ptr<const shell> shell::get_shared_default_shell() {
+        static const std::shared_ptr<const shell> pShell = make_default_shell();
+        return pShell;
+    }
+
     const command *shell::get_command(const std::string &sCommand) const noexcept {
+        if (this->m_fFindBuiltin != nullptr) {
+            if (const auto pCommand = this->m_fFindBuiltin(*this, sCommand); pCommand != nullptr)
+                return pCommand;
+        }
         const auto pIter = this->m_mCommands.find(sCommand);
-        if (pIter == this->m_mCommands.end())
-            return nullptr;
-        return pIter->second.get();
+        if (pIter != this->m_mCommands.end())
+            return pIter->second.get();
+        if (this->m_pBase)
+            return this->m_pBase->get_command(sCommand);
+        return nullptr;
+    }
+
+    bool shell::run_builtin(
+        const std::string_view sCommand,
+        const std::span<const std::string> vArgs,
+        shell_session &oSession,
+        shell_status &nStatus
+    ) const {
+        return this->m_fRunBuiltin != nullptr && this->m_fRunBuiltin(*this, sCommand, vArgs, oSession, nStatus);
     }
 
     void shell::set_command(std::unique_ptr<command> &&pCommand) {
@@ -74,22 +112,47 @@ namespace bs {
     }
 
     std::unique_ptr<command> shell::remove_command(const std::string &sCommand) {
+        // Base commands are hidden with a null command
+        const bool bInBase = this->m_pBase && this->m_pBase->get_command(sCommand) != nullptr;
+
         // Search external map
         const auto pIter = this->m_mCommands.find(sCommand);
-        if (pIter == this->m_mCommands.end())
+        if (pIter == this->m_mCommands.end()) {
+            if (bInBase) this->m_mCommands.emplace(sCommand, nullptr);
             return nullptr;
+        }
         auto pCommand = std::move(pIter->second);
-        this->m_mCommands.erase(pIter);
+        if (!bInBase) this->m_mCommands.erase(pIter);
         return pCommand;
     }
 
     void shell::erase_command(const std::string &sCommand) {
-        if (
-            const auto pIter = this->m_mCommands.find(sCommand);
-            pIter != this->m_mCommands.end()
-        ) {
-            this->m_mCommands.erase(pIter);
+        static_cast<void>(this->remove_command(sCommand));
+    }
+
+    std::vector<const command *> shell::get_commands() const {
+        std::vector<const command *> vCommands;
+        if (this->m_pBase) {
+            // Skip the base commands hidden or replaced by this shell
+            for (const auto pCommand: this->m_pBase->get_commands()) {
+                if (!this->m_mCommands.contains(pCommand->get_name_ref()))
+                    vCommands.push_back(pCommand);
+            }
+        }
+        for (const auto &pCommand: this->m_mCommands | std::views::values) {
+            if (pCommand != nullptr) vCommands.push_back(pCommand.get());
         }
+        return vCommands;
+    }
+
+    std::vector<command_metrics_snapshot> shell::get_command_metrics() const {
+        std::vector<command_metrics_snapshot> vMetrics;
+        for (const auto pCommand: this->get_commands()) {
+            auto &oMetrics = vMetrics.emplace_back(pCommand->get_metrics().snapshot());
+            oMetrics.m_sName = pCommand->get_name_ref();
+        }
+        std::ranges::sort(vMetrics, {}, &command_metrics_snapshot::m_sName);
+        return vMetrics;
     }
 
     bool shell::get_stop_on_command_not_found() const noexcept {
@@ -100,6 +163,22 @@ namespace bs {
         this->m_bStopOnCommandNotFound = bStopOnCommandNotFound;
     }
 
+    bool shell::get_stream_substitution() const noexcept {
+        return shell_traits::THREAD_SAFE && this->m_bStreamSubstitution;
+    }
+
+    void shell::set_stream_substitution(const bool bStreamSubstitution) noexcept {
+        this->m_bStreamSubstitution = bStreamSubstitution;
+    }
+
+    bool shell::get_collect_metrics() const noexcept {
+        return this->m_bCollectMetrics;
+    }
+
+    void shell::set_collect_metrics(const bool bCollectMetrics) noexcept {
+        this->m_bCollectMetrics = bCollectMetrics;
+    }
+
     void shell::msg_error_command_not_found(shell_session &oSession, const std::string &sCommand) const {
         oSession.err() << "shell: \u201C" << sCommand << "\u201D: not found." << std::endl;
     }
@@ -108,51 +187,284 @@ namespace bs {
         oSession.err() << "shell: \u201C" << sFunction << "\u201D: invalid function name." << std::endl;
     }
 
+    void shell::msg_error_invalid_loop_bound(shell_session &oSession, const std::string &sValue) const {
+        oSession.err() << "shell: \u201C" << sValue << "\u201D: loop bound is no integer." << std::endl;
+    }
+
+    void shell::msg_error_invalid_loop_step(
+        shell_session &oSession,
+        const std::int64_t nFrom,
+        const std::int64_t nStep,
+        const std::int64_t nTo
+    ) const {
+        oSession.err() << "shell: can not iterate: "
+                "[ " << nFrom << " : " << nStep << " : " << nTo << " ]" << std::endl;
+    }
+
+    void shell::msg_error_file_not_readable(
+        shell_session &oSession,
+        const std::filesystem::filesystem_error &oError
+    ) const {
+        oSession.err() << "shell: \u201C" << oError.path1().string() << "\u201D: "
+                << oError.code().message() << "." << std::endl;
+    }
+
     void shell::msg_error_syntax_error(const shell_session &oSession, const shell_parser_exception &oException) const {
         oSession.err() << oException.what();
     }
 
     namespace {
+        /**
+         * @brief Copies a syntax error into one owning the text of its source.
+         *
+         * Scripts given as text are parsed over a source viewing the text, so
+         * that parsing copies nothing. Their syntax errors must own the text
+         * before they outlive the call.
+         *
+         * @param oException The syntax error
+         * @return The syntax error, owning its source
+         */
+        shell_parser_exception own_source(const shell_parser_exception &oException) {
+            return {
+                oException.get_status(),
+                shell_source::make(oException.get_command()),
+                oException.get_position()
+            };
+        }
+
         ALWAYS_INLINE shell_status eval(
             shell_session &oSession,
-            ifakestream &oIstream
+            const std::shared_ptr<const shell_source> &pSource,
+            const bool bViewed = false
         ) {
+            const shell_alloc_scope oAlloc(oSession, shell_alloc_phase::SAP_CONTROL);
             try {
-                const auto pMainNode = shell_parser::parse(oIstream);
+                std::unique_ptr<shell_node_evaluable> pMainNode;
+                {
+                    const shell_tracer::scope oTrace(oSession, shell_trace_category::STC_PARSE, "parse");
+                    pMainNode = shell_parser::parse(pSource);
+                }
                 //shell_node_visitor_json oVisitor;
                 //auto sJson = oVisitor.visit_node(oSession, pMainNode.get());
                 //std::ofstream oFile("/home/$USER/Documents/BashSpark/node.json");
                 //oFile << oVisitor.visit_node(oSession, pMainNode.get()).dump(4) << std::endl;
+                const shell_profiler::source oSource(oSession, pMainNode.get());
                 return pMainNode->evaluate(oSession);
             } catch (const shell_parser_exception &oException) {
+                // The message handler may keep the error
                 oSession.get_shell()->msg_error_syntax_error(
-                    oSession, oException
+                    oSession, bViewed ? own_source(oException) : oException
                 );
                 return oException.get_status();
             }
         }
+
+        /**
+         * @brief Maps a file as the source of a script, without copying it.
+         * @param oPath Path to the file
+         * @return Source viewing the mapping, which it keeps alive
+         * @throw std::filesystem::filesystem_error If the file can not be mapped
+         */
+        std::shared_ptr<const shell_source> map_source(const std::filesystem::path &oPath) {
+            auto pFile = std::make_shared<const mapped_file>(oPath);
+            const std::string_view sText = pFile->view();
+            return std::make_shared<const shell_source>(sText, std::move(pFile));
+        }
     }
 
     shell_status shell::run(const std::string &sCommand, shell_session &oSession) {
-        // Open fake istream
-        ifakestream oIstream(sCommand.data(), sCommand.length());
-        // Run command
-        return eval(oSession, oIstream);
+        return eval(oSession, shell_source::view(sCommand), true);
     }
 
     shell_status shell::run(const std::string_view &sCommand, shell_session &oSession) {
-        // Open fake istream
-        ifakestream oIstream(sCommand.data(), sCommand.length());
-        // Run command
-        return eval(oSession, oIstream);
+        return eval(oSession, shell_source::view(sCommand), true);
     }
 
     shell_status shell::run(std::istream &oCommand, shell_session &oSession) {
-        // Parse istream
-        const std::string sCommand(std::istreambuf_iterator<char>(oCommand), {});
-        // Open fake istream
-        ifakestream oIstream(sCommand.data(), sCommand.length());
-        // Run command
-        return eval(oSession, oIstream);
+        // Read istream into the source
+        std::string sCommand(std::istreambuf_iterator<char>(oCommand), {});
+        return eval(oSession, std::make_shared<const shell_source>(std::move(sCommand)));
+    }
+
+    namespace {
+        /**
+         * @brief Runs something on a session whose output is captured.
+         * @param oSession Shell session
+         * @param fRun Function running on the capturing session
+         * @return Status code of last executed command and captured output
+         */
+        template<typename F>
+        shell_capture capture(shell_session &oSession, F &&fRun) {
+            ocapturestream oStdOut;
+            ocapturestream oStdErr;
+            const auto pSession = oSession.make_redirection(oStdOut, oStdErr);
+            const auto nStatus = fRun(*pSession);
+            oSession.set_last_command_result(nStatus);
+            return {nStatus, oStdOut.take(), oStdErr.take()};
+        }
+    }
+
+    shell_capture shell::run_capture(const std::string_view &sCommand, shell_session &oSession) {
+        return capture(oSession, [&sCommand](shell_session &oCapture) {
+            return run(sCommand, oCapture);
+        });
+    }
+
+    shell_capture shell::run_capture(const shell_script &oScript, shell_session &oSession) {
+        return capture(oSession, [&oScript](shell_session &oCapture) {
+            return oScript.run(oCapture);
+        });
+    }
+
+    shell_status shell::run_file(const std::filesystem::path &oPath, shell_session &oSession) {
+        try {
+            // Map file
+            const auto pSource = map_source(oPath);
+            // Run command
+            return eval(oSession, pSource);
+        } catch (const std::filesystem::filesystem_error &oError) {
+            oSession.get_shell()->msg_error_file_not_readable(oSession, oError);
+            return shell_status::SHELL_ERROR_FILE_NOT_READABLE;
+        }
+    }
+
+    shell_script shell::compile(const std::string_view &sCommand) {
+        try {
+            return shell_script(shell_parser::parse(shell_source::view(sCommand)));
+        } catch (const shell_parser_exception &oException) {
+            throw own_source(oException);
+        }
+    }
+
+    shell_script shell::compile_file(const std::filesystem::path &oPath) {
+        return shell_script(shell_parser::parse(map_source(oPath)));
+    }
+
+    namespace {
+        /**
+         * @brief Read-only stream buffer over a string view, avoiding a copy of the job input.
+         */
+        class viewbuffer : public std::streambuf {
+        public:
+            /**
+             * @brief Constructs the buffer.
+             * @param sText Text to read, must outlive the buffer.
+             */
+            explicit viewbuffer(const std::string_view sText) {
+                const auto pData = const_cast<char *>(sText.data());
+                this->setg(pData, pData, pData + sText.size());
+            }
+        };
+
+        /**
+         * @brief Runs a job of a batch on a fresh session.
+         * @param pShell Shell running the job
+         * @param oJob Job to run
+         * @return Result of the job
+         */
+        shell_job_result run_job(const shell *pShell, const shell_job &oJob) noexcept {
+            const auto nStart = std::chrono::steady_clock::now();
+            shell_job_result oResult;
+            // A failing job must not fail the others, nor its worker
+            try {
+                viewbuffer oInBuffer(oJob.m_sIn);
+                std::istream oStdIn(&oInBuffer);
+                ocapturestream oStdOut;
+                ocapturestream oStdErr;
+                try {
+                    shell_session oSession(pShell, oStdIn, oStdOut, oStdErr, oJob.m_oEnv, oJob.m_oArg);
+                    oSession.set_tracer(oJob.m_pTracer);
+                    const shell_tracer::scope oTrace(oSession, shell_trace_category::STC_JOB, "job");
+                    oResult.m_nStatus = oJob.m_pScript != nullptr
+                                            ? oJob.m_pScript->run(oSession)
+                                            : shell::run(oJob.m_sCommand, oSession);
+                } catch (const std::exception &oError) {
+                    oStdErr << oError.what() << '\n';
+                    oResult.m_nStatus = shell_status::SHELL_ERROR;
+                } catch (...) {
+                    oStdErr << "Unknown exception\n";
+                    oResult.m_nStatus = shell_status::SHELL_ERROR;
+                }
+                oResult.m_sOut = oStdOut.take();
+                oResult.m_sErr = oStdErr.take();
+            } catch (...) {
+                // The streams could not be set up, as when out of memory
+                oResult.m_nStatus = shell_status::SHELL_ERROR;
+            }
+            oResult.m_nLatency = std::chrono::steady_clock::now() - nStart;
+            return oResult;
+        }
+
+        /**
+         * @brief Computes the statistics of a batch.
+         * @param vResults Results of the jobs
+         * @param nThreads Number of threads used
+         * @param nWallTime Wall time of the batch
+         * @return Aggregate statistics
+         */
+        shell_batch_stats make_batch_stats(
+            const std::vector<shell_job_result> &vResults,
+            const std::size_t nThreads,
+            const std::chrono::nanoseconds nWallTime
+        ) {
+            shell_batch_stats oStats;
+            oStats.m_nJobs = vResults.size();
+            oStats.m_nThreads = nThreads;
+            oStats.m_nWallTime = nWallTime;
+            if (vResults.empty()) return oStats;
+
+            std::vector<std::chrono::nanoseconds> vLatencies;
+            vLatencies.reserve(vResults.size());
+            for (const auto &oResult: vResults) vLatencies.push_back(oResult.m_nLatency);
+            std::ranges::sort(vLatencies);
+
+            // Nearest rank
+            const auto fPercentile = [&vLatencies](const std::size_t nPercent) {
+                const std::size_t nRank = (nPercent * vLatencies.size() + 99) / 100;
+                return vLatencies[std::max<std::size_t>(nRank, 1) - 1];
+            };
+            oStats.m_nLatencyP50 = fPercentile(50);
+            oStats.m_nLatencyP99 = fPercentile(99);
+            oStats.m_nLatencyMax = vLatencies.back();
+            if (nWallTime.count() > 0)
+                oStats.m_dThroughput = static_cast<double>(vResults.size()) * 1e9
+                                       / static_cast<double>(nWallTime.count());
+            return oStats;
+        }
+    }
+
+    shell_batch_result shell::run_batch(const std::span<const shell_job> vJobs, std::size_t nThreads) const {
+        // Choose pool size
+        if constexpr (!shell_traits::THREAD_SAFE) nThreads = 1;
+        if (nThreads == 0) nThreads = std::max(1u, std::thread::hardware_concurrency());
+        nThreads = std::max<std::size_t>(1, std::min(nThreads, vJobs.size()));
+
+        shell_batch_result oResult;
+        oResult.m_vResults.resize(vJobs.size());
+        std::atomic<std::size_t> nNext{0};
+
+        // Workers take the next job until none is left
+        const auto fWork = [&]() {
+            for (std::size_t i; (i = nNext.fetch_add(1, std::memory_order_relaxed)) < vJobs.size();)
+                oResult.m_vResults[i] = run_job(this, vJobs[i]);
+        };
+
+        const auto nStart = std::chrono::steady_clock::now();
+        {
+            // The workers are joined on every exit
+            std::vector<std::jthread> vThreads;
+            vThreads.reserve(nThreads - 1);
+            try {
+                for (std::size_t i = 1; i < nThreads; ++i) vThreads.emplace_back(fWork);
+            } catch (const std::system_error &) {
+                // The jobs run on the threads already started
+                nThreads = vThreads.size() + 1;
+            }
+            fWork();
+        }
+        const auto nWallTime = std::chrono::steady_clock::now() - nStart;
+
+        oResult.m_oStats = make_batch_stats(oResult.m_vResults, nThreads, nWallTime);
+        return oResult;
     }
 }
@@ -0,0 +1,185 @@
+/**
+ * @file mapped_file.h
+ * @brief Defines class `bs::mapped_file`.
+ *
+ * This file contains the definition of the `bs::mapped_file` class,
+ * which exposes the contents of a file as a read-only view. On POSIX
+ * systems the file is memory-mapped, elsewhere it is read into memory.
+ *
+ * @date Created on 22/11/25
+ * @author Dante Doménech Martínez
+ *
+ * @copyright GNU General Public License v3.0
+ *
+ * This file is part of BashSpark.
+ * Copyright (C) 2025 Dante Doménech Martínez
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <filesystem>
+#include <string>
+#include <string_view>
+#include <system_error>
+
+#if defined(__unix__) || defined(__APPLE__)
+#define BS_MAPPED_FILE_MMAP
+#include <cerrno>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#else
+#include <fstream>
+#endif
+
+namespace bs {
+    /**
+     * @class mapped_file
+     * @brief Read-only view of the contents of a file.
+     *
+     * Regular files are mapped. Pipes, devices and files reporting an empty
+     * size, such as those of `/proc`, are read instead. The view is valid for
+     * the lifetime of the object.
+     */
+    class mapped_file {
+    public:
+        /**
+         * @brief Maps a file.
+         * @param oPath Path of the file.
+         * @throw std::filesystem::filesystem_error If the file can not be read.
+         */
+        explicit mapped_file(const std::filesystem::path &oPath) {
+#ifdef BS_MAPPED_FILE_MMAP
+            const file_guard oFile(::open(oPath.c_str(), O_RDONLY | O_CLOEXEC));
+            if (oFile.m_nFile < 0) fail(oPath, errno);
+
+            struct stat oStat{};
+            if (::fstat(oFile.m_nFile, &oStat) != 0) fail(oPath, errno);
+
+            // Only regular files with a known size can be mapped
+            const auto nSize = static_cast<std::size_t>(oStat.st_size);
+            if (!S_ISREG(oStat.st_mode) || nSize == 0) {
+                this->read_all(oPath, oFile.m_nFile);
+                this->m_sView = this->m_sData;
+            } else {
+                void *pData = ::mmap(nullptr, nSize, PROT_READ, MAP_PRIVATE, oFile.m_nFile, 0);
+                if (pData == MAP_FAILED) fail(oPath, errno);
+                ::madvise(pData, nSize, MADV_SEQUENTIAL);
+                this->m_sView = std::string_view(static_cast<const char *>(pData), nSize);
+                this->m_bMapped = true;
+            }
+#else
+            std::ifstream oFile(oPath, std::ios::binary);
+            if (!oFile) fail(oPath, static_cast<int>(std::errc::no_such_file_or_directory));
+            this->m_sData.assign(std::istreambuf_iterator<char>(oFile), {});
+            this->m_sView = this->m_sData;
+#endif
+        }
+
+        mapped_file(const mapped_file &) = delete;
+
+        mapped_file &operator=(const mapped_file &) = delete;
+
+        /**
+         * @brief Unmaps the file.
+         */
+        ~mapped_file() {
+#ifdef BS_MAPPED_FILE_MMAP
+            if (this->m_bMapped)
+                ::munmap(const_cast<char *>(this->m_sView.data()), this->m_sView.size());
+#endif
+        }
+
+    public:
+        /**
+         * @brief Gets the contents of the file.
+         * @return View of the contents.
+         */
+        [[nodiscard]] std::string_view view() const noexcept {
+            return this->m_sView;
+        }
+
+    private:
+#ifdef BS_MAPPED_FILE_MMAP
+        /**
+         * @brief Closes a file descriptor when leaving its scope.
+         */
+        struct file_guard {
+            /**
+             * @brief Constructs the guard.
+             * @param nFile Descriptor of the file, negative if it failed to open.
+             */
+            explicit file_guard(const int nFile) noexcept
+                : m_nFile(nFile) {
+            }
+
+            file_guard(const file_guard &) = delete;
+
+            file_guard &operator=(const file_guard &) = delete;
+
+            /**
+             * @brief Closes the file, if open.
+             */
+            ~file_guard() {
+                if (this->m_nFile >= 0) ::close(this->m_nFile);
+            }
+
+            /// Descriptor of the file
+            const int m_nFile;
+        };
+
+        /**
+         * @brief Reads a file until its end.
+         * @param oPath Path of the file.
+         * @param nFile Descriptor of the file.
+         */
+        void read_all(const std::filesystem::path &oPath, const int nFile) {
+            char vBuffer[4096];
+            while (true) {
+                const auto nRead = ::read(nFile, vBuffer, sizeof(vBuffer));
+                if (nRead == 0) break;
+                if (nRead < 0) {
+                    if (errno == EINTR) continue;
+                    fail(oPath, errno);
+                }
+                this->m_sData.append(vBuffer, static_cast<std::size_t>(nRead));
+            }
+        }
+#endif
+
+        /**
+         * @brief Throws the error of a failed file operation.
+         * @param oPath Path of the file.
+         * @param nError System error code.
+         */
+        [[noreturn]] static void fail(const std::filesystem::path &oPath, const int nError) {
+            throw std::filesystem::filesystem_error(
+                "can not read file", oPath, std::error_code(nError, std::generic_category())
+            );
+        }
+
+    private:
+        /// File contents, if read instead of mapped
+        std::string m_sData;
+        /// View of the file contents
+        std::string_view m_sView;
+#ifdef BS_MAPPED_FILE_MMAP
+        /// Whether the view is a mapping to unmap
+        bool m_bMapped = false;
+#endif
+    };
+}
@@ -0,0 +1,107 @@
+/**
+ * @file shell_alloc.cpp
+ * @brief Implements the allocation accounting of the interpreter.
+ *
+ * This file contains the definition of the `bs::shell_alloc_stats` and
+ * `bs::shell_alloc_scope` classes.
+ *
+ * @date Created on 22/11/25
+ * @author Dante Doménech Martínez
+ *
+ * @copyright GNU General Public License v3.0
+ *
+ * This file is part of BashSpark.
+ * Copyright (C) 2025 Dante Doménech Martínez
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "BashSpark/shell/shell_alloc.h"
+
+namespace bs {
+    namespace {
+        /**
+         * @brief Attribution of the allocations of a thread.
+         */
+        struct alloc_attribution {
+            shell_alloc_stats *m_pStats; ///< Stats, nullptr if not attributed.
+            shell_alloc_phase m_nPhase; ///< Phase.
+        };
+
+        /// Attribution of the calling thread, trivial so that it is safe to use from operator new
+        constinit thread_local alloc_attribution g_oAttribution{nullptr, shell_alloc_phase::SAP_CONTROL};
+    }
+
+    std::string_view get_alloc_phase_name(const shell_alloc_phase nPhase) noexcept {
+        switch (nPhase) {
+            case shell_alloc_phase::SAP_CONTROL: return "control";
+            case shell_alloc_phase::SAP_TOKENIZE: return "tokenize";
+            case shell_alloc_phase::SAP_PARSE: return "parse";
+            case shell_alloc_phase::SAP_EXPAND: return "expand";
+            case shell_alloc_phase::SAP_DISPATCH: return "dispatch";
+            case shell_alloc_phase::SAP_COMMAND: return "command";
+            default: return "unknown";
+        }
+    }
+
+    void shell_alloc_stats::record_allocation(const std::size_t nBytes) noexcept {
+        if (const auto pStats = g_oAttribution.m_pStats; pStats != nullptr)
+            pStats->add(g_oAttribution.m_nPhase, nBytes);
+    }
+
+    shell_alloc_count shell_alloc_stats::get(const shell_alloc_phase nPhase) const noexcept {
+        const auto nIndex = static_cast<std::size_t>(nPhase);
+        return {
+            this->m_vAllocations[nIndex].load(std::memory_order_relaxed),
+            this->m_vBytes[nIndex].load(std::memory_order_relaxed)
+        };
+    }
+
+    shell_alloc_count shell_alloc_stats::get_total() const noexcept {
+        shell_alloc_count oTotal;
+        for (std::size_t i = 0; i < SHELL_ALLOC_PHASES; ++i) {
+            oTotal.m_nAllocations += this->m_vAllocations[i].load(std::memory_order_relaxed);
+            oTotal.m_nBytes += this->m_vBytes[i].load(std::memory_order_relaxed);
+        }
+        return oTotal;
+    }
+
+    void shell_alloc_stats::add(const shell_alloc_phase nPhase, const std::size_t nBytes) noexcept {
+        const auto nIndex = static_cast<std::size_t>(nPhase);
+        this->m_vAllocations[nIndex].fetch_add(1, std::memory_order_relaxed);
+        this->m_vBytes[nIndex].fetch_add(nBytes, std::memory_order_relaxed);
+    }
+
+    void shell_alloc_stats::clear() noexcept {
+        for (std::size_t i = 0; i < SHELL_ALLOC_PHASES; ++i) {
+            this->m_vAllocations[i].store(0, std::memory_order_relaxed);
+            this->m_vBytes[i].store(0, std::memory_order_relaxed);
+        }
+    }
+
+    shell_alloc_scope::shell_alloc_scope(const shell_alloc_phase nPhase) noexcept
+        : m_bActive(g_oAttribution.m_pStats != nullptr) {
+        if (this->m_bActive) this->enter(g_oAttribution.m_pStats, nPhase);
+    }
+
+    void shell_alloc_scope::enter(shell_alloc_stats *pStats, const shell_alloc_phase nPhase) noexcept {
+        this->m_pPrevStats = g_oAttribution.m_pStats;
+        this->m_nPrevPhase = g_oAttribution.m_nPhase;
+        g_oAttribution = {pStats, nPhase};
+    }
+
+    void shell_alloc_scope::leave() const noexcept {
+        g_oAttribution = {this->m_pPrevStats, this->m_nPrevPhase};
+    }
+}
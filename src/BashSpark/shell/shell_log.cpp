@@ -0,0 +1,88 @@
+/**
+ * @file shell_log.cpp
+ * @brief Implements class shell_log.
+ *
+ * This file contains the definition of the `shell_log` class,
+ * which writes the diagnostics of the interpreter.
+ *
+ * @date Created on 22/11/25
+ * @author Dante Doménech Martínez
+ *
+ * @copyright GNU General Public License v3.0
+ *
+ * This file is part of BashSpark.
+ * Copyright (C) 2025 Dante Doménech Martínez
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "BashSpark/shell/shell_log.h"
+
+#include <mutex>
+
+namespace bs {
+    namespace {
+        /// Guards the sink
+        std::mutex g_oMutex;
+        /// Where the diagnostics are written, nullptr if disabled
+        std::ostream *g_pSink = nullptr;
+    }
+
+    void shell_log::configure(std::ostream &oSink, const shell_log_level nLevel, const std::uint32_t nCategories) {
+        std::uint64_t nMask = 0;
+        for (std::size_t nBit = 0; nBit <= static_cast<std::size_t>(nLevel); ++nBit)
+            nMask |= static_cast<std::uint64_t>(nCategories & ALL_CATEGORIES) << nBit * SHELL_LOG_CATEGORIES;
+
+        const std::lock_guard oLock(g_oMutex);
+        g_pSink = &oSink;
+        get_mask().store(nMask, std::memory_order_relaxed);
+    }
+
+    void shell_log::disable() noexcept {
+        const std::lock_guard oLock(g_oMutex);
+        get_mask().store(0, std::memory_order_relaxed);
+        g_pSink = nullptr;
+    }
+
+    void shell_log::write(const shell_log_level nLevel, const shell_log_category nCategory, const std::string_view sText) {
+        const std::lock_guard oLock(g_oMutex);
+        // The log may have been disabled since the check
+        if (g_pSink == nullptr || !is_enabled(nLevel, nCategory)) return;
+        *g_pSink << '[' << get_level_name(nLevel) << "] " << get_category_name(nCategory) << ": " << sText << '\n';
+        g_pSink->flush();
+    }
+
+    std::string_view shell_log::get_level_name(const shell_log_level nLevel) noexcept {
+        switch (nLevel) {
+            case shell_log_level::SLL_ERROR: return "error";
+            case shell_log_level::SLL_WARNING: return "warning";
+            case shell_log_level::SLL_INFO: return "info";
+            case shell_log_level::SLL_DEBUG: return "debug";
+            case shell_log_level::SLL_TRACE: return "trace";
+            default: return "unknown";
+        }
+    }
+
+    std::string_view shell_log::get_category_name(const shell_log_category nCategory) noexcept {
+        switch (nCategory) {
+            case shell_log_category::SLC_TOKENIZE: return "tokenize";
+            case shell_log_category::SLC_PARSE: return "parse";
+            case shell_log_category::SLC_EXPAND: return "expand";
+            case shell_log_category::SLC_COMMAND: return "command";
+            case shell_log_category::SLC_FUNCTION: return "function";
+            case shell_log_category::SLC_SESSION: return "session";
+            default: return "unknown";
+        }
+    }
+}
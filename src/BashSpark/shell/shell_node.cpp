@@ -99,6 +99,21 @@ namespace bs {
         if (m_pCommand == nullptr)throw shell_node_invalid_argument("Sentence command can not be null");
     }
 
+    shell_node_dollar_array::shell_node_dollar_array(
+        const std::size_t nPos,
+        std::string sVariable,
+        const shell_array_access nAccess,
+        std::unique_ptr<shell_node_expandable> &&pSubscript
+    )
+        : shell_node(shell_node_type::SNT_DOLLAR_ARRAY, nPos),
+          shell_node_expandable(shell_node_type::SNT_DOLLAR_ARRAY, nPos),
+          m_sVariable(std::move(sVariable)),
+          m_nAccess(nAccess),
+          m_pSubscript(std::move(pSubscript)) {
+        if (m_nAccess == shell_array_access::SAA_ELEMENT && m_pSubscript == nullptr)
+            throw shell_node_invalid_argument("Subscript can not be null");
+    }
+
     shell_node_dollar_command::shell_node_dollar_command(
         const std::size_t nPos,
         std::unique_ptr<shell_node_evaluable> &&pCommand
@@ -277,6 +292,26 @@ namespace bs {
         if (m_pIterative == nullptr)throw shell_node_invalid_argument("Iterative block can not be null");
     }
 
+    shell_node_for_count::shell_node_for_count(
+        const std::size_t nPos,
+        std::string sVariable,
+        std::unique_ptr<shell_node_expandable> &&pFrom,
+        std::unique_ptr<shell_node_expandable> &&pTo,
+        std::unique_ptr<shell_node_expandable> &&pStep,
+        std::unique_ptr<shell_node_evaluable> &&pIterative
+    )
+        : shell_node(shell_node_type::SNT_FOR_COUNT, nPos),
+          shell_node_evaluable(shell_node_type::SNT_FOR_COUNT, nPos),
+          m_sVariable(std::move(sVariable)),
+          m_pFrom(std::move(pFrom)),
+          m_pTo(std::move(pTo)),
+          m_pStep(std::move(pStep)),
+          m_pIterative(std::move(pIterative)) {
+        if (m_pFrom == nullptr)throw shell_node_invalid_argument("From value can not be null");
+        if (m_pTo == nullptr)throw shell_node_invalid_argument("To value can not be null");
+        if (m_pIterative == nullptr)throw shell_node_invalid_argument("Iterative block can not be null");
+    }
+
     shell_node_while::shell_node_while(
         const std::size_t nPos,
         std::unique_ptr<shell_node_evaluable> &&pCondition,
@@ -31,47 +31,486 @@
 #include "BashSpark/tools/utf.h"
 #include "BashSpark/shell.h"
 
+#include <atomic>
+#include <chrono>
+#include <exception>
+#include <ios>
+#include <optional>
+#include <ostream>
+#include <thread>
+
 #include "shell_tools.h"
 #include "BashSpark/command/command_test.h"
+#include "BashSpark/shell/shell_alloc.h"
+#include "BashSpark/shell/shell_log.h"
+#include "BashSpark/shell/shell_profiler.h"
+#include "BashSpark/shell/shell_tracer.h"
+#include "BashSpark/tools/countstream.h"
+#include "BashSpark/tools/nullstream.h"
 #include "BashSpark/tools/shell_def.h"
+#include "BashSpark/tools/tokenstream.h"
 
 namespace bs {
-    shell_status shell_node_command::evaluate(shell_session &oSession) const {
-        const auto pShell = oSession.get_shell();
-        std::vector<std::string> vTokens;
+    namespace {
+        /**
+         * @brief Gets the command of a sequence made of a single command substitution
+         * @param pSequence Sequence of a for-loop
+         * @return The substituted command, or nullptr if the sequence is anything else
+         */
+        const shell_node_evaluable *get_substitution(const shell_node_expandable *pSequence) {
+            if (pSequence->get_type() != shell_node_type::SNT_COMMAND_EXPRESSION)
+                return nullptr;
+            const shell_node_expandable *pChild = nullptr;
+            for (const auto &pItem: static_cast<const shell_node_command_expression *>(pSequence)->get_children()) {
+                if (pItem == nullptr) continue;
+                if (pChild != nullptr) return nullptr;
+                pChild = pItem.get();
+            }
+            if (pChild == nullptr) return nullptr;
+            switch (pChild->get_type()) {
+                case shell_node_type::SNT_DOLLAR_COMMAND:
+                    return static_cast<const shell_node_dollar_command *>(pChild)->get_command();
+                case shell_node_type::SNT_STR_BACK:
+                    return static_cast<const shell_node_str_back *>(pChild)->get_command();
+                default:
+                    return nullptr;
+            }
+        }
 
-        // Render command
-        this->m_pCommand->expand(vTokens, oSession, true);
-        ofakestream oStr;
-        concat_vector(oStr, vTokens);
-#ifdef BS_DEBUG
-        std::cout << "cmd " << oStr.str() << std::endl;
-#endif
+        /**
+         * @class command_meter
+         * @brief Records the run of a command in its metrics while alive.
+         *
+         * The session is redirected to counting streams forwarding to the buffers
+         * of its own streams, which are left untouched, and restored on destruction.
+         * If both streams are the same, everything counts as standard output.
+         * A run whose status is not set, as when the command throws, is recorded
+         * as a failed run.
+         */
+        class command_meter {
+        public:
+            /**
+             * @brief Starts measuring.
+             * @param oCommand Command that runs
+             * @param oSession Session of the run
+             */
+            command_meter(const command &oCommand, shell_session &oSession)
+                : m_oMetrics(oCommand.get_metrics()),
+                  m_oSession(oSession),
+                  m_oOut(oSession.out()),
+                  m_oErr(oSession.err()),
+                  m_oOutCounter(m_oOut.rdbuf()),
+                  m_oErrCounter(m_oErr.rdbuf()),
+                  m_oOutStream(&m_oOutCounter),
+                  m_oErrStream(&m_oErrCounter) {
+                prepare(this->m_oOutStream, this->m_oOut);
+                if (&this->m_oErr == &this->m_oOut) {
+                    oSession.set_output(this->m_oOutStream, this->m_oOutStream);
+                } else {
+                    prepare(this->m_oErrStream, this->m_oErr);
+                    oSession.set_output(this->m_oOutStream, this->m_oErrStream);
+                }
+                this->m_nStart = std::chrono::steady_clock::now();
+            }
 
-        // Get command
-        const auto pCommand = oSession.get_shell()->get_command(vTokens[0]);
-        if (pCommand == nullptr) {
-            pShell->msg_error_command_not_found(oSession, vTokens[0]);
-            oSession.set_last_command_result(shell_status::SHELL_ERROR_COMMAND_NOT_FOUND);
-            return shell_status::SHELL_ERROR_COMMAND_NOT_FOUND;
+            /**
+             * @brief Restores the session streams and records the run.
+             */
+            ~command_meter() {
+                const auto nLatency = std::chrono::steady_clock::now() - this->m_nStart;
+                this->m_oSession.set_output(this->m_oOut, this->m_oErr);
+                restore(this->m_oOut, this->m_oOutStream);
+                if (&this->m_oErr != &this->m_oOut) restore(this->m_oErr, this->m_oErrStream);
+                this->m_oMetrics.record(
+                    this->m_nStatus,
+                    std::chrono::duration_cast<std::chrono::nanoseconds>(nLatency),
+                    this->m_oOutCounter.count(),
+                    this->m_oErrCounter.count()
+                );
+            }
+
+            command_meter(const command_meter &) = delete;
+
+            command_meter &operator=(const command_meter &) = delete;
+
+        public:
+            /**
+             * @brief Sets the status of the run, error until set.
+             * @param nStatus Status returned by the command
+             */
+            void set_status(const shell_status nStatus) noexcept {
+                this->m_nStatus = nStatus;
+            }
+
+        private:
+            /**
+             * @brief Gives a counting stream the format and state of the stream it counts.
+             * @param oCounting The counting stream
+             * @param oStream The counted stream
+             */
+            static void prepare(std::ostream &oCounting, const std::ostream &oStream) {
+                oCounting.copyfmt(oStream);
+                oCounting.clear(oStream.rdstate());
+            }
+
+            /**
+             * @brief Reports the write failures of a counting stream on the stream it counts.
+             * @param oStream The counted stream
+             * @param oCounting The counting stream
+             */
+            static void restore(std::ostream &oStream, const std::ostream &oCounting) noexcept {
+                const auto nFailed = oCounting.rdstate() & ~oStream.rdstate();
+                if (nFailed == std::ios_base::goodbit) return;
+                try {
+                    oStream.setstate(nFailed);
+                } catch (const std::ios_base::failure &) {
+                    // Already thrown by the counting stream
+                }
+            }
+
+        private:
+            command_metrics &m_oMetrics; ///< Metrics of the command.
+            shell_session &m_oSession; ///< Session of the run.
+            std::ostream &m_oOut; ///< Standard output of the session.
+            std::ostream &m_oErr; ///< Error output of the session.
+            countbuffer m_oOutCounter; ///< Counts the standard output.
+            countbuffer m_oErrCounter; ///< Counts the error output.
+            std::ostream m_oOutStream; ///< Counting standard output.
+            std::ostream m_oErrStream; ///< Counting error output.
+            std::chrono::steady_clock::time_point m_nStart; ///< Start of the run.
+            shell_status m_nStatus = shell_status::SHELL_ERROR; ///< Status of the run.
+        };
+
+        /**
+         * @class command_run
+         * @brief Steps of a command run shared by the evaluators.
+         *
+         * Expands the command on construction, then looks it up, measures the run
+         * and establishes its result. The evaluators only run the command.
+         */
+        class command_run {
+        public:
+            /**
+             * @brief Expands the command.
+             * @param oSession Session of the run
+             * @param pExpression Expression of the command
+             */
+            command_run(shell_session &oSession, const shell_node_command_expression *pExpression)
+                : m_oSession(oSession) {
+                {
+                    const shell_alloc_scope oAlloc(oSession, shell_alloc_phase::SAP_EXPAND);
+                    pExpression->expand(this->m_vTokens, oSession, true);
+                }
+                BS_LOG(SLL_TRACE, SLC_COMMAND, "cmd " << shell_log::join(this->m_vTokens));
+            }
+
+            command_run(const command_run &) = delete;
+
+            command_run &operator=(const command_run &) = delete;
+
+        public:
+            /**
+             * @brief Checks whether the command expanded to no word.
+             *
+             * Such a command, as `${a[@]}` for an empty array, is run as a null
+             * command: it is not looked up and succeeds.
+             *
+             * @return Whether the command has no name
+             */
+            [[nodiscard]] bool empty() const noexcept {
+                return this->m_vTokens.empty();
+            }
+
+            /**
+             * @brief Gets the name of the command.
+             * @return The first word of the command, which must not be \ref empty
+             */
+            [[nodiscard]] const std::string &name() const noexcept {
+                return this->m_vTokens[0];
+            }
+
+            /**
+             * @brief Gets the command found by \ref dispatch.
+             * @return The command
+             */
+            [[nodiscard]] const command &get_command() const noexcept {
+                return *this->m_pCommand;
+            }
+
+            /**
+             * @brief Gets the arguments of the command.
+             * @return The words after the name, alive as long as the run
+             */
+            [[nodiscard]] std::span<const std::string> args() const noexcept {
+                return {this->m_vTokens.data() + 1, this->m_vTokens.size() - 1};
+            }
+
+            /**
+             * @brief Runs the command if it is a builtin of the shell.
+             *
+             * The builtins are called through their type, without looking them up
+             * in the hash table. Not used while collecting metrics, whose meter
+             * needs the command before its run.
+             *
+             * @param nStatus Set to the status of the run if the command is a builtin
+             * @return Whether the command was a builtin
+             */
+            bool run_builtin(shell_status &nStatus) const {
+                const auto pShell = this->m_oSession.get_shell();
+                if (pShell->get_collect_metrics()) return false;
+                const shell_alloc_scope oAlloc(this->m_oSession, shell_alloc_phase::SAP_DISPATCH);
+                return pShell->run_builtin(this->name(), this->args(), this->m_oSession, nStatus);
+            }
+
+            /**
+             * @brief Looks up the command and starts measuring its run.
+             *
+             * If the command is not found, the error is displayed and set as result.
+             *
+             * @return Whether the command was found
+             */
+            bool dispatch() {
+                const auto pShell = this->m_oSession.get_shell();
+                {
+                    const shell_alloc_scope oAlloc(this->m_oSession, shell_alloc_phase::SAP_DISPATCH);
+                    this->m_pCommand = pShell->get_command(this->name());
+                    if (this->m_pCommand == nullptr) {
+                        pShell->msg_error_command_not_found(this->m_oSession, this->name());
+                        this->m_oSession.set_last_command_result(shell_status::SHELL_ERROR_COMMAND_NOT_FOUND);
+                        return false;
+                    }
+                }
+                if (pShell->get_collect_metrics()) this->m_oMeter.emplace(*this->m_pCommand, this->m_oSession);
+                return true;
+            }
+
+            /**
+             * @brief Normalizes a syntax error thrown by the command.
+             * @param oException The syntax error
+             * @return Status of the run
+             */
+            shell_status syntax_error(const shell_parser_exception &oException) const {
+                this->m_oSession.get_shell()->msg_error_syntax_error(this->m_oSession, oException);
+                return oException.get_status();
+            }
+
+            /**
+             * @brief Establishes the result of the run.
+             *
+             * A run that is not finished, as when the command throws, is
+             * recorded as a failed run once destroyed.
+             *
+             * @param nStatus Status of the run
+             * @return The status
+             */
+            shell_status finish(const shell_status nStatus) {
+                if (this->m_oMeter) this->m_oMeter->set_status(nStatus);
+                this->m_oMeter.reset();
+                this->m_oSession.set_last_command_result(nStatus);
+                return nStatus;
+            }
+
+        private:
+            shell_session &m_oSession; ///< Session of the run.
+            std::vector<std::string> m_vTokens; ///< Name and arguments.
+            const command *m_pCommand = nullptr; ///< Command, once found.
+            std::optional<command_meter> m_oMeter; ///< Meter of the run, if collecting metrics.
+        };
+
+        /**
+         * @class pipe_run
+         * @brief Sessions of both sides of a pipe, shared by the evaluators.
+         *
+         * Builtins on the left side may write records instead of text, which
+         * are only rendered if the right side reads them as text.
+         */
+        class pipe_run {
+        public:
+            /**
+             * @brief Makes the session of the left side.
+             * @param oSession Session of the pipe
+             */
+            explicit pipe_run(shell_session &oSession)
+                : m_oSession(oSession),
+                  m_oRecords(m_oStdOut),
+                  m_pSessionLeft(oSession.make_pipe_left(m_oStdOut)) {
+                this->m_pSessionLeft->set_record_output(&this->m_oRecords);
+            }
+
+            pipe_run(const pipe_run &) = delete;
+
+            pipe_run &operator=(const pipe_run &) = delete;
+
+        public:
+            /**
+             * @brief Gets the session of the left side.
+             * @return The session writing to the pipe
+             */
+            [[nodiscard]] shell_session &left() const noexcept {
+                return *this->m_pSessionLeft;
+            }
+
+            /**
+             * @brief Makes the session of the right side, once the left side is finished.
+             * @return The session reading from the pipe
+             */
+            shell_session &right() {
+                if (!this->m_oRecords.is_typed())
+                    this->m_oStdIn.str(this->m_oRecords.has_records()
+                                           ? this->m_oRecords.text()
+                                           : std::move(this->m_oStdOut).str());
+                this->m_pSessionRight = this->m_oSession.make_pipe_right(this->m_oStdIn);
+                if (this->m_oRecords.is_typed())
+                    this->m_pSessionRight->set_record_input(&this->m_oRecords, this->m_oStdIn);
+                return *this->m_pSessionRight;
+            }
+
+        private:
+            shell_session &m_oSession; ///< Session of the pipe.
+            std::ostringstream m_oStdOut; ///< Output of the left side.
+            shell_records m_oRecords; ///< Records of the left side.
+            std::istringstream m_oStdIn; ///< Input of the right side.
+            std::unique_ptr<shell_session> m_pSessionLeft; ///< Session of the left side.
+            std::unique_ptr<shell_session> m_pSessionRight; ///< Session of the right side.
+        };
+
+        /**
+         * @brief Makes the session of a command of a subshell.
+         * @param oSession Session of the subshell block
+         * @return Independent session sharing the streams
+         */
+        std::unique_ptr<shell_session> make_subshell(shell_session &oSession) {
+            return oSession.make_subsession(oSession.in(), oSession.out(), oSession.err());
         }
 
-        // Get args
-        const std::span vArgs(vTokens.data() + 1, vTokens.size() - 1);
-        auto nStatus = shell_status::SHELL_SUCCESS;
+        /**
+         * @brief Expands the sequence of a for-loop.
+         * @param oSession Session of the loop
+         * @param pSequence Sequence of the loop
+         * @return The items
+         */
+        std::vector<std::string> expand_sequence(shell_session &oSession, const shell_node_expandable *pSequence) {
+            std::vector<std::string> vSequence;
+            pSequence->expand(vSequence, oSession, true);
+            return vSequence;
+        }
 
-        // Run
+        /**
+         * @class stream_substitution
+         * @brief Runs a command substitution on a worker thread.
+         *
+         * The output of the command is split into items pushed to a bounded queue.
+         * Joining cancels the producer if items are left (its next write fails),
+         * then writes its error output to the session. Destruction joins it too,
+         * so no exit path of the loop loses the error output.
+         */
+        class stream_substitution {
+        public:
+            /**
+             * @brief Starts the producer
+             * @param oSession Session of the loop
+             * @param pCommand Command producing the items
+             */
+            stream_substitution(shell_session &oSession, const shell_node_evaluable *pCommand)
+                : m_oQueue(shell::STREAM_SUBSTITUTION_QUEUE_SIZE),
+                  m_oStdOut(m_oQueue),
+                  m_oErr(oSession.err()),
+                  m_pSession(oSession.make_subsession(m_oStdIn, m_oStdOut, m_oStdErr)) {
+                // The profiler is not shared across threads
+                this->m_pSession->set_profiler(nullptr);
+                // Writing on a closed queue aborts the producer
+                this->m_oStdOut.exceptions(std::ios_base::badbit);
+                this->m_oThread = std::thread([this, pCommand] {
+                    // The allocation stats are shared across threads, but the attribution is per thread
+                    const shell_alloc_scope oAlloc(*this->m_pSession, shell_alloc_phase::SAP_CONTROL);
+                    const shell_tracer::scope oTrace(*this->m_pSession, shell_trace_category::STC_SUBSTITUTION, "stream");
+                    try {
+                        pCommand->evaluate(*this->m_pSession);
+                        this->m_oStdOut.finish();
+                    } catch (const std::ios_base::failure &) {
+                        // A write failing because the loop left early is not an error
+                        if (!this->m_bCancelled) this->m_pException = std::current_exception();
+                    } catch (...) {
+                        this->m_pException = std::current_exception();
+                    }
+                    this->m_oQueue.close();
+                });
+            }
+
+            /**
+             * @brief Cancels and joins the producer, if not finished
+             */
+            ~stream_substitution() {
+                if (this->m_oThread.joinable()) this->join();
+            }
+
+            stream_substitution(const stream_substitution &) = delete;
+
+            stream_substitution &operator=(const stream_substitution &) = delete;
+
+        public:
+            /**
+             * @brief Waits for the next item
+             * @param sItem Where to store the item
+             * @return false once the producer has finished and every item has been consumed
+             */
+            bool next(std::string &sItem) {
+                return this->m_oQueue.pop(sItem);
+            }
+
+            /**
+             * @brief Joins the producer, cancelling it if items are left
+             *
+             * Writes the producer error output and rethrows its exception, if any.
+             */
+            void finish() {
+                this->join();
+                if (this->m_pException)
+                    std::rethrow_exception(this->m_pException);
+            }
+
+        private:
+            /**
+             * @brief Cancels and joins the producer, then writes its error output
+             */
+            void join() {
+                this->m_bCancelled = true;
+                this->m_oQueue.close();
+                this->m_oThread.join();
+                this->m_oErr << this->m_oStdErr.view();
+            }
+
+        private:
+            token_queue m_oQueue; ///< Items pending to be consumed.
+            inullstream m_oStdIn; ///< Producer input, the producer reads nothing.
+            otokenstream m_oStdOut; ///< Producer output, split into the queue.
+            std::ostringstream m_oStdErr; ///< Producer error output.
+            std::ostream &m_oErr; ///< Error output of the loop session.
+            std::atomic<bool> m_bCancelled{false}; ///< Whether the loop stopped consuming.
+            std::unique_ptr<shell_session> m_pSession; ///< Producer session.
+            std::exception_ptr m_pException; ///< Exception thrown by the producer.
+            std::thread m_oThread; ///< Producer thread.
+        };
+    }
+
+    shell_status shell_node_command::evaluate(shell_session &oSession) const {
+        const shell_profiler::scope oProfile(oSession, this);
+        command_run oRun(oSession, this->m_pCommand.get());
+        if (oRun.empty()) return oRun.finish(shell_status::SHELL_SUCCESS);
+        const shell_tracer::scope oTrace(oSession, shell_trace_category::STC_COMMAND, oRun.name());
+
+        // Run, the builtins of a static shell without looking them up
+        shell_status nStatus;
         try {
-            nStatus = pCommand->run(vArgs, oSession);
+            if (!oRun.run_builtin(nStatus)) {
+                if (!oRun.dispatch()) return shell_status::SHELL_ERROR_COMMAND_NOT_FOUND;
+                const shell_alloc_scope oAlloc(oSession, shell_alloc_phase::SAP_COMMAND);
+                nStatus = oRun.get_command().run(oRun.args(), oSession);
+            }
         } catch (shell_parser_exception &oException) {
-            // Normalize syntax errors
-            oSession.get_shell()->msg_error_syntax_error(oSession, oException);
-            nStatus = oException.get_status();
+            nStatus = oRun.syntax_error(oException);
         }
-
-        // Establish result
-        oSession.set_last_command_result(nStatus);
-        return nStatus;
+        return oRun.finish(nStatus);
     }
 
     shell_status shell_node_null_command::evaluate(shell_session &oSession) const {
@@ -88,13 +527,9 @@ namespace bs {
     }
 
     shell_status shell_node_command_block_subshell::evaluate(shell_session &oSession) const {
+        const shell_profiler::scope oProfile(oSession, this);
         for (const auto &pSubCommand: this->m_vSubCommands) {
-            auto pSubSession = oSession.make_subsession(
-                oSession.in(),
-                oSession.out(),
-                oSession.err()
-            );
-            pSubCommand->evaluate(*pSubSession);
+            pSubCommand->evaluate(*make_subshell(oSession));
         }
         return oSession.get_last_command_result();
     }
@@ -104,6 +539,7 @@ namespace bs {
     }
 
     shell_status shell_node_and::evaluate(shell_session &oSession) const {
+        const shell_profiler::scope oProfile(oSession, this);
         const auto nLeft = this->get_left()->evaluate(oSession);
         if (nLeft == shell_status::SHELL_SUCCESS)
             return this->get_right()->evaluate(oSession);
@@ -111,6 +547,7 @@ namespace bs {
     }
 
     shell_status shell_node_or::evaluate(shell_session &oSession) const {
+        const shell_profiler::scope oProfile(oSession, this);
         const auto nLeft = this->get_left()->evaluate(oSession);
         if (nLeft != shell_status::SHELL_SUCCESS)
             return this->get_right()->evaluate(oSession);
@@ -118,21 +555,24 @@ namespace bs {
     }
 
     shell_status shell_node_pipe::evaluate(shell_session &oSession) const {
-        std::ostringstream oStdOut;
-        const auto pSessionLeft = oSession.make_pipe_left(oStdOut);
-        this->get_left()->evaluate(*pSessionLeft);
-        std::istringstream oStdIn(oStdOut.str());
-        const auto pSessionRight = oSession.make_pipe_right(oStdIn);
-        return this->get_right()->evaluate(*pSessionRight);
+        const shell_profiler::scope oProfile(oSession, this);
+        pipe_run oPipe(oSession);
+        {
+            const shell_tracer::scope oTrace(oPipe.left(), shell_trace_category::STC_PIPE, "pipe left");
+            this->get_left()->evaluate(oPipe.left());
+        }
+        auto &oSessionRight = oPipe.right();
+        const shell_tracer::scope oTrace(oSessionRight, shell_trace_category::STC_PIPE, "pipe right");
+        return this->get_right()->evaluate(oSessionRight);
     }
 
     shell_status shell_node_test::evaluate(shell_session &oSession) const {
+        const shell_profiler::scope oProfile(oSession, this);
         std::vector<std::string> vTokens;
 
         // Render test
         this->m_pTest->expand(vTokens, oSession, true);
-        ofakestream oStr;
-        concat_vector(oStr, vTokens);
+        BS_LOG(SLL_TRACE, SLC_COMMAND, "test " << shell_log::join(vTokens));
 
         // Get command
         std::unique_ptr<command_test> pCommand;
@@ -160,6 +600,7 @@ namespace bs {
     }
 
     shell_status shell_node_if::evaluate(shell_session &oSession) const {
+        const shell_profiler::scope oProfile(oSession, this);
         if (
             const auto nCondition = this->m_pCondition->evaluate(oSession);
             nCondition == shell_status::SHELL_SUCCESS
@@ -181,9 +622,27 @@ namespace bs {
     }
 
     shell_status shell_node_for::evaluate(shell_session &oSession) const {
-        std::vector<std::string> vSequence;
-        this->m_pSequence->expand(vSequence, oSession, true);
-        for (const auto &sItem: vSequence) {
+        const shell_profiler::scope oProfile(oSession, this);
+        // Streaming command substitution
+        if (oSession.get_shell()->get_stream_substitution()) {
+            if (const auto pCommand = get_substitution(this->m_pSequence.get())) {
+                stream_substitution oProducer(oSession, pCommand);
+                std::string sItem;
+                while (oProducer.next(sItem)) {
+                    oSession.set_var(this->m_sVariable, std::move(sItem));
+                    try {
+                        this->m_pIterative->evaluate(oSession);
+                    } catch (shell_node_continue::continue_signal &) {
+                    } catch (shell_node_break::break_signal &) {
+                        break;
+                    }
+                }
+                oProducer.finish();
+                return oSession.get_last_command_result();
+            }
+        }
+
+        for (const auto &sItem: expand_sequence(oSession, this->m_pSequence.get())) {
             oSession.set_var(this->m_sVariable, sItem);
             try {
                 this->m_pIterative->evaluate(oSession);
@@ -195,7 +654,109 @@ namespace bs {
         return oSession.get_last_command_result();
     }
 
+    namespace {
+        /**
+         * @brief Range of a counted for-loop.
+         */
+        struct count_range {
+            std::int64_t m_nCounter; ///< Current value, the first one until advanced.
+            std::int64_t m_nStep; ///< Step.
+            std::uint64_t m_nDistance; ///< Unsigned distance between the first and the last value.
+            std::uint64_t m_nStride; ///< Unsigned step.
+            std::uint64_t m_nDone = 0; ///< Unsigned distance already covered.
+
+            /**
+             * @brief Advances to the next value.
+             *
+             * The distance is computed unsigned, so neither the counter nor the distance can overflow.
+             *
+             * @return false once past the last value, then the counter is left on the last one.
+             */
+            bool advance() noexcept {
+                if (this->m_nStride == 0 || this->m_nDistance - this->m_nDone < this->m_nStride) return false;
+                this->m_nDone += this->m_nStride;
+                this->m_nCounter += this->m_nStep;
+                return true;
+            }
+        };
+
+        /**
+         * @brief Expands and checks the range of a counted for-loop.
+         * @param oSession Session context.
+         * @param pNode The loop.
+         * @param oRange Range to fill.
+         * @return SHELL_SUCCESS, or the error status once displayed.
+         */
+        shell_status make_count_range(
+            shell_session &oSession,
+            const shell_node_for_count *pNode,
+            count_range &oRange
+        ) {
+            const auto pShell = oSession.get_shell();
+
+            // Expand bounds
+            std::int64_t nValues[3] = {0, 0, 0};
+            const shell_node_expandable *pValues[3] = {
+                pNode->get_from(), pNode->get_to(), pNode->get_step()
+            };
+            for (std::size_t i = 0; i < 3; ++i) {
+                if (pValues[i] == nullptr) continue;
+                std::vector<std::string> vValue;
+                pValues[i]->expand(vValue, oSession, true);
+                if (vValue.size() != 1 || !parse_number(vValue[0], nValues[i])) {
+                    ofakestream oStr;
+                    concat_vector(oStr, vValue);
+                    pShell->msg_error_invalid_loop_bound(oSession, oStr.str());
+                    oSession.set_last_command_result(shell_status::SHELL_ERROR_INVALID_LOOP_BOUND);
+                    return shell_status::SHELL_ERROR_INVALID_LOOP_BOUND;
+                }
+            }
+            const std::int64_t nFrom = nValues[0];
+            const std::int64_t nTo = nValues[1];
+            std::int64_t nStep = nValues[2];
+
+            // Check step
+            if (pNode->get_step() == nullptr) {
+                nStep = nFrom > nTo ? -1 : 1;
+            } else if ((nFrom < nTo && nStep <= 0) || (nFrom > nTo && nStep >= 0)) {
+                pShell->msg_error_invalid_loop_step(oSession, nFrom, nStep, nTo);
+                oSession.set_last_command_result(shell_status::SHELL_ERROR_INVALID_LOOP_STEP);
+                return shell_status::SHELL_ERROR_INVALID_LOOP_STEP;
+            }
+
+            // Distance is computed unsigned, so neither the counter nor the distance can overflow
+            oRange.m_nCounter = nFrom;
+            oRange.m_nStep = nStep;
+            oRange.m_nDistance = nFrom <= nTo
+                                     ? static_cast<std::uint64_t>(nTo) - static_cast<std::uint64_t>(nFrom)
+                                     : static_cast<std::uint64_t>(nFrom) - static_cast<std::uint64_t>(nTo);
+            oRange.m_nStride = nStep >= 0
+                                   ? static_cast<std::uint64_t>(nStep)
+                                   : std::uint64_t{0} - static_cast<std::uint64_t>(nStep);
+            return shell_status::SHELL_SUCCESS;
+        }
+    }
+
+    shell_status shell_node_for_count::evaluate(shell_session &oSession) const {
+        const shell_profiler::scope oProfile(oSession, this);
+        count_range oRange{};
+        if (const auto nStatus = make_count_range(oSession, this, oRange); nStatus != shell_status::SHELL_SUCCESS)
+            return nStatus;
+
+        do {
+            oSession.set_var_int(this->m_sVariable, oRange.m_nCounter);
+            try {
+                this->m_pIterative->evaluate(oSession);
+            } catch (shell_node_continue::continue_signal &) {
+            } catch (shell_node_break::break_signal &) {
+                break;
+            }
+        } while (oRange.advance());
+        return oSession.get_last_command_result();
+    }
+
     shell_status shell_node_while::evaluate(shell_session &oSession) const {
+        const shell_profiler::scope oProfile(oSession, this);
         while (
             this->m_pCondition->evaluate(oSession) == shell_status::SHELL_SUCCESS
         ) {
@@ -210,6 +771,7 @@ namespace bs {
     }
 
     shell_status shell_node_until::evaluate(shell_session &oSession) const {
+        const shell_profiler::scope oProfile(oSession, this);
         while (
             this->m_pCondition->evaluate(oSession) != shell_status::SHELL_SUCCESS
         ) {
@@ -224,6 +786,7 @@ namespace bs {
     }
 
     shell_status shell_node_function::evaluate(shell_session &oSession) const {
+        const shell_profiler::scope oProfile(oSession, this);
         std::vector<std::string> vName;
         this->m_pName->expand(vName, oSession, true);
         if (vName.size() != 1 || !is_var(vName[0])) {
@@ -237,4 +800,159 @@ namespace bs {
         oSession.set_func(vName[0], this->m_pBody.get());
         return shell_status::SHELL_SUCCESS;
     }
+
+    shell_task shell_node_evaluable::evaluate_async(shell_session &oSession) const {
+        co_return this->evaluate(oSession);
+    }
+
+    shell_task shell_node_command::evaluate_async(shell_session &oSession) const {
+        command_run oRun(oSession, this->m_pCommand.get());
+        if (oRun.empty()) co_return oRun.finish(shell_status::SHELL_SUCCESS);
+        if (!oRun.dispatch()) co_return shell_status::SHELL_ERROR_COMMAND_NOT_FOUND;
+
+        // Run, the allocations are not attributed to the command since other tasks run while suspended
+        shell_status nStatus;
+        shell_tracer::begin_async(oSession, shell_trace_category::STC_COMMAND, oRun.name());
+        try {
+            nStatus = co_await oRun.get_command().run_async(oRun.args(), oSession);
+        } catch (shell_parser_exception &oException) {
+            nStatus = oRun.syntax_error(oException);
+        } catch (...) {
+            shell_tracer::end_async(oSession, shell_trace_category::STC_COMMAND, oRun.name());
+            throw;
+        }
+        shell_tracer::end_async(oSession, shell_trace_category::STC_COMMAND, oRun.name());
+        co_return oRun.finish(nStatus);
+    }
+
+    shell_task shell_node_command_block::evaluate_async(shell_session &oSession) const {
+        for (const auto &pSubCommand: this->m_vSubCommands) {
+            co_await shell_yield{};
+            co_await pSubCommand->evaluate_async(oSession);
+        }
+        co_return oSession.get_last_command_result();
+    }
+
+    shell_task shell_node_command_block_subshell::evaluate_async(shell_session &oSession) const {
+        for (const auto &pSubCommand: this->m_vSubCommands) {
+            co_await shell_yield{};
+            co_await pSubCommand->evaluate_async(*make_subshell(oSession));
+        }
+        co_return oSession.get_last_command_result();
+    }
+
+    shell_task shell_node_and::evaluate_async(shell_session &oSession) const {
+        const auto nLeft = co_await this->get_left()->evaluate_async(oSession);
+        if (nLeft == shell_status::SHELL_SUCCESS)
+            co_return co_await this->get_right()->evaluate_async(oSession);
+        co_return nLeft;
+    }
+
+    shell_task shell_node_or::evaluate_async(shell_session &oSession) const {
+        const auto nLeft = co_await this->get_left()->evaluate_async(oSession);
+        if (nLeft != shell_status::SHELL_SUCCESS)
+            co_return co_await this->get_right()->evaluate_async(oSession);
+        co_return nLeft;
+    }
+
+    shell_task shell_node_pipe::evaluate_async(shell_session &oSession) const {
+        pipe_run oPipe(oSession);
+        shell_tracer::begin_async(oPipe.left(), shell_trace_category::STC_PIPE, "pipe left");
+        try {
+            co_await this->get_left()->evaluate_async(oPipe.left());
+        } catch (...) {
+            shell_tracer::end_async(oPipe.left(), shell_trace_category::STC_PIPE, "pipe left");
+            throw;
+        }
+        shell_tracer::end_async(oPipe.left(), shell_trace_category::STC_PIPE, "pipe left");
+
+        auto &oSessionRight = oPipe.right();
+        shell_status nStatus;
+        shell_tracer::begin_async(oSessionRight, shell_trace_category::STC_PIPE, "pipe right");
+        try {
+            nStatus = co_await this->get_right()->evaluate_async(oSessionRight);
+        } catch (...) {
+            shell_tracer::end_async(oSessionRight, shell_trace_category::STC_PIPE, "pipe right");
+            throw;
+        }
+        shell_tracer::end_async(oSessionRight, shell_trace_category::STC_PIPE, "pipe right");
+        co_return nStatus;
+    }
+
+    shell_task shell_node_if::evaluate_async(shell_session &oSession) const {
+        if (
+            const auto nCondition = co_await this->m_pCondition->evaluate_async(oSession);
+            nCondition == shell_status::SHELL_SUCCESS
+        ) {
+            co_return co_await this->m_pCaseIf->evaluate_async(oSession);
+        }
+        if (this->m_pCaseElse != nullptr) {
+            co_return co_await this->m_pCaseElse->evaluate_async(oSession);
+        }
+        co_return oSession.get_last_command_result();
+    }
+
+    shell_task shell_node_for::evaluate_async(shell_session &oSession) const {
+        // The sequence is captured even with streaming substitution, waiting for the producer would block the scheduler
+        for (const auto &sItem: expand_sequence(oSession, this->m_pSequence.get())) {
+            oSession.set_var(this->m_sVariable, sItem);
+            try {
+                co_await this->m_pIterative->evaluate_async(oSession);
+            } catch (shell_node_continue::continue_signal &) {
+            } catch (shell_node_break::break_signal &) {
+                break;
+            }
+            co_await shell_yield{};
+        }
+        co_return oSession.get_last_command_result();
+    }
+
+    shell_task shell_node_for_count::evaluate_async(shell_session &oSession) const {
+        count_range oRange{};
+        if (const auto nStatus = make_count_range(oSession, this, oRange); nStatus != shell_status::SHELL_SUCCESS)
+            co_return nStatus;
+
+        for (;;) {
+            oSession.set_var_int(this->m_sVariable, oRange.m_nCounter);
+            try {
+                co_await this->m_pIterative->evaluate_async(oSession);
+            } catch (shell_node_continue::continue_signal &) {
+            } catch (shell_node_break::break_signal &) {
+                break;
+            }
+            if (!oRange.advance()) break;
+            co_await shell_yield{};
+        }
+        co_return oSession.get_last_command_result();
+    }
+
+    shell_task shell_node_while::evaluate_async(shell_session &oSession) const {
+        while (
+            co_await this->m_pCondition->evaluate_async(oSession) == shell_status::SHELL_SUCCESS
+        ) {
+            try {
+                co_await this->m_pIterative->evaluate_async(oSession);
+            } catch (shell_node_continue::continue_signal &) {
+            } catch (shell_node_break::break_signal &) {
+                break;
+            }
+            co_await shell_yield{};
+        }
+        co_return oSession.get_last_command_result();
+    }
+
+    shell_task shell_node_until::evaluate_async(shell_session &oSession) const {
+        while (
+            co_await this->m_pCondition->evaluate_async(oSession) != shell_status::SHELL_SUCCESS
+        ) {
+            try {
+                co_await this->m_pIterative->evaluate_async(oSession);
+            } catch (shell_node_continue::continue_signal &) {
+            } catch (shell_node_break::break_signal &) {
+                break;
+            }
+            co_await shell_yield{};
+        }
+        co_return oSession.get_last_command_result();
+    }
 }
@@ -32,6 +32,7 @@
 #include "BashSpark/shell.h"
 
 #include "shell_tools.h"
+#include "BashSpark/shell/shell_tracer.h"
 #include "BashSpark/tools/shell_def.h"
 
 namespace bs {
@@ -70,9 +71,6 @@ namespace bs {
         if (!oWord.empty()) {
             vTokens.push_back(oWord.str());
         }
-
-        ofakestream oStr;
-        concat_vector(oStr, vTokens);
     }
 
     void shell_node_word::expand(
@@ -96,14 +94,19 @@ namespace bs {
         shell_session &oSession,
         bool) const {
         ofakestream oOstream;
+        // An expansion without tokens, such as "${a[@]}" on an empty array, yields no word
+        bool bWord = m_vChildren.empty();
         for (const auto &pChild: m_vChildren) {
             std::vector<std::string> vSubTokens;
             pChild->expand(vSubTokens, oSession, false);
-            for (const auto &oSubExpansion: vSubTokens) {
-                oOstream << oSubExpansion;
+            for (std::size_t i = 0; i < vSubTokens.size(); ++i) {
+                // Each element of "${a[@]}" is a word, the first and last stick to the text around
+                if (i > 0) vTokens.push_back(oOstream.str_reset());
+                oOstream << vSubTokens[i];
+                bWord = true;
             }
         }
-        vTokens.push_back(oOstream.str());
+        if (bWord) vTokens.push_back(oOstream.str());
     }
 
     void shell_node_str_back::expand(
@@ -117,7 +120,10 @@ namespace bs {
             oStdOut,
             oSession.out()
         );
-        this->m_pCommand->evaluate(*pSubSession);
+        {
+            const shell_tracer::scope oTrace(*pSubSession, shell_trace_category::STC_SUBSTITUTION, "``");
+            this->m_pCommand->evaluate(*pSubSession);
+        }
         if (bSplit)
             split_string(vTokens, oStdOut.view());
         else
@@ -199,6 +205,56 @@ namespace bs {
         return "";
     }
 
+    void shell_node_dollar_array::expand(
+        std::vector<std::string> &vTokens,
+        shell_session &oSession,
+        const bool bSplit
+    ) const {
+        const auto pArray = oSession.get_array(this->m_sVariable);
+
+        switch (this->m_nAccess) {
+            case shell_array_access::SAA_ELEMENT: {
+                std::vector<std::string> vKey;
+                this->m_pSubscript->expand(vKey, oSession, false);
+                const auto pValue = pArray != nullptr && !vKey.empty() ? pArray->get(vKey.front()) : nullptr;
+                if (bSplit) {
+                    if (pValue != nullptr) split_string(vTokens, *pValue);
+                } else {
+                    vTokens.push_back(pValue != nullptr ? *pValue : "");
+                }
+                return;
+            }
+            case shell_array_access::SAA_SIZE: {
+                vTokens.push_back(std::to_string(pArray != nullptr ? pArray->size() : 0));
+                return;
+            }
+            default:
+                break;
+        }
+
+        // Values or keys, one token per element
+        std::vector<std::string> vItems;
+        if (pArray != nullptr) {
+            vItems.reserve(pArray->size());
+            if (pArray->is_associative()) {
+                for (const auto &[sKey, sValue]: pArray->get_map())
+                    vItems.push_back(this->m_nAccess == shell_array_access::SAA_KEYS ? sKey : sValue);
+            } else if (this->m_nAccess == shell_array_access::SAA_KEYS) {
+                for (std::size_t i = 0; i < pArray->size(); ++i)
+                    vItems.push_back(std::to_string(i));
+            } else {
+                vItems = pArray->get_values();
+            }
+        }
+
+        // Unquoted, each element is split as ${a[i]}; quoted, each element is a word
+        if (bSplit) {
+            for (const auto &sItem: vItems) split_string(vTokens, sItem);
+        } else {
+            for (auto &sItem: vItems) vTokens.push_back(std::move(sItem));
+        }
+    }
+
     void shell_node_dollar_command::expand(
         std::vector<std::string> &vTokens,
         shell_session &oSession,
@@ -210,14 +266,14 @@ namespace bs {
             oStdOut,
             oSession.err()
         );
-        this->m_pCommand->evaluate(*pSubSession);
+        {
+            const shell_tracer::scope oTrace(*pSubSession, shell_trace_category::STC_SUBSTITUTION, "$()");
+            this->m_pCommand->evaluate(*pSubSession);
+        }
         if (bSplit)
             split_string(vTokens, oStdOut.view());
         else
             vTokens.push_back(oStdOut.str());
-
-        ofakestream oStr;
-        concat_vector(oStr, vTokens);
     }
 
     std::string shell_node_dollar_special::get_value(
@@ -45,39 +45,47 @@ namespace bs {
 
         // Expandable
         if (const auto pNode = dynamic_cast<const shell_node_expandable *>(pRawNode)) {
-            inullstream oStdIn;
-            onullstream oStdOut;
-            onullstream oStdErr;
-            auto pSubsession = oSession.make_subsession(oStdIn, oStdOut, oStdErr);
-
-            std::ostringstream oStream;
-            std::vector<std::string> vTokens;
-            pNode->expand(vTokens, *pSubsession, true);
-            for (const auto &sToken: vTokens) {
-                oStream.put('[') << sToken << ']';
-            }
-            oJson["expansion"] = oStream.str();
+            oJson["expansion"] = get_expansion(oSession, pNode);
         }
 
         // Evaluable
         if (const auto pNode = dynamic_cast<const shell_node_evaluable *>(pRawNode)) {
-            inullstream oStdIn;
-            onullstream oStdOut;
-            onullstream oStdErr;
-            auto pSubsession = oSession.make_subsession(oStdIn, oStdOut, oStdErr);
-
-            auto nStatus = shell_status::SHELL_SUCCESS;
-            try {
-                nStatus = pNode->evaluate(*pSubsession);
-            } catch (shell_node_continue::continue_signal &) {
-            } catch (shell_node_break::break_signal &) {
-            }
-            oJson["evaluation"] = nStatus;
+            oJson["evaluation"] = get_evaluation(oSession, pNode);
         }
 
         return oJson;
     }
 
+    std::string shell_node_visitor_json::get_expansion(shell_session &oSession, const shell_node_expandable *pNode) {
+        inullstream oStdIn;
+        onullstream oStdOut;
+        onullstream oStdErr;
+        auto pSubsession = oSession.make_subsession(oStdIn, oStdOut, oStdErr);
+
+        std::ostringstream oStream;
+        std::vector<std::string> vTokens;
+        pNode->expand(vTokens, *pSubsession, true);
+        for (const auto &sToken: vTokens) {
+            oStream.put('[') << sToken << ']';
+        }
+        return oStream.str();
+    }
+
+    shell_status shell_node_visitor_json::get_evaluation(shell_session &oSession, const shell_node_evaluable *pNode) {
+        inullstream oStdIn;
+        onullstream oStdOut;
+        onullstream oStdErr;
+        auto pSubsession = oSession.make_subsession(oStdIn, oStdOut, oStdErr);
+
+        auto nStatus = shell_status::SHELL_SUCCESS;
+        try {
+            nStatus = pNode->evaluate(*pSubsession);
+        } catch (shell_node_continue::continue_signal &) {
+        } catch (shell_node_break::break_signal &) {
+        }
+        return nStatus;
+    }
+
     visit_type shell_node_visitor_json::visit(shell_session &oSession, const shell_node_word *pNode) {
         nlohmann::ordered_json oJson;
         oJson["type"] = "word";
@@ -251,6 +259,32 @@ namespace bs {
         return oJson;
     }
 
+    visit_type shell_node_visitor_json::visit(shell_session &oSession, const shell_node_dollar_array *pNode) {
+        nlohmann::ordered_json oJson;
+        oJson["type"] = "$array";
+        oJson["evaluation"] = nullptr;
+        oJson["expansion"] = nullptr;
+        oJson["variable"] = pNode->get_variable();
+        switch (pNode->get_access()) {
+            case shell_array_access::SAA_ELEMENT:
+                oJson["access"] = "element";
+                break;
+            case shell_array_access::SAA_VALUES:
+                oJson["access"] = "values";
+                break;
+            case shell_array_access::SAA_KEYS:
+                oJson["access"] = "keys";
+                break;
+            case shell_array_access::SAA_SIZE:
+                oJson["access"] = "size";
+                break;
+        }
+        oJson["subscript"] = pNode->get_subscript() != nullptr
+                                 ? this->visit_node(oSession, pNode->get_subscript())
+                                 : nlohmann::ordered_json(nullptr);
+        return oJson;
+    }
+
     visit_type shell_node_visitor_json::visit(shell_session &oSession, const shell_node_dollar_command *pNode) {
         nlohmann::ordered_json oJson;
         oJson["type"] = "$cmd";
@@ -265,7 +299,7 @@ namespace bs {
         oJson["type"] = "$@";
         oJson["evaluation"] = nullptr;
         oJson["expansion"] = nullptr;
-        oJson["item"] = std::string{1, pNode->get_item()};
+        oJson["item"] = std::string(1, pNode->get_item());
         oJson["value"] = pNode->get_value(oSession);
         return oJson;
     }
@@ -357,6 +391,21 @@ namespace bs {
         return oJson;
     }
 
+    visit_type shell_node_visitor_json::visit(shell_session &oSession, const shell_node_for_count *pNode) {
+        nlohmann::ordered_json oJson;
+        oJson["type"] = "for_count";
+        oJson["evaluation"] = nullptr;
+        oJson["expansion"] = nullptr;
+        oJson["variable"] = pNode->get_variable();
+        oJson["from"] = this->visit_node(oSession, pNode->get_from());
+        oJson["to"] = this->visit_node(oSession, pNode->get_to());
+        oJson["step"] = pNode->get_step() != nullptr
+                            ? this->visit_node(oSession, pNode->get_step())
+                            : nlohmann::ordered_json(nullptr);
+        oJson["iterative"] = this->visit_node(oSession, pNode->get_iterative());
+        return oJson;
+    }
+
     visit_type shell_node_visitor_json::visit(shell_session &oSession, const shell_node_while *pNode) {
         nlohmann::ordered_json oJson;
         oJson["type"] = "while";
@@ -0,0 +1,347 @@
+/**
+ * @file shell_node_visitor_json_writer.cpp
+ * @brief Implements class `bs::shell_node_visitor_json_writer`
+ *
+ * Implements class `bs::shell_node_visitor_json_writer` to visit shell node structures.
+ * This particular visitor writes the shell node structure as json to a stream while
+ * it traverses it.
+ *
+ * @date Created on 22/11/25
+ * @author Dante Doménech Martínez
+ *
+ * @copyright GNU General Public License v3.0
+ *
+ * This file is part of BashSpark.
+ * Copyright (C) 2025 Dante Doménech Martínez
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "BashSpark/shell/shell_node_visitor_json_writer.h"
+
+#include "BashSpark/shell/shell_node_visitor_json.h"
+
+namespace bs {
+    shell_node_visitor_json_writer::shell_node_visitor_json_writer(
+        std::ostream &oOut,
+        const int nIndent,
+        const char cIndent
+    )
+        : m_oOut(oOut),
+          m_nIndent(nIndent),
+          m_cIndent(cIndent) {
+    }
+
+    // Visit function for the base case
+    void shell_node_visitor_json_writer::visit_node(shell_session &oSession, const shell_node *pRawNode) {
+        // Computed before the children, written when the node is opened
+        this->m_oExpansion.reset();
+        this->m_oEvaluation.reset();
+        if (const auto pNode = dynamic_cast<const shell_node_expandable *>(pRawNode)) {
+            this->m_oExpansion = shell_node_visitor_json::get_expansion(oSession, pNode);
+        }
+        if (const auto pNode = dynamic_cast<const shell_node_evaluable *>(pRawNode)) {
+            this->m_oEvaluation = shell_node_visitor_json::get_evaluation(oSession, pNode);
+        }
+
+        shell_node_visitor::visit_node(oSession, pRawNode);
+    }
+
+    void shell_node_visitor_json_writer::write_indent() {
+        if (this->m_nIndent < 0) return;
+        this->m_oOut.put('\n');
+        const auto nIndent = static_cast<std::size_t>(this->m_nIndent) * this->m_vEmpty.size();
+        for (std::size_t i = 0; i < nIndent; ++i) this->m_oOut.put(this->m_cIndent);
+    }
+
+    void shell_node_visitor_json_writer::write_separator() {
+        if (!this->m_vEmpty.back()) this->m_oOut.put(',');
+        this->m_vEmpty.back() = false;
+        this->write_indent();
+    }
+
+    void shell_node_visitor_json_writer::write_key(const std::string_view sKey) {
+        this->write_separator();
+        this->write_value(sKey);
+        this->m_oOut.put(':');
+        if (this->m_nIndent >= 0) this->m_oOut.put(' ');
+    }
+
+    void shell_node_visitor_json_writer::write_member(
+        shell_session &oSession,
+        const std::string_view sKey,
+        const shell_node *pNode
+    ) {
+        this->write_key(sKey);
+        this->write_node(oSession, pNode);
+    }
+
+    void shell_node_visitor_json_writer::write_node(shell_session &oSession, const shell_node *pNode) {
+        if (pNode == nullptr)
+            this->m_oOut << "null";
+        else
+            this->visit_node(oSession, pNode);
+    }
+
+    void shell_node_visitor_json_writer::begin_node(const std::string_view sType) {
+        this->begin('{');
+        this->write_member("type", sType);
+        this->write_member("evaluation", this->m_oEvaluation.has_value()
+                                             ? nlohmann::ordered_json(*this->m_oEvaluation)
+                                             : nlohmann::ordered_json(nullptr));
+        this->write_member("expansion", this->m_oExpansion.has_value()
+                                            ? nlohmann::ordered_json(std::move(*this->m_oExpansion))
+                                            : nlohmann::ordered_json(nullptr));
+        this->m_oExpansion.reset();
+        this->m_oEvaluation.reset();
+    }
+
+    void shell_node_visitor_json_writer::begin(const char cOpen) {
+        this->m_oOut.put(cOpen);
+        this->m_vEmpty.push_back(true);
+    }
+
+    void shell_node_visitor_json_writer::end(const char cClose) {
+        const bool bEmpty = this->m_vEmpty.back();
+        this->m_vEmpty.pop_back();
+        if (!bEmpty) this->write_indent();
+        this->m_oOut.put(cClose);
+    }
+
+    void shell_node_visitor_json_writer::visit(shell_session &, const shell_node_word *pNode) {
+        this->begin_node("word");
+        this->write_member("text", pNode->get_text());
+        this->end('}');
+    }
+
+    void shell_node_visitor_json_writer::visit(shell_session &, const shell_node_unicode *pNode) {
+        this->begin_node("unicode");
+        this->write_member("char", pNode->get_character());
+        this->end('}');
+    }
+
+    void shell_node_visitor_json_writer::visit(shell_session &oSession, const shell_node_str_simple *pNode) {
+        this->begin_node("str simple");
+        this->write_children(oSession, "children", pNode->get_children());
+        this->end('}');
+    }
+
+    void shell_node_visitor_json_writer::visit(shell_session &oSession, const shell_node_str_double *pNode) {
+        this->begin_node("str double");
+        this->write_children(oSession, "children", pNode->get_children());
+        this->end('}');
+    }
+
+    void shell_node_visitor_json_writer::visit(shell_session &oSession, const shell_node_str_back *pNode) {
+        this->begin_node("str back");
+        this->write_member(oSession, "command", pNode->get_command());
+        this->end('}');
+    }
+
+    void shell_node_visitor_json_writer::visit(shell_session &, const shell_node_null_command *) {
+        this->begin_node("null cmd");
+        this->end('}');
+    }
+
+    // Visit function for command nodes
+    void shell_node_visitor_json_writer::visit(shell_session &oSession, const shell_node_command *pNode) {
+        this->begin_node("cmd");
+        this->write_member(oSession, "expression", pNode->get_command());
+        this->end('}');
+    }
+
+    void shell_node_visitor_json_writer::visit(shell_session &oSession, const shell_node_command_expression *pNode) {
+        this->begin_node("cmd exp");
+        this->write_children(oSession, "children", pNode->get_children());
+        this->end('}');
+    }
+
+    void shell_node_visitor_json_writer::visit(shell_session &oSession, const shell_node_command_block *pNode) {
+        this->begin_node("cmd block");
+        this->write_children(oSession, "children", pNode->get_children());
+        this->end('}');
+    }
+
+    void shell_node_visitor_json_writer::visit(shell_session &oSession, const shell_node_command_block_subshell *pNode) {
+        this->begin_node("cmd block sh");
+        this->write_children(oSession, "children", pNode->get_children());
+        this->end('}');
+    }
+
+    void shell_node_visitor_json_writer::visit(shell_session &oSession, const shell_node_arg *pNode) {
+        this->begin_node("arg");
+        this->write_member("arg", pNode->get_arg());
+        this->write_member("value", pNode->get_value(oSession));
+        this->end('}');
+    }
+
+    void shell_node_visitor_json_writer::visit(shell_session &oSession, const shell_node_variable *pNode) {
+        this->begin_node("var");
+        this->write_member("variable", pNode->get_variable());
+        this->write_member("value", pNode->get_value(oSession));
+        this->end('}');
+    }
+
+    void shell_node_visitor_json_writer::visit(shell_session &oSession, const shell_node_dollar_arg *pNode) {
+        this->begin_node("$arg");
+        this->write_member("arg", pNode->get_arg());
+        this->write_member("value", pNode->get_value(oSession));
+        this->end('}');
+    }
+
+    void shell_node_visitor_json_writer::visit(shell_session &oSession, const shell_node_dollar_variable *pNode) {
+        this->begin_node("$var");
+        this->write_member("variable", pNode->get_variable());
+        this->write_member("value", pNode->get_value(oSession));
+        this->end('}');
+    }
+
+    void shell_node_visitor_json_writer::visit(shell_session &oSession, const shell_node_dollar_arg_dhop *pNode) {
+        this->begin_node("$arg2");
+        this->write_member("arg", pNode->get_arg());
+        this->write_member("value", pNode->get_value(oSession));
+        this->end('}');
+    }
+
+    void shell_node_visitor_json_writer::visit(shell_session &oSession, const shell_node_dollar_variable_dhop *pNode) {
+        this->begin_node("$var2");
+        this->write_member("variable", pNode->get_variable());
+        this->write_member("value", pNode->get_value(oSession));
+        this->end('}');
+    }
+
+    void shell_node_visitor_json_writer::visit(shell_session &oSession, const shell_node_dollar_array *pNode) {
+        this->begin_node("$array");
+        this->write_member("variable", pNode->get_variable());
+        switch (pNode->get_access()) {
+            case shell_array_access::SAA_ELEMENT:
+                this->write_member("access", "element");
+                break;
+            case shell_array_access::SAA_VALUES:
+                this->write_member("access", "values");
+                break;
+            case shell_array_access::SAA_KEYS:
+                this->write_member("access", "keys");
+                break;
+            case shell_array_access::SAA_SIZE:
+                this->write_member("access", "size");
+                break;
+        }
+        this->write_member(oSession, "subscript", pNode->get_subscript());
+        this->end('}');
+    }
+
+    void shell_node_visitor_json_writer::visit(shell_session &oSession, const shell_node_dollar_command *pNode) {
+        this->begin_node("$cmd");
+        this->write_member(oSession, "command", pNode->get_command());
+        this->end('}');
+    }
+
+    void shell_node_visitor_json_writer::visit(shell_session &oSession, const shell_node_dollar_special *pNode) {
+        this->begin_node("$@");
+        this->write_member("item", std::string(1, pNode->get_item()));
+        this->write_member("value", pNode->get_value(oSession));
+        this->end('}');
+    }
+
+    void shell_node_visitor_json_writer::visit(shell_session &oSession, const shell_node_background *pNode) {
+        this->begin_node("&");
+        this->write_member(oSession, "cmd", pNode->get_command());
+        this->end('}');
+    }
+
+    void shell_node_visitor_json_writer::visit(shell_session &oSession, const shell_node_pipe *pNode) {
+        this->begin_node("|");
+        this->write_member(oSession, "left", pNode->get_left());
+        this->write_member(oSession, "right", pNode->get_right());
+        this->end('}');
+    }
+
+    void shell_node_visitor_json_writer::visit(shell_session &oSession, const shell_node_or *pNode) {
+        this->begin_node("||");
+        this->write_member(oSession, "left", pNode->get_left());
+        this->write_member(oSession, "right", pNode->get_right());
+        this->end('}');
+    }
+
+    void shell_node_visitor_json_writer::visit(shell_session &oSession, const shell_node_and *pNode) {
+        this->begin_node("&&");
+        this->write_member(oSession, "left", pNode->get_left());
+        this->write_member(oSession, "right", pNode->get_right());
+        this->end('}');
+    }
+
+    void shell_node_visitor_json_writer::visit(shell_session &oSession, const shell_node_test *pNode) {
+        this->begin_node("[]");
+        this->write_member(oSession, "test", pNode->get_test());
+        this->end('}');
+    }
+
+    void shell_node_visitor_json_writer::visit(shell_session &oSession, const shell_node_if *pNode) {
+        this->begin_node("if");
+        this->write_member(oSession, "condition", pNode->get_condition());
+        this->write_member(oSession, "case-if", pNode->get_case_if());
+        this->write_member(oSession, "case-else", pNode->get_case_else());
+        this->end('}');
+    }
+
+    void shell_node_visitor_json_writer::visit(shell_session &, const shell_node_break *) {
+        this->begin_node("break");
+        this->end('}');
+    }
+
+    void shell_node_visitor_json_writer::visit(shell_session &, const shell_node_continue *) {
+        this->begin_node("continue");
+        this->end('}');
+    }
+
+    void shell_node_visitor_json_writer::visit(shell_session &oSession, const shell_node_for *pNode) {
+        this->begin_node("for");
+        this->write_member("variable", pNode->get_variable());
+        this->write_member(oSession, "sequence", pNode->get_sequence());
+        this->write_member(oSession, "iterative", pNode->get_iterative());
+        this->end('}');
+    }
+
+    void shell_node_visitor_json_writer::visit(shell_session &oSession, const shell_node_for_count *pNode) {
+        this->begin_node("for_count");
+        this->write_member("variable", pNode->get_variable());
+        this->write_member(oSession, "from", pNode->get_from());
+        this->write_member(oSession, "to", pNode->get_to());
+        this->write_member(oSession, "step", pNode->get_step());
+        this->write_member(oSession, "iterative", pNode->get_iterative());
+        this->end('}');
+    }
+
+    void shell_node_visitor_json_writer::visit(shell_session &oSession, const shell_node_while *pNode) {
+        this->begin_node("while");
+        this->write_member(oSession, "condition", pNode->get_condition());
+        this->write_member(oSession, "iterative", pNode->get_iterative());
+        this->end('}');
+    }
+
+    void shell_node_visitor_json_writer::visit(shell_session &oSession, const shell_node_until *pNode) {
+        this->begin_node("until");
+        this->write_member(oSession, "condition", pNode->get_condition());
+        this->write_member(oSession, "iterative", pNode->get_iterative());
+        this->end('}');
+    }
+
+    void shell_node_visitor_json_writer::visit(shell_session &oSession, const shell_node_function *pNode) {
+        this->begin_node("function");
+        this->write_member(oSession, "name", pNode->get_name());
+        this->write_member(oSession, "body", pNode->get_body());
+        this->end('}');
+    }
+}
@@ -30,12 +30,14 @@
 #include "BashSpark/shell/shell_parser.h"
 
 #include <memory>
+#include <optional>
 #include <ranges>
 
 #include "shell_tools.h"
 #include "token_holder.h"
 #include "BashSpark/shell/shell_node_visitor_json.h"
 
+#include "BashSpark/shell/shell_alloc.h"
 #include "BashSpark/shell/shell_tokenizer.h"
 #include "BashSpark/shell/shell_parser_exception.h"
 #include "BashSpark/shell/shell_status.h"
@@ -71,25 +73,32 @@ namespace bs {
 
     shell_parser::shell_parser(
         ifakestream &oIstream,
-        token_holder &oTokens
+        token_holder &oTokens,
+        const std::shared_ptr<const shell_source> &pSource
     )
         : m_oIstream(oIstream),
+          m_pSource(pSource),
           m_oTokens(oTokens) {
     }
 
     evaluable_ptr shell_parser::parse(
-        ifakestream &oIstream
+        const std::shared_ptr<const shell_source> &pSource
     ) {
+        ifakestream oIstream(pSource->get_text());
+
         // Tokenize
+        std::optional<shell_alloc_scope> oAlloc(std::in_place, shell_alloc_phase::SAP_TOKENIZE);
         token_holder oTokens = {
             oIstream,
-            shell_tokenizer::tokens(oIstream)
+            shell_tokenizer::tokens(oIstream, pSource)
         };
 
         // Parse
+        oAlloc.emplace(shell_alloc_phase::SAP_PARSE);
         const std::unique_ptr<shell_parser> pParser(new shell_parser(
             oIstream,
-            oTokens
+            oTokens,
+            pSource
         ));
         auto pEvaluable = pParser->parse_block(
             shell_token_type::TK_EOF
@@ -106,7 +115,7 @@ namespace bs {
         if (this->m_nDepth > MAX_DEPTH) {
             throw shell_parser_exception{
                 shell_status::SHELL_ERROR_MAX_DEPTH_REACHED,
-                m_oIstream.str(), nPos
+                this->m_pSource, nPos
             };
         }
     }
@@ -128,7 +137,7 @@ namespace bs {
         if (pToken->m_sTokenText.length() < 2) {
             throw shell_parser_exception{
                 shell_status::SHELL_ERROR_BAD_ENCODING,
-                m_oIstream.str(), pToken->m_nPos
+                this->m_pSource, pToken->m_nPos
             };
         }
         switch (pToken->m_sTokenText[1]) {
@@ -193,7 +202,7 @@ namespace bs {
 
         throw shell_parser_exception{
             shell_status::SHELL_ERROR_BAD_ENCODING,
-            m_oIstream.str(), pToken->m_nPos
+            this->m_pSource, pToken->m_nPos
         };
     }
 
@@ -216,7 +225,7 @@ namespace bs {
                 default: {
                     throw shell_parser_exception{
                         shell_status::SHELL_ERROR_SYNTAX_ERROR_UNEXPECTED_TOKEN,
-                        m_oIstream.str(), pToken->m_nPos
+                        this->m_pSource, pToken->m_nPos
                     };
                 }
             }
@@ -227,7 +236,7 @@ namespace bs {
         if (pToken == nullptr) {
             throw shell_parser_exception{
                 shell_status::SHELL_ERROR_SYNTAX_ERROR_UNCLOSED_SIMPLE_QUOTES,
-                m_oIstream.str(), nStartPos
+                this->m_pSource, nStartPos
             };
         }
 
@@ -263,7 +272,7 @@ namespace bs {
                 default: {
                     throw shell_parser_exception{
                         shell_status::SHELL_ERROR_SYNTAX_ERROR_UNEXPECTED_TOKEN,
-                        m_oIstream.str(), pToken->m_nPos
+                        this->m_pSource, pToken->m_nPos
                     };
                 }
             }
@@ -274,7 +283,7 @@ namespace bs {
         if (pToken == nullptr) {
             throw shell_parser_exception{
                 shell_status::SHELL_ERROR_SYNTAX_ERROR_UNCLOSED_DOUBLE_QUOTES,
-                m_oIstream.str(), nStartPos
+                this->m_pSource, nStartPos
             };
         }
 
@@ -309,7 +318,7 @@ namespace bs {
         if (pToken == nullptr) {
             throw shell_parser_exception{
                 shell_status::SHELL_ERROR_SYNTAX_ERROR_UNEXPECTED_TOKEN,
-                m_oIstream.str(), nStartPos
+                this->m_pSource, nStartPos
             };
         }
 
@@ -326,7 +335,7 @@ namespace bs {
                 }
                 throw shell_parser_exception{
                     shell_status::SHELL_ERROR_SYNTAX_ERROR_INVALID_VARIABLE_NAME,
-                    m_oIstream.str(), pToken->m_nPos
+                    this->m_pSource, pToken->m_nPos
                 };
             }
             case shell_token_type::TK_DOLLAR_SPECIAL: {
@@ -344,23 +353,24 @@ namespace bs {
             default:
                 throw shell_parser_exception{
                     shell_status::SHELL_ERROR_SYNTAX_ERROR_UNEXPECTED_TOKEN,
-                    m_oIstream.str(), pToken->m_nPos
+                    this->m_pSource, pToken->m_nPos
                 };
         }
     }
 
-    expandable_ptr shell_parser::parse_dollar_variable() const {
+    expandable_ptr shell_parser::parse_dollar_variable() {
         // Prepare
         const auto nStartPos = m_oTokens.pos();
         std::vector<expandable_ptr> vTokens;
         bool bDoubleHop = false;
+        bool bSize = false;
 
         // Get first token
         auto pNameToken = m_oTokens.get();
         if (pNameToken == nullptr) {
             throw shell_parser_exception{
                 shell_status::SHELL_ERROR_SYNTAX_ERROR_UNCLOSED_VARIABLE,
-                m_oIstream.str(), nStartPos
+                this->m_pSource, nStartPos
             };
         }
 
@@ -371,7 +381,17 @@ namespace bs {
             if (pNameToken == nullptr) {
                 throw shell_parser_exception{
                     shell_status::SHELL_ERROR_SYNTAX_ERROR_UNCLOSED_VARIABLE,
-                    m_oIstream.str(), nStartPos
+                    this->m_pSource, nStartPos
+                };
+            }
+        } else if (pNameToken->m_nType == shell_token_type::TK_DOLLAR_SPECIAL) {
+            // Check array size
+            bSize = true;
+            pNameToken = m_oTokens.get();
+            if (pNameToken == nullptr) {
+                throw shell_parser_exception{
+                    shell_status::SHELL_ERROR_SYNTAX_ERROR_UNCLOSED_VARIABLE,
+                    this->m_pSource, nStartPos
                 };
             }
         }
@@ -380,13 +400,24 @@ namespace bs {
         if (pNameToken->m_nType != shell_token_type::TK_WORD) {
             throw shell_parser_exception{
                 shell_status::SHELL_ERROR_SYNTAX_ERROR_UNEXPECTED_TOKEN,
-                m_oIstream.str(), nStartPos
+                this->m_pSource, nStartPos
             };
         }
         if (!is_arg(pNameToken->m_sTokenText) && !is_var(pNameToken->m_sTokenText)) {
             throw shell_parser_exception{
                 shell_status::SHELL_ERROR_SYNTAX_ERROR_INVALID_VARIABLE_NAME,
-                m_oIstream.str(), nStartPos
+                this->m_pSource, nStartPos
+            };
+        }
+
+        // Check array
+        if (m_oTokens.is_next(shell_token_type::TK_OPEN_SQR_BRACKETS)) {
+            return parse_dollar_array(pNameToken, bDoubleHop, bSize);
+        }
+        if (bSize) {
+            throw shell_parser_exception{
+                shell_status::SHELL_ERROR_SYNTAX_ERROR_INVALID_VARIABLE_NAME,
+                this->m_pSource, nStartPos
             };
         }
 
@@ -394,7 +425,7 @@ namespace bs {
         if (m_oTokens.get() == nullptr) {
             throw shell_parser_exception{
                 shell_status::SHELL_ERROR_SYNTAX_ERROR_UNCLOSED_VARIABLE,
-                m_oIstream.str(), nStartPos
+                this->m_pSource, nStartPos
             };
         }
 
@@ -411,7 +442,7 @@ namespace bs {
             }
             throw shell_parser_exception{
                 shell_status::SHELL_ERROR_SYNTAX_ERROR_INVALID_VARIABLE_NAME,
-                m_oIstream.str(), pNameToken->m_nPos
+                this->m_pSource, pNameToken->m_nPos
             };
         }
 
@@ -427,10 +458,98 @@ namespace bs {
         }
         throw shell_parser_exception{
             shell_status::SHELL_ERROR_SYNTAX_ERROR_INVALID_VARIABLE_NAME,
-            m_oIstream.str(), pNameToken->m_nPos
+            this->m_pSource, pNameToken->m_nPos
         };
     }
 
+    expandable_ptr shell_parser::parse_dollar_array(
+        const shell_token *pNameToken,
+        const bool bKeys,
+        const bool bSize
+    ) {
+        // Prepare
+        const auto nStartPos = m_oTokens.pos();
+        std::vector<expandable_ptr> vSubscript;
+
+        // Check name
+        if (!is_var(pNameToken->m_sTokenText)) {
+            throw shell_parser_exception{
+                shell_status::SHELL_ERROR_SYNTAX_ERROR_INVALID_VARIABLE_NAME,
+                this->m_pSource, pNameToken->m_nPos
+            };
+        }
+
+        // Parse subscript
+        m_oTokens.get();
+        auto pToken = m_oTokens.get();
+        while (pToken != nullptr && pToken->m_nType != shell_token_type::TK_CLOSE_SQR_BRACKETS) {
+            switch (pToken->m_nType) {
+                case shell_token_type::TK_WORD:
+                    vSubscript.push_back(std::make_unique<shell_node_word>(
+                        pToken->m_nPos, std::string{pToken->m_sTokenText}
+                    ));
+                    break;
+                case shell_token_type::TK_DOLLAR:
+                    vSubscript.push_back(parse_dollar());
+                    break;
+                default:
+                    throw shell_parser_exception{
+                        shell_status::SHELL_ERROR_SYNTAX_ERROR_UNEXPECTED_TOKEN,
+                        this->m_pSource, pToken->m_nPos
+                    };
+            }
+            pToken = m_oTokens.get();
+        }
+        if (pToken == nullptr) {
+            throw shell_parser_exception{
+                shell_status::SHELL_ERROR_SYNTAX_ERROR_UNCLOSED_SQR_BRACKETS,
+                this->m_pSource, nStartPos
+            };
+        }
+        if (vSubscript.empty()) {
+            throw shell_parser_exception{
+                shell_status::SHELL_ERROR_SYNTAX_ERROR_UNEXPECTED_TOKEN,
+                this->m_pSource, pToken->m_nPos
+            };
+        }
+
+        // Check close
+        if (m_oTokens.get() == nullptr) {
+            throw shell_parser_exception{
+                shell_status::SHELL_ERROR_SYNTAX_ERROR_UNCLOSED_VARIABLE,
+                this->m_pSource, nStartPos
+            };
+        }
+
+        // Build and return whole array access
+        if (
+            const auto pWord = dynamic_cast<const shell_node_word *>(vSubscript.front().get());
+            vSubscript.size() == 1 && pWord != nullptr && pWord->get_text() == "@"
+        ) {
+            const auto nAccess = bSize
+                                     ? shell_array_access::SAA_SIZE
+                                     : bKeys
+                                           ? shell_array_access::SAA_KEYS
+                                           : shell_array_access::SAA_VALUES;
+            return std::make_unique<shell_node_dollar_array>(
+                pNameToken->m_nPos, std::string{pNameToken->m_sTokenText}, nAccess, nullptr
+            );
+        }
+
+        // Build and return element access
+        if (bKeys || bSize) {
+            throw shell_parser_exception{
+                shell_status::SHELL_ERROR_SYNTAX_ERROR_INVALID_VARIABLE_NAME,
+                this->m_pSource, pNameToken->m_nPos
+            };
+        }
+        const auto nSubscriptPos = vSubscript.front()->get_pos();
+        return std::make_unique<shell_node_dollar_array>(
+            pNameToken->m_nPos, std::string{pNameToken->m_sTokenText}, shell_array_access::SAA_ELEMENT,
+            std::make_unique<shell_node_str_double>(nSubscriptPos, std::move(vSubscript))
+        );
+    }
+
     expandable_ptr shell_parser::parse_dollar_command() {
         auto nPos = m_oTokens.pos();
         depth_guard oDepthGuard(this, nPos);
@@ -482,6 +601,12 @@ namespace bs {
                     break;
                 }
                 case shell_token_type::TK_SPACE: {
+                    if (has(nMode, parse_mode::PM_SINGLE_WORD) && !vTokens.empty()) {
+                        // Finish
+                        m_oTokens.put_back();
+                        bFoundDelimiter = true;
+                        break;
+                    }
                     if (!vTokens.empty() && vTokens.back() != nullptr) {
                         vTokens.emplace_back(nullptr);
                     }
@@ -534,14 +659,14 @@ namespace bs {
                     }
                     throw shell_parser_exception{
                         shell_status::SHELL_ERROR_SYNTAX_ERROR_UNEXPECTED_TOKEN,
-                        m_oIstream.str(), pToken->m_nPos
+                        this->m_pSource, pToken->m_nPos
                     };
                 }
 
                 default:
                     throw shell_parser_exception{
                         shell_status::SHELL_ERROR_SYNTAX_ERROR_UNEXPECTED_TOKEN,
-                        m_oIstream.str(), pToken->m_nPos
+                        this->m_pSource, pToken->m_nPos
                     };
             }
 
@@ -642,7 +767,7 @@ namespace bs {
                     if (vExpressions.empty()) {
                         throw shell_parser_exception{
                             shell_status::SHELL_ERROR_SYNTAX_ERROR_UNEXPECTED_TOKEN,
-                            m_oIstream.str(), pToken->m_nPos
+                            this->m_pSource, pToken->m_nPos
                         };
                     }
                     auto pBack = std::move(vExpressions.back());
@@ -680,7 +805,7 @@ namespace bs {
                 default:
                     throw shell_parser_exception{
                         shell_status::SHELL_ERROR_SYNTAX_ERROR_UNEXPECTED_TOKEN,
-                        m_oIstream.str(), pToken->m_nPos
+                        this->m_pSource, pToken->m_nPos
                     };
             }
 
@@ -711,7 +836,7 @@ namespace bs {
         if (vExpressions.empty()) {
             throw shell_parser_exception{
                 shell_status::SHELL_ERROR_SYNTAX_ERROR_UNEXPECTED_TOKEN,
-                m_oIstream.str(), nPos
+                this->m_pSource, nPos
             };
         }
         // Fetch right expression
@@ -720,7 +845,7 @@ namespace bs {
         if (pExpression == nullptr) {
             throw shell_parser_exception{
                 shell_status::SHELL_ERROR_SYNTAX_ERROR_UNEXPECTED_TOKEN,
-                m_oIstream.str(), nPos
+                this->m_pSource, nPos
             };
         }
         // Make operator
@@ -780,13 +905,13 @@ namespace bs {
         if (!m_oTokens.is(shell_token_type::TK_CLOSE_SQR_BRACKETS)) {
             throw shell_parser_exception{
                 shell_status::SHELL_ERROR_SYNTAX_ERROR_UNCLOSED_SQR_BRACKETS,
-                m_oIstream.str(), nPos
+                this->m_pSource, nPos
             };
         }
         if (pExpression == nullptr) {
             throw shell_parser_exception{
                 shell_status::SHELL_ERROR_SYNTAX_ERROR_UNEXPECTED_TOKEN,
-                m_oIstream.str(), nPos
+                this->m_pSource, nPos
             };
         }
         return std::make_unique<shell_node_test>(
@@ -853,14 +978,14 @@ namespace bs {
                     // Should not find any kind of closing tokens inside aside the end one
                     throw shell_parser_exception{
                         shell_status::SHELL_ERROR_SYNTAX_ERROR_UNEXPECTED_TOKEN,
-                        m_oIstream.str(), pToken->m_nPos
+                        this->m_pSource, pToken->m_nPos
                     };
                 }
 
                 default:
                     throw shell_parser_exception{
                         shell_status::SHELL_ERROR_SYNTAX_ERROR_UNEXPECTED_TOKEN,
-                        m_oIstream.str(), pToken->m_nPos
+                        this->m_pSource, pToken->m_nPos
                     };
             }
 
@@ -889,7 +1014,7 @@ namespace bs {
                     break; // nStatus remains SHELL_ERROR_SYNTAX_ERROR
             }
             throw shell_parser_exception{
-                nStatus, m_oIstream.str(), nStartPos
+                nStatus, this->m_pSource, nStartPos
             };
         }
 
@@ -972,14 +1097,14 @@ namespace bs {
                     // Should not find any kind of closing tokens inside aside the end one
                     throw shell_parser_exception{
                         shell_status::SHELL_ERROR_SYNTAX_ERROR_UNEXPECTED_TOKEN,
-                        m_oIstream.str(), pToken->m_nPos
+                        this->m_pSource, pToken->m_nPos
                     };
                 }
 
                 default:
                     throw shell_parser_exception{
                         shell_status::SHELL_ERROR_SYNTAX_ERROR_UNEXPECTED_TOKEN,
-                        m_oIstream.str(), pToken->m_nPos
+                        this->m_pSource, pToken->m_nPos
                     };
             }
 
@@ -1002,7 +1127,7 @@ namespace bs {
                     break; // nStatus remains SHELL_ERROR_SYNTAX_ERROR
             }
             throw shell_parser_exception{
-                nStatus, m_oIstream.str(), nStartPos
+                nStatus, this->m_pSource, nStartPos
             };
         }
 
@@ -1053,7 +1178,7 @@ namespace bs {
                 }
                 throw shell_parser_exception{
                     shell_status::SHELL_ERROR_SYNTAX_ERROR_UNEXPECTED_TOKEN,
-                    m_oIstream.str(), nPos
+                    this->m_pSource, nPos
                 };
             }
             case shell_keyword::SK_BREAK: {
@@ -1072,7 +1197,7 @@ namespace bs {
                 }
                 throw shell_parser_exception{
                     shell_status::SHELL_ERROR_SYNTAX_ERROR_UNEXPECTED_TOKEN,
-                    m_oIstream.str(), nPos
+                    this->m_pSource, nPos
                 };
             }
 
@@ -1082,7 +1207,7 @@ namespace bs {
             default: {
                 throw shell_parser_exception{
                     shell_status::SHELL_ERROR_SYNTAX_ERROR_UNEXPECTED_TOKEN,
-                    m_oIstream.str(), nPos
+                    this->m_pSource, nPos
                 };
             }
         }
@@ -1153,7 +1278,7 @@ namespace bs {
                 default:
                     throw shell_parser_exception{
                         shell_status::SHELL_ERROR_SYNTAX_ERROR_UNEXPECTED_TOKEN,
-                        m_oIstream.str(), pToken->m_nPos
+                        this->m_pSource, pToken->m_nPos
                     };
             }
 
@@ -1194,7 +1319,7 @@ namespace bs {
         if (!m_oTokens.is(shell_token_type::TK_CMD_SEPARATOR)) {
             throw shell_parser_exception{
                 shell_status::SHELL_ERROR_SYNTAX_ERROR_UNEXPECTED_TOKEN,
-                m_oIstream.str(), m_oTokens.pos()
+                this->m_pSource, m_oTokens.pos()
             };
         }
 
@@ -1206,7 +1331,7 @@ namespace bs {
         if (!m_oTokens.keyword(shell_keyword::SK_THEN)) {
             throw shell_parser_exception{
                 shell_status::SHELL_ERROR_SYNTAX_ERROR_MISSING_KEYWORD_THEN,
-                m_oIstream.str(), nPos
+                this->m_pSource, nPos
             };
         }
 
@@ -1245,7 +1370,7 @@ namespace bs {
         }
         throw shell_parser_exception{
             shell_status::SHELL_ERROR_SYNTAX_ERROR_UNFINISHED_KEYWORD_IF,
-            m_oIstream.str(), nPos
+            this->m_pSource, nPos
         };
     }
 
@@ -1263,7 +1388,7 @@ namespace bs {
         ) {
             throw shell_parser_exception{
                 shell_status::SHELL_ERROR_SYNTAX_ERROR_INVALID_VARIABLE_NAME,
-                m_oIstream.str(), nPos
+                this->m_pSource, nPos
             };
         }
         std::string sVariable(m_oTokens.current()->m_sTokenText);
@@ -1272,11 +1397,16 @@ namespace bs {
         m_oTokens.get();
         while (m_oTokens.is(shell_token_type::TK_SPACE))m_oTokens.get();
 
+        // Counted loop
+        if (is_word("from")) {
+            return parse_for_count(nPos, std::move(sVariable));
+        }
+
         // Get "in" keyword
         if (!m_oTokens.keyword(shell_keyword::SK_IN)) {
             throw shell_parser_exception{
                 shell_status::SHELL_ERROR_SYNTAX_ERROR_MISSING_KEYWORD_IN,
-                m_oIstream.str(), nPos
+                this->m_pSource, nPos
             };
         }
 
@@ -1289,7 +1419,7 @@ namespace bs {
         if (!m_oTokens.is(shell_token_type::TK_CMD_SEPARATOR)) {
             throw shell_parser_exception{
                 shell_status::SHELL_ERROR_SYNTAX_ERROR_UNEXPECTED_TOKEN,
-                m_oIstream.str(), m_oTokens.pos()
+                this->m_pSource, m_oTokens.pos()
             };
         }
 
@@ -1301,7 +1431,7 @@ namespace bs {
         if (!m_oTokens.keyword(shell_keyword::SK_DO)) {
             throw shell_parser_exception{
                 shell_status::SHELL_ERROR_SYNTAX_ERROR_MISSING_KEYWORD_DO,
-                m_oIstream.str(), nPos
+                this->m_pSource, nPos
             };
         }
 
@@ -1318,6 +1448,101 @@ namespace bs {
         );
     }
 
+    evaluable_ptr shell_parser::parse_for_count(const std::size_t nPos, std::string sVariable) {
+        // Get first value
+        auto pFrom = parse_for_count_operand(nPos);
+
+        // Get "to" word
+        if (!is_word("to")) {
+            if (
+                m_oTokens.current() == nullptr
+                || m_oTokens.is(shell_token_type::TK_CMD_SEPARATOR)
+            ) {
+                throw shell_parser_exception{
+                    shell_status::SHELL_ERROR_SYNTAX_ERROR_MISSING_KEYWORD_TO,
+                    this->m_pSource, nPos
+                };
+            }
+            throw shell_parser_exception{
+                shell_status::SHELL_ERROR_SYNTAX_ERROR_UNEXPECTED_TOKEN,
+                this->m_pSource, m_oTokens.pos()
+            };
+        }
+
+        // Get last value
+        auto pTo = parse_for_count_operand(nPos);
+
+        // Get optional step
+        expandable_ptr pStep;
+        if (is_word("step")) {
+            pStep = parse_for_count_operand(nPos);
+        }
+
+        // Check semicolon
+        if (!m_oTokens.is(shell_token_type::TK_CMD_SEPARATOR)) {
+            throw shell_parser_exception{
+                shell_status::SHELL_ERROR_SYNTAX_ERROR_UNEXPECTED_TOKEN,
+                this->m_pSource, m_oTokens.pos()
+            };
+        }
+
+        // Skip empty spaces
+        m_oTokens.get();
+        while (m_oTokens.is(shell_token_type::TK_SPACE))m_oTokens.get();
+
+        // Get "do" keyword
+        if (!m_oTokens.keyword(shell_keyword::SK_DO)) {
+            throw shell_parser_exception{
+                shell_status::SHELL_ERROR_SYNTAX_ERROR_MISSING_KEYWORD_DO,
+                this->m_pSource, nPos
+            };
+        }
+
+        // Get block
+        depth_guard oDepthGuard(this, nPos);
+        auto pIterative = parse_block(shell_keyword::SK_DONE, parse_mode::PM_LOOP);
+        if (pIterative == nullptr)
+            pIterative = std::make_unique<shell_node_null_command>(m_oTokens.pos());
+
+        return std::make_unique<shell_node_for_count>(
+            nPos, std::move(sVariable),
+            std::move(pFrom),
+            std::move(pTo),
+            std::move(pStep),
+            std::move(pIterative)
+        );
+    }
+
+    expandable_ptr shell_parser::parse_for_count_operand(const std::size_t nPos) {
+        // Skip empty spaces
+        m_oTokens.get();
+        while (m_oTokens.is(shell_token_type::TK_SPACE))m_oTokens.get();
+        m_oTokens.put_back();
+
+        // Get operand
+        auto pOperand = parse_command_expression(parse_mode::PM_SINGLE_WORD);
+        if (pOperand == nullptr) {
+            throw shell_parser_exception{
+                shell_status::SHELL_ERROR_SYNTAX_ERROR_UNFINISHED_KEYWORD_FOR,
+                this->m_pSource, nPos
+            };
+        }
+
+        // Skip empty spaces
+        m_oTokens.get();
+        while (m_oTokens.is(shell_token_type::TK_SPACE))m_oTokens.get();
+        return pOperand;
+    }
+
+    bool shell_parser::is_word(const std::string_view &sWord) const noexcept {
+        return m_oTokens.is(shell_token_type::TK_WORD)
+               && m_oTokens.current()->m_sTokenText == sWord
+               && (
+                   m_oTokens.next() == nullptr
+                   || m_oTokens.is_next(shell_token_type::TK_SPACE)
+               );
+    }
+
     evaluable_ptr shell_parser::parse_while() {
         // Record if position
         const auto nPos = m_oTokens.pos();
@@ -1330,7 +1555,7 @@ namespace bs {
         if (!m_oTokens.is(shell_token_type::TK_CMD_SEPARATOR)) {
             throw shell_parser_exception{
                 shell_status::SHELL_ERROR_SYNTAX_ERROR_UNEXPECTED_TOKEN,
-                m_oIstream.str(), m_oTokens.pos()
+                this->m_pSource, m_oTokens.pos()
             };
         }
 
@@ -1342,7 +1567,7 @@ namespace bs {
         if (!m_oTokens.keyword(shell_keyword::SK_DO)) {
             throw shell_parser_exception{
                 shell_status::SHELL_ERROR_SYNTAX_ERROR_MISSING_KEYWORD_DO,
-                m_oIstream.str(), nPos
+                this->m_pSource, nPos
             };
         }
 
@@ -1371,7 +1596,7 @@ namespace bs {
         if (!m_oTokens.is(shell_token_type::TK_CMD_SEPARATOR)) {
             throw shell_parser_exception{
                 shell_status::SHELL_ERROR_SYNTAX_ERROR_UNEXPECTED_TOKEN,
-                m_oIstream.str(), m_oTokens.pos()
+                this->m_pSource, m_oTokens.pos()
             };
         }
 
@@ -1383,7 +1608,7 @@ namespace bs {
         if (!m_oTokens.keyword(shell_keyword::SK_DO)) {
             throw shell_parser_exception{
                 shell_status::SHELL_ERROR_SYNTAX_ERROR_MISSING_KEYWORD_DO,
-                m_oIstream.str(), nPos
+                this->m_pSource, nPos
             };
         }
 
@@ -1414,7 +1639,7 @@ namespace bs {
         if (pName == nullptr) {
             throw shell_parser_exception{
                 shell_status::SHELL_ERROR_SYNTAX_ERROR_INVALID_FUNCTION_NAME,
-                this->m_oIstream.str(), nPos
+                this->m_pSource, nPos
             };
         }
 
@@ -1426,7 +1651,7 @@ namespace bs {
         if (!m_oTokens.is(shell_token_type::TK_OPEN_BRACKETS)) {
             throw shell_parser_exception{
                 shell_status::SHELL_ERROR_SYNTAX_ERROR_INVALID_FUNCTION_BODY,
-                m_oIstream.str(), nPos
+                this->m_pSource, nPos
             };
         }
 
@@ -91,6 +91,8 @@ namespace bs {
                     return "Syntax error: 'until' keyword is not finished.";
                 case shell_status::SHELL_ERROR_SYNTAX_ERROR_MISSING_KEYWORD_DO:
                     return "Syntax error: 'do' keyword is missing.";
+                case shell_status::SHELL_ERROR_SYNTAX_ERROR_MISSING_KEYWORD_TO:
+                    return "Syntax error: 'to' keyword is missing.";
                 case shell_status::SHELL_ERROR_MAX_DEPTH_REACHED:
                     return "Maximum command nesting depth reached";
                 case shell_status::SHELL_ERROR_SYNTAX_ERROR_INVALID_FUNCTION_NAME:
@@ -102,36 +104,6 @@ namespace bs {
             }
         }
 
-        /**
-         * @brief Gets the line of text from a command string at a specific position.
-         *
-         * @param sCommand The command string to search within.
-         * @param nPos The position index to extract the line from.
-         * @return The line containing the given position or an empty string if out of bounds.
-         */
-        std::string getLineFromPosition(const std::string &sCommand, const std::size_t nPos) {
-            if (nPos >= sCommand.size()) {
-                return ""; // Return an empty string if position is out of bounds
-            }
-
-            // Start position for the line
-            std::size_t start = sCommand.rfind('\n', nPos); // Find the previous newline character
-            if (start == std::string::npos) {
-                start = 0; // No newline found, start from the beginning
-            } else {
-                start++; // Move past the newline character
-            }
-
-            // End position for the line
-            std::size_t end = sCommand.find('\n', nPos); // Find the next newline character
-            if (end == std::string::npos) {
-                end = sCommand.size(); // No newline found, go to end of string
-            }
-
-            // Return the substring that represents the line
-            return sCommand.substr(start, end - start);
-        }
-
         /**
          * @brief Gets the code point (character index) at a specific byte position in a UTF-8 encoded string.
          *
@@ -140,7 +112,7 @@ namespace bs {
          * @return The character index (code point) corresponding to the specified byte position.
          * @warning Returns nPos if any error occurred
          */
-        std::size_t getCodePointAtByte(const std::string &sCommand, const size_t nPos) {
+        std::size_t getCodePointAtByte(const std::string_view sCommand, const size_t nPos) {
             if (nPos >= sCommand.size()) return nPos;
 
             std::size_t nByteIndex = 0;
@@ -182,39 +154,64 @@ namespace bs {
         }
 
         /**
-         * @brief Constructs a detailed error message based on the shell status, command, and position.
+         * @brief Constructs a detailed error message based on the shell status, source, and position.
          *
          * @param nStatus The status code representing the shell execution state.
-         * @param sCommand The command string associated with the error.
+         * @param oSource The source associated with the error.
          * @param nPos The byte position where the error occurred.
          * @return A formatted error message string.
          */
         std::string makeMessage(
             const shell_status nStatus,
-            const std::string &sCommand,
+            const shell_source &oSource,
             const std::size_t nPos
         ) {
-            const std::string sLine = getLineFromPosition(sCommand, nPos);
-            const auto nCodePoint = getCodePointAtByte(sLine, nPos);
+            const std::string_view sCommand = oSource.get_text();
+            std::string_view sLine;
+            std::size_t nCodePoint = nPos;
+            if (nPos < sCommand.size()) {
+                const auto nLine = oSource.get_line(nPos);
+                const auto nLineStart = oSource.get_line_start(nLine);
+                sLine = oSource.get_line_text(nLine);
+                nCodePoint = getCodePointAtByte(sLine, nPos - nLineStart);
+            }
             const auto nAbsoluteCodePoint = getCodePointAtByte(sCommand, nPos);
-            return errorMessage(nStatus)
-                   + "\n" + sLine
-                   + "\n" + std::string(nCodePoint, ' ') + "^~~~"
-                   + "\nCode point: " + std::to_string(nAbsoluteCodePoint)
-                   + "\nByte: " + std::to_string(nPos) + "\n";
+
+            std::string sMessage = errorMessage(nStatus);
+            sMessage += '\n';
+            sMessage += sLine;
+            sMessage += '\n';
+            sMessage.append(nCodePoint, ' ');
+            sMessage += "^~~~\nCode point: ";
+            sMessage += std::to_string(nAbsoluteCodePoint);
+            sMessage += "\nByte: ";
+            sMessage += std::to_string(nPos);
+            sMessage += '\n';
+            return sMessage;
         }
     }
 
     shell_parser_exception::shell_parser_exception(
         const shell_status nStatus,
-        std::string sCommand,
+        std::shared_ptr<const shell_source> pSource,
         const std::size_t nPos
     )
-        : std::runtime_error(makeMessage(
-              nStatus, sCommand, nPos
-          )),
+        : std::runtime_error(errorMessage(nStatus)),
           m_nStatus(nStatus),
-          m_sCommand(std::move(sCommand)),
+          m_pState(std::make_shared<state>()),
           m_nPos(nPos) {
+        this->m_pState->m_pSource = std::move(pSource);
+    }
+
+    const char *shell_parser_exception::what() const noexcept {
+        try {
+            std::call_once(this->m_pState->m_oMessageFlag, [this] {
+                this->m_pState->m_sMessage = makeMessage(this->m_nStatus, *this->m_pState->m_pSource, this->m_nPos);
+            });
+            return this->m_pState->m_sMessage.c_str();
+        } catch (...) {
+            // Formatting failed, the message without the source is still meaningful
+            return std::runtime_error::what();
+        }
     }
 }
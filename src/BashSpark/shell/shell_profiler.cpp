@@ -0,0 +1,252 @@
+/**
+ * @file shell_profiler.cpp
+ * @brief Implements class shell_profiler.
+ *
+ * This file contains the definition of the `shell_profiler` class,
+ * which records the time spent on each node and function of a script.
+ *
+ * @date Created on 22/11/25
+ * @author Dante Doménech Martínez
+ *
+ * @copyright GNU General Public License v3.0
+ *
+ * This file is part of BashSpark.
+ * Copyright (C) 2025 Dante Doménech Martínez
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "BashSpark/shell/shell_profiler.h"
+
+#include <algorithm>
+#include <iomanip>
+#include <cstdint>
+#include <ranges>
+
+#include "BashSpark/shell/shell_node_static_visitor.h"
+
+namespace bs {
+    namespace {
+        /// Marks the keys of the functions
+        constexpr std::uint64_t FUNCTION_KEY = std::uint64_t{1} << 63;
+        /// Marks the keys of the nodes of nested sources
+        constexpr std::uint64_t NESTED_KEY = std::uint64_t{1} << 62;
+
+        /**
+         * @brief Collects the nodes of a tree.
+         */
+        class node_collector final : public shell_node_static_visitor<node_collector, void> {
+            friend shell_node_static_visitor;
+
+        public:
+            /**
+             * @brief Constructs the collector.
+             * @param sNodes Where to insert the nodes.
+             */
+            explicit node_collector(std::unordered_set<const shell_node *> &sNodes)
+                : m_sNodes(sNodes) {
+            }
+
+        private:
+            /**
+             * @brief Inserts a node and its children.
+             * @tparam node_t Type of the node.
+             * @param oSession Execution session.
+             * @param pNode The node.
+             */
+            template<typename node_t>
+            void visit(shell_session &oSession, const node_t *pNode) {
+                this->m_sNodes.insert(pNode);
+                for_each_child(pNode, [&](const auto *pChild) { this->visit_node(oSession, pChild); });
+            }
+
+        private:
+            /// Where to insert the nodes
+            std::unordered_set<const shell_node *> &m_sNodes;
+        };
+
+        /**
+         * @brief Gets the name of a node type in the reports.
+         * @param nType Node type.
+         * @return The name.
+         */
+        std::string_view get_type_name(const shell_node_type nType) {
+            switch (nType) {
+                case shell_node_type::SNT_BACKGROUND: return "background";
+                case shell_node_type::SNT_AND: return "and";
+                case shell_node_type::SNT_PIPE: return "pipe";
+                case shell_node_type::SNT_OR: return "or";
+                case shell_node_type::SNT_IF: return "if";
+                case shell_node_type::SNT_TEST: return "test";
+                case shell_node_type::SNT_FOR: return "for";
+                case shell_node_type::SNT_FOR_COUNT: return "for count";
+                case shell_node_type::SNT_WHILE: return "while";
+                case shell_node_type::SNT_UNTIL: return "until";
+                case shell_node_type::SNT_BREAK: return "break";
+                case shell_node_type::SNT_CONTINUE: return "continue";
+                case shell_node_type::SNT_FUNCTION: return "function";
+                case shell_node_type::SNT_NULL_COMMAND: return "null cmd";
+                case shell_node_type::SNT_COMMAND: return "cmd";
+                case shell_node_type::SNT_COMMAND_BLOCK: return "block";
+                case shell_node_type::SNT_COMMAND_BLOCK_SUBSHELL: return "subshell";
+                default: return "node";
+            }
+        }
+    }
+
+    std::string shell_profiler::entry::get_label() const {
+        if (!this->m_sFunction.empty()) return "function " + this->m_sFunction;
+        std::string sLabel(get_type_name(this->m_nType));
+        sLabel += '@';
+        if (this->m_bNested) return sLabel + "nested:" + std::to_string(this->m_nPos);
+        if (this->m_nLine == 0) return sLabel + std::to_string(this->m_nPos);
+        return sLabel + std::to_string(this->m_nLine) + ':' + std::to_string(this->m_nColumn);
+    }
+
+    shell_profiler::shell_profiler(std::string sSource) {
+        // Index the lines
+        if (!sSource.empty()) {
+            this->m_vLines.push_back(0);
+            for (std::size_t i = 0; i < sSource.size(); ++i) {
+                if (sSource[i] == '\n') this->m_vLines.push_back(i + 1);
+            }
+        }
+        this->clear();
+    }
+
+    void shell_profiler::enter(const shell_node *pNode) {
+        // Nested sources number their positions from 0 again, their nodes share a bucket of their own
+        const bool bNested = this->m_nSources > 0 && !this->m_sSourceNodes.contains(pNode);
+        const auto nKey = (bNested ? NESTED_KEY : 0)
+                          | static_cast<std::uint64_t>(pNode->get_pos()) << 8
+                          | static_cast<std::uint64_t>(pNode->get_type());
+        auto [pEntry, bNew] = this->m_mEntries.try_emplace(nKey);
+        if (bNew) {
+            auto &oEntry = pEntry->second;
+            oEntry.m_nType = pNode->get_type();
+            oEntry.m_nPos = pNode->get_pos();
+            oEntry.m_bNested = bNested;
+            if (!bNested && !this->m_vLines.empty()) {
+                const auto pLine = std::ranges::upper_bound(this->m_vLines, oEntry.m_nPos) - 1;
+                oEntry.m_nLine = static_cast<std::size_t>(pLine - this->m_vLines.begin()) + 1;
+                oEntry.m_nColumn = oEntry.m_nPos - *pLine + 1;
+            }
+        }
+        this->enter(nKey, pEntry->second);
+    }
+
+    void shell_profiler::enter(const std::string &sFunction) {
+        auto [pFunction, bNew] = this->m_mFunctions.try_emplace(sFunction, FUNCTION_KEY | this->m_mFunctions.size());
+        auto &oEntry = this->m_mEntries[pFunction->second];
+        if (bNew) oEntry.m_sFunction = sFunction;
+        this->enter(pFunction->second, oEntry);
+    }
+
+    void shell_profiler::enter(const std::uint64_t nKey, entry &oEntry) {
+        // Find the stack
+        const std::size_t nParent = this->m_vFrames.empty() ? 0 : this->m_vFrames.back().m_nStack;
+        auto [pStack, bNew] = this->m_mStacks.try_emplace({nParent, nKey}, this->m_vStacks.size());
+        if (bNew) this->m_vStacks.push_back({nParent, nKey});
+
+        ++oEntry.m_nHits;
+        ++oEntry.m_nActive;
+        this->m_vFrames.push_back({&oEntry, pStack->second, clock_type::now()});
+    }
+
+    void shell_profiler::leave() {
+        if (this->m_vFrames.empty()) return;
+        const auto oFrame = this->m_vFrames.back();
+        this->m_vFrames.pop_back();
+
+        const auto nElapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(clock_type::now() - oFrame.m_nStart);
+        const auto nExclusive = nElapsed - oFrame.m_nChildren;
+        auto &oEntry = *oFrame.m_pEntry;
+
+        // Recursive evaluations are already included in the outermost one
+        if (--oEntry.m_nActive == 0) oEntry.m_nInclusive += nElapsed;
+        oEntry.m_nExclusive += nExclusive;
+        this->m_vStacks[oFrame.m_nStack].m_nExclusive += nExclusive;
+        if (!this->m_vFrames.empty()) this->m_vFrames.back().m_nChildren += nElapsed;
+    }
+
+    void shell_profiler::enter_source(shell_session &oSession, const shell_node_evaluable *pRoot) {
+        if (this->m_nSources++ == 0) node_collector(this->m_sSourceNodes).visit_node(oSession, pRoot);
+    }
+
+    void shell_profiler::leave_source() {
+        if (this->m_nSources > 0 && --this->m_nSources == 0) this->m_sSourceNodes.clear();
+    }
+
+    void shell_profiler::clear() {
+        this->m_mEntries.clear();
+        this->m_mFunctions.clear();
+        this->m_mStacks.clear();
+        this->m_vFrames.clear();
+        this->m_vStacks.assign(1, stack_node{0, 0});
+    }
+
+    std::vector<shell_profiler::entry> shell_profiler::get_entries() const {
+        std::vector<entry> vEntries;
+        vEntries.reserve(this->m_mEntries.size());
+        for (const auto &oEntry: this->m_mEntries | std::views::values) vEntries.push_back(oEntry);
+        std::ranges::sort(vEntries, [](const entry &oLeft, const entry &oRight) {
+            if (oLeft.m_nExclusive != oRight.m_nExclusive) return oLeft.m_nExclusive > oRight.m_nExclusive;
+            return oLeft.m_nPos < oRight.m_nPos;
+        });
+        return vEntries;
+    }
+
+    void shell_profiler::write_report(std::ostream &oOut, const std::size_t nTop) const {
+        const auto vEntries = this->get_entries();
+        const auto nCount = nTop == 0 ? vEntries.size() : std::min(nTop, vEntries.size());
+
+        const auto oFlags = oOut.flags();
+        oOut << std::right << std::setw(12) << "excl us"
+                << std::setw(12) << "incl us"
+                << std::setw(10) << "hits"
+                << "  node" << '\n';
+        for (std::size_t i = 0; i < nCount; ++i) {
+            const auto &oEntry = vEntries[i];
+            oOut << std::setw(12) << std::chrono::duration_cast<std::chrono::microseconds>(oEntry.m_nExclusive).count()
+                    << std::setw(12) << std::chrono::duration_cast<std::chrono::microseconds>(oEntry.m_nInclusive).count()
+                    << std::setw(10) << oEntry.m_nHits
+                    << "  " << oEntry.get_label() << '\n';
+        }
+        oOut.flags(oFlags);
+        oOut.flush();
+    }
+
+    void shell_profiler::write_folded(std::ostream &oOut) const {
+        std::vector<std::string_view> vPath;
+        std::unordered_map<std::uint64_t, std::string> mLabels;
+        for (const auto &[nKey, oEntry]: this->m_mEntries) mLabels.emplace(nKey, oEntry.get_label());
+
+        for (std::size_t i = 1; i < this->m_vStacks.size(); ++i) {
+            const auto nMicroseconds = std::chrono::duration_cast<std::chrono::microseconds>(
+                this->m_vStacks[i].m_nExclusive).count();
+            if (nMicroseconds <= 0) continue;
+
+            // Walk up to the root
+            vPath.clear();
+            for (std::size_t nStack = i; nStack != 0; nStack = this->m_vStacks[nStack].m_nParent)
+                vPath.push_back(mLabels.at(this->m_vStacks[nStack].m_nKey));
+            for (auto pLabel = vPath.rbegin(); pLabel != vPath.rend(); ++pLabel) {
+                if (pLabel != vPath.rbegin()) oOut.put(';');
+                oOut << *pLabel;
+            }
+            oOut << ' ' << nMicroseconds << '\n';
+        }
+        oOut.flush();
+    }
+}
@@ -0,0 +1,122 @@
+/**
+ * @file shell_scheduler.cpp
+ * @brief Implements class shell_scheduler.
+ *
+ * This file contains the definition of the `shell_scheduler` class,
+ * which runs shell tasks in round-robin.
+ *
+ * @date Created on 22/11/25
+ * @author Dante Doménech Martínez
+ *
+ * @copyright GNU General Public License v3.0
+ *
+ * This file is part of BashSpark.
+ * Copyright (C) 2025 Dante Doménech Martínez
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "BashSpark/shell/shell_scheduler.h"
+
+#include <algorithm>
+#include <system_error>
+#include <thread>
+#include <vector>
+
+#include "BashSpark/shell/shell_traits.h"
+
+namespace bs {
+    std::future<shell_status> shell_scheduler::submit(shell_task oTask) {
+        entry oEntry{std::move(oTask), {}};
+        auto oFuture = oEntry.m_oResult.get_future();
+        {
+            std::lock_guard oLock(this->m_oMutex);
+            this->m_dReady.push_back(std::move(oEntry));
+        }
+        this->m_oSignal.notify_one();
+        return oFuture;
+    }
+
+    void shell_scheduler::run(std::size_t nThreads) {
+        if constexpr (!shell_traits::THREAD_SAFE) nThreads = 1;
+        if (nThreads == 0) nThreads = std::max(1u, std::thread::hardware_concurrency());
+
+        // The workers are joined on every exit
+        std::vector<std::jthread> vThreads;
+        vThreads.reserve(nThreads - 1);
+        try {
+            for (std::size_t i = 1; i < nThreads; ++i)
+                vThreads.emplace_back(&shell_scheduler::work, this);
+        } catch (const std::system_error &) {
+            // The tasks run on the threads already started
+        }
+        this->work();
+    }
+
+    std::size_t shell_scheduler::size() const {
+        std::lock_guard oLock(this->m_oMutex);
+        return this->m_dReady.size() + this->m_lParked.size() + this->m_nRunning;
+    }
+
+    void shell_scheduler::work() {
+        std::unique_lock oLock(this->m_oMutex);
+        while (true) {
+            // Wait for a task, stop once none is left
+            this->m_oSignal.wait(oLock, [this] {
+                return !this->m_dReady.empty() || (this->m_nRunning == 0 && this->m_lParked.empty());
+            });
+            if (this->m_dReady.empty()) return;
+
+            entry oEntry = std::move(this->m_dReady.front());
+            this->m_dReady.pop_front();
+            ++this->m_nRunning;
+            oLock.unlock();
+
+            // Run a time slice
+            bool bDone = true;
+            try {
+                bDone = oEntry.m_oTask.resume(shell_task::clock_type::now() + this->m_nTimeSlice);
+                if (bDone) oEntry.m_oResult.set_value(oEntry.m_oTask.get());
+            } catch (...) {
+                oEntry.m_oResult.set_exception(std::current_exception());
+            }
+
+            // Requeue at the end, or put aside until the event is set
+            oLock.lock();
+            --this->m_nRunning;
+            if (!bDone) {
+                const auto pEvent = oEntry.m_oTask.get_event();
+                if (pEvent == nullptr) {
+                    this->m_dReady.push_back(std::move(oEntry));
+                } else {
+                    const auto pParked = this->m_lParked.insert(this->m_lParked.end(), std::move(oEntry));
+                    if (!pEvent->set_waker([this, pParked] { this->wake(pParked); })) {
+                        this->m_dReady.push_back(std::move(*pParked));
+                        this->m_lParked.erase(pParked);
+                    }
+                }
+            }
+            this->m_oSignal.notify_all();
+        }
+    }
+
+    void shell_scheduler::wake(const std::list<entry>::iterator pParked) {
+        {
+            std::lock_guard oLock(this->m_oMutex);
+            this->m_dReady.push_back(std::move(*pParked));
+            this->m_lParked.erase(pParked);
+        }
+        this->m_oSignal.notify_one();
+    }
+}
@@ -0,0 +1,60 @@
+/**
+ * @file shell_source.cpp
+ * @brief Implements class shell_source.
+ *
+ * This file contains the definition of the `shell_source` class,
+ * which holds the source of a script and maps positions to lines.
+ *
+ * @date Created on 22/11/25
+ * @author Dante Doménech Martínez
+ *
+ * @copyright GNU General Public License v3.0
+ *
+ * This file is part of BashSpark.
+ * Copyright (C) 2025 Dante Doménech Martínez
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "BashSpark/shell/shell_source.h"
+
+#include <algorithm>
+
+namespace bs {
+    std::size_t shell_source::get_line(const std::size_t nPos) const {
+        const auto &vLines = this->get_lines();
+        return static_cast<std::size_t>(std::ranges::upper_bound(vLines, nPos) - vLines.begin()) - 1;
+    }
+
+    std::size_t shell_source::get_line_start(const std::size_t nLine) const {
+        return this->get_lines().at(nLine);
+    }
+
+    std::string_view shell_source::get_line_text(const std::size_t nLine) const {
+        const auto &vLines = this->get_lines();
+        const auto nStart = vLines.at(nLine);
+        const auto nEnd = nLine + 1 < vLines.size() ? vLines[nLine + 1] - 1 : this->m_sText.size();
+        return this->m_sText.substr(nStart, nEnd - nStart);
+    }
+
+    const std::vector<std::size_t> &shell_source::get_lines() const {
+        std::call_once(this->m_oLinesFlag, [this] {
+            this->m_vLines.push_back(0);
+            for (std::size_t nPos = this->m_sText.find('\n'); nPos != std::string_view::npos;
+                 nPos = this->m_sText.find('\n', nPos + 1))
+                this->m_vLines.push_back(nPos + 1);
+        });
+        return this->m_vLines;
+    }
+}
@@ -30,10 +30,31 @@
 #include "BashSpark/shell/shell_tokenizer.h"
 
 #include "BashSpark/tools/utf.h"
+#include "BashSpark/shell/shell_log.h"
 #include "BashSpark/shell/shell_parser_exception.h"
 
 namespace bs {
     namespace {
+        /**
+         * @brief Writes tokens to a diagnostic as `<text>` separated by spaces.
+         */
+        struct token_list {
+            /// The tokens
+            const std::vector<shell_token> &m_vTokens;
+
+            /**
+             * @brief Writes the tokens.
+             * @param oOut Output stream.
+             * @param oList The tokens.
+             * @return The output stream.
+             */
+            friend std::ostream &operator<<(std::ostream &oOut, const token_list &oList) {
+                for (const auto &oToken: oList.m_vTokens)
+                    oOut << '<' << oToken.m_sTokenText << "> ";
+                return oOut;
+            }
+        };
+
         void add_word(
             std::vector<shell_token> &vTokens,
             const ifakestream &oStdIn,
@@ -152,24 +173,23 @@ namespace bs {
         }
     }
 
-    std::vector<shell_token> shell_tokenizer::tokens(ifakestream &oStdIn) {
+    std::vector<shell_token> shell_tokenizer::tokens(
+        ifakestream &oStdIn,
+        const std::shared_ptr<const shell_source> &pSource
+    ) {
         std::vector<shell_token> vTokens;
         // Covers most commands and does not make a dent on RAM
         vTokens.reserve(64);
-        tokens(vTokens, oStdIn, '\0');
-#ifdef BS_DEBUG
-        std::cout << "txt " << oStdIn.view() << std::endl;
-        std::cout << "tokens ";
-        for (auto &oToken: vTokens)
-            std::cout << "<" << oToken.m_sTokenText << "> ";
-        std::cout << std::endl;
-#endif
+        tokens(vTokens, oStdIn, pSource, '\0');
+        BS_LOG(SLL_TRACE, SLC_TOKENIZE, "txt " << oStdIn.view());
+        BS_LOG(SLL_TRACE, SLC_TOKENIZE, "tokens " << token_list{vTokens});
         return vTokens;
     }
 
     void shell_tokenizer::tokens(
         std::vector<shell_token> &vTokens,
         ifakestream &oStdIn,
+        const std::shared_ptr<const shell_source> &pSource,
         const char cDelimiter
     ) {
         const auto nStartPos = oStdIn.tell();
@@ -185,13 +205,13 @@ namespace bs {
                 const auto nTokenType = get_token_type(static_cast<char>(cChar))
             ) {
                 case shell_token_type::TK_QUOTE_SIMPLE: {
-                    tokens_quote_simple(vTokens, oStdIn);
+                    tokens_quote_simple(vTokens, oStdIn, pSource);
                     break;
                 }
 
                 case shell_token_type::TK_QUOTE_DOUBLE: {
                     // Add quote
-                    tokens_quote_double(vTokens, oStdIn);
+                    tokens_quote_double(vTokens, oStdIn, pSource);
                     break;
                 }
 
@@ -200,19 +220,19 @@ namespace bs {
                         nTokenType, nPos,
                         oStdIn.sub_view(nPos, 1)
                     );
-                    tokens(vTokens, oStdIn, '`');
+                    tokens(vTokens, oStdIn, pSource, '`');
                     nBegin = vTokens.size();
                     break;
                 }
 
                 case shell_token_type::TK_ESCAPED: {
-                    tokens_backslash(vTokens, oStdIn);
+                    tokens_backslash(vTokens, oStdIn, pSource);
                     nBegin = vTokens.size();
                     break;
                 }
 
                 case shell_token_type::TK_DOLLAR: {
-                    tokens_dollar(vTokens, oStdIn);
+                    tokens_dollar(vTokens, oStdIn, pSource);
                     nBegin = vTokens.size();
                     break;
                 }
@@ -264,7 +284,7 @@ namespace bs {
                         nTokenType, nPos,
                         oStdIn.sub_view(nPos, 1)
                     );
-                    tokens(vTokens, oStdIn, ')');
+                    tokens(vTokens, oStdIn, pSource, ')');
                     nBegin = vTokens.size();
                     break;
                 }
@@ -274,7 +294,7 @@ namespace bs {
                         nTokenType, nPos,
                         oStdIn.sub_view(nPos, 1)
                     );
-                    tokens(vTokens, oStdIn, '}');
+                    tokens(vTokens, oStdIn, pSource, '}');
                     nBegin = vTokens.size();
                     break;
                 }
@@ -284,7 +304,7 @@ namespace bs {
                         nTokenType, nPos,
                         oStdIn.sub_view(nPos, 1)
                     );
-                    tokens(vTokens, oStdIn, ']');
+                    tokens(vTokens, oStdIn, pSource, ']');
                     nBegin = vTokens.size();
                     break;
                 }
@@ -294,7 +314,7 @@ namespace bs {
                 case shell_token_type::TK_CLOSE_SQR_BRACKETS: {
                     throw shell_parser_exception{
                         shell_status::SHELL_ERROR_SYNTAX_ERROR_UNEXPECTED_TOKEN,
-                        oStdIn.str(), nPos
+                        pSource, nPos
                     };
                 }
 
@@ -323,14 +343,15 @@ namespace bs {
                 if (cDelimiter == ']')nStatus = shell_status::SHELL_ERROR_SYNTAX_ERROR_UNCLOSED_SQR_BRACKETS;
                 if (cDelimiter == '}')nStatus = shell_status::SHELL_ERROR_SYNTAX_ERROR_UNCLOSED_BRACKETS;
                 if (cDelimiter == '`')nStatus = shell_status::SHELL_ERROR_SYNTAX_ERROR_UNCLOSED_BACK_QUOTES;
-                throw shell_parser_exception{nStatus, oStdIn.str(), nStartPos};
+                throw shell_parser_exception{nStatus, pSource, nStartPos};
             }
         }
     }
 
     void shell_tokenizer::tokens_quote_simple(
         std::vector<shell_token> &vTokens,
-        ifakestream &oStdIn
+        ifakestream &oStdIn,
+        const std::shared_ptr<const shell_source> &pSource
     ) {
         std::size_t nQuotePos = oStdIn.tell() - 1;
         const auto nBegin = vTokens.size();
@@ -345,7 +366,7 @@ namespace bs {
         // Parse quotes
         while (cChar != '\'' && cChar != ifakestream::EOF_VALUE) {
             if (cChar == '\\') {
-                tokens_backslash(vTokens, oStdIn);
+                tokens_backslash(vTokens, oStdIn, pSource);
             } else {
                 add_word(vTokens, oStdIn, nBegin);
             }
@@ -357,7 +378,7 @@ namespace bs {
         if (cChar == ifakestream::EOF_VALUE) {
             constexpr auto nStatus = shell_status::SHELL_ERROR_SYNTAX_ERROR_UNCLOSED_SIMPLE_QUOTES;
             throw shell_parser_exception{
-                nStatus, oStdIn.str(), nQuotePos
+                nStatus, pSource, nQuotePos
             };
         }
 
@@ -371,7 +392,8 @@ namespace bs {
 
     void shell_tokenizer::tokens_quote_double(
         std::vector<shell_token> &vTokens,
-        ifakestream &oStdIn
+        ifakestream &oStdIn,
+        const std::shared_ptr<const shell_source> &pSource
     ) {
         const std::size_t nQuotePos = oStdIn.tell();
         auto nBegin = vTokens.size();
@@ -393,17 +415,17 @@ namespace bs {
                         nTokenType, nPos,
                         oStdIn.sub_view(nPos, 1)
                     );
-                    tokens(vTokens, oStdIn, '`');
+                    tokens(vTokens, oStdIn, pSource, '`');
                     nBegin = vTokens.size();
                     break;
                 }
                 case shell_token_type::TK_ESCAPED: {
-                    tokens_backslash(vTokens, oStdIn);
+                    tokens_backslash(vTokens, oStdIn, pSource);
                     nBegin = vTokens.size();
                     break;
                 }
                 case shell_token_type::TK_DOLLAR: {
-                    tokens_dollar(vTokens, oStdIn);
+                    tokens_dollar(vTokens, oStdIn, pSource);
                     nBegin = vTokens.size();
                     break;
                 }
@@ -421,7 +443,7 @@ namespace bs {
         if (cChar == ifakestream::EOF_VALUE) {
             throw shell_parser_exception{
                 shell_status::SHELL_ERROR_SYNTAX_ERROR_UNCLOSED_DOUBLE_QUOTES,
-                oStdIn.str(), nQuotePos
+                pSource, nQuotePos
             };
         }
 
@@ -432,7 +454,11 @@ namespace bs {
         );
     }
 
-    void shell_tokenizer::tokens_dollar(std::vector<shell_token> &vTokens, ifakestream &oStdIn) {
+    void shell_tokenizer::tokens_dollar(
+        std::vector<shell_token> &vTokens,
+        ifakestream &oStdIn,
+        const std::shared_ptr<const shell_source> &pSource
+    ) {
         // Add dollar
         auto nDollarPos = oStdIn.tell() - 1;
         vTokens.emplace_back(
@@ -458,14 +484,14 @@ namespace bs {
                 oStdIn.sub_view(nPos, 1)
             );
         } else if (cChar == '{') {
-            tokens_dollar_variable(vTokens, oStdIn);
+            tokens_dollar_variable(vTokens, oStdIn, pSource);
         } else if (cChar == '(') {
             nPos = oStdIn.tell() - 1;
             vTokens.emplace_back(
                 shell_token_type::TK_OPEN_PARENTHESIS, nPos,
                 oStdIn.sub_view(nPos, 1)
             );
-            tokens(vTokens, oStdIn, ')');
+            tokens(vTokens, oStdIn, pSource, ')');
         } else if (
             cChar == '_'
             || 'A' <= cChar && cChar <= 'Z'
@@ -496,7 +522,11 @@ namespace bs {
         }
     }
 
-    void shell_tokenizer::tokens_dollar_variable(std::vector<shell_token> &vTokens, ifakestream &oStdIn) {
+    void shell_tokenizer::tokens_dollar_variable(
+        std::vector<shell_token> &vTokens,
+        ifakestream &oStdIn,
+        const std::shared_ptr<const shell_source> &pSource
+    ) {
         // Add brace
         const auto nBracketPos = oStdIn.tell() - 1;
         vTokens.emplace_back(
@@ -517,6 +547,15 @@ namespace bs {
             );
             cChar = oStdIn.get();
             nVariableStartPos = oStdIn.tell() - 1;
+        } else if (cChar == '#') {
+            // Check array size
+            auto nPos = oStdIn.tell() - 1;
+            vTokens.emplace_back(
+                shell_token_type::TK_DOLLAR_SPECIAL, nPos,
+                oStdIn.sub_view(nPos, 1)
+            );
+            cChar = oStdIn.get();
+            nVariableStartPos = oStdIn.tell() - 1;
         }
 
         if ('1' <= cChar && cChar <= '9') {
@@ -540,10 +579,32 @@ namespace bs {
             ) {
                 cChar = oStdIn.get();
             }
+
+            // Process array subscript
+            if (cChar == '[') {
+                vTokens.emplace_back(
+                    shell_token_type::TK_WORD, nVariableStartPos,
+                    oStdIn.sub_view(nVariableStartPos, oStdIn.tell() - 1 - nVariableStartPos)
+                );
+                tokens_dollar_subscript(vTokens, oStdIn, pSource);
+                cChar = oStdIn.get();
+                if (cChar != '}') {
+                    throw shell_parser_exception{
+                        shell_status::SHELL_ERROR_SYNTAX_ERROR_UNCLOSED_VARIABLE,
+                        pSource, nBracketPos,
+                    };
+                }
+                const auto nPos = oStdIn.tell() - 1;
+                vTokens.emplace_back(
+                    shell_token_type::TK_CLOSE_BRACKETS, nPos,
+                    oStdIn.sub_view(nPos, 1)
+                );
+                return;
+            }
         } else {
             throw shell_parser_exception{
                 shell_status::SHELL_ERROR_SYNTAX_ERROR_INVALID_VARIABLE_NAME,
-                oStdIn.str(), nBracketPos,
+                pSource, nBracketPos,
             };
         }
 
@@ -552,7 +613,7 @@ namespace bs {
         if (cChar != '}') {
             throw shell_parser_exception{
                 shell_status::SHELL_ERROR_SYNTAX_ERROR_UNCLOSED_VARIABLE,
-                oStdIn.str(), nBracketPos,
+                pSource, nBracketPos,
             };
         }
 
@@ -569,8 +630,63 @@ namespace bs {
         );
     }
 
+    void shell_tokenizer::tokens_dollar_subscript(
+        std::vector<shell_token> &vTokens,
+        ifakestream &oStdIn,
+        const std::shared_ptr<const shell_source> &pSource
+    ) {
+        // Add square bracket
+        const auto nSqrBracketPos = oStdIn.tell() - 1;
+        vTokens.emplace_back(
+            shell_token_type::TK_OPEN_SQR_BRACKETS, nSqrBracketPos,
+            oStdIn.sub_view(nSqrBracketPos, 1)
+        );
+
+        // Process subscript: literal text and dollar expansions
+        auto nWordPos = oStdIn.tell();
+        auto cChar = oStdIn.get();
+        while (cChar != ']') {
+            if (
+                cChar == ifakestream::EOF_VALUE || cChar == '}'
+                || cChar == ' ' || cChar == '\t' || cChar == '\n'
+            ) {
+                throw shell_parser_exception{
+                    shell_status::SHELL_ERROR_SYNTAX_ERROR_UNCLOSED_SQR_BRACKETS,
+                    pSource, nSqrBracketPos,
+                };
+            }
+            if (cChar == '$') {
+                if (const auto nPos = oStdIn.tell() - 1; nPos > nWordPos) {
+                    vTokens.emplace_back(
+                        shell_token_type::TK_WORD, nWordPos,
+                        oStdIn.sub_view(nWordPos, nPos - nWordPos)
+                    );
+                }
+                tokens_dollar(vTokens, oStdIn, pSource);
+                nWordPos = oStdIn.tell();
+            }
+            cChar = oStdIn.get();
+        }
+
+        // Add last word and square bracket
+        const auto nPos = oStdIn.tell() - 1;
+        if (nPos > nWordPos) {
+            vTokens.emplace_back(
+                shell_token_type::TK_WORD, nWordPos,
+                oStdIn.sub_view(nWordPos, nPos - nWordPos)
+            );
+        }
+        vTokens.emplace_back(
+            shell_token_type::TK_CLOSE_SQR_BRACKETS, nPos,
+            oStdIn.sub_view(nPos, 1)
+        );
+    }
 
-    void shell_tokenizer::tokens_backslash(std::vector<shell_token> &vTokens, ifakestream &oStdIn) {
+    void shell_tokenizer::tokens_backslash(
+        std::vector<shell_token> &vTokens,
+        ifakestream &oStdIn,
+        const std::shared_ptr<const shell_source> &pSource
+    ) {
         const auto nPos = oStdIn.tell() - 1;
         bool bFailure = false;
 
@@ -640,7 +756,7 @@ namespace bs {
         if (bFailure) {
             throw shell_parser_exception{
                 shell_status::SHELL_ERROR_BAD_ENCODING,
-                oStdIn.str(), nPos
+                pSource, nPos
             };
         }
     }
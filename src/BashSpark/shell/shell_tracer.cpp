@@ -0,0 +1,192 @@
+/**
+ * @file shell_tracer.cpp
+ * @brief Implements class shell_tracer.
+ *
+ * This file contains the definition of the `shell_tracer` class,
+ * which records a timeline of the execution of scripts.
+ *
+ * @date Created on 22/11/25
+ * @author Dante Doménech Martínez
+ *
+ * @copyright GNU General Public License v3.0
+ *
+ * This file is part of BashSpark.
+ * Copyright (C) 2025 Dante Doménech Martínez
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "BashSpark/shell/shell_tracer.h"
+
+#include <algorithm>
+
+#include <nlohmann/json.hpp>
+
+namespace bs {
+    namespace {
+        /// Last tracer id given, 0 is never used
+        std::atomic<std::uint64_t> g_nTracers{0};
+
+        /**
+         * @brief Buffer of the calling thread for the last tracer it used.
+         */
+        struct buffer_cache {
+            std::uint64_t m_nTracer; ///< Id of the tracer.
+            void *m_pBuffer; ///< Buffer of the thread in that tracer.
+        };
+
+        /// Cache of the calling thread
+        constinit thread_local buffer_cache g_oCache{0, nullptr};
+
+        /**
+         * @brief Gets the name of a category in the traces.
+         * @param nCategory The category.
+         * @return The name.
+         */
+        std::string_view get_category_name(const shell_trace_category nCategory) {
+            switch (nCategory) {
+                case shell_trace_category::STC_PARSE: return "parse";
+                case shell_trace_category::STC_COMMAND: return "command";
+                case shell_trace_category::STC_SUBSTITUTION: return "substitution";
+                case shell_trace_category::STC_PIPE: return "pipe";
+                case shell_trace_category::STC_FUNCTION: return "function";
+                case shell_trace_category::STC_JOB: return "job";
+                default: return "other";
+            }
+        }
+    }
+
+    shell_tracer::shell_tracer(const std::size_t nCapacity)
+        : m_nId(g_nTracers.fetch_add(1, std::memory_order_relaxed) + 1),
+          m_nCapacity(std::max<std::size_t>(nCapacity, 1)),
+          m_nStart(clock_type::now()) {
+    }
+
+    void shell_tracer::record(
+        const shell_session &oSession,
+        const shell_trace_category nCategory,
+        const std::string_view sName,
+        const char cPhase
+    ) {
+        const auto nTime = clock_type::now();
+        auto &oBuffer = this->get_buffer();
+
+        // Only this thread writes the buffer, the index is published once the event is written
+        const auto nWritten = oBuffer.m_nWritten.load(std::memory_order_relaxed);
+        auto &oEvent = oBuffer.m_vEvents[nWritten % this->m_nCapacity];
+        oEvent.m_nTime = nTime;
+        oEvent.m_nSession = this->get_session_id(oSession);
+        oEvent.m_nNameSize = static_cast<std::uint8_t>(std::min(sName.size(), NAME_SIZE));
+        std::copy_n(sName.data(), oEvent.m_nNameSize, oEvent.m_sName.data());
+        oEvent.m_nCategory = nCategory;
+        oEvent.m_cPhase = cPhase;
+        oBuffer.m_nWritten.store(nWritten + 1, std::memory_order_release);
+    }
+
+    shell_tracer::thread_buffer &shell_tracer::get_buffer() {
+        if (g_oCache.m_nTracer == this->m_nId)
+            return *static_cast<thread_buffer *>(g_oCache.m_pBuffer);
+
+        const auto oThread = std::this_thread::get_id();
+        std::lock_guard oLock(this->m_oMutex);
+        auto pBuffer = std::ranges::find(this->m_vBuffers, oThread, [](const auto &pItem) {
+            return pItem->m_oThread;
+        });
+        if (pBuffer == this->m_vBuffers.end()) {
+            auto pNew = std::make_unique<thread_buffer>();
+            pNew->m_oThread = oThread;
+            pNew->m_nIndex = this->m_vBuffers.size() + 1;
+            pNew->m_vEvents = std::make_unique<event[]>(this->m_nCapacity);
+            pBuffer = this->m_vBuffers.insert(this->m_vBuffers.end(), std::move(pNew));
+        }
+        g_oCache = {this->m_nId, pBuffer->get()};
+        return **pBuffer;
+    }
+
+    std::uint64_t shell_tracer::get_session_id(const shell_session &oSession) {
+        if (oSession.m_nTraceId == 0)
+            oSession.m_nTraceId = this->m_nSessions.fetch_add(1, std::memory_order_relaxed) + 1;
+        return oSession.m_nTraceId;
+    }
+
+    std::vector<std::vector<shell_tracer::event> > shell_tracer::get_events() const {
+        std::lock_guard oLock(this->m_oMutex);
+        std::vector<std::vector<event> > vEvents;
+        for (const auto &pBuffer: this->m_vBuffers) {
+            const auto nWritten = pBuffer->m_nWritten.load(std::memory_order_acquire);
+            if (nWritten == 0) continue;
+            auto &vThread = vEvents.emplace_back();
+            const auto nFirst = nWritten > this->m_nCapacity ? nWritten - this->m_nCapacity : 0;
+            vThread.reserve(nWritten - nFirst);
+            for (auto i = nFirst; i < nWritten; ++i)
+                vThread.push_back(pBuffer->m_vEvents[i % this->m_nCapacity]);
+        }
+        return vEvents;
+    }
+
+    std::uint64_t shell_tracer::get_dropped() const {
+        std::lock_guard oLock(this->m_oMutex);
+        std::uint64_t nDropped = 0;
+        for (const auto &pBuffer: this->m_vBuffers) {
+            const auto nWritten = pBuffer->m_nWritten.load(std::memory_order_acquire);
+            if (nWritten > this->m_nCapacity) nDropped += nWritten - this->m_nCapacity;
+        }
+        return nDropped;
+    }
+
+    void shell_tracer::clear() {
+        std::lock_guard oLock(this->m_oMutex);
+        for (const auto &pBuffer: this->m_vBuffers)
+            pBuffer->m_nWritten.store(0, std::memory_order_release);
+    }
+
+    void shell_tracer::write_json(std::ostream &oOut) const {
+        std::lock_guard oLock(this->m_oMutex);
+        oOut << R"({"displayTimeUnit":"ns","traceEvents":[)";
+        bool bFirst = true;
+        const auto fWrite = [&oOut, &bFirst](const nlohmann::ordered_json &oEvent) {
+            if (!bFirst) oOut.put(',');
+            oOut << '\n' << oEvent.dump(-1, ' ', false, nlohmann::json::error_handler_t::replace);
+            bFirst = false;
+        };
+
+        for (const auto &pBuffer: this->m_vBuffers) {
+            const auto nWritten = pBuffer->m_nWritten.load(std::memory_order_acquire);
+            if (nWritten == 0) continue;
+            fWrite({
+                {"name", "thread_name"}, {"ph", "M"}, {"pid", 1}, {"tid", pBuffer->m_nIndex},
+                {"args", {{"name", "thread " + std::to_string(pBuffer->m_nIndex)}}}
+            });
+
+            const auto nFirst = nWritten > this->m_nCapacity ? nWritten - this->m_nCapacity : 0;
+            for (auto i = nFirst; i < nWritten; ++i) {
+                const auto &oEvent = pBuffer->m_vEvents[i % this->m_nCapacity];
+                const std::chrono::duration<double, std::micro> nTime = oEvent.m_nTime - this->m_nStart;
+                nlohmann::ordered_json oJson = {
+                    {"name", oEvent.get_name()},
+                    {"cat", get_category_name(oEvent.m_nCategory)},
+                    {"ph", std::string(1, oEvent.m_cPhase)},
+                    {"ts", nTime.count()},
+                    {"pid", 1},
+                    {"tid", pBuffer->m_nIndex},
+                    {"args", {{"session", oEvent.m_nSession}}}
+                };
+                // Asynchronous events are matched by session
+                if (oEvent.m_cPhase == 'b' || oEvent.m_cPhase == 'e') oJson["id"] = oEvent.m_nSession;
+                fWrite(oJson);
+            }
+        }
+        oOut << "\n]}" << std::endl;
+    }
+}
@@ -112,11 +112,11 @@ namespace bs {
         /**
          * @brief Retrieves the current position of the token holder.
          *
-         * @return The current position as an std::size_t. If out of bounds, returns the size of the input stream.
+         * @return The offset of the current token in the input stream. If out of bounds, returns the size of the input stream.
          */
         [[nodiscard]] std::size_t pos() const noexcept {
             if (m_nPos >= m_vTokens.size() || m_nPos < 0) return m_oIstream.size();
-            return m_nPos;
+            return m_vTokens[m_nPos].m_nPos;
         }
 
         /**
@@ -0,0 +1,51 @@
+/**
+ * @file bench_alloc.h
+ * @brief Counts the heap allocations of the benchmark executable.
+ *
+ * The benchmark executable replaces the global `operator new` and
+ * `operator delete` to count every allocation made by the process.
+ *
+ * @date Created on 22/11/25
+ * @author Dante Doménech Martínez
+ *
+ * @copyright GNU General Public License v3.0
+ *
+ * This file is part of BashSpark.
+ * Copyright (C) 2025 Dante Doménech Martínez
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <cstddef>
+
+namespace bs::debug {
+    /**
+     * @struct bench_alloc_count
+     * @brief Allocations made since the process started.
+     */
+    struct bench_alloc_count {
+        /// Number of allocations.
+        std::size_t m_nAllocations;
+        /// Number of bytes allocated.
+        std::size_t m_nBytes;
+    };
+
+    /**
+     * @brief Gets the allocations made since the process started.
+     * @return The allocation count.
+     */
+    bench_alloc_count get_alloc_count() noexcept;
+}
@@ -0,0 +1,185 @@
+/**
+ * @file bench_corpus.h
+ * @brief Defines the whole-script benchmark corpus and its runner.
+ *
+ * The corpus holds representative scripts, each stressing one part of the
+ * interpreter. The runner records their wall time, peak resident memory and
+ * allocations, and compares two recorded results into a regression report.
+ *
+ * @date Created on 22/11/25
+ * @author Dante Doménech Martínez
+ *
+ * @copyright GNU General Public License v3.0
+ *
+ * This file is part of BashSpark.
+ * Copyright (C) 2025 Dante Doménech Martínez
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <ostream>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <nlohmann/json.hpp>
+
+#include "BashSpark/BashSpark.h"
+
+namespace bs::debug {
+    /**
+     * @struct bench_workload
+     * @brief A script of the corpus.
+     */
+    struct bench_workload {
+        /// Name of the workload.
+        std::string_view m_sName;
+        /// Script, run with \ref bs::shell::run "shell::run".
+        std::string_view m_sScript;
+    };
+
+    /**
+     * @struct bench_workload_result
+     * @brief Measures of a workload.
+     */
+    struct bench_workload_result {
+        /// Name of the workload.
+        std::string m_sName;
+        /// Number of measured runs.
+        std::size_t m_nRuns = 0;
+        /// Status of the last run.
+        shell_status m_nStatus = shell_status::SHELL_SUCCESS;
+        /// Median wall time of a run, in milliseconds.
+        double m_dWallTime = 0;
+        /// Fastest wall time of a run, in milliseconds.
+        double m_dWallTimeMin = 0;
+        /// Peak resident memory while running, in bytes, 0 if unknown.
+        std::size_t m_nPeakRss = 0;
+        /// Allocations of a run.
+        double m_dAllocations = 0;
+        /// Bytes allocated by a run.
+        double m_dAllocBytes = 0;
+        /// Allocations of a run by interpreter phase, see \ref bs::shell_alloc_phase "shell_alloc_phase".
+        std::array<double, SHELL_ALLOC_PHASES> m_vPhaseAllocations{};
+    };
+
+    /**
+     * @class bench_corpus
+     * @brief Runs the whole-script workloads and compares their results.
+     *
+     * Each workload runs once to warm up and then \ref DEFAULT_RUNS times,
+     * on a fresh session each time. Results are saved as JSON, see
+     * \ref to_json, so that a later build can be compared with
+     * \ref compare.
+     *
+     * The peak resident memory is reset before each workload on Linux. On
+     * other Unix systems it is the peak of the whole process, elsewhere it
+     * is not measured. The allocations are split by interpreter phase on one
+     * more run, with \ref bs::shell_alloc_stats "shell_alloc_stats" attached
+     * to the session.
+     */
+    class bench_corpus {
+    public:
+        /// Measured runs of each workload
+        constexpr static std::size_t DEFAULT_RUNS = 20;
+        /// Change, in percent, reported as a regression
+        constexpr static double DEFAULT_THRESHOLD = 5.0;
+        /// Version of the result files
+        constexpr static int FORMAT_VERSION = 1;
+
+    public:
+        /**
+         * @brief Constructs the runner.
+         * @param nRuns Measured runs of each workload
+         */
+        explicit bench_corpus(const std::size_t nRuns = DEFAULT_RUNS)
+            : m_nRuns(nRuns) {
+        }
+
+    public:
+        /**
+         * @brief Gets the workloads of the corpus.
+         * @return The workloads.
+         */
+        [[nodiscard]] static std::span<const bench_workload> get_workloads() noexcept;
+
+        /**
+         * @brief Runs the workloads.
+         * @param sFilter Only run the workloads whose name contains it, empty to run all
+         * @return The measures, in corpus order.
+         */
+        [[nodiscard]] std::vector<bench_workload_result> run(std::string_view sFilter = {}) const;
+
+        /**
+         * @brief Prints the measures as a table.
+         * @param vResults Measures
+         * @param oOut Output stream
+         */
+        static void print(const std::vector<bench_workload_result> &vResults, std::ostream &oOut);
+
+        /**
+         * @brief Converts the measures to a result file.
+         * @param vResults Measures
+         * @return The result file.
+         */
+        [[nodiscard]] static nlohmann::ordered_json to_json(const std::vector<bench_workload_result> &vResults);
+
+        /**
+         * @brief Reads the measures of a result file.
+         * @param oJson The result file
+         * @return The measures.
+         * @throw nlohmann::json::exception If the file is malformed.
+         * @throw std::runtime_error If the file has another format version.
+         */
+        [[nodiscard]] static std::vector<bench_workload_result> from_json(const nlohmann::json &oJson);
+
+        /**
+         * @brief Compares two measures and prints a regression report.
+         *
+         * A workload regresses when its median wall time, its allocations or
+         * its peak resident memory grow by more than the threshold, or when
+         * it no longer succeeds. The phases whose allocations change by more
+         * than the threshold are listed below the workload.
+         *
+         * @param vBase Measures of the reference build
+         * @param vCurrent Measures of the build to check
+         * @param dThreshold Change, in percent, reported as a regression
+         * @param oOut Output stream of the report
+         * @return true if no workload regresses.
+         */
+        static bool compare(
+            const std::vector<bench_workload_result> &vBase,
+            const std::vector<bench_workload_result> &vCurrent,
+            double dThreshold,
+            std::ostream &oOut
+        );
+
+    private:
+        /**
+         * @brief Runs a workload.
+         * @param oWorkload The workload
+         * @return Its measures.
+         */
+        [[nodiscard]] bench_workload_result run_workload(const bench_workload &oWorkload) const;
+
+    private:
+        /// Measured runs of each workload
+        std::size_t m_nRuns;
+    };
+}
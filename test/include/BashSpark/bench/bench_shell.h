@@ -0,0 +1,201 @@
+/**
+ * @file bench_shell.h
+ * @brief Defines a series of benchmarks measuring the performance of the shell.
+ *
+ * @date Created on 22/11/25
+ * @author Dante Doménech Martínez
+ *
+ * @copyright GNU General Public License v3.0
+ *
+ * This file is part of BashSpark.
+ * Copyright (C) 2025 Dante Doménech Martínez
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <string>
+#include <string_view>
+#include <utility>
+
+#include "BashSpark/BashSpark.h"
+
+namespace bs::debug {
+    /**
+     * @class bench_shell
+     * @brief A class to encapsulate shell benchmarks.
+     *
+     * Every benchmark warms up, then repeats an operation on a fixed input
+     * until a minimum time has elapsed. It reports the time per operation,
+     * the operations per second, the input bytes per second and the heap
+     * allocations per operation, either as text or as one JSON object per line.
+     */
+    class bench_shell {
+    public:
+        /// Minimum time spent on each benchmark
+        constexpr static std::chrono::milliseconds MIN_TIME{200};
+        /// Operations per batch, the clock is read once per batch
+        constexpr static std::size_t BATCH_SIZE = 64;
+
+    public:
+        /**
+         * @brief Constructs the benchmarks.
+         * @param bJson Whether to print one JSON object per line instead of text
+         * @param sFilter Only run the benchmarks whose name contains it, empty to run all
+         */
+        explicit bench_shell(const bool bJson = false, std::string sFilter = {})
+            : m_bJson(bJson), m_sFilter(std::move(sFilter)) {
+        }
+
+    public:
+        /**
+         * @brief Executes all the benchmarks.
+         */
+        void bench() const;
+
+    private:
+        /**
+         * @brief Benchmarks the shell construction.
+         *
+         * This method measures the shells created per second with the default
+         * shell, the static shell and a shell on the shared default shell.
+         */
+        void bench_startup() const;
+
+        /**
+         * @brief Benchmarks the output capture.
+         *
+         * This method compares capturing through a `std::ostringstream` with
+         * \ref bs::shell::run_capture "shell::run_capture".
+         */
+        void bench_capture() const;
+
+        /**
+         * @brief Benchmarks the batch runs.
+         *
+         * This method prints the throughput and tail latency of
+         * \ref bs::shell::run_batch "shell::run_batch" with 1, 2 and all threads.
+         */
+        void bench_batch() const;
+
+        /**
+         * @brief Benchmarks the coroutine evaluation.
+         *
+         * This method compares the synchronous evaluation of a compiled script
+         * with its coroutine evaluation, without and with time slicing.
+         */
+        void bench_async() const;
+
+        /**
+         * @brief Benchmarks the session environment.
+         *
+         * This method compares creating a session copying a large environment
+         * with creating it on a shared base environment, and their lookups.
+         */
+        void bench_env() const;
+
+        /**
+         * @brief Benchmarks the tokenizer.
+         *
+         * This method measures \ref bs::shell_tokenizer::tokens "shell_tokenizer::tokens"
+         * on a short command and on a script with loops, quotes and substitutions.
+         */
+        void bench_tokenizer() const;
+
+        /**
+         * @brief Benchmarks the parser.
+         *
+         * This method measures \ref bs::shell_parser::parse "shell_parser::parse",
+         * tokenization included, on the inputs of \ref bench_tokenizer.
+         */
+        void bench_parser() const;
+
+        /**
+         * @brief Benchmarks the expansion of a command.
+         *
+         * This method measures \ref bs::shell_node_command_expression::expand "shell_node_command_expression::expand"
+         * on words, variables, quotes and arguments.
+         */
+        void bench_expand() const;
+
+        /**
+         * @brief Benchmarks the word splitting.
+         *
+         * This method measures `split_string` on a short and a long text.
+         */
+        void bench_split() const;
+
+        /**
+         * @brief Benchmarks the variable lookup.
+         *
+         * This method measures reading a string and an integer variable of a session.
+         */
+        void bench_var() const;
+
+        /**
+         * @brief Benchmarks the builtin commands.
+         *
+         * This method measures \ref bs::command_math "command_math",
+         * \ref bs::command_test "command_test" and \ref bs::command_seq "command_seq"
+         * called directly, without parsing. Their bytes are the bytes written
+         * on stdout.
+         */
+        void bench_commands() const;
+
+        /**
+         * @brief Benchmarks the dispatch of the builtin commands.
+         *
+         * This method compares looking a builtin up in the hash table of the
+         * default shell and calling it virtually with running it through the
+         * static table of \ref bs::default_static_shell "default_static_shell",
+         * directly and from a compiled script.
+         */
+        void bench_dispatch() const;
+
+        /**
+         * @brief Benchmarks the traversal of a large syntax tree.
+         *
+         * This method counts the nodes of a long script with a
+         * \ref bs::shell_node_visitor "shell_node_visitor" and with a
+         * \ref bs::shell_node_static_visitor "shell_node_static_visitor".
+         */
+        void bench_visitor() const;
+
+    private:
+        /**
+         * @brief Checks whether a benchmark is selected by the filter.
+         * @param sName Benchmark name
+         * @return true if it must run
+         */
+        [[nodiscard]] bool selected(std::string_view sName) const;
+
+        /**
+         * @brief Repeats an operation and prints its speed.
+         * @param sName Benchmark name
+         * @param nBytes Bytes processed by each operation, 0 if not meaningful
+         * @param fOperation Operation to measure, returns a value to keep it from being optimized away
+         */
+        template<typename F>
+        void measure(std::string_view sName, std::size_t nBytes, F &&fOperation) const;
+
+    private:
+        /// Print JSON lines
+        bool m_bJson;
+        /// Name filter
+        std::string m_sFilter;
+    };
+}
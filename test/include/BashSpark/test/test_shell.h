@@ -132,6 +132,147 @@ namespace bs::debug {
          */
         void test_script()const;
 
+        /**
+         * @brief Tests streaming command substitution
+         *
+         * This method verifies for-loops consuming a producer running concurrently.
+         */
+        void test_stream()const;
+
+        /**
+         * @brief Tests array variables
+         *
+         * This method verifies indexed and associative arrays and their expansions.
+         */
+        void test_array()const;
+
+        /**
+         * @brief Tests the static shell
+         *
+         * This method verifies the builtin table and the fallback to user commands.
+         */
+        void test_static_shell()const;
+
+        /**
+         * @brief Tests shells built on a shared base shell
+         *
+         * This method verifies the command lookup, hiding and overriding of base commands.
+         */
+        void test_shared_shell()const;
+
+        /**
+         * @brief Tests script files and compiled scripts
+         *
+         * This method verifies running and compiling scripts from files.
+         */
+        void test_file()const;
+
+        /**
+         * @brief Tests captured runs
+         *
+         * This method verifies the output, errors, status and state of captured runs.
+         */
+        void test_capture()const;
+
+        /**
+         * @brief Tests typed records in pipes
+         *
+         * This method verifies that records and text pipes produce the same results.
+         */
+        void test_records()const;
+
+        /**
+         * @brief Tests batch runs
+         *
+         * This method verifies that batch jobs are isolated and their results kept in order.
+         */
+        void test_batch()const;
+
+        /**
+         * @brief Tests coroutine evaluation
+         *
+         * This method verifies that tasks produce the same output as the synchronous
+         * evaluation, and that the scheduler interleaves them.
+         */
+        void test_async()const;
+
+        /**
+         * @brief Tests asynchronous commands
+         *
+         * This method verifies that tasks awaiting a command give up their thread.
+         */
+        void test_async_command()const;
+
+        /**
+         * @brief Tests environments on a shared base
+         *
+         * This method verifies that overlays shadow the base without modifying it.
+         */
+        void test_env_base()const;
+
+        /**
+         * @brief Tests the profiler
+         *
+         * This method verifies the hits, times and stacks recorded per node and function.
+         */
+        void test_profiler()const;
+
+        /**
+         * @brief Tests the command metrics
+         *
+         * This method verifies the calls, errors, latencies and characters recorded per command.
+         */
+        void test_command_metrics()const;
+
+        /**
+         * @brief Tests the allocation accounting
+         *
+         * This method verifies the attribution of allocations to sessions and phases.
+         */
+        void test_alloc_stats()const;
+
+        /**
+         * @brief Tests the tracer
+         *
+         * This method verifies the events recorded per thread and their trace-event JSON.
+         */
+        void test_tracer()const;
+
+        /**
+         * @brief Tests the diagnostic log
+         *
+         * This method verifies the filtering of diagnostics by level and category.
+         */
+        void test_log()const;
+
+        /**
+         * @brief Tests the syntax errors
+         *
+         * This method verifies the shared source and the message of the syntax errors.
+         */
+        void test_parser_exception()const;
+
+        /**
+         * @brief Tests the streaming JSON writer
+         *
+         * This method verifies that the writer outputs the same JSON as the tree visitor.
+         */
+        void test_json_writer()const;
+
+        /**
+         * @brief Tests the static visitor
+         *
+         * This method verifies that the static visitor reaches every node the tree visitor reaches.
+         */
+        void test_static_visitor()const;
+
+        /**
+         * @brief Tests the single-threaded shared pointer
+         *
+         * This method verifies that copies, moves and resets keep the reference count and destroy the object once.
+         */
+        void test_local_ptr()const;
+
     private:
         std::unique_ptr<shell> m_pShell; ///< Pointer to the shell instance used for testing.
     };
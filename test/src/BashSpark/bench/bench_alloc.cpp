@@ -0,0 +1,132 @@
+/**
+ * @file bench_alloc.cpp
+ * @brief Replaces the global allocation functions to count the allocations.
+ *
+ * @date Created on 22/11/25
+ * @author Dante Doménech Martínez
+ *
+ * @copyright GNU General Public License v3.0
+ *
+ * This file is part of BashSpark.
+ * Copyright (C) 2025 Dante Doménech Martínez
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "BashSpark/bench/bench_alloc.h"
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+#include "BashSpark/shell/shell_alloc.h"
+
+namespace bs::debug {
+    namespace {
+        /// Number of allocations
+        std::atomic<std::size_t> g_nAllocations{0};
+        /// Number of bytes allocated
+        std::atomic<std::size_t> g_nBytes{0};
+
+        /**
+         * @brief Allocates and counts memory.
+         * @param nSize Bytes to allocate.
+         * @param nAlign Alignment, 0 for the default one.
+         * @return The memory, nullptr on failure.
+         */
+        void *allocate(std::size_t nSize, const std::size_t nAlign) noexcept {
+            if (nSize == 0) nSize = 1;
+            g_nAllocations.fetch_add(1, std::memory_order_relaxed);
+            g_nBytes.fetch_add(nSize, std::memory_order_relaxed);
+            shell_alloc_stats::record_allocation(nSize);
+            if (nAlign == 0) return std::malloc(nSize);
+            return std::aligned_alloc(nAlign, (nSize + nAlign - 1) / nAlign * nAlign);
+        }
+
+        /**
+         * @brief Allocates and counts memory, throwing on failure.
+         * @param nSize Bytes to allocate.
+         * @param nAlign Alignment, 0 for the default one.
+         * @return The memory.
+         * @throw std::bad_alloc If the memory can not be allocated.
+         */
+        void *allocate_or_throw(const std::size_t nSize, const std::size_t nAlign) {
+            if (const auto pMemory = allocate(nSize, nAlign)) return pMemory;
+            throw std::bad_alloc();
+        }
+    }
+
+    bench_alloc_count get_alloc_count() noexcept {
+        return {
+            g_nAllocations.load(std::memory_order_relaxed),
+            g_nBytes.load(std::memory_order_relaxed)
+        };
+    }
+}
+
+void *operator new(const std::size_t nSize) {
+    return bs::debug::allocate_or_throw(nSize, 0);
+}
+
+void *operator new[](const std::size_t nSize) {
+    return bs::debug::allocate_or_throw(nSize, 0);
+}
+
+void *operator new(const std::size_t nSize, const std::nothrow_t &) noexcept {
+    return bs::debug::allocate(nSize, 0);
+}
+
+void *operator new[](const std::size_t nSize, const std::nothrow_t &) noexcept {
+    return bs::debug::allocate(nSize, 0);
+}
+
+void *operator new(const std::size_t nSize, const std::align_val_t nAlign) {
+    return bs::debug::allocate_or_throw(nSize, static_cast<std::size_t>(nAlign));
+}
+
+void *operator new[](const std::size_t nSize, const std::align_val_t nAlign) {
+    return bs::debug::allocate_or_throw(nSize, static_cast<std::size_t>(nAlign));
+}
+
+void operator delete(void *pMemory) noexcept {
+    std::free(pMemory);
+}
+
+void operator delete[](void *pMemory) noexcept {
+    std::free(pMemory);
+}
+
+void operator delete(void *pMemory, std::size_t) noexcept {
+    std::free(pMemory);
+}
+
+void operator delete[](void *pMemory, std::size_t) noexcept {
+    std::free(pMemory);
+}
+
+void operator delete(void *pMemory, std::align_val_t) noexcept {
+    std::free(pMemory);
+}
+
+void operator delete[](void *pMemory, std::align_val_t) noexcept {
+    std::free(pMemory);
+}
+
+void operator delete(void *pMemory, std::size_t, std::align_val_t) noexcept {
+    std::free(pMemory);
+}
+
+void operator delete[](void *pMemory, std::size_t, std::align_val_t) noexcept {
+    std::free(pMemory);
+}
@@ -0,0 +1,372 @@
+/**
+ * @file bench_corpus.cpp
+ * @brief Implements the whole-script benchmark corpus and its runner.
+ *
+ * @date Created on 22/11/25
+ * @author Dante Doménech Martínez
+ *
+ * @copyright GNU General Public License v3.0
+ *
+ * This file is part of BashSpark.
+ * Copyright (C) 2025 Dante Doménech Martínez
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "BashSpark/bench/bench_corpus.h"
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <iomanip>
+#include <stdexcept>
+
+#include "BashSpark/bench/bench_alloc.h"
+#include "BashSpark/tools/nullstream.h"
+
+#if defined(__linux__)
+#define BS_BENCH_RSS_PROC
+#include <fstream>
+#include <sstream>
+#elif defined(__unix__) || defined(__APPLE__)
+#define BS_BENCH_RSS_RUSAGE
+#include <sys/resource.h>
+#endif
+
+namespace bs::debug {
+    namespace {
+        /// Loop-heavy arithmetic
+        constexpr std::string_view WORKLOAD_LOOP =
+                "setvar s 0\n"
+                "for i from 1 to 2000; do\n"
+                "    setvar s $(math $(getvar s) + $i * $i)\n"
+                "done\n"
+                "test $(getvar s) == 2668667000\n";
+
+        /// Substitution-heavy templating
+        constexpr std::string_view WORKLOAD_TEMPLATE =
+                "setvar customer \"Ada Lovelace\"\n"
+                "setvar product \"analytical engine\"\n"
+                "for i from 1 to 300; do\n"
+                "    setvar line \"Dear $customer, order #$i for the $(getvar product) costs $(math $i * 7 + 3) EUR.\"\n"
+                "    appendvar letter \"$line\"\n"
+                "done\n"
+                "test -n \"$(getvar letter)\"\n";
+
+        /// Function-call-heavy recursion
+        constexpr std::string_view WORKLOAD_RECURSION =
+                "function fib {\n"
+                "    if test $1 -lt 2; then\n"
+                "        echo -n $1\n"
+                "    else\n"
+                "        echo -n $(math $(fcall fib $(math $1 - 1)) + $(fcall fib $(math $1 - 2)))\n"
+                "    fi\n"
+                "}\n"
+                "test $(fcall fib 12) == 144\n";
+
+        /// Pipeline-heavy text flow
+        constexpr std::string_view WORKLOAD_PIPELINE =
+                "for i from 1 to 200; do\n"
+                "    seq 1 50 | readarray lines\n"
+                "    echo \"${lines[7]} ${lines[42]}\" | readarray pair\n"
+                "    appendvar out \"${pair[0]};\"\n"
+                "done\n"
+                "test -n \"$(getvar out)\"\n";
+
+        /// Eval-heavy code generation
+        constexpr std::string_view WORKLOAD_EVAL =
+                "for i from 1 to 300; do\n"
+                "    eval \"setvar v$i \\$(math $i * 2)\"\n"
+                "    eval \"appendvar out \\\"\\$(getvar v$i),\\\"\"\n"
+                "    eval \"eval \\\"appendvar out $i\\\"\"\n"
+                "done\n"
+                "test $(getvar v300) == 600\n";
+
+        /// The corpus
+        constexpr std::array WORKLOADS{
+            bench_workload{"loop_arithmetic", WORKLOAD_LOOP},
+            bench_workload{"substitution_templating", WORKLOAD_TEMPLATE},
+            bench_workload{"function_recursion", WORKLOAD_RECURSION},
+            bench_workload{"pipeline_text", WORKLOAD_PIPELINE},
+            bench_workload{"eval_codegen", WORKLOAD_EVAL},
+        };
+
+        /**
+         * @brief Resets the peak resident memory of the process, if supported.
+         */
+        void reset_peak_rss() {
+#ifdef BS_BENCH_RSS_PROC
+            std::ofstream oClear("/proc/self/clear_refs");
+            oClear << "5";
+#endif
+        }
+
+        /**
+         * @brief Gets the peak resident memory of the process.
+         * @return The peak in bytes, 0 if unknown.
+         */
+        std::size_t get_peak_rss() {
+#if defined(BS_BENCH_RSS_PROC)
+            std::ifstream oStatus("/proc/self/status");
+            std::string sLine;
+            while (std::getline(oStatus, sLine)) {
+                if (!sLine.starts_with("VmHWM:")) continue;
+                std::istringstream oLine(sLine.substr(6));
+                std::size_t nKiB = 0;
+                oLine >> nKiB;
+                return nKiB * 1024;
+            }
+            return 0;
+#elif defined(BS_BENCH_RSS_RUSAGE)
+            rusage oUsage{};
+            if (getrusage(RUSAGE_SELF, &oUsage) != 0) return 0;
+#if defined(__APPLE__)
+            return static_cast<std::size_t>(oUsage.ru_maxrss);
+#else
+            return static_cast<std::size_t>(oUsage.ru_maxrss) * 1024;
+#endif
+#else
+            return 0;
+#endif
+        }
+
+        /**
+         * @brief Gets the relative change of a measure.
+         * @param dBase Reference value
+         * @param dCurrent Current value
+         * @return The change in percent, 0 if both are 0.
+         */
+        double get_change(const double dBase, const double dCurrent) {
+            if (dBase == 0) return dCurrent == 0 ? 0 : 100;
+            return (dCurrent - dBase) * 100 / dBase;
+        }
+    }
+
+    std::span<const bench_workload> bench_corpus::get_workloads() noexcept {
+        return WORKLOADS;
+    }
+
+    std::vector<bench_workload_result> bench_corpus::run(const std::string_view sFilter) const {
+        std::vector<bench_workload_result> vResults;
+        for (const auto &oWorkload: WORKLOADS) {
+            if (oWorkload.m_sName.find(sFilter) == std::string_view::npos) continue;
+            vResults.push_back(this->run_workload(oWorkload));
+        }
+        return vResults;
+    }
+
+    bench_workload_result bench_corpus::run_workload(const bench_workload &oWorkload) const {
+        using clock = std::chrono::steady_clock;
+        const auto pShell = shell::make_default_shell();
+        inullstream oStdIn;
+        onullstream oStdNull;
+
+        const auto fRun = [&](shell_alloc_stats *pAllocStats = nullptr) {
+            shell_session oSession(pShell.get(), oStdIn, oStdNull, oStdNull);
+            oSession.set_alloc_stats(pAllocStats);
+            return shell::run(oWorkload.m_sScript, oSession);
+        };
+
+        bench_workload_result oResult;
+        oResult.m_sName = oWorkload.m_sName;
+        oResult.m_nRuns = this->m_nRuns;
+
+        // Warm up
+        reset_peak_rss();
+        oResult.m_nStatus = fRun();
+
+        std::vector<double> vTimes;
+        vTimes.reserve(this->m_nRuns);
+        const auto oAllocStart = get_alloc_count();
+        for (std::size_t i = 0; i < this->m_nRuns; ++i) {
+            const auto oStart = clock::now();
+            oResult.m_nStatus = fRun();
+            vTimes.push_back(std::chrono::duration<double, std::milli>(clock::now() - oStart).count());
+        }
+        const auto oAllocEnd = get_alloc_count();
+        oResult.m_nPeakRss = get_peak_rss();
+
+        if (!vTimes.empty()) {
+            std::ranges::sort(vTimes);
+            oResult.m_dWallTime = vTimes[vTimes.size() / 2];
+            oResult.m_dWallTimeMin = vTimes.front();
+            const auto dRuns = static_cast<double>(vTimes.size());
+            oResult.m_dAllocations = static_cast<double>(oAllocEnd.m_nAllocations - oAllocStart.m_nAllocations) / dRuns;
+            oResult.m_dAllocBytes = static_cast<double>(oAllocEnd.m_nBytes - oAllocStart.m_nBytes) / dRuns;
+        }
+
+        // Allocations by phase, apart so that the accounting does not slow down the measured runs
+        shell_alloc_stats oAllocStats;
+        static_cast<void>(fRun(&oAllocStats));
+        for (std::size_t i = 0; i < SHELL_ALLOC_PHASES; ++i) {
+            oResult.m_vPhaseAllocations[i] = static_cast<double>(
+                oAllocStats.get(static_cast<shell_alloc_phase>(i)).m_nAllocations);
+        }
+        return oResult;
+    }
+
+    void bench_corpus::print(const std::vector<bench_workload_result> &vResults, std::ostream &oOut) {
+        oOut << std::left << std::setw(26) << "workload"
+                << std::right << std::setw(12) << "median ms"
+                << std::setw(12) << "min ms"
+                << std::setw(12) << "rss KiB"
+                << std::setw(14) << "allocs/run"
+                << std::setw(8) << "status" << '\n';
+        for (const auto &oResult: vResults) {
+            oOut << std::left << std::setw(26) << oResult.m_sName
+                    << std::right << std::fixed << std::setprecision(3)
+                    << std::setw(12) << oResult.m_dWallTime
+                    << std::setw(12) << oResult.m_dWallTimeMin
+                    << std::setw(12) << oResult.m_nPeakRss / 1024
+                    << std::setprecision(0) << std::setw(14) << oResult.m_dAllocations
+                    << std::setw(8) << static_cast<int>(oResult.m_nStatus) << '\n';
+        }
+
+        // Allocations by phase
+        oOut << '\n' << std::left << std::setw(26) << "allocs/run by phase" << std::right;
+        for (std::size_t i = 0; i < SHELL_ALLOC_PHASES; ++i)
+            oOut << std::setw(10) << get_alloc_phase_name(static_cast<shell_alloc_phase>(i));
+        oOut << '\n' << std::setprecision(0);
+        for (const auto &oResult: vResults) {
+            oOut << std::left << std::setw(26) << oResult.m_sName << std::right;
+            for (const auto dAllocations: oResult.m_vPhaseAllocations)
+                oOut << std::setw(10) << dAllocations;
+            oOut << '\n';
+        }
+        oOut << std::defaultfloat << std::flush;
+    }
+
+    nlohmann::ordered_json bench_corpus::to_json(const std::vector<bench_workload_result> &vResults) {
+        nlohmann::ordered_json oJson;
+        oJson["format"] = FORMAT_VERSION;
+        oJson["workloads"] = nlohmann::ordered_json::array();
+        for (const auto &oResult: vResults) {
+            nlohmann::ordered_json oWorkload;
+            oWorkload["name"] = oResult.m_sName;
+            oWorkload["runs"] = oResult.m_nRuns;
+            oWorkload["status"] = static_cast<int>(oResult.m_nStatus);
+            oWorkload["wall_ms"] = oResult.m_dWallTime;
+            oWorkload["wall_ms_min"] = oResult.m_dWallTimeMin;
+            oWorkload["peak_rss_bytes"] = oResult.m_nPeakRss;
+            oWorkload["allocs_per_run"] = oResult.m_dAllocations;
+            oWorkload["alloc_bytes_per_run"] = oResult.m_dAllocBytes;
+            nlohmann::ordered_json oPhases;
+            for (std::size_t i = 0; i < SHELL_ALLOC_PHASES; ++i) {
+                const auto sPhase = get_alloc_phase_name(static_cast<shell_alloc_phase>(i));
+                oPhases[std::string(sPhase)] = oResult.m_vPhaseAllocations[i];
+            }
+            oWorkload["allocs_by_phase"] = std::move(oPhases);
+            oJson["workloads"].push_back(std::move(oWorkload));
+        }
+        return oJson;
+    }
+
+    std::vector<bench_workload_result> bench_corpus::from_json(const nlohmann::json &oJson) {
+        if (oJson.at("format").get<int>() != FORMAT_VERSION)
+            throw std::runtime_error("bench_corpus: unsupported result format");
+
+        std::vector<bench_workload_result> vResults;
+        for (const auto &oWorkload: oJson.at("workloads")) {
+            bench_workload_result oResult;
+            oResult.m_sName = oWorkload.at("name").get<std::string>();
+            oResult.m_nRuns = oWorkload.at("runs").get<std::size_t>();
+            oResult.m_nStatus = static_cast<shell_status>(oWorkload.at("status").get<int>());
+            oResult.m_dWallTime = oWorkload.at("wall_ms").get<double>();
+            oResult.m_dWallTimeMin = oWorkload.at("wall_ms_min").get<double>();
+            oResult.m_nPeakRss = oWorkload.at("peak_rss_bytes").get<std::size_t>();
+            oResult.m_dAllocations = oWorkload.at("allocs_per_run").get<double>();
+            oResult.m_dAllocBytes = oWorkload.at("alloc_bytes_per_run").get<double>();
+            // Missing in files recorded before the phases were accounted
+            if (const auto pPhases = oWorkload.find("allocs_by_phase"); pPhases != oWorkload.end()) {
+                for (std::size_t i = 0; i < SHELL_ALLOC_PHASES; ++i) {
+                    const auto sPhase = get_alloc_phase_name(static_cast<shell_alloc_phase>(i));
+                    oResult.m_vPhaseAllocations[i] = pPhases->value(std::string(sPhase), 0.0);
+                }
+            }
+            vResults.push_back(std::move(oResult));
+        }
+        return vResults;
+    }
+
+    bool bench_corpus::compare(
+        const std::vector<bench_workload_result> &vBase,
+        const std::vector<bench_workload_result> &vCurrent,
+        const double dThreshold,
+        std::ostream &oOut
+    ) {
+        bool bPassed = true;
+        const auto oFlags = oOut.flags();
+        const auto nPrecision = oOut.precision();
+        oOut << std::left << std::setw(26) << "workload"
+                << std::right << std::setw(12) << "wall"
+                << std::setw(12) << "allocs"
+                << std::setw(12) << "rss"
+                << "  verdict" << '\n';
+        oOut << std::fixed << std::setprecision(1) << std::showpos;
+
+        for (const auto &oCurrent: vCurrent) {
+            const auto pBase = std::ranges::find(vBase, oCurrent.m_sName, &bench_workload_result::m_sName);
+            oOut << std::left << std::setw(26) << oCurrent.m_sName << std::right;
+            if (pBase == vBase.end()) {
+                oOut << "  new workload" << '\n';
+                continue;
+            }
+
+            const double dWall = get_change(pBase->m_dWallTime, oCurrent.m_dWallTime);
+            const double dAllocs = get_change(pBase->m_dAllocations, oCurrent.m_dAllocations);
+            // Unknown memory on either side is not compared
+            const double dRss = pBase->m_nPeakRss == 0 || oCurrent.m_nPeakRss == 0
+                                    ? 0
+                                    : get_change(static_cast<double>(pBase->m_nPeakRss),
+                                                 static_cast<double>(oCurrent.m_nPeakRss));
+            oOut << std::setw(11) << dWall << '%'
+                    << std::setw(11) << dAllocs << '%'
+                    << std::setw(11) << dRss << '%';
+
+            if (oCurrent.m_nStatus != shell_status::SHELL_SUCCESS
+                && pBase->m_nStatus == shell_status::SHELL_SUCCESS) {
+                oOut << "  FAILED";
+                bPassed = false;
+            } else if (dWall > dThreshold || dAllocs > dThreshold || dRss > dThreshold) {
+                oOut << "  REGRESSION";
+                bPassed = false;
+            } else if (dWall < -dThreshold || dAllocs < -dThreshold || dRss < -dThreshold) {
+                oOut << "  improved";
+            } else {
+                oOut << "  ok";
+            }
+            oOut << '\n';
+
+            // Phases whose allocations changed
+            for (std::size_t i = 0; i < SHELL_ALLOC_PHASES; ++i) {
+                const double dPhase = get_change(pBase->m_vPhaseAllocations[i], oCurrent.m_vPhaseAllocations[i]);
+                if (dPhase <= dThreshold && dPhase >= -dThreshold) continue;
+                oOut << "  allocs " << std::left << std::setw(16)
+                        << get_alloc_phase_name(static_cast<shell_alloc_phase>(i)) << std::right
+                        << std::setw(12) << dPhase << '%' << '\n';
+            }
+        }
+
+        for (const auto &oBase: vBase) {
+            if (std::ranges::find(vCurrent, oBase.m_sName, &bench_workload_result::m_sName) == vCurrent.end())
+                oOut << std::left << std::setw(26) << oBase.m_sName << std::right << "  missing" << '\n';
+        }
+
+        oOut.flags(oFlags);
+        oOut.precision(nPrecision);
+        oOut << (bPassed ? "No regression" : "Regressions found")
+                << " (threshold " << dThreshold << "%)" << std::endl;
+        return bPassed;
+    }
+}
@@ -0,0 +1,635 @@
+/**
+ * @file bench_shell.cpp
+ * @brief Implements a series of benchmarks measuring the performance of the shell.
+ *
+ * @date Created on 22/11/25
+ * @author Dante Doménech Martínez
+ *
+ * @copyright GNU General Public License v3.0
+ *
+ * This file is part of BashSpark.
+ * Copyright (C) 2025 Dante Doménech Martínez
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "BashSpark/bench/bench_shell.h"
+
+#include <atomic>
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+#include <utility>
+
+#include <nlohmann/json.hpp>
+
+#include "shell/shell_tools.h"
+#include "BashSpark/bench/bench_alloc.h"
+#include "BashSpark/shell/shell_node_static_visitor.h"
+#include "BashSpark/shell/shell_node_visitor.h"
+#include "BashSpark/shell/shell_parser.h"
+#include "BashSpark/shell/shell_source.h"
+#include "BashSpark/shell/shell_tokenizer.h"
+#include "BashSpark/tools/fakestream.h"
+#include "BashSpark/tools/nullstream.h"
+
+namespace bs::debug {
+    namespace {
+        /// Results of the measured operations, stored so that they are not optimized away
+        std::atomic<std::size_t> g_nSink{0};
+    }
+
+    template<typename F>
+    void bench_shell::measure(const std::string_view sName, const std::size_t nBytes, F &&fOperation) const {
+        if (!this->selected(sName)) return;
+        using clock = std::chrono::steady_clock;
+        std::size_t nSink = 0;
+
+        // Warm up caches and lazily built state
+        for (std::size_t i = 0; i < BATCH_SIZE; ++i)
+            nSink += static_cast<std::size_t>(fOperation());
+
+        std::size_t nOperations = 0;
+        const auto oAllocStart = get_alloc_count();
+        const auto oStart = clock::now();
+        auto oEnd = oStart;
+        do {
+            for (std::size_t i = 0; i < BATCH_SIZE; ++i)
+                nSink += static_cast<std::size_t>(fOperation());
+            nOperations += BATCH_SIZE;
+            oEnd = clock::now();
+        } while (oEnd - oStart < MIN_TIME);
+        const auto oAllocEnd = get_alloc_count();
+
+        // Keep the results alive
+        g_nSink.store(nSink, std::memory_order_relaxed);
+
+        const auto dOperations = static_cast<double>(nOperations);
+        const auto dNanoseconds = std::chrono::duration<double, std::nano>(oEnd - oStart).count();
+        const auto dOpsPerSecond = dOperations * 1e9 / dNanoseconds;
+        const auto dAllocs = static_cast<double>(oAllocEnd.m_nAllocations - oAllocStart.m_nAllocations) / dOperations;
+        const auto dAllocBytes = static_cast<double>(oAllocEnd.m_nBytes - oAllocStart.m_nBytes) / dOperations;
+
+        if (this->m_bJson) {
+            nlohmann::ordered_json oJson;
+            oJson["name"] = sName;
+            oJson["iterations"] = nOperations;
+            oJson["ns_per_op"] = dNanoseconds / dOperations;
+            oJson["ops_per_s"] = dOpsPerSecond;
+            oJson["bytes_per_s"] = nBytes == 0 ? nlohmann::ordered_json() : nlohmann::ordered_json(dOpsPerSecond * static_cast<double>(nBytes));
+            oJson["allocs_per_op"] = dAllocs;
+            oJson["alloc_bytes_per_op"] = dAllocBytes;
+            std::cout << oJson.dump() << std::endl;
+            return;
+        }
+
+        std::cout << sName << ": "
+                << dNanoseconds / dOperations << " ns/op, "
+                << dOpsPerSecond << " op/s, ";
+        if (nBytes != 0) std::cout << dOpsPerSecond * static_cast<double>(nBytes) / 1e6 << " MB/s, ";
+        std::cout << dAllocs << " allocs/op" << std::endl;
+    }
+
+    bool bench_shell::selected(const std::string_view sName) const {
+        return sName.find(this->m_sFilter) != std::string_view::npos;
+    }
+
+    void bench_shell::bench() const {
+        this->bench_startup();
+        this->bench_capture();
+        this->bench_batch();
+        this->bench_async();
+        this->bench_env();
+        this->bench_tokenizer();
+        this->bench_parser();
+        this->bench_expand();
+        this->bench_split();
+        this->bench_var();
+        this->bench_commands();
+        this->bench_dispatch();
+        this->bench_visitor();
+        if (!this->m_bJson) std::cout << "Benchmarks finished" << std::endl;
+    }
+
+    void bench_shell::bench_startup() const {
+        this->measure("startup make_default_shell", 0, [] {
+            return shell::make_default_shell() != nullptr;
+        });
+        this->measure("startup default_static_shell", 0, [] {
+            return std::make_unique<default_static_shell>() != nullptr;
+        });
+        this->measure("startup shared default shell", 0, [] {
+            return std::make_unique<shell>(shell::get_shared_default_shell()) != nullptr;
+        });
+
+        inullstream oStdIn;
+        onullstream oStdOut;
+        this->measure("startup shared default shell with session", 0, [&] {
+            const shell oShell(shell::get_shared_default_shell());
+            const shell_session oSession(&oShell, oStdIn, oStdOut, oStdOut);
+            return oSession.get_shell() != nullptr;
+        });
+    }
+
+    void bench_shell::bench_capture() const {
+        constexpr std::string_view sCommand = "seq 1 1000";
+        const auto pShell = shell::make_default_shell();
+        inullstream oStdIn;
+        onullstream oStdNull;
+
+        this->measure("capture ostringstream", 0, [&] {
+            std::ostringstream oStdOut;
+            std::ostringstream oStdErr;
+            shell_session oSession(pShell.get(), oStdIn, oStdOut, oStdErr);
+            shell::run(sCommand, oSession);
+            return oStdOut.str().size() + oStdErr.str().size();
+        });
+        this->measure("capture run_capture", 0, [&] {
+            shell_session oSession(pShell.get(), oStdIn, oStdNull, oStdNull);
+            const auto oCapture = shell::run_capture(sCommand, oSession);
+            return oCapture.m_sOut.size() + oCapture.m_sErr.size();
+        });
+    }
+
+    void bench_shell::bench_batch() const {
+        if (!this->selected("batch")) return;
+        const auto pShell = shell::make_default_shell();
+        const shell_script oScript = shell::compile("for i in $(seq 1 $1); do setvar v $i; done; echo -n $(getvar v)");
+
+        std::vector<shell_job> vJobs(4096);
+        for (std::size_t i = 0; i < vJobs.size(); ++i) {
+            vJobs[i].m_pScript = &oScript;
+            vJobs[i].m_oArg = shell_arg(std::vector<std::string>{"fcall", std::to_string(1 + i % 64)});
+        }
+
+        for (const std::size_t nThreads: {std::size_t{1}, std::size_t{2}, std::size_t{0}}) {
+            const auto oStats = pShell->run_batch(vJobs, nThreads).m_oStats;
+            // Named by the requested count, the used one is clamped to the cores and could repeat
+            const std::string sThreads = nThreads == 0 ? "all" : std::to_string(nThreads);
+            const std::string sName = "batch " + sThreads + " threads";
+            if (this->m_bJson) {
+                nlohmann::ordered_json oJson;
+                oJson["name"] = sName;
+                oJson["threads"] = oStats.m_nThreads;
+                oJson["iterations"] = oStats.m_nJobs;
+                oJson["jobs_per_s"] = oStats.m_dThroughput;
+                oJson["p50_ns"] = oStats.m_nLatencyP50.count();
+                oJson["p99_ns"] = oStats.m_nLatencyP99.count();
+                oJson["max_ns"] = oStats.m_nLatencyMax.count();
+                std::cout << oJson.dump() << std::endl;
+                continue;
+            }
+            std::cout << sName << " (" << oStats.m_nThreads << " used): "
+                    << oStats.m_dThroughput << " jobs/s, p50 "
+                    << oStats.m_nLatencyP50.count() << " ns, p99 "
+                    << oStats.m_nLatencyP99.count() << " ns, max "
+                    << oStats.m_nLatencyMax.count() << " ns" << std::endl;
+        }
+    }
+
+    void bench_shell::bench_async() const {
+        const auto pShell = shell::make_default_shell();
+        const shell_script oScript = shell::compile("for i from 1 to 100; do setvar v $i; done");
+        inullstream oStdIn;
+        onullstream oStdNull;
+        shell_session oSession(pShell.get(), oStdIn, oStdNull, oStdNull);
+
+        this->measure("async run", 0, [&] {
+            return oScript.run(oSession);
+        });
+        this->measure("async run_async", 0, [&] {
+            return oScript.run_async(oSession).get();
+        });
+        this->measure("async scheduler 1us slice", 0, [&] {
+            shell_scheduler oScheduler(std::chrono::microseconds{1});
+            auto oFuture = oScheduler.submit(oScript, oSession);
+            oScheduler.run();
+            return oFuture.get();
+        });
+    }
+
+    void bench_shell::bench_env() const {
+        const auto pShell = shell::make_default_shell();
+        inullstream oStdIn;
+        onullstream oStdNull;
+
+        shell_env oEnv;
+        for (std::size_t i = 0; i < 500; ++i)
+            oEnv.set_env("VARIABLE_" + std::to_string(i), "value " + std::to_string(i));
+        const auto pBase = shell_traits::make<const shell_env>(oEnv);
+
+        this->measure("env session copy 500", 0, [&] {
+            const shell_session oSession(pShell.get(), oStdIn, oStdNull, oStdNull, oEnv, shell_arg());
+            return oSession.has_env("VARIABLE_42");
+        });
+        this->measure("env session base 500", 0, [&] {
+            const shell_session oSession(pShell.get(), oStdIn, oStdNull, oStdNull, shell_env(pBase), shell_arg());
+            return oSession.has_env("VARIABLE_42");
+        });
+
+        shell_env oOverlay(pBase);
+        oOverlay.set_env("VARIABLE_1", "mine");
+        this->measure("env lookup flat", 0, [&] {
+            return oEnv.get_env("VARIABLE_42").size();
+        });
+        this->measure("env lookup overlay", 0, [&] {
+            return oOverlay.get_env("VARIABLE_42").size();
+        });
+    }
+
+    namespace {
+        /// Short command
+        constexpr std::string_view BENCH_COMMAND = "echo -n hello $USER \"from $HOME\" 'and more' > /dev/null";
+
+        /// Script with loops, quotes and substitutions
+        constexpr std::string_view BENCH_SCRIPT =
+                "function greet {\n"
+                "    echo \"Hello, $1! You are $2 years old.\"\n"
+                "}\n"
+                "for i in $(seq 1 10); do\n"
+                "    if test $i -gt 5; then\n"
+                "        fcall greet \"user $i\" $(math $i * 3)\n"
+                "    else\n"
+                "        echo 'small' $i && setvar last $i || echo failed\n"
+                "    fi\n"
+                "done\n"
+                "while test $(getvar last) -lt 3; do setvar last $(math $(getvar last) + 1); done\n"
+                "echo \"done: $(getvar last)\" | readarray result\n";
+
+        /// Text for the word splitting
+        constexpr std::string_view BENCH_TEXT =
+                "  the quick\tbrown fox\njumps over   the lazy dog  "
+                "lorem ipsum dolor sit amet consectetur adipiscing elit "
+                "sed do eiusmod tempor incididunt ut labore et dolore magna aliqua ";
+    }
+
+    void bench_shell::bench_tokenizer() const {
+        for (const auto &[sName, sInput]: {
+                 std::pair{"tokenizer command", BENCH_COMMAND},
+                 std::pair{"tokenizer script", BENCH_SCRIPT}
+             }) {
+            const auto pSource = shell_source::make(sInput);
+            this->measure(sName, sInput.size(), [&] {
+                ifakestream oStream(pSource->get_text());
+                return shell_tokenizer::tokens(oStream, pSource).size();
+            });
+        }
+    }
+
+    void bench_shell::bench_parser() const {
+        for (const auto &[sName, sInput]: {
+                 std::pair{"parser command", BENCH_COMMAND},
+                 std::pair{"parser script", BENCH_SCRIPT}
+             }) {
+            const auto pSource = shell_source::make(sInput);
+            this->measure(sName, sInput.size(), [&] {
+                return shell_parser::parse(pSource) != nullptr;
+            });
+        }
+    }
+
+    void bench_shell::bench_expand() const {
+        const auto pShell = shell::make_default_shell();
+        inullstream oStdIn;
+        onullstream oStdNull;
+        shell_env oEnv;
+        oEnv.set_env("USER", "bench");
+        oEnv.set_env("HOME", "/home/bench");
+        shell_session oSession(pShell.get(), oStdIn, oStdNull, oStdNull, oEnv,
+                               shell_arg(std::vector<std::string>{"fcall", "first", "second word"}));
+        oSession.set_var("NAME", "a value with several words");
+
+        for (const auto &[sName, sInput]: {
+                 std::pair{"expand words", std::string_view("echo one two three four five six")},
+                 std::pair{"expand variables", std::string_view("echo $USER ${HOME} $NAME $1 $2 $#")},
+                 std::pair{"expand quotes", std::string_view("echo \"$USER at ${HOME}: $NAME\" 'literal $USER' \"$@\"")}
+             }) {
+            const auto pRoot = shell_parser::parse(shell_source::make(sInput));
+            const shell_node_evaluable *pNode = pRoot.get();
+            while (const auto pBlock = dynamic_cast<const shell_node_command_block *>(pNode)) {
+                if (pBlock->get_children().size() != 1) break;
+                pNode = pBlock->get_children().front().get();
+            }
+            const auto pCommand = dynamic_cast<const shell_node_command *>(pNode);
+            if (pCommand == nullptr) throw std::logic_error("bench_expand: input is not a single command");
+
+            std::vector<std::string> vTokens;
+            this->measure(sName, sInput.size(), [&] {
+                vTokens.clear();
+                pCommand->get_command()->expand(vTokens, oSession, true);
+                return vTokens.size();
+            });
+        }
+    }
+
+    void bench_shell::bench_split() const {
+        const std::string sShort(BENCH_TEXT.substr(0, 32));
+        std::string sLong;
+        for (std::size_t i = 0; i < 64; ++i) sLong += BENCH_TEXT;
+
+        std::vector<std::string> vTokens;
+        for (const auto &[sName, sInput]: {
+                 std::pair{"split short", std::string_view(sShort)},
+                 std::pair{"split long", std::string_view(sLong)}
+             }) {
+            this->measure(sName, sInput.size(), [&] {
+                vTokens.clear();
+                split_string(vTokens, sInput);
+                return vTokens.size();
+            });
+        }
+    }
+
+    void bench_shell::bench_var() const {
+        const auto pShell = shell::make_default_shell();
+        inullstream oStdIn;
+        onullstream oStdNull;
+        shell_session oSession(pShell.get(), oStdIn, oStdNull, oStdNull);
+        for (std::size_t i = 0; i < 64; ++i)
+            oSession.set_var("variable_" + std::to_string(i), std::to_string(i * 1000));
+
+        this->measure("var get", 0, [&] {
+            return oSession.get_var("variable_42").size();
+        });
+        this->measure("var get missing", 0, [&] {
+            return oSession.get_var("missing").size();
+        });
+        this->measure("var get_int", 0, [&] {
+            std::int64_t nValue = 0;
+            return oSession.get_var_int("variable_42", nValue) ? nValue : 0;
+        });
+    }
+
+    void bench_shell::bench_commands() const {
+        const auto pShell = shell::make_default_shell();
+        inullstream oStdIn;
+        onullstream oStdNull;
+        shell_session oSession(pShell.get(), oStdIn, oStdNull, oStdNull);
+        oSession.set_var("n", "12");
+
+        const auto run = [&](const std::string_view sName, const std::string &sCommand, const std::vector<std::string> &vArgs) {
+            const command *pCommand = pShell->get_command(sCommand);
+            if (pCommand == nullptr) throw std::logic_error("bench_commands: missing command " + sCommand);
+
+            // Bytes written by one run
+            std::ostringstream oOut;
+            shell_session oCapture(pShell.get(), oStdIn, oOut, oStdNull);
+            oCapture.set_var("n", "12");
+            if (pCommand->run(vArgs, oCapture) != shell_status::SHELL_SUCCESS)
+                throw std::logic_error("bench_commands: failed " + std::string(sName));
+
+            this->measure(sName, oOut.str().size(), [&] {
+                return pCommand->run(vArgs, oSession);
+            });
+        };
+
+        run("command math", "math", {"(", "3", "+", "4", ")", "*", "12", "/", "2", "-", "2", "^", "5"});
+        run("command math sum", "math", {"sum", "(", "x", ",", "1", ",", "1", ",", "100", ",", "x", "*", "x", ")"});
+        run("command test numeric", "test", {"3", "-lt", "12", "-a", "(", "5", "==", "5", "-o", "1", "-gt", "2", ")"});
+        run("command test string", "test", {"hello", "-lt", "world", "&&", "abc", "==", "abc"});
+        run("command seq 100", "seq", {"1", "100"});
+        run("command seq variable", "seq", {"1", "2", "n"});
+    }
+
+    void bench_shell::bench_dispatch() const {
+        const auto pShell = shell::make_default_shell();
+        const default_static_shell oStatic;
+        inullstream oStdIn;
+        onullstream oStdNull;
+        shell_session oSession(pShell.get(), oStdIn, oStdNull, oStdNull);
+        shell_session oStaticSession(&oStatic, oStdIn, oStdNull, oStdNull);
+
+        // A cheap builtin, so that the dispatch weighs
+        const std::string sCommand = "setvar";
+        const std::vector<std::string> vArgs = {"v", "x"};
+        this->measure("dispatch dynamic table", 0, [&] {
+            return pShell->get_command(sCommand)->run(vArgs, oSession);
+        });
+        this->measure("dispatch static table", 0, [&] {
+            shell_status nStatus = shell_status::SHELL_ERROR;
+            static_cast<void>(oStatic.run_builtin(sCommand, vArgs, oStaticSession, nStatus));
+            return nStatus;
+        });
+
+        std::string sScript;
+        for (std::size_t i = 0; i < 32; ++i) sScript += "setvar v x; getvar v; ";
+        const shell_script oScript = shell::compile(sScript);
+        this->measure("dispatch script dynamic table", 0, [&] {
+            return oScript.run(oSession);
+        });
+        this->measure("dispatch script static table", 0, [&] {
+            return oScript.run(oStaticSession);
+        });
+    }
+
+    namespace {
+        /**
+         * @class bench_static_counter
+         * @brief Counts the nodes of a tree through \ref bs::shell_node_static_visitor "shell_node_static_visitor".
+         */
+        class bench_static_counter final : public shell_node_static_visitor<bench_static_counter, std::size_t> {
+            friend shell_node_static_visitor;
+
+        private:
+            /**
+             * @brief Counts a node and its children.
+             * @param oSession The current shell session.
+             * @param pNode The node.
+             * @return The number of nodes.
+             */
+            template<typename node_t>
+            std::size_t visit(shell_session &oSession, const node_t *pNode) {
+                std::size_t nCount = 1;
+                for_each_child(pNode, [&](const auto *pChild) {
+                    nCount += this->visit_node(oSession, pChild);
+                });
+                return nCount;
+            }
+        };
+
+        /**
+         * @class bench_virtual_counter
+         * @brief Counts the nodes of a tree through \ref bs::shell_node_visitor "shell_node_visitor".
+         */
+        class bench_virtual_counter final : public shell_node_visitor<std::size_t> {
+        private:
+            /**
+             * @brief Counts a node and its children.
+             * @param oSession The current shell session.
+             * @param pNode The node.
+             * @return The number of nodes.
+             */
+            template<typename node_t>
+            std::size_t count(shell_session &oSession, const node_t *pNode) {
+                std::size_t nCount = 1;
+                bench_static_counter::for_each_child(pNode, [&](const shell_node *pChild) {
+                    nCount += this->visit_node(oSession, pChild);
+                });
+                return nCount;
+            }
+
+        protected:
+            std::size_t visit(shell_session &oSession, const shell_node_word *pNode) override {
+                return this->count(oSession, pNode);
+            }
+
+            std::size_t visit(shell_session &oSession, const shell_node_unicode *pNode) override {
+                return this->count(oSession, pNode);
+            }
+
+            std::size_t visit(shell_session &oSession, const shell_node_str_simple *pNode) override {
+                return this->count(oSession, pNode);
+            }
+
+            std::size_t visit(shell_session &oSession, const shell_node_str_double *pNode) override {
+                return this->count(oSession, pNode);
+            }
+
+            std::size_t visit(shell_session &oSession, const shell_node_str_back *pNode) override {
+                return this->count(oSession, pNode);
+            }
+
+            std::size_t visit(shell_session &oSession, const shell_node_null_command *pNode) override {
+                return this->count(oSession, pNode);
+            }
+
+            std::size_t visit(shell_session &oSession, const shell_node_command *pNode) override {
+                return this->count(oSession, pNode);
+            }
+
+            std::size_t visit(shell_session &oSession, const shell_node_command_expression *pNode) override {
+                return this->count(oSession, pNode);
+            }
+
+            std::size_t visit(shell_session &oSession, const shell_node_command_block *pNode) override {
+                return this->count(oSession, pNode);
+            }
+
+            std::size_t visit(shell_session &oSession, const shell_node_command_block_subshell *pNode) override {
+                return this->count(oSession, pNode);
+            }
+
+            std::size_t visit(shell_session &oSession, const shell_node_arg *pNode) override {
+                return this->count(oSession, pNode);
+            }
+
+            std::size_t visit(shell_session &oSession, const shell_node_variable *pNode) override {
+                return this->count(oSession, pNode);
+            }
+
+            std::size_t visit(shell_session &oSession, const shell_node_dollar_arg *pNode) override {
+                return this->count(oSession, pNode);
+            }
+
+            std::size_t visit(shell_session &oSession, const shell_node_dollar_variable *pNode) override {
+                return this->count(oSession, pNode);
+            }
+
+            std::size_t visit(shell_session &oSession, const shell_node_dollar_arg_dhop *pNode) override {
+                return this->count(oSession, pNode);
+            }
+
+            std::size_t visit(shell_session &oSession, const shell_node_dollar_variable_dhop *pNode) override {
+                return this->count(oSession, pNode);
+            }
+
+            std::size_t visit(shell_session &oSession, const shell_node_dollar_array *pNode) override {
+                return this->count(oSession, pNode);
+            }
+
+            std::size_t visit(shell_session &oSession, const shell_node_dollar_command *pNode) override {
+                return this->count(oSession, pNode);
+            }
+
+            std::size_t visit(shell_session &oSession, const shell_node_dollar_special *pNode) override {
+                return this->count(oSession, pNode);
+            }
+
+            std::size_t visit(shell_session &oSession, const shell_node_background *pNode) override {
+                return this->count(oSession, pNode);
+            }
+
+            std::size_t visit(shell_session &oSession, const shell_node_pipe *pNode) override {
+                return this->count(oSession, pNode);
+            }
+
+            std::size_t visit(shell_session &oSession, const shell_node_or *pNode) override {
+                return this->count(oSession, pNode);
+            }
+
+            std::size_t visit(shell_session &oSession, const shell_node_and *pNode) override {
+                return this->count(oSession, pNode);
+            }
+
+            std::size_t visit(shell_session &oSession, const shell_node_test *pNode) override {
+                return this->count(oSession, pNode);
+            }
+
+            std::size_t visit(shell_session &oSession, const shell_node_if *pNode) override {
+                return this->count(oSession, pNode);
+            }
+
+            std::size_t visit(shell_session &oSession, const shell_node_break *pNode) override {
+                return this->count(oSession, pNode);
+            }
+
+            std::size_t visit(shell_session &oSession, const shell_node_continue *pNode) override {
+                return this->count(oSession, pNode);
+            }
+
+            std::size_t visit(shell_session &oSession, const shell_node_for *pNode) override {
+                return this->count(oSession, pNode);
+            }
+
+            std::size_t visit(shell_session &oSession, const shell_node_for_count *pNode) override {
+                return this->count(oSession, pNode);
+            }
+
+            std::size_t visit(shell_session &oSession, const shell_node_while *pNode) override {
+                return this->count(oSession, pNode);
+            }
+
+            std::size_t visit(shell_session &oSession, const shell_node_until *pNode) override {
+                return this->count(oSession, pNode);
+            }
+
+            std::size_t visit(shell_session &oSession, const shell_node_function *pNode) override {
+                return this->count(oSession, pNode);
+            }
+        };
+    }
+
+    void bench_shell::bench_visitor() const {
+        const auto pShell = shell::make_default_shell();
+        inullstream oStdIn;
+        onullstream oStdNull;
+        shell_session oSession(pShell.get(), oStdIn, oStdNull, oStdNull);
+
+        std::string sScript;
+        for (std::size_t i = 0; i < 1000; ++i) sScript += BENCH_SCRIPT;
+        const auto oScript = shell::compile(sScript);
+
+        bench_virtual_counter oVirtual;
+        bench_static_counter oStatic;
+        if (oVirtual.visit_node(oSession, oScript.get_root()) != oStatic.visit_node(oSession, oScript.get_root()))
+            throw std::logic_error("bench_visitor: the visitors disagree");
+
+        this->measure("visitor virtual", sScript.size(), [&] {
+            return oVirtual.visit_node(oSession, oScript.get_root());
+        });
+        this->measure("visitor static", sScript.size(), [&] {
+            return oStatic.visit_node(oSession, oScript.get_root());
+        });
+    }
+}
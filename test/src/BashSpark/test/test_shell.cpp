@@ -28,13 +28,39 @@
 
 #include "BashSpark/test/test_shell.h"
 
+#include <algorithm>
+#include <atomic>
 #include <cassert>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <limits>
+#include <map>
+#include <ranges>
+#include <set>
 #include <sstream>
+#include <stdexcept>
 #include <string_view>
+#include <thread>
+#include <tuple>
 
+#include "BashSpark/shell/shell_alloc.h"
+#include "BashSpark/shell/shell_log.h"
+#include "BashSpark/shell/shell_node_static_visitor.h"
 #include "BashSpark/shell/shell_node_visitor_json.h"
+#include "BashSpark/shell/shell_node_visitor_json_writer.h"
+#include "BashSpark/shell/shell_parser.h"
+#include "BashSpark/shell/shell_parser_exception.h"
+#include "BashSpark/shell/shell_profiler.h"
+#include "BashSpark/shell/shell_scheduler.h"
+#include "BashSpark/shell/shell_source.h"
+#include "BashSpark/shell/shell_tracer.h"
 #include "BashSpark/tools/nullstream.h"
 
+#if defined(__unix__) || defined(__APPLE__)
+#include <sys/stat.h>
+#endif
+
 using namespace std::string_view_literals;
 
 namespace bs::debug {
@@ -50,6 +76,228 @@ namespace bs::debug {
                 std::abort();
             }
         }
+
+        /**
+         * @brief User command printing its argument count
+         */
+        class command_argc final : public command {
+        public:
+            /**
+             * @brief Constructs the command
+             */
+            command_argc()
+                : command("argc") {
+            }
+
+        public:
+            /**
+             * @brief Prints the argument count.
+             * @param vArgs Arguments for the command.
+             * @param oSession The shell session context.
+             * @return Status of command execution.
+             */
+            [[nodiscard]] shell_status run(
+                const std::span<const std::string> &vArgs,
+                shell_session &oSession
+            ) const override {
+                oSession.out() << vArgs.size();
+                return shell_status::SHELL_SUCCESS;
+            }
+        };
+
+        /**
+         * @brief User command reporting an allocation of as many bytes as its argument
+         */
+        class command_alloc final : public command {
+        public:
+            /**
+             * @brief Constructs the command
+             */
+            command_alloc()
+                : command("alloc") {
+            }
+
+        public:
+            /**
+             * @brief Reports the allocation.
+             * @param vArgs Bytes allocated.
+             * @param oSession The shell session context.
+             * @return Status of command execution.
+             */
+            [[nodiscard]] shell_status run(
+                const std::span<const std::string> &vArgs,
+                [[maybe_unused]] shell_session &oSession
+            ) const override {
+                shell_alloc_stats::record_allocation(std::stoull(vArgs[0]));
+                return shell_status::SHELL_SUCCESS;
+            }
+        };
+
+        /**
+         * @brief Stream buffer shared by threads, discarding the output and counting it
+         */
+        class shared_countbuffer final : public std::streambuf {
+        public:
+            /**
+             * @brief Gets the number of characters written.
+             * @return Characters written by every thread.
+             */
+            [[nodiscard]] std::size_t count() const noexcept {
+                return this->m_nCount;
+            }
+
+        protected:
+            /**
+             * @brief Writes a character.
+             * @param nChar Character to write.
+             * @return The character.
+             */
+            int_type overflow(const int_type nChar) override {
+                if (!traits_type::eq_int_type(nChar, traits_type::eof())) ++this->m_nCount;
+                return traits_type::not_eof(nChar);
+            }
+
+            /**
+             * @brief Writes a number of characters.
+             * @param s Pointer to the characters.
+             * @param n The number of characters.
+             * @return The number of characters written.
+             */
+            std::streamsize xsputn([[maybe_unused]] const char *s, const std::streamsize n) override {
+                this->m_nCount += static_cast<std::size_t>(n);
+                return n;
+            }
+
+        private:
+            std::atomic<std::size_t> m_nCount{0}; ///< Characters written.
+        };
+
+        /**
+         * @brief User command throwing its first argument
+         */
+        class command_throw final : public command {
+        public:
+            /**
+             * @brief Constructs the command
+             */
+            command_throw()
+                : command("throw") {
+            }
+
+        public:
+            /**
+             * @brief Throws.
+             * @param vArgs Message of the exception.
+             * @param oSession The shell session context.
+             * @return Never returns.
+             */
+            [[nodiscard]] shell_status run(
+                const std::span<const std::string> &vArgs,
+                [[maybe_unused]] shell_session &oSession
+            ) const override {
+                throw std::runtime_error(vArgs.empty() ? "throw" : vArgs[0]);
+            }
+        };
+
+        /**
+         * @brief User command waiting some milliseconds, then printing its text
+         */
+        class command_wait final : public command {
+        public:
+            /**
+             * @brief Constructs the command
+             */
+            command_wait()
+                : command("wait") {
+            }
+
+        public:
+            /**
+             * @brief Blocks the thread while waiting.
+             * @param vArgs Milliseconds and text.
+             * @param oSession The shell session context.
+             * @return Status of command execution.
+             */
+            [[nodiscard]] shell_status run(
+                const std::span<const std::string> &vArgs,
+                shell_session &oSession
+            ) const override {
+                std::this_thread::sleep_for(std::chrono::milliseconds(std::stoll(vArgs[0])));
+                oSession.out() << vArgs[1];
+                return shell_status::SHELL_SUCCESS;
+            }
+
+            /**
+             * @brief Waits on another thread, giving up the thread of the task.
+             * @param vArgs Milliseconds and text.
+             * @param oSession The shell session context.
+             * @return Task returning the status of command execution.
+             */
+            [[nodiscard]] shell_task run_async(
+                const std::span<const std::string> vArgs,
+                shell_session &oSession
+            ) const override {
+                shell_event oEvent;
+                const std::chrono::milliseconds nWait(std::stoll(vArgs[0]));
+                std::jthread oThread([&oEvent, nWait] {
+                    std::this_thread::sleep_for(nWait);
+                    oEvent.set();
+                });
+                co_await oEvent;
+                oSession.out() << vArgs[1];
+                co_return shell_status::SHELL_SUCCESS;
+            }
+        };
+
+        /**
+         * @brief User command awaiting an event shared by all its calls
+         */
+        class command_latch final : public command {
+        public:
+            /**
+             * @brief Constructs the command
+             * @param pEvent The shared event.
+             */
+            explicit command_latch(shell_event *pEvent)
+                : command("latch"), m_pEvent(pEvent) {
+            }
+
+        public:
+            /**
+             * @brief Blocks the thread until the event is set.
+             * @param vArgs Text.
+             * @param oSession The shell session context.
+             * @return Status of command execution.
+             */
+            [[nodiscard]] shell_status run(
+                const std::span<const std::string> &vArgs,
+                shell_session &oSession
+            ) const override {
+                this->m_pEvent->wait();
+                oSession.out() << vArgs[0];
+                return shell_status::SHELL_SUCCESS;
+            }
+
+            /**
+             * @brief Awaits the event, giving up the thread of the task.
+             * @param vArgs Text.
+             * @param oSession The shell session context.
+             * @return Task returning the status of command execution.
+             */
+            [[nodiscard]] shell_task run_async(
+                const std::span<const std::string> vArgs,
+                shell_session &oSession
+            ) const override {
+                shell_event &oEvent = *this->m_pEvent;
+                co_await oEvent;
+                oSession.out() << vArgs[0];
+                co_return shell_status::SHELL_SUCCESS;
+            }
+
+        private:
+            /// The shared event
+            shell_event *m_pEvent;
+        };
     }
 
     test_shell::test_shell()
@@ -68,6 +316,26 @@ namespace bs::debug {
         this->test_math();
         this->test_test();
         this->test_script();
+        this->test_stream();
+        this->test_array();
+        this->test_static_shell();
+        this->test_shared_shell();
+        this->test_file();
+        this->test_capture();
+        this->test_records();
+        this->test_batch();
+        this->test_async();
+        this->test_async_command();
+        this->test_env_base();
+        this->test_profiler();
+        this->test_command_metrics();
+        this->test_alloc_stats();
+        this->test_tracer();
+        this->test_log();
+        this->test_parser_exception();
+        this->test_json_writer();
+        this->test_static_visitor();
+        this->test_local_ptr();
         std::cout << "Tests finished" << std::endl;
     }
 
@@ -166,6 +434,8 @@ namespace bs::debug {
             {"seq 5 -2 1", "5 3 1"},
             {"seq 5 1", "5 4 3 2 1"},
             {"echo -n $(seq 1 5)", "1 2 3 4 5"},
+            {"setvar n 3; seq 1 n", "1 2 3"},
+            {"setvar n 3; seq n -1 1", "3 2 1"},
         };
 
         inullstream oStdIn;
@@ -178,6 +448,27 @@ namespace bs::debug {
             const std::string sName = "Check command " + sCommand + " " + oStdOut.str();
             custom_assert(sOutput == oStdOut.view(), sName);
         }
+
+        // Sequences ending at the limits of 64 bit integers do not overflow
+        constexpr auto nMax = std::numeric_limits<std::int64_t>::max();
+        constexpr auto nMin = std::numeric_limits<std::int64_t>::min();
+        const std::vector<std::pair<std::string, std::string> > vLimits = {
+            {"seq near top", std::to_string(nMax - 1) + " " + std::to_string(nMax)},
+            {"seq near 2 top", std::to_string(nMax - 1)},
+            {"seq low -1 bottom", std::to_string(nMin + 1) + " " + std::to_string(nMin)},
+            {"seq near top | readarray a; echo -n ${a[@]}", std::to_string(nMax - 1) + " " + std::to_string(nMax)},
+        };
+        for (const auto &[sCommand, sOutput]: vLimits) {
+            std::ostringstream oStdOut;
+            shell_session oSession(m_pShell.get(), oStdIn, oStdOut, std::cout);
+            oSession.set_var_int("top", nMax);
+            oSession.set_var_int("near", nMax - 1);
+            oSession.set_var_int("bottom", nMin);
+            oSession.set_var_int("low", nMin + 1);
+            shell::run(sCommand, oSession);
+            const std::string sName = "Check command " + sCommand + " " + oStdOut.str();
+            custom_assert(sOutput == oStdOut.view(), sName);
+        }
     }
 
     void test_shell::test_setenv() const {
@@ -228,6 +519,30 @@ namespace bs::debug {
         // Wrong getvar
         shell_status res4 = shell::run("getvar 1234"sv, oSession);
         assert(res4 == shell_status::SHELL_CMD_ERROR_GETVAR_VARIABLE_NAME_INVALID);
+
+        // Normal appendvar
+        shell_status res5 = shell::run("appendvar variable ' more'; appendvar created value"sv, oSession);
+        assert(res5 == shell_status::SHELL_SUCCESS);
+        assert(oSession.get_var("variable")=="value more");
+        assert(oSession.get_var("created")=="value");
+
+        // Wrong appendvar
+        shell_status res6 = shell::run("appendvar 1234 value"sv, oSession);
+        assert(res6 == shell_status::SHELL_CMD_ERROR_APPENDVAR_VARIABLE_NAME_INVALID);
+        shell_status res7 = shell::run("appendvar variable"sv, oSession);
+        assert(res7 == shell_status::SHELL_CMD_ERROR_APPENDVAR_PARAM_NUMBER);
+
+        // Linear accumulation
+        shell::run("for num in $(seq 1 2000); do appendvar accum \"$num \"; done"sv, oSession);
+        assert(oSession.get_var("accum").size()==8893);
+
+        // All variables, as text and with their cached integer form
+        oSession.var().set_var_int("count", 42);
+        const auto mVariables = oSession.var().get_var();
+        assert(mVariables.size()==oSession.var().get_var_size());
+        assert(mVariables.at("count")=="42" && mVariables.at("created")=="value");
+        std::int64_t nCount = 0;
+        assert(oSession.var().get_var_values().at("count").get_int(nCount) && nCount==42);
     }
 
     void test_shell::test_oper() const {
@@ -267,6 +582,21 @@ namespace bs::debug {
             {"for num in $(seq 1 5);do echo -n $num; break; echo -n $num; done", "1"},
             {"for   num   in   $(seq 1 5);   do echo -n $num;   continue   ; echo -n $num;   done", "12345"},
             {"for   num   in   $(seq 1 5);   do echo -n $num;   break      ; echo -n $num;   done", "1"},
+            {"for num from 1 to 5;do echo -n $num; done", "12345"},
+            {"for num from 5 to 1;do echo -n $num; done", "54321"},
+            {"for   num   from   0   to   10   step   5   ;  do echo -n $num; done", "0510"},
+            {"for num from 10 to 0 step -3;do echo -n $num; done", "10741"},
+            {"for num from 7 to 7 step 0;do echo -n $num; done", "7"},
+            {"for num from 1 to 5;do echo -n $num; break; echo -n $num; done", "1"},
+            {"for num from $(math 0 + 1) to 3;do echo -n $num; continue; echo -n x; done", "123"},
+            {"setvar n 3; for num from 1 to $n;do echo -n $num; done", "123"},
+            {"for num from 1 to 3;do math num * 2; done", "246"},
+            {"for num from 1 to 5 step -1;do echo -n $num; done", ""},
+            {"for num from a to 5;do echo -n $num; done", ""},
+            {"for num from - to 3;do echo -n $num; done", ""},
+            {"for num from 1 to +;do echo -n $num; done", ""},
+            {"for num from 1 to 99999999999999999999;do echo -n $num; done", ""},
+            {"for from in 1 2;do echo -n $from; done", "12"},
             {"if [-z \"\"]; then echo -n true; fi", "true"},
             {"if [ ( -z \"\" ) && ( -n \"d\" ) ]; then echo -n true; fi", "true"},
             {"if [ ( -z \"\" ) ] && [ ( -n \"d\" ) ]; then echo -n true; fi", "true"},
@@ -315,6 +645,8 @@ namespace bs::debug {
             {"math factorial \\( 5 \\)", "120"},
             {"math product \\( x , 1 , 1 , 5 , x \\)", "120"},
             {"math sum \\( x , 1 , 1 , 5 , x \\)", "15"},
+            {"setvar i 41; math i + 1", "42"},
+            {"setvar i 41; math - i", "-41"},
             {"math sign \\( - 42 \\) ; math sign \\( 0 \\) ; math sign \\( + 42 \\)", "-101"},
             {"math abs \\( - 42 \\) ; math abs \\( + 42 \\)", "4242"},
             {"math sum \\( x , 1 , 1 , 5 , sum \\( x , 1 , 1 , 3 , x \\) \\)", "30"},
@@ -413,6 +745,9 @@ namespace bs::debug {
             {"test 6 -ge 7", false},
             {"test 7 -ge 7", true},
             {"test 8 -ge 7", true},
+            {"test -2 -lt 1", true},
+            {"test 1 -lt -2", false},
+            {"test 8 -ge 7 -a 7 -ge 7", true},
             {"test 7 >= 7", true},
             {"test 6 >= 7", false},
             {"test 8 >= 7", true},
@@ -514,4 +849,1263 @@ namespace bs::debug {
             custom_assert(sOutput == oStdOut.view(), sName);
         }
     }
+
+    void test_shell::test_stream() const {
+        // Streaming is disabled by the single-threaded policy, infinite producers would never end
+        if constexpr (!shell_traits::THREAD_SAFE) return;
+
+        const std::vector<std::pair<std::string, std::string> > vTests = {
+            {"for num in $(seq 1 5);do echo -n $num; done", "12345"},
+            {"for num in `seq 1 5`;do echo -n $num; done", "12345"},
+            {"for num in $(echo '1 2\n3\t4 ');do echo -n $num; done", "1234"},
+            {"for num in $(seq 1 5);do echo -n $num; continue; echo -n $num; done", "12345"},
+            {"for num in $(seq 1 100000);do echo -n $num; break; done", "1"},
+            {"for num in $(while [ -z \"\" ]; do echo y; done);do echo -n $num; break; done", "y"},
+            {"for num in $(seq 1 1000);do setvar last $num; done; echo -n $last", "1000"},
+            {"for num in $(seq 1 3);do for sub in $(seq 1 2);do echo -n $num; echo -n $sub; done; done", "111221223132"},
+            {"for num in $();do echo -n $num; done", ""},
+        };
+
+        const auto pShell = shell::make_default_shell();
+        pShell->set_stream_substitution(true);
+        pShell->set_command<command_throw>();
+
+        inullstream oStdIn;
+        onullstream oStdErr;
+
+        for (const auto &[sCommand, sOutput]: vTests) {
+            std::ostringstream oStdOut;
+            shell_session oSession(pShell.get(), oStdIn, oStdOut, oStdErr);
+            shell::run(sCommand, oSession);
+            const std::string sName = "Check command " + sCommand + " " + oStdOut.str();
+            custom_assert(sOutput == oStdOut.view(), sName);
+        }
+
+        // Coroutines capture the substitution instead, they must not block their scheduler
+        {
+            std::ostringstream oStdOut;
+            shell_session oSession(pShell.get(), oStdIn, oStdOut, oStdErr);
+            const shell_script oScript = shell::compile("for num in $(seq 1 5);do echo -n $num; break; done");
+            custom_assert(oScript.run_async(oSession).get() == shell_status::SHELL_SUCCESS, "Check stream async status");
+            custom_assert(oStdOut.view() == "1", "Check stream async " + oStdOut.str());
+        }
+
+        // Leaving the loop early keeps the error output and the exception of the producer
+        {
+            std::ostringstream oStdOut;
+            std::ostringstream oStdErrBreak;
+            shell_session oSession(pShell.get(), oStdIn, oStdOut, oStdErrBreak);
+            shell::run("for num in $(echo a; getvar 1234; seq 1 100000);do echo -n $num; break; done"sv, oSession);
+            custom_assert(oStdOut.view() == "a", "Check stream break output " + oStdOut.str());
+            custom_assert(!oStdErrBreak.view().empty(), "Check stream break error output");
+
+            std::string sError;
+            try {
+                shell::run("for num in $(echo a; throw boom);do echo -n $num; break; done"sv, oSession);
+            } catch (const std::runtime_error &oError) {
+                sError = oError.what();
+            }
+            custom_assert(sError == "boom", "Check stream break exception " + sError);
+        }
+    }
+
+    void test_shell::test_array() const {
+        const std::vector<std::pair<std::string, std::string> > vTests = {
+            {"setarray a x y z; echo -n ${a[1]}", "y"},
+            {"setarray a x y z; echo -n ${a[-1]}", "z"},
+            {"setarray a x y z; echo -n ${a[3]}", ""},
+            {"setarray a x y z; echo -n ${#a[@]}", "3"},
+            {"setarray a x y z; echo -n ${a[@]}", "x y z"},
+            {"setarray a x y z; echo -n ${!a[@]}", "0 1 2"},
+            {"setarray a x y z; setvar i 2; echo -n ${a[$i]}", "z"},
+            {"setarray a x y z; setvar i 1; echo -n ${a[-$i]}", "z"},
+            {"setarray a 'x 1' y; for v in ${a[@]}; do echo -n \"[$v]\"; done", "[x][1][y]"},
+            {"setarray a 'x 1' y; for v in ${a[0]}; do echo -n \"[$v]\"; done", "[x][1]"},
+            {"setarray a 'x 1' y; for v in \"${a[@]}\"; do echo -n \"[$v]\"; done", "[x 1][y]"},
+            {"setarray a 'x 1' y; for v in \"${a[0]}\"; do echo -n \"[$v]\"; done", "[x 1]"},
+            {"setarray a 'x 1' y; for v in \"<${a[@]}>\"; do echo -n \"[$v]\"; done", "[<x 1][y>]"},
+            {"setarray a; for v in \"${a[@]}\"; do echo -n \"[$v]\"; done", ""},
+            {"setmap m b 'x 2' a 1; for v in \"${m[@]}\"; do echo -n \"[$v]\"; done", "[1][x 2]"},
+            {"setarray a x y; echo -n \"<${a[@]}>\"", "<x y>"},
+            {"setarray a; echo -n ${#a[@]}", "0"},
+            {"echo -n \"x${a[0]}y${#a[@]}\"", "xy0"},
+            {"setarray a x y; setitem a 2 z; setitem a 0 w; echo -n ${a[@]}", "w y z"},
+            {"setitem a 0 x; setitem a 1 y; echo -n ${a[@]}", "x y"},
+            {"setitem a 5 z; echo -n ${#a[@]}", "0"},
+            {"setmap m k1 v1 k2 v2; echo -n ${m[k2]}", "v2"},
+            {"setmap m b 2 a 1; echo -n ${!m[@]} ${m[@]}", "a b 1 2"},
+            {"setmap m; setitem m key val; echo -n ${m[key]} ${#m[@]}", "val 1"},
+            {"setvar a scalar; setarray a x; echo -n $a ${a[0]}", "scalar x"},
+            {"echo -n ${#a}", ""},
+            {"echo -n ${a[0}", ""},
+            {"echo -n ${!a[0]}", ""},
+            {"setarray a; ${a[@]}", ""},
+            {"setarray a; ${a[@]} && echo -n ok", "ok"},
+            {"$e && echo -n ok", "ok"},
+        };
+
+        inullstream oStdIn;
+        onullstream oStdErr;
+
+        for (const auto &[sCommand, sOutput]: vTests) {
+            std::ostringstream oStdOut;
+            shell_session oSession(m_pShell.get(), oStdIn, oStdOut, oStdErr);
+            shell::run(sCommand, oSession);
+            const std::string sName = "Check command " + sCommand + " " + oStdOut.str();
+            custom_assert(sOutput == oStdOut.view(), sName);
+        }
+    }
+
+    void test_shell::test_static_shell() const {
+        const std::vector<std::pair<std::string, std::string> > vTests = {
+            {"echo -n a b", "a b"},
+            {"setvar x 3; math x + 1", "4"},
+            {"seq 1 3", "1 2 3"},
+            {"[ 1 -lt 2 ] && echo -n yes", "yes"},
+            {"argc a b c", "3"},
+            {"unknown || echo -n no", "no"},
+        };
+
+        default_static_shell oShell;
+        oShell.set_command<command_argc>();
+        oShell.set_stop_on_command_not_found(false);
+
+        custom_assert(oShell.get_command("echo") == &oShell.get_builtin<command_echo>(), "Check builtin echo");
+        custom_assert(oShell.get_command("fcall") == &oShell.get_builtin<command_fcall>(), "Check builtin fcall");
+        custom_assert(oShell.get_builtin("argc") == nullptr, "Check builtin argc");
+        custom_assert(oShell.get_command("argc") != nullptr, "Check user command argc");
+        custom_assert(oShell.get_command("echoo") == nullptr, "Check command echoo");
+
+        // Builtins are found through the base class and from a shell built on top
+        const auto pStatic = std::make_shared<const default_static_shell>();
+        const shell &oBase = *pStatic;
+        custom_assert(oBase.get_command("seq") == &pStatic->get_builtin<command_seq>(), "Check builtin seq from shell");
+        const shell oOverlay(pStatic);
+        custom_assert(oOverlay.get_command("seq") == &pStatic->get_builtin<command_seq>(), "Check builtin seq from base");
+
+        // Builtins can not be replaced nor removed
+        bool bThrown = false;
+        try {
+            oShell.set_command<command_echo>();
+        } catch (const std::invalid_argument &) {
+            bThrown = true;
+        }
+        custom_assert(bThrown, "Check replace builtin echo");
+        custom_assert(oShell.remove_command("echo") == nullptr, "Check remove builtin echo");
+        oShell.erase_command("echo");
+        custom_assert(oShell.get_command("echo") == &oShell.get_builtin<command_echo>(), "Check builtin echo kept");
+
+        inullstream oStdIn;
+        onullstream oStdErr;
+
+        // Builtins run without a lookup, user commands are not builtins
+        {
+            std::ostringstream oStdOut;
+            shell_session oSession(&oShell, oStdIn, oStdOut, oStdErr);
+            const std::vector<std::string> vArgs = {"-n", "a"};
+            shell_status nStatus = shell_status::SHELL_ERROR;
+            custom_assert(oShell.run_builtin("echo", vArgs, oSession, nStatus)
+                          && nStatus == shell_status::SHELL_SUCCESS && oStdOut.view() == "a", "Check run builtin echo");
+            custom_assert(!oShell.run_builtin("argc", vArgs, oSession, nStatus), "Check run builtin argc");
+            custom_assert(!oOverlay.run_builtin("echo", vArgs, oSession, nStatus), "Check run builtin from base");
+        }
+
+        for (const auto &[sCommand, sOutput]: vTests) {
+            std::ostringstream oStdOut;
+            shell_session oSession(&oShell, oStdIn, oStdOut, oStdErr);
+            shell::run(sCommand, oSession);
+            const std::string sName = "Check command " + sCommand + " " + oStdOut.str();
+            custom_assert(sOutput == oStdOut.view(), sName);
+        }
+    }
+
+    void test_shell::test_shared_shell() const {
+        const auto pBase = shell::get_shared_default_shell();
+        custom_assert(pBase == shell::get_shared_default_shell(), "Check shared default shell");
+
+        shell oShell(pBase);
+        oShell.set_command<command_argc>();
+        custom_assert(oShell.get_command("echo") == pBase->get_command("echo"), "Check base command echo");
+        custom_assert(oShell.get_command("argc") != nullptr, "Check user command argc");
+        custom_assert(pBase->get_command("argc") == nullptr, "Check base command argc");
+
+        // Null base shell
+        bool bThrown = false;
+        try {
+            shell oNullBase(std::shared_ptr<const shell>{});
+        } catch (const std::invalid_argument &) {
+            bThrown = true;
+        }
+        custom_assert(bThrown, "Check null base shell");
+
+        // Hide base commands
+        custom_assert(oShell.remove_command("seq") == nullptr, "Check remove base command seq");
+        custom_assert(oShell.get_command("seq") == nullptr, "Check hidden command seq");
+        oShell.erase_command("math");
+        custom_assert(oShell.get_command("math") == nullptr, "Check hidden command math");
+        custom_assert(pBase->get_command("seq") != nullptr, "Check base command seq");
+
+        // Override base commands
+        oShell.set_command<command_echo>();
+        custom_assert(oShell.get_command("echo") != pBase->get_command("echo"), "Check override command echo");
+        custom_assert(oShell.remove_command("echo") != nullptr, "Check remove override command echo");
+        custom_assert(oShell.get_command("echo") == nullptr, "Check removed command echo");
+
+        const std::vector<std::pair<std::string, std::string> > vTests = {
+            {"setvar x 3; getvar x", "3"},
+            {"argc a b", "2"},
+            {"seq 1 3", ""},
+            {"echo -n a", ""},
+        };
+
+        inullstream oStdIn;
+        onullstream oStdErr;
+
+        for (const auto &[sCommand, sOutput]: vTests) {
+            std::ostringstream oStdOut;
+            shell_session oSession(&oShell, oStdIn, oStdOut, oStdErr);
+            shell::run(sCommand, oSession);
+            const std::string sName = "Check command " + sCommand + " " + oStdOut.str();
+            custom_assert(sOutput == oStdOut.view(), sName);
+        }
+    }
+
+    void test_shell::test_file() const {
+        const std::vector<std::pair<std::string, std::string> > vTests = {
+            {"", ""},
+            {"echo -n hello", "hello"},
+            {"for i from 1 to 3; do\n  echo -n $i\ndone\n", "123"},
+            {"setvar x 2\nmath x + 1", "3"},
+        };
+
+        const auto oPath = std::filesystem::temp_directory_path() / "bashspark_test_file.sh";
+        inullstream oStdIn;
+        onullstream oStdErr;
+
+        for (const auto &[sCommand, sOutput]: vTests) {
+            std::ofstream(oPath, std::ios::binary) << sCommand;
+
+            // Run file
+            std::ostringstream oStdOut;
+            shell_session oSession(m_pShell.get(), oStdIn, oStdOut, oStdErr);
+            shell::run_file(oPath, oSession);
+            custom_assert(sOutput == oStdOut.view(), "Check file " + sCommand + " " + oStdOut.str());
+
+            // Compile file and run twice
+            const auto oScript = shell::compile_file(oPath);
+            std::ostringstream oStdOutCompiled;
+            shell_session oSessionCompiled(m_pShell.get(), oStdIn, oStdOutCompiled, oStdErr);
+            oScript.run(oSessionCompiled);
+            oScript.run(oSessionCompiled);
+            custom_assert(sOutput + sOutput == oStdOutCompiled.view(),
+                          "Check compiled file " + sCommand + " " + oStdOutCompiled.str());
+        }
+
+        // Syntax errors
+        std::ofstream(oPath, std::ios::binary) << "echo \"";
+        bool bThrown = false;
+        try {
+            static_cast<void>(shell::compile_file(oPath));
+        } catch (const shell_parser_exception &) {
+            bThrown = true;
+        }
+        custom_assert(bThrown, "Check compiled file syntax error");
+        std::filesystem::remove(oPath);
+
+#if defined(__unix__) || defined(__APPLE__)
+        // Pipes report an empty size, they are read instead of mapped
+        const auto oFifo = std::filesystem::temp_directory_path() / "bashspark_test_fifo.sh";
+        std::filesystem::remove(oFifo);
+        custom_assert(::mkfifo(oFifo.c_str(), 0600) == 0, "Check pipe creation");
+        {
+            std::jthread oWriter([&oFifo] {
+                std::ofstream(oFifo, std::ios::binary) << "echo -n piped; seq 1 3";
+            });
+            std::ostringstream oStdOut;
+            shell_session oSession(m_pShell.get(), oStdIn, oStdOut, oStdErr);
+            const auto nStatus = shell::run_file(oFifo, oSession);
+            custom_assert(nStatus == shell_status::SHELL_SUCCESS, "Check piped file status");
+            custom_assert(oStdOut.view() == "piped1 2 3", "Check piped file " + oStdOut.str());
+        }
+        std::filesystem::remove(oFifo);
+#endif
+
+        // Missing file
+        std::ostringstream oStdOut;
+        std::ostringstream oStdErrMissing;
+        shell_session oSession(m_pShell.get(), oStdIn, oStdOut, oStdErrMissing);
+        const auto nStatus = shell::run_file(oPath, oSession);
+        custom_assert(nStatus == shell_status::SHELL_ERROR_FILE_NOT_READABLE, "Check missing file status");
+        custom_assert(!oStdErrMissing.view().empty(), "Check missing file message");
+    }
+
+    void test_shell::test_capture() const {
+        const std::vector<std::pair<std::string, std::string> > vTests = {
+            {"", ""},
+            {"echo hello", "hello\n"},
+            {"for i from 1 to 3; do echo -n $i; done", "123"},
+            {"echo -n a | echo -n b", "b"},
+        };
+
+        inullstream oStdIn;
+        onullstream oStdOut;
+        onullstream oStdErr;
+
+        for (const auto &[sCommand, sOutput]: vTests) {
+            shell_session oSession(m_pShell.get(), oStdIn, oStdOut, oStdErr);
+            const auto oCapture = shell::run_capture(sCommand, oSession);
+            custom_assert(sOutput == oCapture.m_sOut, "Check capture " + sCommand + " " + oCapture.m_sOut);
+            custom_assert(oCapture.m_sErr.empty(), "Check capture error " + sCommand + " " + oCapture.m_sErr);
+        }
+
+        // Errors, status and session state
+        shell_session oSession(m_pShell.get(), oStdIn, oStdOut, oStdErr);
+        auto oCapture = shell::run_capture("setvar x 5; unknown_command", oSession);
+        custom_assert(oCapture.m_nStatus == shell_status::SHELL_ERROR_COMMAND_NOT_FOUND, "Check capture status");
+        custom_assert(oSession.get_last_command_result() == oCapture.m_nStatus, "Check capture last status");
+        custom_assert(!oCapture.m_sErr.empty() && oCapture.m_sOut.empty(), "Check capture error output");
+        custom_assert(oSession.get_var("x") == "5", "Check capture variables");
+
+        // Big output
+        oCapture = shell::run_capture("seq 1 20000", oSession);
+        std::ostringstream oExpected;
+        shell_session oSessionExpected(m_pShell.get(), oStdIn, oExpected, oStdErr);
+        shell::run("seq 1 20000"sv, oSessionExpected);
+        custom_assert(oExpected.view() == oCapture.m_sOut, "Check capture big output");
+
+        // Parsed script
+        const auto oScript = shell::compile("echo -n $x");
+        oCapture = shell::run_capture(oScript, oSession);
+        custom_assert(oCapture.m_sOut == "5", "Check capture script " + oCapture.m_sOut);
+    }
+
+    void test_shell::test_records() const {
+        const std::vector<std::pair<std::string, std::string> > vTests = {
+            {"seq 1 3 | readarray a; echo -n ${#a[@]} ${a[2]}", "3 3"},
+            {"seq 3 -1 1 | readarray a; echo -n ${a[@]}", "3 2 1"},
+            {"echo ' 1  2 ' | readarray a; echo -n ${#a[@]}", "2"},
+            {"{ seq 1 2; echo -n x; } | readarray a; echo -n ${a[@]}", "1 2x"},
+            {"{ echo -n x; seq 1 2; } | readarray a; echo -n ${a[@]}", "x1 2"},
+            {"{ seq 1 2; seq 3 4; } | readarray a; echo -n ${a[@]}", "1 23 4"},
+            {"seq 1 3 | ( readarray a; echo -n ${#a[@]} )", "3"},
+            {"seq 1 3 | echo -n y", "y"},
+            {"seq 1 3 | seq 1 2 | readarray a; echo -n ${a[@]}", "1 2"},
+            {"readarray a; echo -n ${#a[@]}", "0"},
+            {"readarray", ""},
+            {"readarray 1a", ""},
+        };
+
+        inullstream oStdIn;
+        onullstream oStdErr;
+
+        for (const auto &[sCommand, sOutput]: vTests) {
+            std::ostringstream oStdOut;
+            shell_session oSession(m_pShell.get(), oStdIn, oStdOut, oStdErr);
+            shell::run(sCommand, oSession);
+            const std::string sName = "Check command " + sCommand + " " + oStdOut.str();
+            custom_assert(sOutput == oStdOut.view(), sName);
+        }
+    }
+
+    void test_shell::test_batch() const {
+        const shell_script oScript = shell::compile("setvar v $1; echo -n $(getenv name) $(getvar v)");
+
+        // Same script, different env and args
+        std::vector<shell_job> vJobs;
+        for (std::size_t i = 0; i < 64; ++i) {
+            shell_job oJob;
+            oJob.m_pScript = &oScript;
+            oJob.m_oEnv.set_env("name", "job" + std::to_string(i));
+            oJob.m_oArg = shell_arg(std::vector<std::string>{"fcall", std::to_string(i * 2)});
+            vJobs.push_back(std::move(oJob));
+        }
+
+        // Commands and input
+        shell_job oCommand;
+        oCommand.m_sCommand = "readarray a; echo -n ${#a[@]}";
+        oCommand.m_sIn = "x y z";
+        vJobs.push_back(std::move(oCommand));
+        shell_job oError;
+        oError.m_sCommand = "echo 'x";
+        vJobs.push_back(std::move(oError));
+
+        const auto oBatch = m_pShell->run_batch(vJobs, 4);
+        custom_assert(oBatch.m_vResults.size() == vJobs.size(), "Check batch size");
+        custom_assert(oBatch.m_oStats.m_nJobs == vJobs.size(), "Check batch stats");
+        custom_assert(oBatch.m_oStats.m_nLatencyP50 <= oBatch.m_oStats.m_nLatencyP99, "Check batch percentiles");
+        custom_assert(oBatch.m_oStats.m_nLatencyP99 <= oBatch.m_oStats.m_nLatencyMax, "Check batch percentiles");
+        for (std::size_t i = 0; i < 64; ++i) {
+            const auto &oResult = oBatch.m_vResults[i];
+            const std::string sExpected = "job" + std::to_string(i) + " " + std::to_string(i * 2);
+            custom_assert(oResult.m_nStatus == shell_status::SHELL_SUCCESS, "Check batch status " + sExpected);
+            custom_assert(oResult.m_sOut == sExpected, "Check batch job " + sExpected + " " + oResult.m_sOut);
+        }
+        custom_assert(oBatch.m_vResults[64].m_sOut == "3", "Check batch input " + oBatch.m_vResults[64].m_sOut);
+        custom_assert(oBatch.m_vResults[65].m_nStatus == shell_status::SHELL_ERROR_SYNTAX_ERROR_UNCLOSED_SIMPLE_QUOTES,
+                      "Check batch syntax error");
+        custom_assert(!oBatch.m_vResults[65].m_sErr.empty(), "Check batch syntax error output");
+
+        // A throwing job fails alone
+        shell oShell(shell::get_shared_default_shell());
+        oShell.set_command<command_throw>();
+        std::vector<shell_job> vThrowJobs(16);
+        for (auto &oJob: vThrowJobs) oJob.m_sCommand = "echo -n ok";
+        vThrowJobs[5].m_sCommand = "echo -n partial; throw boom; echo -n never";
+        const auto oThrowBatch = oShell.run_batch(vThrowJobs, 4);
+        custom_assert(oThrowBatch.m_vResults.size() == vThrowJobs.size(), "Check batch throw size");
+        for (std::size_t i = 0; i < vThrowJobs.size(); ++i) {
+            const auto &oResult = oThrowBatch.m_vResults[i];
+            if (i == 5) {
+                custom_assert(oResult.m_nStatus == shell_status::SHELL_ERROR, "Check batch throw status");
+                custom_assert(oResult.m_sOut == "partial", "Check batch throw output " + oResult.m_sOut);
+                custom_assert(oResult.m_sErr == "boom\n", "Check batch throw message " + oResult.m_sErr);
+            } else {
+                custom_assert(oResult.m_nStatus == shell_status::SHELL_SUCCESS && oResult.m_sOut == "ok",
+                              "Check batch throw other job " + std::to_string(i));
+            }
+        }
+
+        // Empty batch
+        custom_assert(m_pShell->run_batch({}).m_vResults.empty(), "Check empty batch");
+    }
+
+    void test_shell::test_async() const {
+        const std::vector<std::string_view> vTests = {
+            "echo -n a; echo -n b",
+            "echo -n a && echo -n b || echo -n c",
+            "test 1 -eq 2 && echo -n a || echo -n b",
+            "if [ 1 -eq 1 ]; then echo -n a; else echo -n b; fi",
+            "for i in 1 2 3; do echo -n $i; done",
+            "for i in $(seq 1 5); do echo -n $i; break; echo -n $i; done",
+            "for i from 1 to 5; do echo -n $i; continue; echo -n x; done",
+            "for i from 1 to 3; do for j from 1 to 2; do echo -n $i$j; done; done",
+            "setvar i 0; while [ $(getvar i) -lt 3 ]; do setvar i $(math $(getvar i) + 1); echo -n $(getvar i); done",
+            "setvar i 0; until [ $(getvar i) -eq 3 ]; do setvar i $(math $(getvar i) + 1); echo -n $(getvar i); done",
+            "(echo -n a; setvar v b); echo -n $(getvar v)",
+            "function f { echo -n $1 } fcall f x",
+            "seq 1 3 | readarray a; echo -n ${#a[@]}",
+            "for i from 1 to 3 step 0; do echo -n $i; done",
+            "for i from - to 3; do echo -n $i; done",
+            "setarray a; ${a[@]} && echo -n a",
+        };
+
+        inullstream oStdIn;
+        onullstream oStdErr;
+
+        // Same output as the synchronous evaluation
+        for (const auto &sCommand: vTests) {
+            std::ostringstream oExpected;
+            shell_session oSessionSync(m_pShell.get(), oStdIn, oExpected, oStdErr);
+            const auto nExpected = shell::run(sCommand, oSessionSync);
+
+            std::ostringstream oStdOut;
+            shell_session oSession(m_pShell.get(), oStdIn, oStdOut, oStdErr);
+            const shell_script oScript = shell::compile(sCommand);
+            const auto nStatus = oScript.run_async(oSession).get();
+            const std::string sName = "Check async " + std::string(sCommand) + " " + oStdOut.str();
+            custom_assert(oExpected.view() == oStdOut.view(), sName);
+            custom_assert(nExpected == nStatus, sName);
+        }
+
+        // Empty and moved-from tasks have no status
+        {
+            const auto fThrows = [](shell_task &oTask) {
+                try {
+                    static_cast<void>(oTask.get());
+                } catch (const std::logic_error &) {
+                    return true;
+                }
+                return false;
+            };
+            std::ostringstream oStdOut;
+            shell_session oSession(m_pShell.get(), oStdIn, oStdOut, oStdErr);
+            const shell_script oScript = shell::compile("echo -n a");
+            shell_task oTask = oScript.run_async(oSession);
+            shell_task oMoved = std::move(oTask);
+            shell_task oEmpty;
+            custom_assert(oTask.done() && oTask.get_event() == nullptr, "Check moved-from task");
+            custom_assert(fThrows(oTask), "Check moved-from task get");
+            custom_assert(fThrows(oEmpty), "Check empty task get");
+            custom_assert(oMoved.get() == shell_status::SHELL_SUCCESS && oStdOut.view() == "a", "Check moved task");
+        }
+
+        // Round-robin with an expired time slice at every suspension point
+        const shell_script oScriptA = shell::compile("for i from 1 to 3; do echo -n a; done");
+        const shell_script oScriptB = shell::compile("for i from 1 to 3; do echo -n b; done");
+        std::ostringstream oStdOut;
+        shell_session oSessionA(m_pShell.get(), oStdIn, oStdOut, oStdErr);
+        shell_session oSessionB(m_pShell.get(), oStdIn, oStdOut, oStdErr);
+        shell_scheduler oScheduler(std::chrono::nanoseconds{0});
+        auto oFutureA = oScheduler.submit(oScriptA, oSessionA);
+        auto oFutureB = oScheduler.submit(oScriptB, oSessionB);
+        custom_assert(oScheduler.size() == 2, "Check scheduler size");
+        oScheduler.run();
+        custom_assert(oScheduler.size() == 0, "Check scheduler size");
+        custom_assert(oStdOut.view() == "ababab", "Check scheduler interleaving " + oStdOut.str());
+        custom_assert(oFutureA.get() == shell_status::SHELL_SUCCESS, "Check scheduler status");
+        custom_assert(oFutureB.get() == shell_status::SHELL_SUCCESS, "Check scheduler status");
+
+        // Many tasks on several threads
+        if constexpr (shell_traits::THREAD_SAFE) {
+            const shell_script oScript = shell::compile("for i from 1 to 50; do setvar v $i; done; echo -n $(getvar v)");
+            std::vector<std::ostringstream> vStdOut(32);
+            std::vector<std::unique_ptr<shell_session> > vSessions;
+            std::vector<std::future<shell_status> > vFutures;
+            shell_scheduler oPool(std::chrono::microseconds{10});
+            for (auto &oOut: vStdOut) {
+                vSessions.push_back(std::make_unique<shell_session>(m_pShell.get(), oStdIn, oOut, oStdErr));
+                vFutures.push_back(oPool.submit(oScript, *vSessions.back()));
+            }
+            oPool.run(4);
+            for (std::size_t i = 0; i < vStdOut.size(); ++i) {
+                custom_assert(vFutures[i].get() == shell_status::SHELL_SUCCESS, "Check scheduler pool status");
+                custom_assert(vStdOut[i].view() == "50", "Check scheduler pool " + vStdOut[i].str());
+            }
+        }
+    }
+
+    void test_shell::test_async_command() const {
+        shell oShell(shell::get_shared_default_shell());
+        oShell.set_command<command_wait>();
+        inullstream oStdIn;
+        onullstream oStdErr;
+
+        // Driven without scheduler, blocks on the event
+        {
+            std::ostringstream oStdOut;
+            shell_session oSession(&oShell, oStdIn, oStdOut, oStdErr);
+            const shell_script oScript = shell::compile("wait 1 a; echo -n b; function f { wait 1 $1 } fcall f c");
+            custom_assert(oScript.run_async(oSession).get() == shell_status::SHELL_SUCCESS, "Check async command status");
+            custom_assert(oStdOut.view() == "abc", "Check async command " + oStdOut.str());
+        }
+        if constexpr (!shell_traits::THREAD_SAFE) return;
+
+        // A waiting task lets the others run
+        {
+            std::ostringstream oStdOut;
+            shell_session oSessionA(&oShell, oStdIn, oStdOut, oStdErr);
+            shell_session oSessionB(&oShell, oStdIn, oStdOut, oStdErr);
+            const shell_script oScriptA = shell::compile("wait 50 a | readarray v; echo -n ${v[0]}");
+            const shell_script oScriptB = shell::compile("echo -n b");
+            shell_scheduler oScheduler;
+            auto oFutureA = oScheduler.submit(oScriptA, oSessionA);
+            auto oFutureB = oScheduler.submit(oScriptB, oSessionB);
+            oScheduler.run();
+            custom_assert(oFutureA.get() == shell_status::SHELL_SUCCESS, "Check async command status");
+            custom_assert(oFutureB.get() == shell_status::SHELL_SUCCESS, "Check async command status");
+            custom_assert(oStdOut.view() == "ba", "Check async command order " + oStdOut.str());
+        }
+
+        // Waits overlap on a single thread
+        {
+            const shell_script oScript = shell::compile("wait 50 x");
+            std::vector<std::ostringstream> vStdOut(8);
+            std::vector<std::unique_ptr<shell_session> > vSessions;
+            std::vector<std::future<shell_status> > vFutures;
+            shell_scheduler oScheduler;
+            for (auto &oOut: vStdOut) {
+                vSessions.push_back(std::make_unique<shell_session>(&oShell, oStdIn, oOut, oStdErr));
+                vFutures.push_back(oScheduler.submit(oScript, *vSessions.back()));
+            }
+            const auto nStart = std::chrono::steady_clock::now();
+            oScheduler.run(1);
+            const auto nTime = std::chrono::steady_clock::now() - nStart;
+            for (std::size_t i = 0; i < vStdOut.size(); ++i) {
+                custom_assert(vFutures[i].get() == shell_status::SHELL_SUCCESS, "Check async command status");
+                custom_assert(vStdOut[i].view() == "x", "Check async command " + vStdOut[i].str());
+            }
+            custom_assert(nTime < std::chrono::milliseconds(300), "Check async command overlap");
+        }
+
+        // Every task awaiting the same event is woken
+        {
+            shell_event oEvent;
+            shell oLatchShell(shell::get_shared_default_shell());
+            oLatchShell.set_command<command_latch>(&oEvent);
+            const shell_script oScript = shell::compile("latch x");
+            std::vector<std::ostringstream> vStdOut(3);
+            std::vector<std::unique_ptr<shell_session> > vSessions;
+            std::vector<std::future<shell_status> > vFutures;
+            shell_scheduler oScheduler;
+            for (auto &oOut: vStdOut) {
+                vSessions.push_back(std::make_unique<shell_session>(&oLatchShell, oStdIn, oOut, oStdErr));
+                vFutures.push_back(oScheduler.submit(oScript, *vSessions.back()));
+            }
+            std::jthread oThread([&oEvent] {
+                std::this_thread::sleep_for(std::chrono::milliseconds(20));
+                oEvent.set();
+            });
+            oScheduler.run(1);
+            for (std::size_t i = 0; i < vStdOut.size(); ++i) {
+                custom_assert(vFutures[i].get() == shell_status::SHELL_SUCCESS, "Check shared event status");
+                custom_assert(vStdOut[i].view() == "x", "Check shared event " + vStdOut[i].str());
+            }
+        }
+    }
+
+    void test_shell::test_env_base() const {
+        shell_env oBaseEnv;
+        for (std::size_t i = 0; i < 300; ++i)
+            oBaseEnv.set_env("base" + std::to_string(i), std::to_string(i));
+        oBaseEnv.set_env("shared", "base");
+        oBaseEnv.set_env("link", "base7");
+        const auto pBase = shell_traits::make<const shell_env>(std::move(oBaseEnv));
+
+        const std::vector<std::pair<std::string, std::string> > vTests = {
+            {"echo -n $(getenv base42)", "42"},
+            {"echo -n $(getenv shared)", "base"},
+            {"setenv shared mine; echo -n $(getenv shared)", "mine"},
+            {"setenv base42 x; echo -n $(getenv base42) $(getenv base43)", "x 43"},
+            {"(setenv shared sub); echo -n $(getenv shared)", "base"},
+            {"echo -n ${!link}", "7"},
+            {"setenv link shared; echo -n ${!link}", "base"},
+            {"setenv other base8; setenv link other; echo -n ${!link}", "base8"},
+        };
+
+        inullstream oStdIn;
+        onullstream oStdErr;
+
+        for (const auto &[sCommand, sOutput]: vTests) {
+            std::ostringstream oStdOut;
+            shell_session oSession(m_pShell.get(), oStdIn, oStdOut, oStdErr, shell_env(pBase), shell_arg());
+            shell::run(sCommand, oSession);
+            const std::string sName = "Check env base " + sCommand + " " + oStdOut.str();
+            custom_assert(sOutput == oStdOut.view(), sName);
+        }
+
+        // The base is never modified
+        custom_assert(pBase->get_env("shared") == "base", "Check env base unmodified");
+        custom_assert(pBase->get_env("base42") == "42", "Check env base unmodified");
+        custom_assert(pBase->get_env_size() == 302, "Check env base size");
+
+        // Overlay size counts shadowed variables once
+        shell_env oEnv(pBase);
+        oEnv.set_env("shared", "mine");
+        oEnv.set_env("new", "value");
+        custom_assert(oEnv.get_env_size() == 303, "Check env overlay size");
+        custom_assert(oEnv.get_env().size() == 2, "Check env overlay map");
+        custom_assert(oEnv.has_env("base0") && !oEnv.has_env("none"), "Check env overlay has_env");
+    }
+
+    void test_shell::test_profiler() const {
+        shell oShell(shell::get_shared_default_shell());
+        oShell.set_command<command_wait>();
+        inullstream oStdIn;
+        onullstream oStdErr;
+
+        const std::string sScript =
+                "function f {\n"
+                "    wait 2 $1\n"
+                "}\n"
+                "for i from 1 to 3; do\n"
+                "    fcall f $i\n"
+                "done\n"
+                "echo -n 4 | readarray v; echo -n ${v[0]}\n";
+
+        std::ostringstream oStdOut;
+        shell_profiler oProfiler(sScript);
+        shell_session oSession(&oShell, oStdIn, oStdOut, oStdErr);
+        oSession.set_profiler(&oProfiler);
+        shell::run(sScript, oSession);
+        custom_assert(oStdOut.view() == "1234", "Check profiler output " + oStdOut.str());
+
+        // Hits and times
+        std::map<std::string, shell_profiler::entry> mEntries;
+        for (const auto &oEntry: oProfiler.get_entries()) mEntries.emplace(oEntry.get_label(), oEntry);
+        std::ostringstream oReport;
+        oProfiler.write_report(oReport, 0);
+        const std::vector<std::pair<std::string, std::uint64_t> > vHits = {
+            {"function f", 3},
+            {"cmd@2:5", 3},
+            {"cmd@5:5", 3},
+            {"for count@4:1", 1},
+            {"pipe@7:11", 1},
+        };
+        for (const auto &[sLabel, nHits]: vHits) {
+            const auto pEntry = mEntries.find(sLabel);
+            custom_assert(pEntry != mEntries.end() && pEntry->second.m_nHits == nHits,
+                          "Check profiler hits " + sLabel + "\n" + oReport.str());
+        }
+        custom_assert(mEntries["cmd@2:5"].m_nExclusive >= std::chrono::milliseconds(6), "Check profiler exclusive time");
+        custom_assert(mEntries["for count@4:1"].m_nInclusive >= mEntries["function f"].m_nInclusive,
+                      "Check profiler inclusive time");
+        custom_assert(mEntries["function f"].m_nExclusive < std::chrono::milliseconds(2), "Check profiler function exclusive time");
+
+        // Folded stacks
+        std::ostringstream oFolded;
+        oProfiler.write_folded(oFolded);
+        custom_assert(oFolded.str().find("for count@4:1;cmd@5:5;function f;cmd@2:5 ") != std::string::npos,
+                      "Check profiler folded stacks " + oFolded.str());
+
+        // Nested sources restart at position 0, they are kept apart from the profiled source
+        {
+            const std::string sNested = "echo -n a\neval 'echo -n b; echo -n c'\n";
+            shell_profiler oNestedProfiler(sNested);
+            std::ostringstream oNestedOut;
+            shell_session oNestedSession(&oShell, oStdIn, oNestedOut, oStdErr);
+            oNestedSession.set_profiler(&oNestedProfiler);
+            shell::run(sNested, oNestedSession);
+            std::map<std::string, std::uint64_t> mHits;
+            for (const auto &oEntry: oNestedProfiler.get_entries()) mHits[oEntry.get_label()] += oEntry.m_nHits;
+            custom_assert(oNestedOut.view() == "abc", "Check profiler nested output " + oNestedOut.str());
+            custom_assert(mHits["cmd@1:1"] == 1 && mHits["cmd@2:1"] == 1, "Check profiler nested source lines");
+            custom_assert(mHits["cmd@nested:0"] == 1 && mHits["cmd@nested:11"] == 1, "Check profiler nested nodes");
+
+            // Each run parses the nested source again, its nodes add up in the same entries
+            oNestedProfiler.clear();
+            shell::run(std::string("for i from 1 to 50; do eval 'echo -n b'; done"), oNestedSession);
+            const auto vEntries = oNestedProfiler.get_entries();
+            const auto nNested = std::ranges::count(vEntries, true, &shell_profiler::entry::m_bNested);
+            const auto pEval = std::ranges::find(vEntries, std::string("cmd@nested:0"), &shell_profiler::entry::get_label);
+            custom_assert(nNested == 1 && pEval != vEntries.end() && pEval->m_nHits == 50,
+                          "Check profiler repeated nested source " + std::to_string(nNested));
+        }
+
+        // Recursion is counted once in the inclusive time
+        oProfiler.clear();
+        const std::string sRecursion = "function r { if test $1 -gt 0; then wait 2 ''; fcall r $(math $1 - 1); fi } fcall r 3";
+        const auto nStart = std::chrono::steady_clock::now();
+        shell::run(sRecursion, oSession);
+        const auto nElapsed = std::chrono::steady_clock::now() - nStart;
+        const auto vEntries = oProfiler.get_entries();
+        const auto pFunction = std::ranges::find(vEntries, std::string("r"), &shell_profiler::entry::m_sFunction);
+        custom_assert(pFunction != vEntries.end() && pFunction->m_nHits == 4, "Check profiler recursion hits");
+        custom_assert(pFunction != vEntries.end() && pFunction->m_nInclusive <= nElapsed,
+                      "Check profiler recursion inclusive time");
+
+        // Disabled
+        oSession.set_profiler(nullptr);
+        oProfiler.clear();
+        shell::run(std::string("echo -n x"), oSession);
+        custom_assert(oProfiler.get_entries().empty(), "Check profiler disabled");
+    }
+
+    void test_shell::test_command_metrics() const {
+        // A shell of its own, the commands of the shared default shell are shared with other tests
+        const auto pShell = shell::make_default_shell();
+        pShell->set_command<command_wait>();
+        pShell->set_collect_metrics(true);
+        inullstream oStdIn;
+        std::ostringstream oStdOut;
+        std::ostringstream oStdErr;
+        shell_session oSession(pShell.get(), oStdIn, oStdOut, oStdErr);
+
+        const std::string sScript = "echo -n abc; echo xy; wait 3 ''; fcall none; echo -n $(echo -n q)";
+        shell::run(sScript, oSession);
+        custom_assert(oStdOut.view() == "abcxy\nq", "Check metrics output " + oStdOut.str());
+
+        std::map<std::string, command_metrics_snapshot> mMetrics;
+        for (auto &oMetrics: pShell->get_command_metrics()) mMetrics.emplace(oMetrics.m_sName, std::move(oMetrics));
+        custom_assert(mMetrics.size() == 16, "Check metrics commands");
+
+        const auto &oEcho = mMetrics["echo"];
+        custom_assert(oEcho.m_nCalls == 4 && oEcho.m_nErrors == 0, "Check metrics echo calls");
+        custom_assert(oEcho.m_nBytesOut == 8 && oEcho.m_nBytesErr == 0, "Check metrics echo bytes");
+
+        const auto &oFcall = mMetrics["fcall"];
+        custom_assert(oFcall.m_nCalls == 1 && oFcall.m_nErrors == 1, "Check metrics fcall errors");
+        custom_assert(oFcall.m_mErrors.size() == 1
+                      && oFcall.m_mErrors.begin()->first == shell_status::SHELL_CMD_ERROR_FCALL_FUNCTION_NOT_FOUND,
+                      "Check metrics fcall status");
+        custom_assert(oFcall.m_nBytesErr == oStdErr.view().size() && oFcall.m_nBytesErr > 0, "Check metrics fcall bytes");
+
+        const auto &oWait = mMetrics["wait"];
+        custom_assert(oWait.m_nLatency >= std::chrono::milliseconds(3), "Check metrics wait latency");
+        custom_assert(oWait.get_latency_quantile(1.0) >= std::chrono::microseconds(4096), "Check metrics wait histogram");
+        custom_assert(mMetrics["getvar"].m_nCalls == 0, "Check metrics unused command");
+
+        // Disabled
+        pShell->set_collect_metrics(false);
+        shell::run(std::string("echo -n x"), oSession);
+        custom_assert(pShell->get_command(std::string(command_echo::NAME))->get_metrics().snapshot().m_nCalls == 4,
+                      "Check metrics disabled");
+
+        // Commands that throw are failed runs
+        pShell->set_command<command_throw>();
+        pShell->set_collect_metrics(true);
+        try {
+            shell::run(std::string("throw boom"), oSession);
+            custom_assert(false, "Check metrics throw");
+        } catch (const std::runtime_error &) {
+        }
+        const shell_script oThrowScript = shell::compile("echo -n ab; throw boom");
+        try {
+            oThrowScript.run_async(oSession).get();
+            custom_assert(false, "Check metrics throw async");
+        } catch (const std::runtime_error &) {
+        }
+        const auto oThrow = pShell->get_command("throw")->get_metrics().snapshot();
+        custom_assert(oThrow.m_nCalls == 2 && oThrow.m_nErrors == 2
+                      && oThrow.m_mErrors.begin()->first == shell_status::SHELL_ERROR, "Check metrics throw errors");
+
+        // Statuses without a slot are not counted as a status of their own
+        command_metrics oStatuses;
+        oStatuses.record(static_cast<shell_status>(109), std::chrono::nanoseconds{0}, 0, 0);
+        oStatuses.record(static_cast<shell_status>(500), std::chrono::nanoseconds{0}, 0, 0);
+        const auto oStatusesSnapshot = oStatuses.snapshot();
+        custom_assert(oStatusesSnapshot.m_nErrors == 2 && oStatusesSnapshot.m_nOtherErrors == 1
+                      && oStatusesSnapshot.m_mErrors.size() == 1
+                      && oStatusesSnapshot.m_mErrors.begin()->first == static_cast<shell_status>(109),
+                      "Check metrics other statuses");
+
+        // Coroutine runs count characters too
+        const auto oEchoAsync = pShell->get_command(std::string(command_echo::NAME))->get_metrics().snapshot();
+        custom_assert(oEchoAsync.m_nCalls == 5 && oEchoAsync.m_nBytesOut == 10, "Check metrics async bytes");
+
+        // Sessions on several threads sharing their streams
+        if constexpr (shell_traits::THREAD_SAFE) {
+            const auto pShared = shell::make_default_shell();
+            pShared->set_collect_metrics(true);
+            shared_countbuffer oBuffer;
+            std::ostream oStream(&oBuffer);
+            const shell_script oScript = shell::compile("for i from 1 to 200; do echo x; done");
+            {
+                std::vector<std::jthread> vThreads;
+                for (std::size_t i = 0; i < 4; ++i) {
+                    vThreads.emplace_back([&pShared, &oStdIn, &oStream, &oScript] {
+                        shell_session oThreadSession(pShared.get(), oStdIn, oStream, oStream);
+                        oScript.run(oThreadSession);
+                    });
+                }
+            }
+            const auto oShared = pShared->get_command(std::string(command_echo::NAME))->get_metrics().snapshot();
+            custom_assert(oShared.m_nCalls == 800 && oShared.m_nErrors == 0, "Check metrics threads calls");
+            custom_assert(oShared.m_nBytesOut == 1600 && oBuffer.count() == 1600, "Check metrics threads bytes");
+            custom_assert(oStream.rdbuf() == &oBuffer && oStream.good(), "Check metrics threads stream");
+        }
+
+        // Builtins of a static shell
+        const default_static_shell oStatic;
+        custom_assert(oStatic.get_command_metrics().size() == 15, "Check metrics static shell");
+    }
+
+    void test_shell::test_alloc_stats() const {
+        shell oShell(shell::get_shared_default_shell());
+        oShell.set_command<command_alloc>();
+        oShell.set_stream_substitution(true);
+        inullstream oStdIn;
+        onullstream oStdOut;
+        onullstream oStdErr;
+        shell_alloc_stats oStats;
+
+        // Allocations of the commands, including function calls and substitutions
+        shell_session oSession(&oShell, oStdIn, oStdOut, oStdErr);
+        oSession.set_alloc_stats(&oStats);
+        shell::run(std::string("function f { alloc 20 } alloc 100; fcall f; echo -n $(alloc 5)"), oSession);
+        auto oCommand = oStats.get(shell_alloc_phase::SAP_COMMAND);
+        custom_assert(oCommand.m_nAllocations == 3 && oCommand.m_nBytes == 125, "Check alloc stats commands");
+
+        // Streamed substitutions run on another thread
+        shell::run(std::string("for x in $(alloc 9; echo a b); do alloc 1; done"), oSession);
+        oCommand = oStats.get(shell_alloc_phase::SAP_COMMAND);
+        custom_assert(oCommand.m_nAllocations == 6 && oCommand.m_nBytes == 136, "Check alloc stats stream substitution");
+
+        // Sessions without stats are not accounted
+        shell_session oPlain(&oShell, oStdIn, oStdOut, oStdErr);
+        shell::run(std::string("alloc 100"), oPlain);
+        shell_alloc_stats::record_allocation(100);
+        custom_assert(oStats.get_total().m_nAllocations == 6, "Check alloc stats disabled");
+
+        // Scopes nest
+        oStats.clear();
+        {
+            const shell_alloc_scope oParse(&oStats, shell_alloc_phase::SAP_PARSE);
+            shell_alloc_stats::record_allocation(7);
+            {
+                const shell_alloc_scope oTokenize(shell_alloc_phase::SAP_TOKENIZE);
+                shell_alloc_stats::record_allocation(3);
+            }
+            shell_alloc_stats::record_allocation(7);
+        }
+        shell_alloc_stats::record_allocation(1);
+        custom_assert(oStats.get(shell_alloc_phase::SAP_PARSE).m_nBytes == 14, "Check alloc scope parse");
+        custom_assert(oStats.get(shell_alloc_phase::SAP_TOKENIZE).m_nBytes == 3, "Check alloc scope tokenize");
+        custom_assert(oStats.get_total().m_nAllocations == 3, "Check alloc scope total");
+        custom_assert(get_alloc_phase_name(shell_alloc_phase::SAP_DISPATCH) == "dispatch", "Check alloc phase name");
+    }
+
+    void test_shell::test_tracer() const {
+        shell oShell(shell::get_shared_default_shell());
+        oShell.set_stream_substitution(true);
+        inullstream oStdIn;
+        onullstream oStdErr;
+
+        std::ostringstream oStdOut;
+        shell_tracer oTracer;
+        shell_session oSession(&oShell, oStdIn, oStdOut, oStdErr);
+        oSession.set_tracer(&oTracer);
+        const std::string sScript = "function f { echo -n $1 } fcall f a; echo -n `echo b` | readarray v; "
+                "echo -n ${v[0]}; for x in $(echo c d); do echo -n $x; done";
+        shell::run(sScript, oSession);
+        custom_assert(oStdOut.view() == "abcd", "Check tracer output " + oStdOut.str());
+
+        // Begin and end events nest on each thread
+        std::map<std::string, std::size_t> mBegins;
+        std::set<std::uint64_t> vSessions;
+        const auto vThreads = oTracer.get_events();
+        std::size_t nEvents = 0;
+        for (const auto &vEvents: vThreads) {
+            std::vector<const shell_tracer::event *> vStack;
+            for (const auto &oEvent: vEvents) {
+                vSessions.insert(oEvent.m_nSession);
+                if (oEvent.m_cPhase == 'B') {
+                    vStack.push_back(&oEvent);
+                    ++mBegins[std::string(oEvent.get_name())];
+                } else {
+                    custom_assert(!vStack.empty() && vStack.back()->get_name() == oEvent.get_name()
+                                  && vStack.back()->m_nSession == oEvent.m_nSession, "Check tracer nesting");
+                    vStack.pop_back();
+                }
+            }
+            custom_assert(vStack.empty(), "Check tracer balance");
+            nEvents += vEvents.size();
+        }
+        custom_assert(vThreads.size() == (shell_traits::THREAD_SAFE ? 2 : 1), "Check tracer threads");
+        custom_assert(mBegins["parse"] == 1 && mBegins["f"] == 1 && mBegins["echo"] == 7 && mBegins["fcall"] == 1,
+                      "Check tracer commands");
+        custom_assert(mBegins["``"] == 1 && mBegins["pipe left"] == 1 && mBegins["pipe right"] == 1,
+                      "Check tracer substitutions and pipes");
+        custom_assert(mBegins[shell_traits::THREAD_SAFE ? "stream" : "$()"] == 1, "Check tracer stream");
+        custom_assert(vSessions.size() >= 5, "Check tracer sessions");
+
+        // Trace-event JSON
+        std::ostringstream oJson;
+        oTracer.write_json(oJson);
+        const auto oTrace = nlohmann::json::parse(oJson.str());
+        custom_assert(oTrace.at("traceEvents").size() == nEvents + vThreads.size(), "Check tracer json");
+        custom_assert(oTrace.at("traceEvents")[1].at("ph") == "B" && oTrace.at("traceEvents")[1].at("cat") == "parse",
+                      "Check tracer json event");
+
+        // Full buffers keep the last events
+        shell_tracer oSmall(4);
+        oSession.set_tracer(&oSmall);
+        shell::run(std::string("echo a; echo b; echo c"), oSession);
+        custom_assert(oSmall.get_dropped() == 4 && oSmall.get_events().front().size() == 4, "Check tracer ring");
+        custom_assert(oSmall.get_events().front().back().get_name() == "echo", "Check tracer ring order");
+        oSmall.clear();
+        custom_assert(oSmall.get_events().empty(), "Check tracer clear");
+
+        // Batch jobs
+        oTracer.clear();
+        std::vector<shell_job> vJobs(8);
+        for (auto &oJob: vJobs) {
+            oJob.m_sCommand = "echo -n x";
+            oJob.m_pTracer = &oTracer;
+        }
+        static_cast<void>(oShell.run_batch(vJobs, 2));
+        std::size_t nJobs = 0;
+        for (const auto &vEvents: oTracer.get_events())
+            nJobs += std::ranges::count_if(vEvents, [](const auto &oEvent) { return oEvent.get_name() == "job"; });
+        custom_assert(nJobs == 16, "Check tracer batch");
+
+        // Interleaved coroutines write asynchronous events, matched by session
+        oTracer.clear();
+        const auto oAsyncScript = shell::compile("function f { echo -n $1 } fcall f a; echo -n b | readarray v; echo -n c");
+        std::ostringstream oStdOutA;
+        std::ostringstream oStdOutB;
+        shell_session oSessionA(&oShell, oStdIn, oStdOutA, oStdErr);
+        shell_session oSessionB(&oShell, oStdIn, oStdOutB, oStdErr);
+        oSessionA.set_tracer(&oTracer);
+        oSessionB.set_tracer(&oTracer);
+        shell_scheduler oScheduler(std::chrono::nanoseconds{0});
+        auto oFutureA = oScheduler.submit(oAsyncScript, oSessionA);
+        auto oFutureB = oScheduler.submit(oAsyncScript, oSessionB);
+        oScheduler.run();
+        custom_assert(oFutureA.get() == shell_status::SHELL_SUCCESS && oFutureB.get() == shell_status::SHELL_SUCCESS,
+                      "Check tracer async status");
+        std::map<std::uint64_t, std::vector<std::string> > mAsyncStacks;
+        std::map<std::string, std::size_t> mAsyncBegins;
+        for (const auto &vEvents: oTracer.get_events()) {
+            for (const auto &oEvent: vEvents) {
+                if (oEvent.m_cPhase == 'b') {
+                    mAsyncStacks[oEvent.m_nSession].emplace_back(oEvent.get_name());
+                    ++mAsyncBegins[std::string(oEvent.get_name())];
+                } else if (oEvent.m_cPhase == 'e') {
+                    auto &vStack = mAsyncStacks[oEvent.m_nSession];
+                    custom_assert(!vStack.empty() && vStack.back() == oEvent.get_name(), "Check tracer async nesting");
+                    vStack.pop_back();
+                }
+            }
+        }
+        for (const auto &vStack: mAsyncStacks | std::views::values)
+            custom_assert(vStack.empty(), "Check tracer async balance");
+        custom_assert(mAsyncBegins["fcall"] == 2 && mAsyncBegins["f"] == 2 && mAsyncBegins["echo"] == 6
+                      && mAsyncBegins["pipe left"] == 2 && mAsyncBegins["pipe right"] == 2,
+                      "Check tracer async events");
+        std::ostringstream oAsyncJson;
+        oTracer.write_json(oAsyncJson);
+        const auto oAsyncTrace = nlohmann::json::parse(oAsyncJson.str());
+        custom_assert(std::ranges::any_of(oAsyncTrace.at("traceEvents"), [](const auto &oEvent) {
+            return oEvent.at("ph") == "b" && oEvent.contains("id");
+        }), "Check tracer async json");
+    }
+
+    void test_shell::test_log() const {
+        inullstream oStdIn;
+        onullstream oStdErr;
+        std::ostringstream oStdOut;
+        shell_session oSession(m_pShell.get(), oStdIn, oStdOut, oStdErr);
+        const std::string sScript = "function f { echo -n $1 } fcall f a";
+
+        // Functions up to debug
+        std::ostringstream oLog;
+        shell_log::configure(oLog, shell_log_level::SLL_DEBUG,
+                             shell_log::get_category_mask(shell_log_category::SLC_FUNCTION));
+        shell::run(sScript, oSession);
+        custom_assert(oStdOut.view() == "a", "Check log output " + oStdOut.str());
+#ifdef BS_NO_LOG
+        custom_assert(oLog.view().empty(), "Check log removed " + oLog.str());
+#else
+        custom_assert(oLog.view() == "[debug] function: fcall f a\n", "Check log filter " + oLog.str());
+        custom_assert(shell_log::is_enabled(shell_log_level::SLL_ERROR, shell_log_category::SLC_FUNCTION)
+                      && !shell_log::is_enabled(shell_log_level::SLL_TRACE, shell_log_category::SLC_FUNCTION)
+                      && !shell_log::is_enabled(shell_log_level::SLL_DEBUG, shell_log_category::SLC_COMMAND),
+                      "Check log levels");
+
+        // Everything
+        oLog.str({});
+        shell_log::configure(oLog, shell_log_level::SLL_TRACE);
+        shell::run(sScript, oSession);
+        custom_assert(oLog.view().find("[trace] tokenize: tokens <function> ") != std::string_view::npos
+                      && oLog.view().find("[trace] command: cmd fcall f a\n") != std::string_view::npos
+                      && oLog.view().find("[trace] session: function session with 1 args\n") != std::string_view::npos
+                      && oLog.view().find("[trace] command: cmd echo -n a\n") != std::string_view::npos,
+                      "Check log trace " + oLog.str());
+#endif
+
+        // Disabled
+        oLog.str({});
+        shell_log::disable();
+        shell::run(sScript, oSession);
+        custom_assert(oLog.view().empty(), "Check log disabled " + oLog.str());
+        custom_assert(!shell_log::is_enabled(shell_log_level::SLL_ERROR, shell_log_category::SLC_PARSE),
+                      "Check log disabled levels");
+    }
+
+    void test_shell::test_parser_exception() const {
+        // The error is on the second line, after a two-byte character
+        const std::string sScript = "echo \u00E9\necho 'b";
+        try {
+            std::ignore = shell::compile(sScript);
+            custom_assert(false, "Check syntax error thrown");
+        } catch (const shell_parser_exception &oException) {
+            custom_assert(oException.get_status() == shell_status::SHELL_ERROR_SYNTAX_ERROR_UNCLOSED_SIMPLE_QUOTES,
+                          "Check syntax error status");
+            custom_assert(oException.get_position() == 13 && oException.get_line() == 2, "Check syntax error position");
+            custom_assert(oException.get_command() == sScript, "Check syntax error command");
+            custom_assert(oException.get_command().data() != sScript.data(), "Check syntax error owns the command");
+
+            // Copies share the source and the message
+            const shell_parser_exception oCopy = oException;
+            custom_assert(oCopy.get_source() == oException.get_source(), "Check syntax error source");
+            const std::string_view sMessage = oException.what();
+            custom_assert(sMessage == "Unclosed simple quotes\necho 'b\n     ^~~~\nCode point: 12\nByte: 13\n",
+                          "Check syntax error message " + std::string(sMessage));
+            custom_assert(oCopy.what() == sMessage.data(), "Check syntax error shared message");
+        }
+
+        // Errors of the same source share it without copying the script
+        const auto pSource = shell_source::make(sScript);
+        const auto fParse = [&pSource] {
+            try {
+                std::ignore = shell_parser::parse(pSource);
+            } catch (const shell_parser_exception &oException) {
+                return oException;
+            }
+            throw std::logic_error("Syntax error not thrown");
+        };
+        const shell_parser_exception oFirst = fParse();
+        const shell_parser_exception oSecond = fParse();
+        custom_assert(oFirst.get_source() == pSource && oSecond.get_source() == pSource,
+                      "Check syntax errors share the source");
+        custom_assert(pSource.use_count() == 3, "Check syntax errors source count " +
+                                                std::to_string(pSource.use_count()));
+
+        // Errors of the counted loop
+        const std::vector<std::tuple<std::string, shell_status, std::size_t> > vForCount = {
+            {"for i from 1; do echo; done", shell_status::SHELL_ERROR_SYNTAX_ERROR_MISSING_KEYWORD_TO, 0},
+            {"for i from 1", shell_status::SHELL_ERROR_SYNTAX_ERROR_MISSING_KEYWORD_TO, 0},
+            {"for i from 1 2 to 5; do echo; done", shell_status::SHELL_ERROR_SYNTAX_ERROR_UNEXPECTED_TOKEN, 13},
+            {"for i from to 5; do echo; done", shell_status::SHELL_ERROR_SYNTAX_ERROR_UNEXPECTED_TOKEN, 14},
+        };
+        for (const auto &[sForCount, nForCountStatus, nForCountPos]: vForCount) {
+            try {
+                std::ignore = shell::compile(sForCount);
+                custom_assert(false, "Check counted loop error thrown " + sForCount);
+            } catch (const shell_parser_exception &oException) {
+                custom_assert(oException.get_status() == nForCountStatus
+                              && oException.get_position() == nForCountPos,
+                              "Check counted loop error " + sForCount + " " +
+                              std::to_string(static_cast<int>(oException.get_status())) + " " +
+                              std::to_string(oException.get_position()));
+            }
+        }
+
+        // Errors of the parser
+        std::ostringstream oStdOut;
+        std::ostringstream oStdErr;
+        inullstream oStdIn;
+        shell_session oSession(m_pShell.get(), oStdIn, oStdOut, oStdErr);
+        const std::string sParser = "echo a\nif true; then echo b";
+        const auto nStatus = shell::run(sParser, oSession);
+        custom_assert(nStatus == shell_status::SHELL_ERROR_SYNTAX_ERROR_UNFINISHED_KEYWORD_IF,
+                      "Check parser error status " + std::to_string(static_cast<int>(nStatus)));
+        custom_assert(oStdErr.view() == "Syntax error: 'if' keyword is not finished.\nif true; then echo b\n"
+                      "         ^~~~\nCode point: 16\nByte: 16\n",
+                      "Check parser error message " + oStdErr.str());
+    }
+
+    void test_shell::test_json_writer() const {
+        inullstream oStdIn;
+        onullstream oStdOut;
+        onullstream oStdErr;
+        shell_session oSession(m_pShell.get(), oStdIn, oStdOut, oStdErr);
+        oSession.set_var("v", "x\"y\\\u00E9\t");
+        const std::string sScript =
+                "function f { echo -n $1 \"$v\" '' ${v} $@ $# \\u00E9; } fcall f a\n"
+                "if [ $v = x ] && test 1 -eq 1 || test 1 -eq 2; then echo `echo a` | readarray w; else (echo ${w[0]} ${w[@]}); fi\n"
+                "for x in $(seq 1 3); do test $x -eq 2; continue; break; done\n"
+                "for i from 1 to 5 step 2; do echo $i; done; for i from 1 to 2; do echo ${#w[@]}; done\n"
+                "while test 1 -eq 2; do echo; done; until test 1 -eq 1; do echo; done; {echo a; echo b} &";
+        const auto oScript = shell::compile(sScript);
+
+        shell_node_visitor_json oVisitor;
+        const auto oJson = oVisitor.visit_node(oSession, oScript.get_root());
+        for (const auto &[nIndent, cIndent]:
+             {std::pair{-1, ' '}, std::pair{0, ' '}, std::pair{4, ' '}, std::pair{1, '\t'}}) {
+            std::ostringstream oWriter;
+            shell_node_visitor_json_writer oStream(oWriter, nIndent, cIndent);
+            oStream.visit_node(oSession, oScript.get_root());
+            custom_assert(oWriter.view() == oJson.dump(nIndent, cIndent),
+                          "Check json writer indent " + std::to_string(nIndent) + "\n" + oWriter.str());
+        }
+    }
+
+    namespace {
+        /**
+         * @class test_type_counter
+         * @brief Counts the nodes of a tree by type.
+         */
+        class test_type_counter final : public shell_node_static_visitor<test_type_counter, void> {
+            friend shell_node_static_visitor;
+
+        public:
+            /// Nodes by type
+            std::map<shell_node_type, std::size_t> m_mCount;
+
+        private:
+            /**
+             * @brief Counts a node and its children.
+             * @param oSession The current shell session.
+             * @param pNode The node.
+             */
+            template<typename node_t>
+            void visit(shell_session &oSession, const node_t *pNode) {
+                ++this->m_mCount[pNode->get_type()];
+                for_each_child(pNode, [&](const auto *pChild) { this->visit_node(oSession, pChild); });
+            }
+        };
+
+        /**
+         * @brief Counts the nodes of a tree converted to JSON.
+         * @param oJson The tree.
+         * @return The number of objects with a type.
+         */
+        std::size_t count_json_nodes(const nlohmann::json &oJson) {
+            std::size_t nCount = oJson.is_object() && oJson.contains("type") ? 1 : 0;
+            if (oJson.is_structured())
+                for (const auto &oChild: oJson)
+                    nCount += count_json_nodes(oChild);
+            return nCount;
+        }
+    }
+
+    void test_shell::test_static_visitor() const {
+        inullstream oStdIn;
+        onullstream oStdOut;
+        onullstream oStdErr;
+        shell_session oSession(m_pShell.get(), oStdIn, oStdOut, oStdErr);
+        const std::string sScript =
+                "function f { echo -n $1 \"$v\" '' ${v} $@ $# \\u00E9; } fcall f a\n"
+                "if [ $v = x ] && test 1 -eq 1 || test 1 -eq 2; then echo `echo a` | readarray w; else (echo ${w[0]} ${w[@]}); fi\n"
+                "for x in $(seq 1 3); do test $x -eq 2; continue; break; done\n"
+                "for i from 1 to 5 step 2; do echo $i; done; for i from 1 to 2; do echo ${#w[@]}; done\n"
+                "while test 1 -eq 2; do echo; done; until test 1 -eq 1; do echo; done; {echo a; echo b} &";
+        const auto oScript = shell::compile(sScript);
+
+        test_type_counter oCounter;
+        oCounter.visit_node(oSession, oScript.get_root());
+        std::size_t nCount = 0;
+        for (const auto &[nType, nNodes]: oCounter.m_mCount) nCount += nNodes;
+
+        shell_node_visitor_json oVisitor;
+        const auto nExpected = count_json_nodes(oVisitor.visit_node(oSession, oScript.get_root()));
+        custom_assert(nCount == nExpected,
+                      "Check static visitor count " + std::to_string(nCount) + " " + std::to_string(nExpected));
+        custom_assert(oCounter.m_mCount[shell_node_type::SNT_FOR_COUNT] == 2, "Check static visitor for count");
+        custom_assert(oCounter.m_mCount[shell_node_type::SNT_BREAK] == 1, "Check static visitor break");
+        custom_assert(oCounter.m_mCount[shell_node_type::SNT_FUNCTION] == 1, "Check static visitor function");
+
+        // Through the node base
+        test_type_counter oBase;
+        oBase.visit_node(oSession, static_cast<const shell_node *>(oScript.get_root()));
+        custom_assert(oBase.m_mCount == oCounter.m_mCount, "Check static visitor from shell_node");
+    }
+
+    void test_shell::test_local_ptr() const {
+        // Counts the destructions of its objects
+        struct counted {
+            explicit counted(std::size_t &nDestroyed) : m_nDestroyed(nDestroyed) {
+            }
+
+            ~counted() {
+                ++this->m_nDestroyed;
+            }
+
+            std::size_t &m_nDestroyed;
+        };
+
+        std::size_t nDestroyed = 0;
+        {
+            local_ptr<counted> pFirst = make_local<counted>(nDestroyed);
+            custom_assert(pFirst.use_count() == 1, "Check local_ptr count");
+
+            // Copies share the object
+            local_ptr<counted> pCopy(pFirst);
+            custom_assert(pFirst.use_count() == 2 && pCopy.get() == pFirst.get(), "Check local_ptr copy");
+            local_ptr<counted> pAssigned;
+            pAssigned = pCopy;
+            custom_assert(pFirst.use_count() == 3, "Check local_ptr copy assignment");
+            const local_ptr<counted> &pSelf = pAssigned;
+            pAssigned = pSelf;
+            custom_assert(pFirst.use_count() == 3, "Check local_ptr self assignment");
+
+            // Moves transfer the ownership
+            local_ptr<counted> pMoved(std::move(pCopy));
+            custom_assert(!pCopy && pCopy.use_count() == 0 && pFirst.use_count() == 3, "Check local_ptr move");
+            pCopy = std::move(pMoved);
+            custom_assert(!pMoved && pFirst.use_count() == 3, "Check local_ptr move assignment");
+
+            // Pointers to const share the object
+            local_ptr<const counted> pConst(pFirst);
+            custom_assert(pFirst.use_count() == 4 && pConst.get() == pFirst.get(), "Check local_ptr const copy");
+            local_ptr<const counted> pConstMoved(std::move(pAssigned));
+            custom_assert(!pAssigned && pFirst.use_count() == 4, "Check local_ptr const move");
+            pAssigned = pFirst;
+            pConst.reset();
+            pConstMoved.reset();
+
+            // Resets drop one owner, the last one destroys the object
+            pCopy.reset();
+            pAssigned = nullptr;
+            custom_assert(!pCopy && !pAssigned && pFirst.use_count() == 1, "Check local_ptr reset");
+            custom_assert(nDestroyed == 0, "Check local_ptr alive");
+            pAssigned = make_local<counted>(nDestroyed);
+            pAssigned = pFirst;
+            custom_assert(nDestroyed == 1 && pFirst.use_count() == 2, "Check local_ptr replace");
+            pFirst.reset();
+            custom_assert(nDestroyed == 1 && pAssigned.use_count() == 1, "Check local_ptr last owner");
+        }
+        custom_assert(nDestroyed == 2, "Check local_ptr destroyed");
+    }
 }